@@ -5,7 +5,12 @@
 #include <iomanip>
 #include <vector>
 #include <algorithm>
+#include <thread>
+#include <mutex>
 #include "dsas.h"
+#if defined DSAS_LINUX
+    #include <sys/wait.h>
+#endif
 
 using std::cout;
 using std::endl;
@@ -23,19 +28,41 @@ void test_queue();
 void test_bt();
 void test_graph();
 void test_bst();
+void test_bst_range();
+void test_order_stat();
+void test_tree_bulk();
+void test_persistent();
 void test_avl();
 void test_splay();
 void test_btree();
+void test_bplus_tree();
+void test_btree_disk();
+void test_btree_durable();
 void test_redblack();
 void test_maprbt();
+void test_map_skiplist();
 void test_bitmap();
 void test_hash();
+void test_hash_concurrent();
+void test_hash_func();
+void test_hash_bucket();
+void test_hash_frozen();
+void test_filter();
 void test_pq();
 void test_leftpq();
+void test_pq_index();
+void test_pq_dary();
+void test_pq_meld();
+void test_pq_multiqueue();
+void test_dijkstra_pq();
+void test_graph_csr();
+void test_graph_path();
 void test_string();
 void test_sort();
 void test_sort_time();
 void test_share();
+void test_node_pool();
+void test_slim_node();
 void test_kdtree();
 void test_trie();
 
@@ -45,19 +72,41 @@ int main()
     //test_kdtree();
     //test_varray();
     //test_share();
+    //test_node_pool();
+    //test_slim_node();
     //test_sort_time();
     //test_sort();
     test_string();
     //test_leftpq();
+    //test_pq_index();
+    //test_pq_dary();
+    //test_pq_meld();
+    //test_pq_multiqueue();
+    //test_dijkstra_pq();
+    //test_graph_csr();
+    //test_graph_path();
     //test_pq();
     //test_hash();
+    //test_hash_concurrent();
+    //test_hash_func();
+    //test_hash_bucket();
+    //test_hash_frozen();
+    //test_filter();
     //test_bitmap();
     //test_redblack();
     //test_maprbt();
+    //test_map_skiplist();
     //test_btree();
+    //test_bplus_tree();
+    //test_btree_disk();
+    //test_btree_durable();
     //test_splay();
     //test_avl();
     //test_bst();
+    //test_bst_range();
+    //test_order_stat();
+    //test_tree_bulk();
+    //test_persistent();
     //test_graph();
     //test_bt();
     //test_queue();
@@ -68,6 +117,99 @@ int main()
 
     return 0;
 }
+/** 检查红黑树的颜色、黑高度与父节点链接，返回黑高度，不满足时返回-1 */
+template <typename N>
+int check_rb_node(N* x)
+{
+    if (!x) return 0;
+    if ((x->left && x->left->parent != x) || (x->right && x->right->parent != x)) return -1;
+    if (BN_IsRed(x) && (BN_IsRed(x->left) || BN_IsRed(x->right))) return -1;
+    int l = check_rb_node<N>(x->left);
+    int r = check_rb_node<N>(x->right);
+    if (l < 0 || l != r) return -1;
+    return l + (BN_IsBlack(x) ? 1 : 0);
+}
+/** 检查AVL树的高度与平衡，返回高度，不满足时返回-2 */
+template <typename N>
+int check_avl_node(N* x)
+{
+    if (!x) return -1;
+    int l = check_avl_node<N>(x->left);
+    int r = check_avl_node<N>(x->right);
+    if (l < -1 || r < -1 || l - r > 1 || r - l > 1 || x->height != 1 + std::max(l, r)) return -2;
+    return x->height;
+}
+template <typename Tree>
+std::vector<int> tree_keys(Tree& t)
+{
+    std::vector<int> v;
+    for (int& e : t.scan())
+        v.push_back(e);
+    return v;
+}
+void test_slim_node()
+{
+    // 各树通过模板参数N选择节点类型，默认为BinNode<T>
+    cout << "sizeof int   : BinNode " << sizeof(dsa::BinNode<int>) << "  BinNodeAvl " << sizeof(dsa::BinNodeAvl<int>)
+         << "  BinNodeRb " << sizeof(dsa::BinNodeRb<int>) << "  BinNodeIdx " << sizeof(dsa::BinNodeIdx<int>) << endl;
+    cout << "sizeof double: BinNode " << sizeof(dsa::BinNode<double>) << "  BinNodeAvl " << sizeof(dsa::BinNodeAvl<double>)
+         << "  BinNodeRb " << sizeof(dsa::BinNodeRb<double>) << "  BinNodeIdx " << sizeof(dsa::BinNodeIdx<double>) << endl;
+
+    const int N = 100000;
+    dsa::RedBlackTree<int> ref;
+    dsa::AvlTree<int, dsa::BinNodeAvl<int> > avl;
+    dsa::RedBlackTree<int, dsa::BinNodeRb<int> > rb;
+    dsa::RedBlackTree<int, dsa::BinNodeIdx<int> > rbi;
+    dsa::AvlTree<int, dsa::BinNodeIdx<int> > avli;
+    dsa::SplayTree<int, dsa::BinNodeIdx<int> > spi(dsa::SplayMode::SplayTopDown);
+    for (int k = 0; k < N; k ++)
+    {
+        int e = (k * 7919) % N;
+        ref.insert(e); avl.insert(e); rb.insert(e); rbi.insert(e); avli.insert(e); spi.insert(e);
+    }
+    for (int k = 0; k < N; k += 3)
+    {
+        int e = (k * 7919) % N;     // 乱序删除（顺序删除会使伸展树退化为链，析构时递归过深）
+        ref.remove(e); avl.remove(e); rb.remove(e); rbi.remove(e); avli.remove(e); spi.remove(e);
+    }
+    std::vector<int> keys = tree_keys(ref);
+    cout << "size: " << ref.size() << "  same keys: "
+         << (tree_keys(avl) == keys) << (tree_keys(rb) == keys) << (tree_keys(rbi) == keys)
+         << (tree_keys(avli) == keys) << (tree_keys(spi) == keys) << endl;
+    cout << "rb black height: " << check_rb_node(rb.root()) << "  " << check_rb_node(rbi.root())
+         << "  avl height: " << check_avl_node(avl.root()) << "  " << check_avl_node(avli.root()) << endl;
+
+    // 分裂与连接
+    dsa::RedBlackTree<int, dsa::BinNodeRb<int> > rb2;
+    dsa::AvlTree<int, dsa::BinNodeIdx<int> > avli2;
+    rb.split(N / 2, rb2);
+    avli.split(N / 2, avli2);
+    cout << "split: " << rb.size() << " + " << rb2.size() << "  " << check_rb_node(rb.root()) << " "
+         << check_rb_node(rb2.root()) << "  " << check_avl_node(avli.root()) << " " << check_avl_node(avli2.root()) << endl;
+    rb.join(rb2);
+    avli.join(avli2);
+    cout << "join: " << (tree_keys(rb) == keys) << (tree_keys(avli) == keys) << "  "
+         << check_rb_node(rb.root()) << "  " << check_avl_node(avli.root()) << endl;
+#if BN_ORDER_STAT
+    int n = ref.size();
+    cout << "select(n/2): " << ref.select(n / 2)->data << " " << rb.select(n / 2)->data << " " << rbi.select(n / 2)->data
+         << "  rank(777): " << ref.rank(777) << " " << avl.rank(777) << " " << avli.rank(777) << endl;
+#endif
+
+    // 由有序序列构建（颜色由build_at设置）
+    dsa::Vector<int> v;
+    for (int k = 0; k < 1000; k ++)
+        v.push_back(k * 2);
+    dsa::RedBlackTree<int, dsa::BinNodeRb<int> > rbb;
+    dsa::RedBlackTree<int, dsa::BinNodeIdx<int> > rbbi;
+    rbb.build_from_sorted(v);
+    rbbi.build_from_sorted(v);
+    rbb.insert(7); rbbi.insert(7);
+    cout << "build: " << check_rb_node(rbb.root()) << "  " << check_rb_node(rbbi.root()) << endl;
+
+    dsa::IndexPool& pool = dsa::BinNodeIdx<int>::pool();
+    cout << "index pool used: " << pool.used() << "  reserved: " << pool.reserved() / 1024 << "KB" << endl;
+}
 
 void test_varray()
 {
@@ -372,6 +514,131 @@ void test_bst()
     bst.root()->traverse_LDR(print_node<int>);
 }
 
+void test_bst_range()
+{
+    dsa::RedBlackTree<int> rb;
+    for (int k = 0; k < 100; k ++)
+        rb.insert((k * 37) % 100 * 2);      // 0, 2, 4, ..., 198
+    cout << "lower_bound(31): " << *rb.lower_bound(31) << "  upper_bound(32): " << *rb.upper_bound(32) << endl;
+    for (int& e : rb.range(31, 41))
+        cout << e << " ";
+    cout << endl;
+    for (int& e : rb.range(31, 41, true))
+        cout << e << " ";
+    cout << endl;
+
+    // 退化为单链的BST，树高超过BST_SCAN_STACK，迭代器改为沿parent指针回溯
+    dsa::BinSearchTree<int> bst;
+    for (int k = 0; k < 200; k ++)
+        bst.insert(k);
+    int cnt = 0, sum = 0;
+    for (int& e : bst.range(50, 150))
+        cnt ++, sum += e;
+    cout << "chain range [50,150): " << cnt << " " << sum << endl;
+    cnt = 0, sum = 0;
+    for (int& e : bst.scan(true))
+        cnt ++, sum += e;
+    cout << "chain reverse scan: " << cnt << " " << sum << endl;
+}
+
+void test_order_stat()
+{
+#if BN_ORDER_STAT
+    dsa::AvlTree<int> avl;
+    dsa::MapRBT<int, int> mr;
+    for (int k = 0; k < 1000; k ++)
+    {
+        avl.insert((k * 7) % 1000);
+        mr.put((k * 7) % 1000, k);
+    }
+    for (int k = 0; k < 1000; k += 3)
+    {
+        avl.remove(k);
+        mr.remove(k);
+    }
+    // 百分位数
+    cout << "avl size: " << avl.size() << "  p50: " << avl.select(avl.size() / 2)->data
+         << "  p99: " << avl.select(avl.size() * 99 / 100)->data << endl;
+    cout << "avl rank(500): " << avl.rank(500) << "  count_range[100,200): " << avl.count_range(100, 200) << endl;
+    cout << "map p90 key: " << mr.select(mr.size() * 9 / 10)->key << "  rank(900): " << mr.rank(900)
+         << "  count_range[0,10): " << mr.count_range(0, 10) << endl;
+#else
+    cout << "BN_ORDER_STAT is 0: select/rank/count_range are not available" << endl;
+#endif
+}
+
+void test_tree_bulk()
+{
+    const int N = 1000000;
+    dsa::Vector<int> v(N);
+    for (int k = 0; k < N; k ++)
+        v.push_back(k * 2);
+
+    dsa::ClockTime s = dsa::get_clock();
+    dsa::RedBlackTree<int> rb1;
+    for (int k = 0; k < N; k ++)
+        rb1.insert(v[k]);
+    cout << "rb insert x " << N << ": " << dsa::get_time_ms(s, dsa::get_clock()) << "ms" << endl;
+
+    s = dsa::get_clock();
+    dsa::RedBlackTree<int> rb2;
+    rb2.build_from_sorted(v);
+    cout << "rb build_from_sorted: " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  size: " << rb2.size()
+         << "  black height: " << rb2.root()->height << endl;
+
+    // 奇数批量插入，归并重建
+    dsa::Vector<int> odd(N / 2);
+    for (int k = 0; k < N / 2; k ++)
+        odd.push_back(k * 2 + 1);
+    s = dsa::get_clock();
+    cout << "rb insert_many: " << rb2.insert_many(odd);
+    cout << "  " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  size: " << rb2.size() << endl;
+
+    dsa::AvlTree<int> avl, right;
+    avl.build_from_sorted(v);
+    s = dsa::get_clock();
+    avl.split(N, right);
+    cout << "avl split: " << avl.size() << " + " << right.size();
+    avl.join(right);
+    cout << "  join: " << avl.size() << "  height: " << avl.root()->height
+         << "  " << dsa::get_time_ms(s, dsa::get_clock()) << "ms" << endl;
+}
+
+void test_persistent()
+{
+    const int N = 100000;
+    dsa::PersistentRBTree<int> rb;
+    dsa::PersistentAvl<int> avl;
+    for (int k = 0; k < N; k ++)
+    {
+        rb.insert(k);
+        avl.insert(k);
+    }
+
+    // 快照O(1)，之后的修改只复制路径上的节点
+    dsa::ClockTime s = dsa::get_clock();
+    dsa::PersistentRBTree<int> rb_snap = rb;
+    dsa::PersistentAvl<int> avl_snap = avl;
+    cout << "snapshot: " << dsa::get_time_ms(s, dsa::get_clock()) << "ms" << endl;
+
+    s = dsa::get_clock();
+    for (int k = 0; k < N; k += 2)
+    {
+        rb.remove(k);
+        avl.remove(k);
+    }
+    cout << "remove x " << N / 2 << ": " << dsa::get_time_ms(s, dsa::get_clock()) << "ms" << endl;
+    cout << "rb: " << rb.size() << "  snapshot: " << rb_snap.size() << "  " << (rb_snap.search(0) ? "found 0" : "lost 0") << endl;
+    cout << "avl: " << avl.size() << "  snapshot: " << avl_snap.size() << "  height: " << avl.root()->height << endl;
+
+    dsa::PersistentAvl<int> t;
+    t.insert(5); t.insert(1); t.insert(9);
+    dsa::PersistentAvl<int> t0 = t;
+    t.insert(3); t.remove(9);
+    t.traverse(print_node<int>); cout << endl;
+    t0.traverse(print_node<int>); cout << endl;
+}
+
 void test_avl()
 {
     dsa::AvlTree<int> at;
@@ -419,6 +686,234 @@ void test_splay()
     st.root()->traverse_LDR(print_node<int>);
     cout << endl;
     cout << st.root()->data << endl;
+
+    // 倾斜访问：90%的访问集中在1%的键上，比较各伸展方式的平均深度与旋转次数
+    const int N = 100000;
+    const char* names[] = {"bottom-up", "top-down", "semi", "random"};
+    for (int m = 0; m < 4; m ++)
+    {
+        dsa::SplayTree<int> sp((dsa::SplayMode)m);
+        for (int k = 0; k < N; k ++)
+            sp.insert((k * 7919) % N);
+        sp.reset_stat();
+        std::srand(1);
+        dsa::ClockTime s = dsa::get_clock();
+        for (int k = 0; k < N * 10; k ++)
+            sp.search((std::rand() % 10) ? std::rand() % (N / 100) : std::rand() % N);
+        const auto& stat = sp.stat();
+        cout << names[m] << ": " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  avg depth: "
+             << (double)stat.depth / stat.accesses << "  rotations: " << stat.rotations
+             << "  splays: " << stat.splays << endl;
+    }
+}
+
+void test_bplus_tree()
+{
+    const int N = 10000000;
+    const int Q = 1000000;
+    dsa::Vector<int> keys(N);
+    for (int k = 0; k < N; k ++)
+        keys.push_back((int)((long long)k * 7919 % N));     // 0~N-1的乱序排列
+
+    dsa::BPlusTree<int> bp;
+    dsa::RedBlackTree<int> rb;
+    dsa::BTree<unsigned int> bt(64);     // BTree<int>的BTNode(int)构造函数有歧义
+    cout << "b+ tree CAP: " << dsa::BPlusTree<int>::CAP << endl;
+
+    dsa::ClockTime s = dsa::get_clock();
+    for (int k = 0; k < N; k ++)
+        bp.insert(keys[k]);
+    cout << "b+ tree insert: " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  height: " << bp.height() << endl;
+    s = dsa::get_clock();
+    for (int k = 0; k < N; k ++)
+        rb.insert(keys[k]);
+    cout << "rb tree insert: " << dsa::get_time_ms(s, dsa::get_clock()) << "ms" << endl;
+    s = dsa::get_clock();
+    for (int k = 0; k < N; k ++)
+        bt.insert((unsigned int)keys[k]);
+    cout << "b-tree  insert: " << dsa::get_time_ms(s, dsa::get_clock()) << "ms" << endl;
+
+    long long hit = 0;
+    s = dsa::get_clock();
+    for (int k = 0; k < Q; k ++)
+        hit += (bp.search(keys[(k * 31) % N]) != nullptr);
+    cout << "b+ tree search x " << Q << ": " << dsa::get_time_ms(s, dsa::get_clock()) << "ms" << endl;
+    s = dsa::get_clock();
+    for (int k = 0; k < Q; k ++)
+        hit += (rb.search(keys[(k * 31) % N]) != nullptr);
+    cout << "rb tree search x " << Q << ": " << dsa::get_time_ms(s, dsa::get_clock()) << "ms" << endl;
+    s = dsa::get_clock();
+    for (int k = 0; k < Q; k ++)
+        hit += (bt.search((unsigned int)keys[(k * 31) % N]) != nullptr);
+    cout << "b-tree  search x " << Q << ": " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  hit: " << hit << endl;
+
+    // 区间扫描：b+树沿叶节点链表，红黑树沿中序后继
+    long long sum = 0;
+    auto add = [&sum](const int& e) {sum += e;};
+    s = dsa::get_clock();
+    int cnt = bp.range(N / 4, N / 4 * 3, add);
+    cout << "b+ tree range " << cnt << ": " << dsa::get_time_ms(s, dsa::get_clock()) << "ms" << endl;
+    s = dsa::get_clock();
+    cnt = 0;
+    for (int e : rb.range(N / 4, N / 4 * 3))
+    {
+        sum += e;
+        cnt ++;
+    }
+    cout << "rb tree range " << cnt << ": " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  sum: " << sum << endl;
+
+    dsa::Vector<int> sorted(N);
+    for (int k = 0; k < N; k ++)
+        sorted.push_back(k);
+    dsa::BPlusTree<int> bulk;
+    s = dsa::get_clock();
+    bulk.build_from_sorted(sorted);
+    cout << "b+ tree build_from_sorted: " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  height: " << bulk.height() << endl;
+
+    s = dsa::get_clock();
+    for (int k = 0; k < N; k += 2)
+        bp.remove(keys[k]);
+    cout << "b+ tree remove x " << N / 2 << ": " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  size: " << bp.size() << endl;
+}
+
+void test_btree_disk()
+{
+    const int N = 1000000;
+    const char* path = "btree_disk.db";
+    std::remove(path);
+
+    // 4KB页，缓冲池64页（256KB），远小于索引本身
+    dsa::DiskBTree<int> dt;
+    if (!dt.open(path, 4096, 64))
+    {
+        cout << "open failed" << endl;
+        return;
+    }
+    cout << "min degree: " << dt.min_degree() << endl;
+
+    dsa::ClockTime s = dsa::get_clock();
+    for (int k = 0; k < N; k ++)
+        dt.insert((int)((long long)k * 7919 % N));
+    dt.flush();
+    auto st = dt.stat();
+    cout << "insert x " << N << ": " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  height: " << dt.height()
+         << "  pages: " << dt.pages() << "  reads/op: " << (double)st.reads / N
+         << "  writes/op: " << (double)st.writes / N << endl;
+
+    dt.reset_stat();
+    int hit = 0;
+    s = dsa::get_clock();
+    for (int k = 0; k < N; k ++)
+        hit += dt.search((int)((long long)k * 104729 % N));
+    st = dt.stat();
+    cout << "search x " << N << ": " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  hit: " << hit
+         << "  reads/op: " << (double)st.reads / N << "  hit ratio: " << (double)st.hits / (st.hits + st.misses) << endl;
+
+    // 重新打开：树根以下的页都需要从文件读取
+    dt.close();
+    dt.open(path, 4096, 64);
+    dt.reset_stat();
+    s = dsa::get_clock();
+    for (int k = 0; k < N; k += 2)
+        dt.remove((int)((long long)k * 7919 % N));
+    dt.flush();
+    st = dt.stat();
+    cout << "remove x " << N / 2 << ": " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  size: " << dt.size()
+         << "  reads/op: " << (double)st.reads / (N / 2) << "  writes/op: " << (double)st.writes / (N / 2) << endl;
+
+    dt.close();
+    std::remove(path);
+}
+
+void test_btree_durable()
+{
+    const int N = 1000000;
+    const int B = 10000;
+    const char* path = "btree_durable.db";
+    const char* log_path = "btree_durable.wal";
+    std::remove(path);
+    std::remove(log_path);
+
+    dsa::Vector<int> keys(N);
+    for (int k = 0; k < N; k ++)
+        keys.push_back((int)((long long)k * 7919 % N));
+
+    // 批量插入：每批一次组提交（一次fsync），日志超过WAL_CHECKPOINT_SIZE时自动做检查点
+    dsa::DurableBTree<int> dt;
+    if (!dt.open(path, log_path, 4096, 256))
+    {
+        cout << "open failed" << endl;
+        return;
+    }
+    dsa::ClockTime s = dsa::get_clock();
+    for (int k = 0; k < N; k += B)
+        dt.insert(&keys[k], B);
+    dt.checkpoint();
+    cout << "batch insert x " << N << ": " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  height: " << dt.height()
+         << "  pages: " << dt.pages() << "  checkpoint: " << dt.last_checkpoint() << endl;
+
+    dt.close();
+
+#if defined DSAS_LINUX
+    // 模拟崩溃：子进程打开文件，提交一批删除后直接退出（不做检查点），父进程重新打开时重放日志
+    if (fork() == 0)
+    {
+        dsa::DurableBTree<int> ct;
+        if (ct.open(path, log_path, 4096, 256))
+        {
+            for (int k = 0; k < B; k ++)
+                ct.remove(keys[k]);
+            ct.commit();
+        }
+        _exit(0);
+    }
+    wait(nullptr);
+#endif
+    s = dsa::get_clock();
+    dt.open(path, log_path, 4096, 256);
+    cout << "recover: " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  size: " << dt.size()
+         << "  found: " << dt.search(keys[0]) << "  " << dt.search(keys[B]) << endl;
+    dt.close();
+
+    // 对比：没有持久化时，重启需要逐个插入重建索引
+    s = dsa::get_clock();
+    dsa::BTree<unsigned int> bt(256);
+    for (int k = 0; k < N; k ++)
+        bt.insert((unsigned int)keys[k]);
+    cout << "rebuild BTree: " << dsa::get_time_ms(s, dsa::get_clock()) << "ms" << endl;
+
+    // 只读快速启动：映射最后一个检查点
+    s = dsa::get_clock();
+    dsa::DurableBTree<int>::Mapped mp;
+    mp.open(path);
+    cout << "mmap open: " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  size: " << mp.size() << endl;
+    int hit = 0;
+    s = dsa::get_clock();
+    for (int k = 0; k < N; k ++)
+        hit += mp.search(keys[k]);
+    cout << "mmap search x " << N << ": " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  hit: " << hit << endl;
+    mp.close();
+
+    // 反复做小检查点：空闲页表复用空闲页，页文件不应增长
+    std::remove(path);
+    std::remove(log_path);
+    dt.open(path, log_path, 4096, 16);
+    for (int k = 0; k < 1000; k ++)
+        dt.insert(k);
+    dt.checkpoint();
+    int p0 = dt.pages();
+    for (int k = 0; k < 5000; k ++)
+    {
+        dt.remove(k % 1000);
+        dt.insert(k % 1000);
+        dt.checkpoint();
+    }
+    cout << "checkpoint x 5000: pages " << p0 << " -> " << dt.pages()
+         << "  bounded: " << (dt.pages() <= 2 * p0) << endl;
+    dt.close();
+
+    std::remove(path);
+    std::remove(log_path);
 }
 
 void test_btree()
@@ -478,6 +973,29 @@ void test_btree()
             cnt = 0;
         }
     }
+
+    // 阶次扫描：分裂与合并整段转移，高阶次下插入删除的耗时不应随阶次平方增长
+    const int N = 1000000;
+    const int orders[] = {3, 4, 8, 16, 32, 64, 128, 256, 512};
+    for (int order : orders)
+    {
+        dsa::BTree<unsigned int> bo(order);
+        dsa::ClockTime s = dsa::get_clock();
+        for (int k = 0; k < N; k ++)
+            bo.insert((unsigned int)((long long)k * 7919 % N));
+        double t_ins = dsa::get_time_ms(s, dsa::get_clock());
+        s = dsa::get_clock();
+        int hit = 0;
+        for (int k = 0; k < N; k ++)
+            hit += (bo.search((unsigned int)k) != nullptr);
+        double t_sch = dsa::get_time_ms(s, dsa::get_clock());
+        s = dsa::get_clock();
+        for (int k = 0; k < N; k ++)
+            bo.remove((unsigned int)((long long)k * 7919 % N));
+        double t_rmv = dsa::get_time_ms(s, dsa::get_clock());
+        cout << "order " << order << ": insert " << t_ins << "ms  search " << t_sch << "ms  remove "
+             << t_rmv << "ms  hit: " << hit << "  size: " << bo.size() << endl;
+    }
 }
 
 void test_bitmap()
@@ -573,6 +1091,420 @@ void test_hash()
     hl.remove("hash");
     if (hl.get("hash"))
         cout << *hl.get("hash") << endl;
+
+    // 渐进式重散列：容量随装填因子扩容与收缩
+    dsa::HashTable<int, int> hr;
+    for (int k = 0; k < 100000; k ++)
+        hr.put(k, k);
+    cout << "size: " << hr.size() << "  cap: " << hr.capacity() << endl;
+    for (int k = 0; k < 99000; k ++)
+        hr.remove(k);
+    cout << "size: " << hr.size() << "  cap: " << hr.capacity() << endl;
+
+    // 懒惰删除：反复插入删除，墓碑数量受控，查找链长度可观察
+    hr.reset_stat();
+    for (int k = 0; k < 1000000; k ++)
+    {
+        hr.put(100000 + k, k);
+        hr.remove(100000 + k - 500);
+    }
+    cout << "size: " << hr.size() << "  cap: " << hr.capacity() << "  tombstones: " << hr.tombstones() << endl;
+    cout << "lookups: " << hr.stat().lookups
+         << "  avg probe: " << (double)hr.stat().probes / hr.stat().lookups
+         << "  max probe: " << hr.stat().max_probe << endl;
+}
+
+void test_hash_concurrent()
+{
+    const int T = 8;
+    const int N = 200000;
+    dsa::HashTableConcurrent<int, int> hc(64);
+
+    // 多线程插入互不相交的键
+    dsa::ClockTime s = dsa::get_clock();
+    std::vector<std::thread> th;
+    for (int t = 0; t < T; t ++)
+        th.push_back(std::thread([&hc, t]() {
+            for (int k = t; k < N; k += T)
+                hc.put(k, k * 2);
+        }));
+    for (auto& x : th) x.join();
+    th.clear();
+    cout << "shards: " << hc.shards() << "  size: " << hc.size()
+         << "  put: " << dsa::get_time_ms(s, dsa::get_clock()) << "ms" << endl;
+
+    // 多线程读：分片无锁读 vs 全局互斥锁
+    std::atomic<int> miss(0);
+    s = dsa::get_clock();
+    for (int t = 0; t < T; t ++)
+        th.push_back(std::thread([&hc, &miss, t]() {
+            int v;
+            for (int k = 0; k < N; k ++)
+                if (!hc.get((k + t * 997) % N, v) || v != (k + t * 997) % N * 2)
+                    miss ++;
+        }));
+    for (auto& x : th) x.join();
+    th.clear();
+    cout << "sharded get: " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  miss: " << miss << endl;
+
+    dsa::HashTable<int, int> ht;
+    std::mutex mtx;
+    for (int k = 0; k < N; k ++)
+        ht.put(k, k * 2);
+    s = dsa::get_clock();
+    for (int t = 0; t < T; t ++)
+        th.push_back(std::thread([&ht, &mtx, t]() {
+            for (int k = 0; k < N; k ++)
+            {
+                std::lock_guard<std::mutex> g(mtx);
+                ht.get((k + t * 997) % N);
+            }
+        }));
+    for (auto& x : th) x.join();
+    th.clear();
+    cout << "global mutex get: " << dsa::get_time_ms(s, dsa::get_clock()) << "ms" << endl;
+
+    // 批量操作
+    const int B = 1000;
+    int keys[B], vals[B];
+    bool found[B];
+    for (int k = 0; k < B; k ++)
+        keys[k] = N - B / 2 + k;
+    for (int k = 0; k < B; k ++)
+        vals[k] = -k;
+    cout << "put_batch: " << hc.put_batch(keys, vals, B) << endl;
+    cout << "get_batch: " << hc.get_batch(keys, B, vals, found) << endl;
+    cout << keys[0] << ": " << vals[0] << "  " << keys[B-1] << ": " << vals[B-1] << endl;
+
+    // 读写并发：写者反复插入、删除[N, 2N)（触发扩容、收缩与重散列），读者查找[0, N)，不应丢失
+    std::atomic<bool> stop(false);
+    std::atomic<long long> reads(0);
+    miss = 0;
+    s = dsa::get_clock();
+    std::thread w([&hc, &stop]() {
+        for (int r = 0; r < 3; r ++)
+        {
+            for (int k = N; k < 2 * N; k ++)
+                hc.put(k, k);
+            for (int k = N; k < 2 * N; k ++)
+                hc.remove(k);
+        }
+        stop = true;
+    });
+    for (int t = 0; t < T - 1; t ++)
+        th.push_back(std::thread([&hc, &miss, &stop, &reads, t]() {
+            int v;
+            long long n = 0;
+            for (int k = t; !stop; k = (k + 7919) % N, n ++)
+                if (!hc.get(k, v) || v != k * 2)
+                    miss ++;
+            reads += n;
+        }));
+    w.join();
+    for (auto& x : th) x.join();
+    th.clear();
+    cout << "mixed: " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  reads: " << reads
+         << "  miss: " << miss << "  size: " << hc.size() << endl;
+}
+
+void test_hash_bucket()
+{
+    dsa::HashTableBucket<dsa::String, int> hb;
+    hb.put("bucket", 100);
+    hb.put("hash", 55);
+    hb["bucket"] = 88;
+    cout << *hb.get("bucket") << "  " << hb["hash"] << endl;
+    hb.remove("hash");
+    cout << (hb.get("hash") ? "hash" : "No hash") << endl;
+
+    // 与HashTableList比较内存：1M个键值对
+    const int N = 1 << 20;
+    dsa::HashTableBucket<int, int> hi;
+    for (int k = 0; k < N; k ++)
+        hi.put(k * 7, k);
+    int err = 0;
+    for (int k = 0; k < N; k += 2)
+        hi.remove(k * 7);
+    for (int k = 0; k < N; k ++)
+    {
+        int* p = hi.get(k * 7);
+        if ((k & 1) != (p != nullptr) || (p && *p != k))
+            err ++;
+    }
+    cout << "size: " << hi.size() << "  buckets: " << hi.buckets()
+         << "  overflow: " << hi.overflow() << "  err: " << err << endl;
+    long list_mem = (long)N * (sizeof(dsa::List<dsa::Entry<int,int>>) + 2 * sizeof(dsa::ListNode<dsa::Entry<int,int>>))
+                  + (long)hi.size() * sizeof(dsa::ListNode<dsa::Entry<int,int>>);
+    cout << "payload: " << (long)hi.size() * 8 / 1024 << "KB"
+         << "  bucket: " << hi.memory() / 1024 << "KB"
+         << "  list(" << N << " buckets): " << list_mem / 1024 << "KB" << endl;
+}
+
+void test_hash_frozen()
+{
+    const int N = 1 << 20;
+    dsa::HashTable<int, int> ht;
+    for (int k = 0; k < N; k ++)
+        ht.put(k * 3, k);
+
+    dsa::ClockTime s = dsa::get_clock();
+    dsa::HashFrozen<int, int> fz;
+    bool ok = dsa::freeze(ht, fz);
+    cout << "freeze: " << ok << "  " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  size: " << fz.size()
+         << "  cap: " << fz.capacity() << "  memory: " << fz.memory() / 1024 << "KB" << endl;
+
+    // 查找：命中与未命中各半
+    long long acc = 0;
+    int err = 0;
+    s = dsa::get_clock();
+    for (int k = 0; k < 2 * N; k ++)
+    {
+        int* p = ht.get(k * 3 / 2);
+        acc += p ? *p : 0;
+    }
+    dsa::ClockTime e = dsa::get_clock();
+    for (int k = 0; k < 2 * N; k ++)
+    {
+        const int* p = fz.get(k * 3 / 2);
+        acc -= p ? *p : 0;
+        if ((p != nullptr) != ((k * 3 / 2) % 3 == 0))
+            err ++;
+    }
+    cout << "HashTable get: " << dsa::get_time_ms(s, e) << "ms  HashFrozen get: "
+         << dsa::get_time_ms(e, dsa::get_clock()) << "ms  diff: " << acc << "  err: " << err << endl;
+
+    // 保存并通过mmap加载
+    const char* file = "hash_frozen.bin";
+    dsa::HashFrozen<int, int> fl;
+    if (fz.save(file) && fl.load(file))
+    {
+        err = 0;
+        for (int k = 0; k < N; k ++)
+            if (!fl.get(k * 3) || *fl.get(k * 3) != k || fl.get(k * 3 + 1))
+                err ++;
+        cout << "load: mapped " << fl.is_mapped() << "  size: " << fl.size() << "  err: " << err << endl;
+    }
+    std::remove(file);
+
+    dsa::HashTableList<dsa::String, int> hl;
+    hl.put("frozen", 1);
+    hl.put("hash", 2);
+    dsa::HashFrozen<dsa::String, int> fs;
+    if (dsa::freeze(hl, fs))
+        cout << *fs.get("frozen") << "  " << *fs.get("hash") << "  " << (fs.get("list") ? "list" : "No list") << endl;
+
+    // 自定义HF：冻结后沿用同一个HF（经HashMix64扩展为64位）
+    struct ModHash {uint operator() (int k) const {return static_cast<uint>(k) % 1000003u;}};
+    dsa::HashTable<int, int, ModHash> hm;
+    for (int k = 0; k < 1000; k ++)
+        hm.put(k * 7, k);
+    dsa::HashFrozen<int, int, dsa::HashMix64<ModHash> > fm;
+    ok = dsa::freeze(hm, fm);
+    cout << "custom HF freeze: " << ok << "  size: " << fm.size() << "  get(700): " << *fm.get(700) << endl;
+    // Hash值相同的键无法构建完美散列，返回false
+    for (int k = 0; k < 3; k ++)
+        hm.put(1000003 * (k + 1), k);
+    ok = dsa::freeze(hm, fm);
+    cout << "colliding HF freeze: " << ok << "  size: " << fm.size() << endl;
+}
+
+void test_filter()
+{
+    // 误判率：Bloom过滤器每个键10位，插入N个键，查询N个不存在的键
+    const int N = 1 << 20;
+    dsa::BloomFilter<int> bf(N, 10);
+    dsa::BloomBlocked<int> bb(N, 10);
+    for (int k = 0; k < N; k ++)
+    {
+        bf.insert(k);
+        bb.insert(k);
+    }
+    int fp_bf = 0, fp_bb = 0, fp_cf = 0, fn = 0;
+    dsa::ClockTime t0 = dsa::get_clock();
+    for (int k = N; k < 2 * N; k ++)
+        fp_bf += bf.contains(k);
+    dsa::ClockTime t1 = dsa::get_clock();
+    for (int k = N; k < 2 * N; k ++)
+        fp_bb += bb.contains(k);
+    dsa::ClockTime t2 = dsa::get_clock();
+    for (int k = 0; k < N; k ++)
+        fn += !bf.contains(k) + !bb.contains(k);
+    cout << std::setprecision(4);
+    cout << "bloom:   fpr " << 100.0 * fp_bf / N << "%  (expected " << 100.0 * bf.expected_fpr() << "%)  "
+         << dsa::get_time_ms(t0, t1) << "ms  bits/key " << (double)bf.bits() / N << endl;
+    cout << "blocked: fpr " << 100.0 * fp_bb / N << "%  " << dsa::get_time_ms(t1, t2) << "ms  bits/key " << (double)bb.bits() / N << endl;
+
+    // 相同空间下比较：Cuckoo过滤器装到90%，两种Bloom过滤器使用相同的位数
+    dsa::CuckooFilter<int> cf(N);
+    const int M = cf.capacity() / 10 * 9;
+    int cf_fail = 0;
+    for (int k = 0; k < M; k ++)
+        if (!cf.insert(k))
+            cf_fail ++;
+    int bpk = static_cast<int>((double)cf.bits() / M + 0.5);
+    dsa::BloomFilter<int> bf2(M, bpk);
+    dsa::BloomBlocked<int> bb2(M, bpk);
+    for (int k = 0; k < M; k ++)
+    {
+        bf2.insert(k);
+        bb2.insert(k);
+    }
+    fp_bf = fp_bb = 0;
+    t0 = dsa::get_clock();
+    for (int k = M; k < 2 * M; k ++)
+        fp_cf += cf.contains(k);
+    t1 = dsa::get_clock();
+    for (int k = M; k < 2 * M; k ++)
+    {
+        fp_bf += bf2.contains(k);
+        fp_bb += bb2.contains(k);
+    }
+    for (int k = 0; k < M; k ++)
+        fn += !cf.contains(k) + !bf2.contains(k) + !bb2.contains(k);
+    cout << "at " << (double)cf.bits() / M << " bits/key:" << endl;
+    cout << "cuckoo:  fpr " << 100.0 * fp_cf / M << "%  " << dsa::get_time_ms(t0, t1) << "ms  load "
+         << (double)cf.count() / cf.capacity() << "  fail " << cf_fail << endl;
+    cout << "bloom:   fpr " << 100.0 * fp_bf / M << "%  bits/key " << (double)bf2.bits() / M << endl;
+    cout << "blocked: fpr " << 100.0 * fp_bb / M << "%  bits/key " << (double)bb2.bits() / M << endl;
+    cout << "false negatives: " << fn << endl;
+
+    // Cuckoo过滤器删除
+    for (int k = 0; k < N; k += 2)
+        cf.remove(k);
+    fn = 0;
+    int fp = 0;
+    for (int k = 0; k < N; k ++)
+    {
+        if (k & 1) fn += !cf.contains(k);
+        else       fp += cf.contains(k);
+    }
+    cout << "cuckoo after remove: count " << cf.count() << "  removed still found " << fp << "  false negatives " << fn << endl;
+
+    // HashTable前置过滤器：70%查询未命中
+    dsa::HashTable<int, int> ht, hf;
+    hf.enable_filter(10);
+    for (int k = 0; k < N; k ++)
+    {
+        ht.put(k * 10, k);
+        hf.put(k * 10, k);
+    }
+    long long acc = 0;
+    t0 = dsa::get_clock();
+    for (int k = 0; k < 10 * N; k += 3)
+    {
+        int* p = ht.get(k);
+        acc += p ? *p : 0;
+    }
+    t1 = dsa::get_clock();
+    for (int k = 0; k < 10 * N; k += 3)
+    {
+        int* p = hf.get(k);
+        acc -= p ? *p : 0;
+    }
+    t2 = dsa::get_clock();
+    cout << "HashTable get: " << dsa::get_time_ms(t0, t1) << "ms  with filter: " << dsa::get_time_ms(t1, t2)
+         << "ms  diff: " << acc << endl;
+}
+
+/** 旧的Hash<int>：直接转换 */
+struct HashIntOld { dsa::uint operator() (int h) const {return static_cast<dsa::uint>(h);} };
+/** 旧的Hash<String>：5位循环移位累加 */
+struct HashStrOld
+{
+    dsa::uint operator() (const dsa::String& h) const
+    {
+        dsa::uint hc = 0;
+        for (int k = 0; k < h.size(); k ++)
+        {
+            hc = (hc << 5) | (hc >> 27);
+            hc += static_cast<dsa::uint>(h[k]);
+        }
+        return hc;
+    }
+};
+
+/** 统计keys在cap个桶中的分布：冲突数（keys - 非空桶数）与最大桶长 */
+template <typename T, typename HF>
+void hash_quality(const char* name, const std::vector<T>& keys, int cap, bool pow2)
+{
+    HF hf;
+    std::vector<int> bucket(cap, 0);
+    for (size_t k = 0; k < keys.size(); k ++)
+    {
+        dsa::uint h = hf(keys[k]);
+        bucket[pow2 ? (h & (cap - 1)) : (h % cap)] ++;
+    }
+    int used = 0, mx = 0;
+    for (int k = 0; k < cap; k ++)
+    {
+        if (bucket[k]) used ++;
+        if (bucket[k] > mx) mx = bucket[k];
+    }
+    cout << std::setw(24) << name << (pow2 ? "  2^k: " : "  prime: ")
+         << "collisions " << std::setw(6) << (int)keys.size() - used << "  max bucket " << mx << endl;
+}
+
+void test_hash_func()
+{
+    // 散列质量：装填因子0.5，理想的冲突数约为 0.21*keys
+    const int N = 1 << 15;
+    const int P = 65537;
+    std::vector<int> seq, stride;
+    std::vector<dsa::String> str;
+    char buf[32];
+    for (int k = 0; k < N; k ++)
+    {
+        seq.push_back(k);
+        stride.push_back(k * 1024);
+        sprintf(buf, "key_%d", k);
+        str.push_back(dsa::String(buf));
+    }
+    hash_quality<int, HashIntOld>("old int seq", seq, 2*N, true);
+    hash_quality<int, dsa::Hash<int>>("new int seq", seq, 2*N, true);
+    hash_quality<int, HashIntOld>("old int stride 1024", stride, 2*N, true);
+    hash_quality<int, dsa::Hash<int>>("new int stride 1024", stride, 2*N, true);
+    hash_quality<int, HashIntOld>("old int stride 1024", stride, P, false);
+    hash_quality<int, dsa::Hash<int>>("new int stride 1024", stride, P, false);
+    hash_quality<dsa::String, HashStrOld>("old string", str, 2*N, true);
+    hash_quality<dsa::String, dsa::Hash<dsa::String>>("new string", str, 2*N, true);
+    hash_quality<dsa::String, HashStrOld>("old string", str, P, false);
+    hash_quality<dsa::String, dsa::Hash<dsa::String>>("new string", str, P, false);
+
+    // 吞吐量
+    const int lens[] = {8, 32, 256, 4096};
+    for (int l = 0; l < 4; l ++)
+    {
+        dsa::String s;
+        for (int k = 0; k < lens[l]; k ++)
+            s.push(static_cast<char>('a' + k % 26));
+        const int R = 64 * 1024 * 1024 / lens[l];
+        dsa::uint acc = 0;
+        dsa::ClockTime t0 = dsa::get_clock();
+        for (int r = 0; r < R; r ++)
+        {
+            s[r % lens[l]] ^= 1;
+            acc += HashStrOld()(s);
+        }
+        dsa::ClockTime t1 = dsa::get_clock();
+        for (int r = 0; r < R; r ++)
+        {
+            s[r % lens[l]] ^= 1;
+            acc += dsa::Hash<dsa::String>()(s);
+        }
+        dsa::ClockTime t2 = dsa::get_clock();
+        cout << "len " << std::setw(4) << lens[l]
+             << "  old: " << std::setw(8) << 64.0 * 1000.0 / dsa::get_time_ms(t0, t1) << " MB/s"
+             << "  new: " << std::setw(8) << 64.0 * 1000.0 / dsa::get_time_ms(t1, t2) << " MB/s"
+             << "  (" << acc % 10 << ")" << endl;
+    }
+
+    dsa::Array<int, 4> ar;
+    ar.fill(7);
+    dsa::Entry<int, int> e(42, 0);
+    cout << "Array: " << dsa::Hash<dsa::Array<int, 4>>()(ar)
+         << "  Entry: " << dsa::Hash<dsa::Entry<int, int>>()(e)
+         << "  key: " << dsa::Hash<int>()(42)
+         << "  -0.0: " << dsa::Hash<double>()(-0.0) << endl;
 }
 
 void test_redblack()
@@ -663,6 +1595,60 @@ void test_maprbt()
         cout << (*iter).key << " & " << (*iter).value << endl;
 
     mr.traverse(print_entry<int, dsa::String>);
+
+    for (dsa::Entry<int, dsa::String>& e : mr.range(15, 40, true))
+        cout << e.key << " & " << e.value << endl;
+}
+
+void test_map_skiplist()
+{
+    const int T = 4;
+    const int N = 100000;
+    dsa::MapSkipList<int, int> ms;
+    for (int k = 0; k < N; k += 2)
+        ms.put(k, k * 2);
+
+    // 一个写者不断插入、覆盖、删除奇数键，多个读者并发查找与区间扫描
+    std::atomic<bool> stop(false);
+    std::atomic<long> bad(0), hits(0);
+    std::vector<std::thread> th;
+    for (int t = 0; t < T; t ++)
+        th.push_back(std::thread([&, t]() {
+            long h = 0;
+            int val;
+            auto check = [&](const int& k, const int& v) {if (v != k * 2) bad ++;};
+            for (int r = 0; !stop.load(std::memory_order_relaxed); r ++)
+            {
+                int k = (int)(((long)r * 7919 + t) % N);
+                if (ms.get(k, val))
+                {
+                    h ++;
+                    if (val != k * 2) bad ++;
+                }
+                if (r % 1000 == 0)
+                    ms.range(k, k + 100, check);
+            }
+            hits += h;
+        }));
+    dsa::ClockTime s = dsa::get_clock();
+    for (int r = 0; r < 5; r ++)
+    {
+        for (int k = 1; k < N; k += 2) ms.put(k, k * 2);
+        for (int k = 1; k < N; k += 2) ms.put(k, k * 2);     // 覆盖，旧值退休
+        for (int k = 1; k < N; k += 2) ms.remove(k);
+    }
+    stop = true;
+    for (auto& x : th) x.join();
+    cout << "writer: " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  size: " << ms.size()
+         << "  reader hits: " << hits << "  bad: " << bad << endl;
+    dsa::EpochDomain::instance().reclaim();
+    cout << "pending retired: " << dsa::EpochDomain::instance().pending() << endl;
+
+    int* pv = ms.get(10);
+    if (pv) cout << "get(10): " << *pv << endl;
+    auto print = [](const int& k, const int& v) {cout << k << ":" << v << " ";};
+    ms.range(0, 10, print);
+    cout << endl;
 }
 
 void test_pq()
@@ -747,6 +1733,494 @@ void test_leftpq()
     }
 }
 
+void test_pq_index()
+{
+    // 最小堆，以顶点编号为句柄：松弛时直接降低距离，不插入重复元素
+    dsa::PqIndexHeap<int, dsa::Greater<int>> ih;
+    ih.insert(0, 30);
+    ih.insert(1, 50);
+    ih.insert(2, 10);
+    ih.insert(3, 40);
+    ih.update(1, 5);
+    ih.remove(2);
+    cout << "top: " << ih.top() << " (" << ih.get_max() << ")" << endl;
+    while (!ih.is_empty())
+    {
+        int h = ih.pop();
+        cout << h << ":" << ih.key(h) << "  ";
+    }
+    cout << endl;
+
+    // 更新为主的负载（类似Dijkstra）：N个句柄，4N次随机更新，再逐个出堆
+    const int N = 1000000;
+    unsigned int seed = 2463534242u;
+    auto rnd = [&seed]() {seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5; return seed;};
+    dsa::PqIndexHeap<unsigned int, dsa::Greater<unsigned int>, 2> h2(N);
+    dsa::PqIndexHeap<unsigned int, dsa::Greater<unsigned int>, 4> h4(N);
+    dsa::ClockTime s = dsa::get_clock();
+    for (int k = 0; k < N; k ++)
+        h2.insert(k, rnd());
+    for (int k = 0; k < 4 * N; k ++)
+        h2.update(rnd() % N, rnd());
+    while (!h2.is_empty())
+        h2.pop();
+    cout << "index heap (2-ary): " << dsa::get_time_ms(s, dsa::get_clock()) << "ms" << endl;
+    seed = 2463534242u;
+    s = dsa::get_clock();
+    for (int k = 0; k < N; k ++)
+        h4.insert(k, rnd());
+    for (int k = 0; k < 4 * N; k ++)
+        h4.update(rnd() % N, rnd());
+    while (!h4.is_empty())
+        h4.pop();
+    cout << "index heap (4-ary): " << dsa::get_time_ms(s, dsa::get_clock()) << "ms" << endl;
+}
+
+template <typename H>
+void bench_pq(const char* name, H& h, const dsa::Vector<int>& keys)
+{
+    long long sum = 0;
+    dsa::ClockTime s = dsa::get_clock();
+    for (int k = 0; k < keys.size(); k ++)
+        h.insert(keys[k]);
+    double t_ins = dsa::get_time_ms(s, dsa::get_clock());
+    s = dsa::get_clock();
+    while (!h.is_empty())
+        sum += h.del_max();
+    cout << name << ": insert " << t_ins << "ms  del_max " << dsa::get_time_ms(s, dsa::get_clock())
+         << "ms  sum: " << sum << endl;
+}
+
+void test_pq_dary()
+{
+    const int N = 10000000;
+    dsa::Vector<int> keys(N);
+    unsigned int seed = 2463534242u;
+    for (int k = 0; k < N; k ++)
+    {
+        seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+        keys.push_back((int)(seed >> 1));
+    }
+
+    {
+        dsa::PqComplHeap<int> h;
+        bench_pq("binary (PqComplHeap)", h, keys);
+    }
+    {
+        dsa::PqDaryHeap<int, 4> h;
+        bench_pq("4-ary", h, keys);
+    }
+    {
+        dsa::PqDaryHeap<int, 8> h;
+        bench_pq("8-ary", h, keys);
+    }
+}
+
+template <typename H>
+void meld_pq(H& a, H& b) {a.merge(b);}
+template <typename T>
+void meld_pq(dsa::PqComplHeap<T>& a, dsa::PqComplHeap<T>& b) {while (!b.is_empty()) a.insert(b.del_max());}
+
+/** 事件调度：每个tick各线程的队列合并到主队列，再取出一半事件 */
+template <typename H>
+void bench_meld(const char* name)
+{
+    const int TICKS = 200, THREADS = 16, EVENTS = 1000;
+    unsigned int seed = 2463534242u;
+    long long sum = 0;
+    H main_q;
+    dsa::ClockTime s = dsa::get_clock();
+    for (int t = 0; t < TICKS; t ++)
+    {
+        for (int k = 0; k < THREADS; k ++)
+        {
+            H q;
+            for (int j = 0; j < EVENTS; j ++)
+            {
+                seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+                q.insert((int)(seed >> 1));
+            }
+            meld_pq(main_q, q);
+        }
+        for (int j = main_q.size() / 2; j > 0; j --)
+            sum += main_q.del_max();
+    }
+    cout << name << ": " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  sum: " << sum << endl;
+}
+
+void test_pq_meld()
+{
+    // 最小堆，按句柄降低关键码
+    dsa::PqPairingHeap<int, dsa::Greater<int>> ph;
+    dsa::PqFibHeap<int, dsa::Greater<int>> fh;
+    dsa::PairNodePtr<int> pn[8];
+    dsa::FibNodePtr<int> fn[8];
+    int keys[8] = {50, 20, 80, 10, 70, 30, 60, 40};
+    for (int k = 0; k < 8; k ++)
+    {
+        pn[k] = ph.push(keys[k]);
+        fn[k] = fh.push(keys[k]);
+    }
+    ph.del_max();
+    fh.del_max();
+    ph.increase_key(pn[2], 5);      // 80 -> 5
+    fh.increase_key(fn[2], 5);
+    ph.remove(pn[4]);               // 70
+    fh.remove(fn[4]);
+    cout << "pairing: ";
+    while (!ph.is_empty())
+        cout << ph.del_max() << " ";
+    cout << endl << "fib:     ";
+    while (!fh.is_empty())
+        cout << fh.del_max() << " ";
+    cout << endl;
+
+    // 有序插入使左式堆的左侧链长为n，合并与析构均不递归
+    dsa::PqLeftHeap<int> la, lb;
+    for (int k = 0; k < 1000000; k ++)
+        (k & 1 ? la : lb).insert(k);
+    la.merge(lb);
+    cout << "leftist: size " << la.size() << "  max " << la.get_max() << endl;
+
+    bench_meld<dsa::PqPairingHeap<int>>("pairing");
+    bench_meld<dsa::PqFibHeap<int>>("fib");
+    bench_meld<dsa::PqLeftHeap<int>>("leftist");
+    bench_meld<dsa::PqComplHeap<int>>("binary (reinsert)");
+}
+
+/** 全局互斥锁保护的单个堆，作为对照 */
+template <typename T>
+struct LockedHeap
+{
+    std::mutex mtx;
+    dsa::PqComplHeap<T> heap;
+    void insert(const T& e) {std::lock_guard<std::mutex> g(this->mtx); this->heap.insert(e);}
+    bool try_del_max(T& e)
+    {
+        std::lock_guard<std::mutex> g(this->mtx);
+        if (this->heap.is_empty())
+            return false;
+        e = this->heap.del_max();
+        return true;
+    }
+};
+
+/** 预填充后，T个线程各自交替insert/del_max，返回每秒的操作数（百万） */
+template <typename Q>
+double bench_concurrent_pq(Q& q, int T, int ops, long long& sum)
+{
+    std::atomic<long long> total(0);
+    std::vector<std::thread> th;
+    dsa::ClockTime s = dsa::get_clock();
+    for (int t = 0; t < T; t ++)
+        th.push_back(std::thread([&q, &total, t, T, ops]() {
+            unsigned int seed = 2463534242u + t;
+            long long local = 0;
+            int e;
+            for (int k = 0; k < ops / T; k ++)
+            {
+                seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+                if (k & 1)
+                    local += q.try_del_max(e) ? e : 0;
+                else
+                    q.insert((int)(seed >> 1));
+            }
+            total += local;
+        }));
+    for (auto& x : th) x.join();
+    sum = total;
+    return ops / dsa::get_time_ms(s, dsa::get_clock()) / 1000.0;
+}
+
+void test_pq_multiqueue()
+{
+    // 多线程插入0~N-1后全部删除，检查没有丢失或重复
+    const int N = 400000, T = 8;
+    dsa::PqMultiQueue<int> mq(T, 2);
+    std::vector<std::thread> th;
+    for (int t = 0; t < T; t ++)
+        th.push_back(std::thread([&mq, t]() {
+            for (int k = t; k < N; k += T)
+                mq.insert(k);
+        }));
+    for (auto& x : th) x.join();
+    th.clear();
+    std::atomic<long long> sum(0);
+    std::atomic<int> cnt(0);
+    for (int t = 0; t < T; t ++)
+        th.push_back(std::thread([&mq, &sum, &cnt]() {
+            int e;
+            while (mq.try_del_max(e))
+            {
+                sum += e;
+                cnt ++;
+            }
+        }));
+    for (auto& x : th) x.join();
+    th.clear();
+    cout << "queues: " << mq.queues() << "  popped: " << cnt << "  sum ok: "
+         << (sum == (long long)N * (N - 1) / 2 ? "yes" : "no") << endl;
+
+    // 单线程下删除序列的排名误差：与真实最大值相差的位置数
+    dsa::PqMultiQueue<int> rq(4, 2);
+    for (int k = 0; k < 100000; k ++)
+        rq.insert(k);
+    long long err = 0;
+    for (int k = 99999; k >= 0; k --)
+    {
+        int e = rq.del_max();
+        err += e > k ? e - k : k - e;
+    }
+    cout << "avg rank error (8 queues): " << (double)err / 100000 << endl;
+
+    // 吞吐量：MultiQueue vs 全局锁
+    const int OPS = 2000000;
+    for (int t = 1; t <= 64; t *= 2)
+    {
+        long long s1, s2;
+        dsa::PqMultiQueue<int> q(t, 2);
+        LockedHeap<int> lh;
+        for (int k = 0; k < 1000000; k ++)
+        {
+            q.insert(k * 7);
+            lh.insert(k * 7);
+        }
+        double m1 = bench_concurrent_pq(q, t, OPS, s1);
+        double m2 = bench_concurrent_pq(lh, t, OPS, s2);
+        cout << "threads " << std::setw(2) << t << ":  multiqueue " << m1 << " Mops/s   locked heap "
+             << m2 << " Mops/s" << endl;
+    }
+}
+
+void test_dijkstra_pq()
+{
+    // 单调整数优先级队列
+    dsa::PqRadixHeap<unsigned int, int> rh;
+    dsa::PqBucketQueue<int> bq(16);
+    int keys[8] = {7, 3, 9, 3, 120, 0, 15, 8};
+    for (int k = 0; k < 8; k ++)
+    {
+        rh.push(keys[k], k);
+        bq.push(keys[k], k);
+    }
+    cout << "radix:  ";
+    while (!rh.is_empty())
+        cout << rh.del_max().key << " ";
+    cout << endl << "bucket: ";
+    while (!bq.is_empty())
+        cout << bq.del_max().key << " ";
+    cout << endl;
+
+    // 随机稀疏图，边权1~100
+    const int N = 2000, DEG = 8;
+    dsa::GraphMatrix<int, int> g;
+    for (int k = 0; k < N; k ++)
+        g.insert_vertex(k);
+    unsigned int seed = 2463534242u;
+    auto rnd = [&seed]() {seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5; return seed;};
+    for (int k = 0; k < N * DEG; k ++)
+    {
+        int i = rnd() % N, j = rnd() % N;
+        if (i != j && !g.exist_edge(i, j))
+            g.insert_edge(0, 1 + rnd() % 100, i, j);
+    }
+
+    const char* names[3] = {"scan", "radix heap", "bucket queue"};
+    dsa::DijkstraQueue qs[3] = {dsa::ScanQueue, dsa::RadixQueue, dsa::BucketQueue};
+    dsa::Vector<int> dist[3];
+    for (int q = 0; q < 3; q ++)
+    {
+        dsa::ClockTime s = dsa::get_clock();
+        g.dijkstra(0, qs[q]);
+        double t = dsa::get_time_ms(s, dsa::get_clock());
+        long long sum = 0;
+        for (int k = 0; k < N; k ++)
+        {
+            dist[q].push_back(g.vertex_priority(k));
+            sum += g.vertex_priority(k) == INIT_PRIORITY ? 0 : g.vertex_priority(k);
+        }
+        cout << names[q] << ": " << t << "ms  sum of distances: " << sum << endl;
+    }
+    int diff = 0;
+    for (int k = 0; k < N; k ++)
+        diff += (dist[0][k] != dist[1][k]) + (dist[0][k] != dist[2][k]);
+    cout << "mismatch: " << diff << endl;
+}
+
+void test_graph_csr()
+{
+    // 与GraphMatrix在同一幅随机图上比较
+    const int N = 2000, DEG = 8;
+    unsigned int seed = 2463534242u;
+    auto rnd = [&seed]() {seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5; return seed;};
+    dsa::GraphMatrix<int, int> gm;
+    dsa::GraphCSR<int, int> gc;
+    for (int k = 0; k < N; k ++)
+    {
+        gm.insert_vertex(k);
+        gc.insert_vertex(k);
+    }
+    dsa::Vector<int> src, dst, wt;
+    for (int k = 0; k < N * DEG; k ++)
+    {
+        int i = rnd() % N, j = rnd() % N, w = 1 + rnd() % 100;
+        if (i != j && !gm.exist_edge(i, j))
+        {
+            gm.insert_edge(0, w, i, j);
+            src.push_back(i);
+            dst.push_back(j);
+            wt.push_back(w);
+        }
+    }
+    gc.build(N, &src[0], &dst[0], &wt[0], src.size());
+    gm.dijkstra(0, dsa::RadixQueue);
+    gc.dijkstra(0, dsa::RadixQueue);
+    int diff = 0;
+    for (int k = 0; k < N; k ++)
+        diff += gm.vertex_priority(k) != gc.vertex_priority(k);
+    gm.bfs(0);
+    gc.bfs(0);
+    for (int k = 0; k < N; k ++)
+        diff += gm.vertex_status(k) != gc.vertex_status(k);
+    cout << "edges: " << gc.edge_size() << "  mismatch with GraphMatrix: " << diff << endl;
+
+    // 动态修改
+    gc.remove_edge(src[0], dst[0]);
+    gc.insert_edge(0, 3, src[0], dst[0]);
+    gc.remove_vertex(N - 1);
+    cout << "after edit: vertices " << gc.vertex_size() << "  edges " << gc.edge_size() << endl;
+
+    // 大图：10^6个顶点，平均出度8
+    const int BN = 1000000;
+    src.clear(); dst.clear(); wt.clear();
+    for (int k = 0; k < BN * DEG; k ++)
+    {
+        src.push_back(rnd() % BN);
+        dst.push_back(rnd() % BN);
+        wt.push_back(1 + rnd() % 100);
+    }
+    dsa::GraphCSR<int, char> big;
+    dsa::ClockTime s = dsa::get_clock();
+    big.build(BN, &src[0], &dst[0], &wt[0], src.size());
+    cout << "build: " << dsa::get_time_ms(s, dsa::get_clock()) << "ms" << endl;
+    s = dsa::get_clock();
+    big.bfs(0);
+    cout << "bfs: " << dsa::get_time_ms(s, dsa::get_clock()) << "ms" << endl;
+    s = dsa::get_clock();
+    big.dfs(0);
+    cout << "dfs: " << dsa::get_time_ms(s, dsa::get_clock()) << "ms" << endl;
+    s = dsa::get_clock();
+    big.dijkstra(0, dsa::RadixQueue);
+    cout << "dijkstra (radix heap): " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  d(1) = "
+         << big.vertex_priority(1) << endl;
+    s = dsa::get_clock();
+    big.dijkstra(0, dsa::BucketQueue);
+    cout << "dijkstra (bucket queue): " << dsa::get_time_ms(s, dsa::get_clock()) << "ms  d(1) = "
+         << big.vertex_priority(1) << endl;
+}
+
+void test_graph_path()
+{
+    unsigned int seed = 88172645u;
+    auto rnd = [&seed]() {seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5; return seed;};
+
+    // 随机图：各种查询与GraphCSR::dijkstra（基数堆）比较
+    const int N = 3000, DEG = 6;
+    dsa::Vector<int> src, dst, wt;
+    for (int k = 0; k < N * DEG; k ++)
+    {
+        src.push_back(rnd() % N);
+        dst.push_back(rnd() % N);
+        wt.push_back(rnd() % 50);
+    }
+    dsa::GraphCSR<int, int> gc;
+    gc.build(N, &src[0], &dst[0], &wt[0], src.size());
+    dsa::GraphPath<dsa::GraphCSR<int, int>> gp(gc);
+    auto zero = [](int) {return 0;};
+    int diff = 0;
+    for (int q = 0; q < 50; q ++)
+    {
+        int s = rnd() % N, t = rnd() % N;
+        gc.dijkstra(s, dsa::RadixQueue);
+        gp.dijkstra(s);
+        for (int k = 0; k < N; k ++)
+            diff += gp.dist()[k] != gc.vertex_priority(k);
+        int d = gc.vertex_priority(t);
+        diff += gp.dijkstra(s, t) != d;
+        diff += gp.astar(s, t, zero) != d;
+        diff += gp.bidirectional(s, t) != d;
+        // 路径上的边权之和等于距离
+        dsa::Vector<int> path;
+        if (gp.path(t, path))
+        {
+            int len = 0;
+            for (int k = 0; k + 1 < path.size(); k ++)
+                len += gc.edge_weight(path[k], path[k + 1]);
+            diff += path[0] != s || len != d;
+        }
+    }
+    int centers[3] = {1, 2, 3};
+    gp.dijkstra_multi(centers, 3);
+    for (int k = 0; k < 3; k ++)
+        diff += gp.dist()[centers[k]] != 0;
+    cout << "mismatch with GraphCSR::dijkstra: " << diff << endl;
+
+    // 网格图（路网的近似）：点对点查询，A*以曼哈顿距离为启发函数
+    const int W = 1000, MINW = 10;
+    src.clear(); dst.clear(); wt.clear();
+    for (int y = 0; y < W; y ++)
+    {
+        for (int x = 0; x < W; x ++)
+        {
+            int v = y * W + x;
+            int nb[4] = {x > 0 ? v - 1 : -1, x + 1 < W ? v + 1 : -1, y > 0 ? v - W : -1, y + 1 < W ? v + W : -1};
+            for (int k = 0; k < 4; k ++)
+            {
+                if (nb[k] < 0)
+                    continue;
+                src.push_back(v);
+                dst.push_back(nb[k]);
+                wt.push_back(MINW + rnd() % 10);
+            }
+        }
+    }
+    dsa::GraphCSR<int, char> grid;
+    grid.build(W * W, &src[0], &dst[0], &wt[0], src.size());
+    dsa::GraphPath<dsa::GraphCSR<int, char>> gpath(grid);
+    const int Q = 20;
+    int qs[Q], qt[Q];
+    for (int q = 0; q < Q; q ++)
+    {
+        qs[q] = rnd() % (W * W);
+        qt[q] = rnd() % (W * W);
+    }
+    int target = 0;
+    auto manhattan = [&target](int v) {return MINW * (std::abs(v % W - target % W) + std::abs(v / W - target / W));};
+
+    long long sum[4] = {0, 0, 0, 0};
+    double cost[4] = {0, 0, 0, 0};
+    for (int q = 0; q < Q; q ++)
+    {
+        dsa::ClockTime s = dsa::get_clock();
+        gpath.dijkstra(qs[q]);
+        sum[0] += gpath.dist()[qt[q]];
+        cost[0] += dsa::get_time_ms(s, dsa::get_clock());
+        s = dsa::get_clock();
+        sum[1] += gpath.dijkstra(qs[q], qt[q]);
+        cost[1] += dsa::get_time_ms(s, dsa::get_clock());
+        s = dsa::get_clock();
+        sum[2] += gpath.bidirectional(qs[q], qt[q]);
+        cost[2] += dsa::get_time_ms(s, dsa::get_clock());
+        s = dsa::get_clock();
+        target = qt[q];
+        sum[3] += gpath.astar(qs[q], qt[q], manhattan);
+        cost[3] += dsa::get_time_ms(s, dsa::get_clock());
+    }
+    const char* name[4] = {"full", "early exit", "bidirectional", "A*"};
+    for (int k = 0; k < 4; k ++)
+        cout << name[k] << ": " << cost[k] / Q << "ms/query  sum = " << sum[k] << endl;
+}
+
 void test_string()
 {
     char txt[] = "adoifeachilaiehchixxxabcxxxchiabcdoivja";
@@ -938,6 +2412,38 @@ void test_share()
     cout << (co == 10) << endl;
 }
 
+void test_node_pool()
+{
+    // 所有树共享同一个BinNode<int>内存池（BN_USE_POOL为0时使用全局new/delete）
+    const int N = 100000;
+    cout << "sizeof(BinNode<int>): " << sizeof(dsa::BinNode<int>) << endl;
+#if BN_USE_POOL
+    dsa::NodePool& pool = dsa::BinNode<int>::pool();
+    cout << "pool node: " << pool.node_size() << endl;
+#endif
+    {
+        dsa::RedBlackTree<int> rb;
+        dsa::AvlTree<int> avl;
+        dsa::ClockTime s = dsa::get_clock();
+        for (int k = 0; k < N; k ++)
+            rb.insert((k * 7919) % N);
+        for (int k = 0; k < N; k ++)
+            avl.insert((k * 7919) % N);
+        cout << "insert: " << dsa::get_time_ms(s, dsa::get_clock()) << "ms" << endl;
+#if BN_USE_POOL
+        cout << "used: " << pool.used() << "  reserved: " << pool.reserved() / 1024 << "KB" << endl;
+#endif
+        for (int k = 0; k < N; k += 2)
+            rb.remove(k);
+#if BN_USE_POOL
+        cout << "after remove used: " << pool.used() << endl;
+#endif
+    }
+#if BN_USE_POOL
+    cout << "after destroy used: " << pool.used() << "  reserved: " << pool.reserved() / 1024 << "KB" << endl;
+#endif
+}
+
 void test_kdtree()
 {
     dsa::Vector<dsa::Vector<int>> vd;
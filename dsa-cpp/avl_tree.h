@@ -85,12 +85,19 @@ namespace dsa
  * search, insert, remove在最坏情况下需要O(log(n))时间。
  * </pre>
  */
-template <typename T>
-class AvlTree : public BinSearchTree<T>
+template <typename T, typename N = BinNode<T> >
+class AvlTree : public BinSearchTree<T,N>
 {
 public:
-    BinNodePtr<T>   insert(const T&);
+    N*              insert(const T&);
     bool            remove(const T&);
+    /** 并入other（要求本树元素均小于other中的元素），O(log(n)) */
+    bool            join(AvlTree<T,N>& other) {return this->join_tree(other);}
+    /** 本树保留 < e 的元素，其余移入other，O(log(n)) */
+    void            split(const T& e, AvlTree<T,N>& other) {this->split_tree(e, other);}
+
+protected:
+    N*              join_at(N*, N*, N*);
 };
 
 /*! @} */
@@ -134,22 +141,23 @@ public:
  * @return 返回新插入的节点
  * @retval None
  */
-template <typename T>
-BinNodePtr<T> AvlTree<T>::insert(const T& e)
+template <typename T, typename N>
+N* AvlTree<T,N>::insert(const T& e)
 {
-    BinNodePtr<T>& x = this->search(e);
+    typename N::Link& x = this->search(e);
     if (x) return x;                        // 不插入重复节点
 
-    x = new BinNode<T>(e, this->m_hot);     // 新插入的节点
+    x = new N(e, this->m_hot);              // 新插入的节点
     this->m_size ++;
-    BinNodePtr<T> node = x;
+    N* node = x;
+    this->update_size_above(this->m_hot);   // 失衡调整可能提前结束，故先更新所有祖先的cnt
 
     // 从新插入节点的父节点开始，向上遍历所有父节点，检查是否满足Avl平衡
-    for(BinNodePtr<T> g = this->m_hot; g; g = g->parent)
+    for(N* g = this->m_hot; g; g = g->parent)
     {
         if(!AVL_Balanced(*g))               // 所有失衡节点中的最低点
         {
-            BinNodePtr<T>& sub_node = RefFromParent(*g);
+            typename N::Link& sub_node = RefFromParent(*g);
                                             // 获取g在父节点的孩子节点指针
             sub_node = this->rotate_at(AVL_TallerChild(AVL_TallerChild(g)));
                                             // 将rotate_at返回子树的根节点添加到Avl树中
@@ -196,19 +204,19 @@ BinNodePtr<T> AvlTree<T>::insert(const T& e)
  * @return
  * @retval None
  */
-template <typename T>
-bool AvlTree<T>::remove(const T& e)
+template <typename T, typename N>
+bool AvlTree<T,N>::remove(const T& e)
 {
-    BinNodePtr<T>& x = this->search(e);
+    typename N::Link& x = this->search(e);
     if (!x) return false;
     this->remove_at(x, this->m_hot);
     this->m_size--;
 
-    for (BinNodePtr<T> g = this->m_hot; g; g = g->parent)
+    for (N* g = this->m_hot; g; g = g->parent)
     {
         if (!AVL_Balanced(*g))
         {
-            BinNodePtr<T>& sub_node = RefFromParent(*g);
+            typename N::Link& sub_node = RefFromParent(*g);
             g = sub_node = this->rotate_at(AVL_TallerChild(AVL_TallerChild(g)));
         }
         this->update_height(g);
@@ -217,6 +225,70 @@ bool AvlTree<T>::remove(const T& e)
     return true;
 }
 
+/*!
+ * @brief 以k为根节点，连接AVL子树l与r（l中元素 < k < r中元素）
+ *
+ * <pre>
+ * 设l较高（r较高时对称）：沿l的右侧链下行，找到第一个高度不超过h(r)+1的节点c；
+ * 以k替换c的位置，c与r分别作为k的左右子树，则k处平衡，且子树高度最多增加1；
+ * 与插入类似，再自c原父节点向上检测失衡，进行旋转调整，O(|h(l)-h(r)|)。
+ *
+ *        l                  l
+ *       / \                /  *      .   .       =>     .   .
+ *           \                   *            c                  k
+ *                              /  *                             c   r
+ * </pre>
+ *
+ * @param l: 左子树根节点（parent为nullptr）
+ * @param k: 独立的节点
+ * @param r: 右子树根节点（parent为nullptr）
+ * @return 返回连接后的根节点
+ * @retval None
+ */
+template <typename T, typename N>
+N* AvlTree<T,N>::join_at(N* l, N* k, N* r)
+{
+    int hl = BN_Stature(l);
+    int hr = BN_Stature(r);
+    if (hl <= hr + 1 && hr <= hl + 1)
+        return BinSearchTree<T,N>::join_at(l, k, r);
+
+    N* p = nullptr;
+    N* c;
+    if (hl > hr)
+    {
+        this->m_root = c = l;
+        while (BN_Stature(c) > hr + 1) {p = c; c = c->right;}
+        p->right = k;
+        k->left = c;
+        k->right = r;
+    }
+    else
+    {
+        this->m_root = c = r;
+        while (BN_Stature(c) > hl + 1) {p = c; c = c->left;}
+        p->left = k;
+        k->left = l;
+        k->right = c;
+    }
+    k->parent = p;
+    if (k->left) k->left->parent = k;
+    if (k->right) k->right->parent = k;
+    this->update_height(k);
+    this->update_size_above(k);
+
+    for (N* g = p; g; g = g->parent)
+    {
+        if (!AVL_Balanced(*g))
+        {
+            typename N::Link& sub_node = RefFromParent(*g);
+            g = sub_node = this->rotate_at(AVL_TallerChild(AVL_TallerChild(g)));
+        }
+        this->update_height(g);
+    }
+    return this->m_root;
+}
+
 } /* dsa */
 
 #endif /* ifndef DSAS_AVL_TREE_H */
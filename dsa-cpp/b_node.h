@@ -50,6 +50,7 @@ using BTNodePtr = struct BTNode<T>*;
 template <typename T> struct BTNode
 {
     BTNodePtr<T>                parent;
+    int                         idx;    /**< 在父节点child中的下标，由BTree维护，免去在父节点中线性查找 */
     dsa::Vector<T>              key;    /**< 关键码，即节点数据 */
     dsa::Vector<BTNodePtr<T> >  child;  /**< 分支，即子节点 */
 
@@ -63,7 +64,7 @@ template <typename T> struct BTNode
      * @return
      * @retval None
      */
-    BTNode(){parent = nullptr; child.insert(0, nullptr); }
+    BTNode(){parent = nullptr; idx = 0; child.insert(0, nullptr); }
 
     /*!
      * @brief b-tree节点构造函数
@@ -76,7 +77,7 @@ template <typename T> struct BTNode
      * @return
      * @retval None
      */
-    BTNode(int m) : key(m-1+1), child(m+1) {parent = nullptr; child.insert(0, nullptr); }
+    BTNode(int m) : key(m-1+1), child(m+1) {parent = nullptr; idx = 0; child.insert(0, nullptr); }
 
     /*!
      * @brief b-tree节点构造函数
@@ -91,11 +92,12 @@ template <typename T> struct BTNode
     BTNode(const T& e, BTNodePtr<T> lc = nullptr, BTNodePtr<T> rc = nullptr)
     {
         this->parent = nullptr;
+        this->idx = 0;
         this->key.insert(0, e);
         this->child.insert(0, lc);
         this->child.insert(1, rc);
-        if (lc) lc->parent = this;
-        if (rc) rc->parent = this;
+        if (lc) {lc->parent = this; lc->idx = 0;}
+        if (rc) {rc->parent = this; rc->idx = 1;}
     }
 
     /*!
@@ -114,11 +116,12 @@ template <typename T> struct BTNode
     BTNode(int m, const T& e, BTNodePtr<T> lc = nullptr, BTNodePtr<T> rc = nullptr) : key(m-1+1), child(m+1)
     {
         this->parent = nullptr;
+        this->idx = 0;
         this->key.insert(0, e);
         this->child.insert(0, lc);
         this->child.insert(1, rc);
-        if (lc) lc->parent = this;
-        if (rc) rc->parent = this;
+        if (lc) {lc->parent = this; lc->idx = 0;}
+        if (rc) {rc->parent = this; rc->idx = 1;}
     }
 };
 
@@ -54,6 +54,7 @@ protected:
     BTNodePtr<T> m_hot;         /**< search最后访问的非空节点位置 */
 
     void clear(BTNodePtr<T>);
+    void relink(BTNodePtr<T>, int);
     void solve_overflow(BTNodePtr<T>);
     void solve_underflow(BTNodePtr<T>);
 
@@ -66,7 +67,7 @@ public:
     /** 返回b-tree关键码总数 */
     int     size() const {return this->m_size;}
     /** 判断b-tree是否存在节点，存在节点不一定有关键码 */
-    bool    is_empty() const {return !this-m_root;}
+    bool    is_empty() const {return !this->m_root;}
 
     /** 返回根节点 */
     BTNodePtr<T>&   root(){return this->m_root;};
@@ -96,6 +97,29 @@ void BTree<T>::clear(BTNodePtr<T> r)
     }
 }
 
+/*!
+ * @brief 更新p->child[lo, size)的父节点及其在p->child中的下标
+ *
+ * 分裂、合并与旋转都会整体移动分支，之后由此函数统一修正，
+ * 叶节点的分支均为nullptr，无需修正。
+ *
+ * @param p: 父节点
+ * @param lo: 起始下标
+ * @return
+ * @retval None
+ */
+template <typename T>
+void BTree<T>::relink(BTNodePtr<T> p, int lo)
+{
+    if (!p->child[0])
+        return;
+    for (int k = lo; k < p->child.size(); k ++)
+    {
+        p->child[k]->parent = p;
+        p->child[k]->idx = k;
+    }
+}
+
 /*!
  * @brief 使用分裂修复上溢
  *
@@ -124,6 +148,9 @@ void BTree<T>::clear(BTNodePtr<T> r)
  * 根节点上溢时，分裂出的新根节点，且新的根节点只有2个分支;
  * 根据分裂特性，可知非叶节点的子节点不可指向nullptr。
  *
+ * 关键码与分支均整段转移，node在父节点中的下标r即为[ks]上移的位置，
+ * 故一次分裂的代价为O(m)，与阶次m成线性关系。
+ *
  * </pre>
  *
  * @param node: 可能发生上溢的节点
@@ -145,33 +172,26 @@ void BTree<T>::solve_overflow(BTNodePtr<T> node)
         this->m_root = p = new BTNode<T>(this->m_order); // BTNode默认构造函数，在没关键码时有一个指向nullptr子节点
         p->child[0] = node;
         node->parent = p;
+        node->idx = 0;
     }
 
-    // 转移node中s之后关键码和分支节点，追加到新节点rc中
+    // 整段转移node中s之后关键码和分支节点到新节点rc中
     // 即转移示意图中的 *[5]* 部分
     int s = this->m_order / 2;              // 确定上移的节点位置
     BTNodePtr<T> rc = new BTNode<T>(this->m_order);      // BTNode默认构造函数，在没关键码时有一个指向nullptr子节点
     rc->child.clear();                      // 清除第一个默认添加的nullptr子节点
-    for (int k = s + 1; k < node->key.size(); k ++)
-    {
-        rc->key.push_back(node->key[k]);
-        rc->child.push_back(node->child[k]);
-    }
-    rc->child.push_back(node->child[node->child.size()-1]); // 分支节点数比关键码数多1
-    if (rc->child[0])                       // 非叶节点的子节点均在存(不为nullptr)
-    {
-        for (int k = 0; k < rc->child.size(); k ++)
-            rc->child[k]->parent = rc;      // 更新父节点，rc即在p->child中
-    }
-    node->key.remove(s+1, node->key.size());// 移除原节点node中的关键码和分支
+    rc->key.insert(0, node->key, s+1, node->key.size());
+    rc->child.insert(0, node->child, s+1, node->child.size()); // 分支节点数比关键码数多1
+    this->relink(rc, 0);
     node->child.remove(s+1, node->child.size());
 
     // 上移目标关键码
-    // 即上移示意图的中 [3]
-    int r = p->key.search(node->key[s]);    // 确定移至父节点的位置
-    p->key.insert(r+1, node->key.remove(s));
-    p->child.insert(r+2, rc);               // 连接节点，p->child[r+2]现在指向rc
-    rc->parent = p;
+    // 即上移示意图的中 [3]，node为p->child[r]，则[3]插入p->key[r]，rc作为p->child[r+1]
+    int r = node->idx;
+    p->key.insert(r, node->key[s]);
+    node->key.remove(s, node->key.size());  // 移除原节点node中的[3]及其后的关键码
+    p->child.insert(r+1, rc);
+    this->relink(p, r+1);
 
     solve_overflow(p);
 }
@@ -206,6 +226,8 @@ void BTree<T>::solve_overflow(BTNodePtr<T> node)
  *            下溢节点node
  * 合并后，将删除节点#
  *
+ * node在父节点中的下标r由node->idx直接给出；合并时关键码与分支整段转移，
+ * 故一次旋转或合并的代价为O(m)。
  * </pre>
  *
  * @param None
@@ -227,6 +249,7 @@ void BTree<T>::solve_underflow(BTNodePtr<T> node)
             // 在在根节点下溢时，树高度会下降
             this->m_root = node->child[0];
             this->m_root->parent = nullptr;
+            this->m_root->idx = 0;
             node->child[0] = nullptr;
             delete node;
         }
@@ -235,7 +258,7 @@ void BTree<T>::solve_underflow(BTNodePtr<T> node)
 
     // 获取node在父节点中的位置，这里不能用search，因为node是指针，在vector中是无序的
     // r在p->child的左右两侧，必有一侧存在
-    int r = p->child.find(node);
+    int r = node->idx;
 
     // 尝试旋转
     if (r > 0)
@@ -248,6 +271,7 @@ void BTree<T>::solve_underflow(BTNodePtr<T> node)
             node->key.push_front(p->key[r-1]);
             node->child.push_front(s->child.remove(s->child.size()-1));
             p->key[r-1] = s->key.remove(s->key.size()-1);
+            this->relink(node, 0);
             return;
         }
     }
@@ -261,6 +285,8 @@ void BTree<T>::solve_underflow(BTNodePtr<T> node)
             node->key.push_back(p->key[r]);
             node->child.push_back(s->child.remove(0));
             p->key[r] = s->key.remove(0);
+            this->relink(node, node->child.size()-1);
+            this->relink(s, 0);
             return;
         }
     }
@@ -274,16 +300,12 @@ void BTree<T>::solve_underflow(BTNodePtr<T> node)
 
         s->key.push_back(p->key.remove(r-1));
         p->child.remove(r);
+        this->relink(p, r);
 
-        for (int k = 0; k < node->key.size(); k++)
-            s->key.push_back(node->key[0]);
-
-        for (int k = 0; k < node->child.size(); k++)
-        {
-            if (node->child[k])
-                node->child[k]->parent = s;
-            s->child.push_back(node->child[k]);
-        }
+        int n = s->child.size();
+        s->key.insert(s->key.size(), node->key, 0, node->key.size());
+        s->child.insert(n, node->child, 0, node->child.size());
+        this->relink(s, n);
         delete node;
     }
     else
@@ -292,18 +314,13 @@ void BTree<T>::solve_underflow(BTNodePtr<T> node)
         BTNodePtr<T> s = p->child[r+1];       // p->child和node均为p的节点，node不为nullptr，其它的child也必定不为nullptr
         //int y = r;
 
-        s->key.push_front(p->key.remove(r));
+        node->key.push_back(p->key.remove(r));   // 先与分隔关键码拼接，s中原有关键码只需后移一次
         p->child.remove(r);
+        this->relink(p, r);
 
-        for (int k = 0; k < node->key.size(); k++)
-            s->key.insert(k, node->key[k]);
-
-        for (int k = 0; k < node->child.size(); k++)
-        {
-            if (node->child[k])
-                node->child[k]->parent = s;
-            s->child.insert(k, node->child[k]);
-        }
+        s->key.insert(0, node->key, 0, node->key.size());
+        s->child.insert(0, node->child, 0, node->child.size());
+        this->relink(s, 0);
         delete node;
     }
 
@@ -400,7 +417,7 @@ bool BTree<T>::remove(const T& e)
     {
         // node不是叶节点，则e右侧必有子节点
         BTNodePtr<T> u = node->child[r+1];
-        while(node->child[0]) u = u->child[0];  // 迭代至e的后继(后继必定是叶节点)
+        while(u->child[0]) u = u->child[0];  // 迭代至e的后继(后继必定是叶节点)
         node->key[r] = u->key[0];   // 将u->key[0]与待删除e交换位置
         //u->key[0] = e;              // 赋不赋值无所谓，反正要删除
         node = u;                   // node重新指向包含待删除目标e的叶节点u
@@ -0,0 +1,748 @@
+
+//==============================================================================
+/*!
+ * @file b_tree_disk.h
+ * @brief 基于页文件的b-tree类
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_B_TREE_DISK_H
+#define DSAS_B_TREE_DISK_H
+
+#include <cstring>
+#include <type_traits>
+#include "share/compare.h"
+#include "buffer_pool.h"
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup TBTree
+ * @{
+ */
+
+#define DBT_MAGIC           0x31544244u     /**< 文件标识"DBT1" */
+#define DBT_FRAMES_DEFAULT  256             /**< 默认缓冲池页帧数 */
+
+/*!
+ * @brief 基于页文件的b-树(b-tree)类
+ *
+ * <pre>
+ * 每个节点占用页文件中的一页，节点之间通过页号（而非指针）引用，所有访问都经过缓冲池：
+ *
+ * page 0:   [magic|page_size|t|root|size|height|free|key_size]       元数据页
+ * page k:   [n|leaf|key[0] ... key[2t-2]|child[0] ... child[2t-1]]    节点页
+ *
+ * 最小度数t由页大小决定（4KB页、4字节关键码时t=255），关键码数n满足 t-1 <= n <= 2t-1（树根除外），
+ * 树高约为log_t(N)，查找只需读取约log_t(N)页，上层节点通常常驻缓冲池。
+ *
+ * 插入与删除均采用《算法导论》中自顶向下的一趟算法，不需要回溯到父节点，同时固定的页不超过3个：
+ * 插入：沿途遇到满节点（2t-1个关键码）先分裂，保证插入叶节点时不会上溢；
+ * 删除：下降到子节点之前，保证其至少有t个关键码（从兄弟借或与兄弟合并），删除叶节点中的关键码时不会下溢；
+ *       目标位于内部节点时，用前驱或后继替换，再到对应子树中删除前驱或后继。
+ * 合并或树根下降释放的页挂到空闲页链表上（链接存放在空闲页的前4字节），分配时优先复用。
+ * 固定页失败（读取错误，或页帧都已被固定）时操作停止并返回false；插入/删除中途失败时，
+ * 已完成的分裂、借与合并保持树的结构，但替换为前驱或后继的关键码可能重复，与flush前崩溃一样应重建文件。
+ *
+ * 关键码T须是可平凡复制的定长类型，按字节存入页中（不可跨不同字节序或对齐的平台使用）。
+ * 元数据在flush/close时写入，期间崩溃可能导致文件不一致（崩溃一致性见b_tree_durable.h中的DurableBTree）。
+ * </pre>
+ *
+ */
+template <typename T>
+class DiskBTree
+{
+    static_assert(std::is_trivially_copyable<T>::value, "DiskBTree: T must be trivially copyable");
+
+private:
+    /** 元数据 */
+    struct Meta
+    {
+        unsigned    magic;
+        int         page_size;
+        int         t;          /**< 最小度数 */
+        int         root;       /**< 根节点页号 */
+        int         size;       /**< 关键码总数 */
+        int         height;     /**< 树高（只有树根时为1） */
+        int         free;       /**< 空闲页链表，-1表示没有 */
+        int         key_size;   /**< sizeof(T)，打开文件时校验 */
+    };
+    /** 节点页的视图，各字段直接指向页数据 */
+    struct Node
+    {
+        int*    n;
+        int*    leaf;
+        T*      key;
+        int*    child;
+    };
+
+    dsa::PageFile       m_file;
+    dsa::BufferPool*    m_pool;
+    Meta                m_meta;
+    int                 m_child_off;    /**< 页中child数组的偏移 */
+
+protected:
+    Node    view(char* p) const
+    {
+        Node x;
+        x.n = reinterpret_cast<int*>(p);
+        x.leaf = reinterpret_cast<int*>(p) + 1;
+        x.key = reinterpret_cast<T*>(p + 8);
+        x.child = reinterpret_cast<int*>(p + this->m_child_off);
+        return x;
+    }
+    /** child数组的偏移 */
+    static int child_offset(int t) {return (int)((8 + (2 * t - 1) * sizeof(T) + 3) / 4 * 4);}
+    /** 页大小能容纳的最大最小度数 */
+    static int max_degree(int page_size)
+    {
+        int t = (int)((page_size - 12) / (sizeof(T) + 4) + 1) / 2;
+        while (t > 2 && child_offset(t) + 8 * t > page_size)
+            t --;
+        return t;
+    }
+    /** 第一个不小于e的位置 */
+    static int lower(const Node& x, const T& e)
+    {
+        int lo = 0, hi = *x.n;
+        while (lo < hi)
+        {
+            int mi = (lo + hi) >> 1;
+            if (dsa::less_than(x.key[mi], e)) lo = mi + 1;
+            else hi = mi;
+        }
+        return lo;
+    }
+
+    int     alloc_page();
+    void    free_page(int);
+    bool    write_meta();
+    bool    split_child(Node&, int, Node&, dsa::PageGuard&);
+    void    merge_child(Node&, int, Node&, Node&, int);
+    bool    edge_key(int, bool, T&);
+    template <typename VST>
+    void    traverse_at(int, VST&);
+
+public:
+    DiskBTree() : m_pool(nullptr), m_child_off(0) {}
+    ~DiskBTree() {this->close();}
+    DiskBTree(const DiskBTree&) = delete;
+    DiskBTree& operator= (const DiskBTree&) = delete;
+
+    bool    open(const char* path, int page_size = PAGE_SIZE_DEFAULT, int frames = DBT_FRAMES_DEFAULT, int t = 0);
+    bool    flush();
+    void    close();
+    bool    is_open() const {return this->m_pool != nullptr;}
+
+    /** 返回关键码总数 */
+    int     size() const {return this->m_meta.size;}
+    /** 返回树高 */
+    int     height() const {return this->m_meta.height;}
+    /** 返回最小度数 */
+    int     min_degree() const {return this->m_meta.t;}
+    /** 返回页文件的页数 */
+    int     pages() const {return this->m_file.pages();}
+    /** 获取缓冲池统计 */
+    const dsa::BufferPool::PoolStat& stat() const {return this->m_pool->stat();}
+    /** 清零缓冲池统计 */
+    void    reset_stat() {this->m_pool->reset_stat();}
+
+    bool    search(const T& e, T* out = nullptr);
+    bool    insert(const T& e);
+    bool    remove(const T& e);
+    /** 按顺序访问所有关键码，visit(const T&) */
+    template <typename VST>
+    void    traverse(VST& visit) {this->traverse_at(this->m_meta.root, visit);}
+};
+
+/*! @} */
+
+
+/*!
+ * @brief 打开（或创建）b-tree文件
+ *
+ * @param path: 文件路径
+ * @param page_size: 页大小（字节，建议4KB~16KB），打开已有文件时以文件中记录的为准
+ * @param frames: 缓冲池页帧数
+ * @param t: 最小度数，0表示由页大小决定（创建文件时有效，超过页的容量时取最大值）
+ * @return 打开失败或文件格式不符时返回false
+ * @retval None
+ */
+template <typename T>
+bool DiskBTree<T>::open(const char* path, int page_size, int frames, int t)
+{
+    this->close();
+    if (page_size < PAGE_SIZE_MIN)
+        page_size = PAGE_SIZE_MIN;
+    if (!this->m_file.open(path, page_size))
+        return false;
+
+    if (this->m_file.pages() > 0)
+    {
+        // 已有文件：读取元数据，页大小不同时重新打开
+        char* buf = new char[page_size];
+        bool ok = this->m_file.read(0, buf);
+        std::memcpy(&this->m_meta, buf, sizeof(Meta));
+        delete[] buf;
+        if (!ok || this->m_meta.magic != DBT_MAGIC || this->m_meta.key_size != (int)sizeof(T)
+            || this->m_meta.page_size < PAGE_SIZE_MIN)
+        {
+            this->m_file.close();
+            return false;
+        }
+        if (this->m_meta.page_size != page_size && !this->m_file.open(path, this->m_meta.page_size))
+            return false;
+        this->m_child_off = child_offset(this->m_meta.t);
+        this->m_pool = new dsa::BufferPool(this->m_file, frames);
+        return true;
+    }
+
+    // 新文件：元数据页与一个空的根节点
+    int tmax = max_degree(page_size);
+    this->m_meta.magic = DBT_MAGIC;
+    this->m_meta.page_size = page_size;
+    this->m_meta.t = (t >= 2 && t < tmax) ? t : tmax;
+    this->m_meta.size = 0;
+    this->m_meta.height = 1;
+    this->m_meta.free = -1;
+    this->m_meta.key_size = (int)sizeof(T);
+    this->m_child_off = child_offset(this->m_meta.t);
+    this->m_pool = new dsa::BufferPool(this->m_file, frames);
+    this->m_file.allocate();
+    this->m_meta.root = this->m_file.allocate();
+    {
+        dsa::PageGuard g(*this->m_pool, this->m_meta.root, true);
+        if (!g.data())
+            return false;
+        Node r = this->view(g.data());
+        *r.n = 0;
+        *r.leaf = 1;
+    }
+    return this->flush();
+}
+
+/*!
+ * @brief 写回所有脏页与元数据，并刷到磁盘
+ *
+ * @param None
+ * @return 写入失败时返回false
+ * @retval None
+ */
+template <typename T>
+bool DiskBTree<T>::flush()
+{
+    if (!this->m_pool)
+        return false;
+    return this->write_meta() && this->m_pool->flush() && this->m_file.sync();
+}
+
+/** 关闭文件（先flush） */
+template <typename T>
+void DiskBTree<T>::close()
+{
+    if (this->m_pool)
+    {
+        this->flush();
+        delete this->m_pool;
+        this->m_pool = nullptr;
+    }
+    this->m_file.close();
+}
+
+/** 将元数据写入第0页（缓冲池中） */
+template <typename T>
+bool DiskBTree<T>::write_meta()
+{
+    dsa::PageGuard g(*this->m_pool, 0);
+    if (!g.data())
+        return false;
+    std::memcpy(g.data(), &this->m_meta, sizeof(Meta));
+    g.mark_dirty();
+    return true;
+}
+
+/** 分配一页，优先复用空闲页；调用者需以fresh方式固定该页。读取空闲页失败时返回-1 */
+template <typename T>
+int DiskBTree<T>::alloc_page()
+{
+    if (this->m_meta.free < 0)
+        return this->m_file.allocate();
+    int id = this->m_meta.free;
+    dsa::PageGuard g(*this->m_pool, id);
+    if (!g.data())
+        return -1;
+    std::memcpy(&this->m_meta.free, g.data(), sizeof(int));
+    return id;
+}
+
+/** 释放一页，挂到空闲页链表上（固定失败时该页不再复用，不影响树的内容） */
+template <typename T>
+void DiskBTree<T>::free_page(int id)
+{
+    dsa::PageGuard g(*this->m_pool, id, true);
+    if (!g.data())
+        return;
+    std::memcpy(g.data(), &this->m_meta.free, sizeof(int));
+    this->m_meta.free = id;
+}
+
+/*!
+ * @brief 分裂x的第i个子节点y（y已满）
+ *
+ * <pre>
+ * y的前t-1个关键码留在y中，第t个（y.key[t-1]）上移到x.key[i]，后t-1个移到新节点z（x.child[i+1]）中：
+ *           x: [ ... k(i-1) |        | k(i) ... ]
+ *                               |
+ *           y: [ a0 ... a(t-2) | a(t-1) | a(t) ... a(2t-2) ]
+ *                        =>
+ *           x: [ ... k(i-1) | a(t-1) | k(i) ... ]
+ *                          /           \
+ *         y: [ a0 ... a(t-2) ]   z: [ a(t) ... a(2t-2) ]
+ * </pre>
+ *
+ * @param x: 父节点（不满），调用者负责标记为脏页
+ * @param i: y在x中的位置
+ * @param y: 满的子节点
+ * @param yg: y的页固定
+ * @return 分配或固定新页失败时返回false，此时x与y不变
+ * @retval None
+ */
+template <typename T>
+bool DiskBTree<T>::split_child(Node& x, int i, Node& y, dsa::PageGuard& yg)
+{
+    const int t = this->m_meta.t;
+    int zid = this->alloc_page();
+    if (zid < 0)
+        return false;
+    dsa::PageGuard zg(*this->m_pool, zid, true);
+    if (!zg.data())
+    {
+        zg.release();
+        this->free_page(zid);
+        return false;
+    }
+    Node z = this->view(zg.data());
+
+    *z.leaf = *y.leaf;
+    *z.n = t - 1;
+    for (int j = 0; j < t - 1; j ++)
+        z.key[j] = y.key[j + t];
+    if (!*y.leaf)
+        for (int j = 0; j < t; j ++)
+            z.child[j] = y.child[j + t];
+    *y.n = t - 1;
+    yg.mark_dirty();
+
+    for (int j = *x.n; j > i; j --)
+    {
+        x.child[j + 1] = x.child[j];
+        x.key[j] = x.key[j - 1];
+    }
+    x.child[i + 1] = zid;
+    x.key[i] = y.key[t - 1];
+    (*x.n) ++;
+    return true;
+}
+
+/*!
+ * @brief 合并x的第i个与第i+1个子节点：y吸收x.key[i]与z的全部内容，z的页被释放
+ *
+ * @param x: 父节点，调用者负责标记为脏页
+ * @param i: y在x中的位置
+ * @param y,z: 相邻的两个子节点，调用者负责将y标记为脏页
+ * @param zid: z的页号
+ * @return
+ * @retval None
+ */
+template <typename T>
+void DiskBTree<T>::merge_child(Node& x, int i, Node& y, Node& z, int zid)
+{
+    int n = *y.n;
+    y.key[n] = x.key[i];
+    for (int j = 0; j < *z.n; j ++)
+        y.key[n + 1 + j] = z.key[j];
+    if (!*y.leaf)
+        for (int j = 0; j <= *z.n; j ++)
+            y.child[n + 1 + j] = z.child[j];
+    *y.n = n + 1 + *z.n;
+
+    for (int j = i; j < *x.n - 1; j ++)
+    {
+        x.key[j] = x.key[j + 1];
+        x.child[j + 1] = x.child[j + 2];
+    }
+    (*x.n) --;
+    this->free_page(zid);
+}
+
+/** 子树中的最大（max为true）或最小关键码，固定页失败时返回false */
+template <typename T>
+bool DiskBTree<T>::edge_key(int id, bool max, T& out)
+{
+    for (;;)
+    {
+        dsa::PageGuard g(*this->m_pool, id);
+        if (!g.data())
+            return false;
+        Node x = this->view(g.data());
+        if (*x.leaf)
+        {
+            out = x.key[max ? *x.n - 1 : 0];
+            return true;
+        }
+        id = x.child[max ? *x.n : 0];
+    }
+}
+
+/*!
+ * @brief 查找
+ *
+ * @param e: 查找目标
+ * @param out: 不为nullptr时，返回树中与e相等的关键码
+ * @return 不存在或固定页失败时返回false
+ * @retval None
+ */
+template <typename T>
+bool DiskBTree<T>::search(const T& e, T* out)
+{
+    int id = this->m_meta.root;
+    for (;;)
+    {
+        dsa::PageGuard g(*this->m_pool, id);
+        if (!g.data())
+            return false;
+        Node x = this->view(g.data());
+        int i = lower(x, e);
+        if (i < *x.n && !dsa::less_than(e, x.key[i]))
+        {
+            if (out) *out = x.key[i];
+            return true;
+        }
+        if (*x.leaf)
+            return false;
+        id = x.child[i];
+    }
+}
+
+/*!
+ * @brief 插入（自顶向下，沿途分裂满节点）
+ *
+ * @param e: 插入目标
+ * @return 已存在或固定页失败时返回false
+ * @retval None
+ */
+template <typename T>
+bool DiskBTree<T>::insert(const T& e)
+{
+    const int t = this->m_meta.t;
+    {
+        // 树根已满：新建树根，原树根作为其唯一的子节点后分裂，树高加1
+        dsa::PageGuard rg(*this->m_pool, this->m_meta.root);
+        if (!rg.data())
+            return false;
+        Node r = this->view(rg.data());
+        if (*r.n == 2 * t - 1)
+        {
+            int sid = this->alloc_page();
+            if (sid < 0)
+                return false;
+            dsa::PageGuard sg(*this->m_pool, sid, true);
+            if (!sg.data())
+            {
+                sg.release();
+                this->free_page(sid);
+                return false;
+            }
+            Node s = this->view(sg.data());
+            *s.leaf = 0;
+            *s.n = 0;
+            s.child[0] = this->m_meta.root;
+            if (!this->split_child(s, 0, r, rg))
+            {
+                sg.release();
+                this->free_page(sid);
+                return false;
+            }
+            this->m_meta.root = sid;
+            this->m_meta.height ++;
+        }
+    }
+
+    int id = this->m_meta.root;
+    for (;;)
+    {
+        dsa::PageGuard g(*this->m_pool, id);
+        if (!g.data())
+            return false;
+        Node x = this->view(g.data());
+        int i = lower(x, e);
+        if (i < *x.n && !dsa::less_than(e, x.key[i]))
+            return false;
+        if (*x.leaf)
+        {
+            for (int j = *x.n; j > i; j --)
+                x.key[j] = x.key[j - 1];
+            x.key[i] = e;
+            (*x.n) ++;
+            g.mark_dirty();
+            this->m_meta.size ++;
+            return true;
+        }
+
+        int cid = x.child[i];
+        dsa::PageGuard cg(*this->m_pool, cid);
+        if (!cg.data())
+            return false;
+        Node c = this->view(cg.data());
+        if (*c.n == 2 * t - 1)
+        {
+            if (!this->split_child(x, i, c, cg))
+                return false;
+            g.mark_dirty();
+            if (!dsa::less_than(e, x.key[i]) && !dsa::less_than(x.key[i], e))
+                return false;       // 与上移的中位数相等
+            if (dsa::less_than(x.key[i], e))
+                cid = x.child[i + 1];
+        }
+        id = cid;
+    }
+}
+
+/*!
+ * @brief 删除（自顶向下，下降前保证子节点至少有t个关键码）
+ *
+ * <pre>
+ * 在节点x中（x不是树根时至少有t个关键码）：
+ * (1) x是叶节点：直接删除；
+ * (2) 目标为x.key[i]，x是内部节点：
+ *     a. 左子节点y至少有t个关键码：用前驱替换x.key[i]，再到y中删除前驱；
+ *     b. 右子节点z至少有t个关键码：用后继替换x.key[i]，再到z中删除后继；
+ *     c. 否则合并y、x.key[i]、z，再到合并后的y中删除目标；
+ * (3) 目标不在x中，将进入的子节点c只有t-1个关键码：
+ *     a. 相邻兄弟至少有t个关键码：经过x旋转，从兄弟借一个关键码（及其分支）；
+ *     b. 否则与一个相邻兄弟合并。
+ * 树根的关键码被合并下移而变空时，树高减1。
+ * 同时固定的页不超过3个：查找前驱或后继前先解除子节点的固定。
+ * </pre>
+ *
+ * @param e: 删除目标
+ * @return 不存在或固定页失败时返回false
+ * @retval None
+ */
+template <typename T>
+bool DiskBTree<T>::remove(const T& e)
+{
+    const int t = this->m_meta.t;
+    T key = e;
+    bool found = false;
+    int id = this->m_meta.root;
+    for (;;)
+    {
+        dsa::PageGuard g(*this->m_pool, id);
+        if (!g.data())
+            return false;
+        Node x = this->view(g.data());
+        int i = lower(x, key);
+        bool hit = i < *x.n && !dsa::less_than(key, x.key[i]);
+
+        if (*x.leaf)
+        {
+            if (hit)
+            {
+                for (int j = i; j < *x.n - 1; j ++)
+                    x.key[j] = x.key[j + 1];
+                (*x.n) --;
+                g.mark_dirty();
+                found = true;
+            }
+            break;
+        }
+
+        if (hit)
+        {
+            int yid = x.child[i], zid = x.child[i + 1];
+            dsa::PageGuard yg(*this->m_pool, yid);
+            if (!yg.data())
+                return false;
+            Node y = this->view(yg.data());
+            if (*y.n >= t)
+            {
+                yg.release();
+                if (!this->edge_key(yid, true, key))        // (2a)
+                    return false;
+                x.key[i] = key;
+                g.mark_dirty();
+                id = yid;
+                continue;
+            }
+            dsa::PageGuard zg(*this->m_pool, zid);
+            if (!zg.data())
+                return false;
+            Node z = this->view(zg.data());
+            if (*z.n >= t)
+            {
+                yg.release();
+                zg.release();
+                if (!this->edge_key(zid, false, key))       // (2b)
+                    return false;
+                x.key[i] = key;
+                g.mark_dirty();
+                id = zid;
+                continue;
+            }
+            this->merge_child(x, i, y, z, zid);             // (2c)
+            yg.mark_dirty();
+            g.mark_dirty();
+            id = yid;
+            continue;
+        }
+
+        int cid = x.child[i];
+        dsa::PageGuard cg(*this->m_pool, cid);
+        if (!cg.data())
+            return false;
+        Node c = this->view(cg.data());
+        if (*c.n == t - 1)
+        {
+            int lid = (i > 0) ? x.child[i - 1] : -1;
+            int rid = (i < *x.n) ? x.child[i + 1] : -1;
+            if (lid >= 0)
+            {
+                dsa::PageGuard lg(*this->m_pool, lid);
+                if (!lg.data())
+                    return false;
+                Node l = this->view(lg.data());
+                if (*l.n >= t)
+                {
+                    // (3a) 从左兄弟借
+                    for (int j = *c.n; j > 0; j --)
+                        c.key[j] = c.key[j - 1];
+                    if (!*c.leaf)
+                        for (int j = *c.n + 1; j > 0; j --)
+                            c.child[j] = c.child[j - 1];
+                    c.key[0] = x.key[i - 1];
+                    if (!*c.leaf)
+                        c.child[0] = l.child[*l.n];
+                    x.key[i - 1] = l.key[*l.n - 1];
+                    (*l.n) --;
+                    (*c.n) ++;
+                    lg.mark_dirty();
+                    cg.mark_dirty();
+                    g.mark_dirty();
+                    id = cid;
+                    continue;
+                }
+            }
+            if (rid >= 0)
+            {
+                dsa::PageGuard rg(*this->m_pool, rid);
+                if (!rg.data())
+                    return false;
+                Node r = this->view(rg.data());
+                if (*r.n >= t)
+                {
+                    // (3a) 从右兄弟借
+                    c.key[*c.n] = x.key[i];
+                    if (!*c.leaf)
+                        c.child[*c.n + 1] = r.child[0];
+                    x.key[i] = r.key[0];
+                    for (int j = 0; j < *r.n - 1; j ++)
+                        r.key[j] = r.key[j + 1];
+                    if (!*r.leaf)
+                        for (int j = 0; j < *r.n; j ++)
+                            r.child[j] = r.child[j + 1];
+                    (*r.n) --;
+                    (*c.n) ++;
+                    rg.mark_dirty();
+                    cg.mark_dirty();
+                    g.mark_dirty();
+                    id = cid;
+                    continue;
+                }
+                // (3b) 与右兄弟合并
+                this->merge_child(x, i, c, r, rid);
+                cg.mark_dirty();
+                g.mark_dirty();
+                id = cid;
+                continue;
+            }
+            // (3b) 与左兄弟合并
+            dsa::PageGuard lg(*this->m_pool, lid);
+            if (!lg.data())
+                return false;
+            Node l = this->view(lg.data());
+            this->merge_child(x, i - 1, l, c, cid);
+            lg.mark_dirty();
+            g.mark_dirty();
+            id = lid;
+            continue;
+        }
+        id = cid;
+    }
+
+    // 树根变空（且不是叶节点）时，唯一的子节点成为新树根
+    {
+        dsa::PageGuard rg(*this->m_pool, this->m_meta.root);
+        if (!rg.data())
+            return false;
+        Node r = this->view(rg.data());
+        if (*r.n == 0 && !*r.leaf)
+        {
+            int old = this->m_meta.root;
+            this->m_meta.root = r.child[0];
+            this->m_meta.height --;
+            rg.release();
+            this->free_page(old);
+        }
+    }
+    if (found)
+        this->m_meta.size --;
+    return found;
+}
+
+/** 中序遍历以id为根的子树，递归前解除固定，同时固定的页数不随树高增加 */
+template <typename T>
+template <typename VST>
+void DiskBTree<T>::traverse_at(int id, VST& visit)
+{
+    int n;
+    {
+        dsa::PageGuard g(*this->m_pool, id);
+        if (!g.data())
+            return;
+        Node x = this->view(g.data());
+        n = *x.n;
+        if (*x.leaf)
+        {
+            for (int k = 0; k < n; k ++)
+                visit(x.key[k]);
+            return;
+        }
+    }
+    for (int k = 0; k <= n; k ++)
+    {
+        int c;
+        T key;
+        {
+            dsa::PageGuard g(*this->m_pool, id);
+            if (!g.data())
+                return;
+            Node x = this->view(g.data());
+            c = x.child[k];
+            if (k < n) key = x.key[k];
+        }
+        this->traverse_at(c, visit);
+        if (k < n)
+            visit(key);
+    }
+}
+
+} /* dsa */
+
+#endif /* ifndef DSAS_B_TREE_DISK_H */
@@ -0,0 +1,1388 @@
+
+//==============================================================================
+/*!
+ * @file b_tree_durable.h
+ * @brief 崩溃安全的持久化b-tree类（写时复制 + 预写日志）
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_B_TREE_DURABLE_H
+#define DSAS_B_TREE_DURABLE_H
+
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+#include <type_traits>
+#include "share/compare.h"
+#include "vector.h"
+#include "buffer_pool.h"
+#include "b_tree_disk.h"
+#if defined DSAS_LINUX
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup TBTree
+ * @{
+ */
+
+#define DBT_DURABLE_MAGIC   0x33544244u     /**< 文件标识"DBT3" */
+#define DBT_META_SLOT       512             /**< 两个元数据槽在第0页中的间隔（字节），两槽位于不同的扇区 */
+#define WAL_GROUP_DEFAULT   256             /**< 组提交：日志缓冲中累积的记录数达到此值时提交（写入并fsync） */
+#define WAL_CHECKPOINT_SIZE (16 << 20)      /**< 日志文件超过此大小（字节）时自动做检查点 */
+
+/*!
+ * @brief 只追加的日志文件
+ *
+ * DSAS_LINUX下使用pwrite/ftruncate，否则使用std::FILE（truncate只改变逻辑长度，
+ * 残留的旧记录由日志序号的连续性排除）。
+ */
+class LogFile
+{
+private:
+#if defined DSAS_LINUX
+    int         m_fd;
+#else
+    std::FILE*  m_fp;
+#endif
+    long long   m_size;
+
+public:
+#if defined DSAS_LINUX
+    LogFile() : m_fd(-1), m_size(0) {}
+#else
+    LogFile() : m_fp(nullptr), m_size(0) {}
+#endif
+    ~LogFile() {this->close();}
+    LogFile(const LogFile&) = delete;
+    LogFile& operator= (const LogFile&) = delete;
+
+    /** 打开日志文件，不存在时创建 */
+    bool    open(const char* path)
+    {
+        this->close();
+#if defined DSAS_LINUX
+        this->m_fd = ::open(path, O_RDWR | O_CREAT, 0644);
+        if (this->m_fd < 0)
+            return false;
+        struct stat st;
+        this->m_size = (fstat(this->m_fd, &st) == 0) ? st.st_size : 0;
+#else
+        this->m_fp = std::fopen(path, "r+b");
+        if (!this->m_fp)
+            this->m_fp = std::fopen(path, "w+b");
+        if (!this->m_fp)
+            return false;
+        std::fseek(this->m_fp, 0, SEEK_END);
+        this->m_size = std::ftell(this->m_fp);
+#endif
+        return true;
+    }
+    /** 关闭文件 */
+    void    close()
+    {
+#if defined DSAS_LINUX
+        if (this->m_fd >= 0)
+            ::close(this->m_fd);
+        this->m_fd = -1;
+#else
+        if (this->m_fp)
+            std::fclose(this->m_fp);
+        this->m_fp = nullptr;
+#endif
+        this->m_size = 0;
+    }
+    long long size() const {return this->m_size;}
+
+    /** 读取[off, off+n)，不足n字节时返回false */
+    bool    read(long long off, void* buf, long long n)
+    {
+#if defined DSAS_LINUX
+        char* p = static_cast<char*>(buf);
+        while (n > 0)
+        {
+            ssize_t r = ::pread(this->m_fd, p, n, off);
+            if (r <= 0)
+                return false;
+            p += r;
+            off += r;
+            n -= r;
+        }
+        return true;
+#else
+        if (std::fseek(this->m_fp, (long)off, SEEK_SET) != 0)
+            return false;
+        return std::fread(buf, 1, (size_t)n, this->m_fp) == (size_t)n;
+#endif
+    }
+    /** 追加到文件末尾 */
+    bool    append(const void* buf, long long n)
+    {
+#if defined DSAS_LINUX
+        const char* p = static_cast<const char*>(buf);
+        long long off = this->m_size;
+        while (n > 0)
+        {
+            ssize_t w = ::pwrite(this->m_fd, p, n, off);
+            if (w <= 0)
+                return false;
+            p += w;
+            off += w;
+            n -= w;
+        }
+        this->m_size = off;
+        return true;
+#else
+        if (std::fseek(this->m_fp, (long)this->m_size, SEEK_SET) != 0
+            || std::fwrite(buf, 1, (size_t)n, this->m_fp) != (size_t)n)
+            return false;
+        this->m_size += n;
+        return true;
+#endif
+    }
+    /** 截断到len字节 */
+    bool    truncate(long long len)
+    {
+        this->m_size = len;
+#if defined DSAS_LINUX
+        return ::ftruncate(this->m_fd, len) == 0;
+#else
+        return true;
+#endif
+    }
+    /** 将已写入的数据刷到磁盘 */
+    bool    sync()
+    {
+#if defined DSAS_LINUX
+        return ::fdatasync(this->m_fd) == 0;
+#else
+        return std::fflush(this->m_fp) == 0;
+#endif
+    }
+};
+
+/*!
+ * @brief 崩溃安全的持久化b-树(b-tree)类
+ *
+ * <pre>
+ * 节点布局与DiskBTree相同（一页一个节点，自顶向下的一趟插入/删除），另外：
+ *
+ * (1) 写时复制：节点页头记录写入它的检查点编号txn，修改一个不属于当前检查点的节点时，
+ *     先复制到新页再修改，并更新父节点中的页号（父节点已先被复制），原页待检查点完成后才回收；
+ *     故上一个检查点的所有页在磁盘上保持不变，缓冲池换出脏页也不会破坏它。
+ * (2) 原子切换树根：第0页有两个元数据槽，分处不同的512字节扇区，检查点txn只写入槽(txn % 2)，
+ *     写入不完整时只破坏这一个槽，打开时取校验和正确且txn较大者；
+ *     检查点依次：提交日志 -> 写回新页并fsync -> 写入元数据槽并fsync -> 清空日志，
+ *     任一步崩溃，都能回到上一个或新的检查点。
+ * (3) 预写日志：每次插入/删除在修改节点后，向日志缓冲追加一条记录[lsn|op|sum|key]，
+ *     缓冲中的记录数达到组大小（或调用commit）时，一次写入并fsync（组提交，多次操作分摊一次fsync）；
+ *     commit返回后，这些操作在崩溃后仍然有效。
+ * (4) 恢复：打开时载入有效的检查点，再按序重放日志中lsn大于检查点lsn的记录，
+ *     遇到校验和错误（写入不完整）或序号不连续的记录即停止，并截掉其后的部分。
+ * (5) 空闲页：检查点时将空闲页号写入空闲页表页，表页取自可直接复用的空闲页（不足时才在文件末尾分配），
+ *     并从写入的页号中去掉；只有上一个空闲页表所占的页须保持不变，新元数据落盘后它们变为空闲。
+ *     故反复做检查点时文件不会增长。
+ * (6) 读写失败：插入/删除中途固定页失败时停止并返回false，此时内存中的树可能不完整，
+ *     之后的插入、删除与检查点均返回false（失败前的操作仍可commit），重新打开即从上一个检查点与日志恢复。
+ *
+ * page 0:   slot0 [magic|page_size|t|key_size|txn|lsn|root|size|height|pages|free_head|free_count|sum]
+ *           slot1 [...]                                           (slot1位于偏移DBT_META_SLOT处，页大小至少为其2倍)
+ * page k:   [n|leaf|txn|key[0] ... key[2t-2]|child[0] ... child[2t-1]]    节点页
+ * page f:   [next|count|id ...]                                            空闲页表页
+ *
+ * 只读快速启动：Mapped将页文件整体映射（mmap）到内存，只读取元数据即可查找上一个检查点的内容，
+ * 不经过缓冲池，也不重放日志。
+ * </pre>
+ *
+ */
+template <typename T>
+class DurableBTree
+{
+    static_assert(std::is_trivially_copyable<T>::value, "DurableBTree: T must be trivially copyable");
+
+private:
+    /** 元数据（检查点） */
+    struct Meta
+    {
+        unsigned            magic;
+        int                 page_size;
+        int                 t;          /**< 最小度数 */
+        int                 key_size;   /**< sizeof(T)，打开文件时校验 */
+        unsigned long long  txn;        /**< 检查点编号 */
+        unsigned long long  lsn;        /**< 已并入检查点的最后一条日志序号 */
+        int                 root;       /**< 根节点页号 */
+        int                 size;       /**< 关键码总数 */
+        int                 height;     /**< 树高（只有树根时为1） */
+        int                 pages;      /**< 页文件的页数，其后的页为崩溃前未提交的页 */
+        int                 free_head;  /**< 空闲页表的首页，-1表示没有 */
+        int                 free_count; /**< 空闲页数 */
+        unsigned            sum;        /**< 以上字段的校验和 */
+    };
+    /** 节点页的视图，各字段直接指向页数据 */
+    struct Node
+    {
+        int*                n;
+        int*                leaf;
+        unsigned long long* txn;
+        T*                  key;
+        int*                child;
+    };
+    /** 日志记录头，其后紧跟关键码 */
+    struct LogRec
+    {
+        unsigned long long  lsn;
+        int                 op;         /**< 1：插入，2：删除 */
+        unsigned            sum;        /**< lsn、op与关键码的校验和 */
+    };
+    enum {OP_INSERT = 1, OP_REMOVE = 2, REC_SIZE = sizeof(LogRec) + sizeof(T)};
+
+public:
+    class Mapped;
+
+private:
+    dsa::PageFile       m_file;
+    dsa::BufferPool*    m_pool;
+    dsa::LogFile        m_log;
+    Meta                m_meta;         /**< 当前（未提交）的元数据，txn与lsn为上一个检查点的值 */
+    int                 m_child_off;    /**< 页中child数组的偏移 */
+    unsigned long long  m_txn;          /**< 当前检查点编号，txn等于它的页可原地修改 */
+    unsigned long long  m_lsn;          /**< 最后一条日志记录的序号 */
+    dsa::Vector<int>    m_free;         /**< 可直接复用的空闲页 */
+    dsa::Vector<int>    m_pending;      /**< 上一个检查点仍在引用的页，下一个检查点完成后才可复用 */
+    dsa::Vector<int>    m_chain;        /**< 上一个检查点的空闲页表所占的页 */
+    char*               m_logbuf;       /**< 日志缓冲 */
+    int                 m_logn;         /**< 日志缓冲中的记录数 */
+    int                 m_logcap;       /**< 日志缓冲可容纳的记录数 */
+    int                 m_group;        /**< 组提交的记录数 */
+    bool                m_error;        /**< 插入/删除中途固定页失败，内存中的树可能不完整 */
+
+protected:
+    Node    view(char* p) const
+    {
+        Node x;
+        x.n = reinterpret_cast<int*>(p);
+        x.leaf = reinterpret_cast<int*>(p) + 1;
+        x.txn = reinterpret_cast<unsigned long long*>(p + 8);
+        x.key = reinterpret_cast<T*>(p + 16);
+        x.child = reinterpret_cast<int*>(p + this->m_child_off);
+        return x;
+    }
+    /** child数组的偏移 */
+    static int child_offset(int t) {return (int)((16 + (2 * t - 1) * sizeof(T) + 3) / 4 * 4);}
+    /** 页大小能容纳的最大最小度数 */
+    static int max_degree(int page_size)
+    {
+        int t = (int)((page_size - 20) / (sizeof(T) + 4) + 1) / 2;
+        while (t > 2 && child_offset(t) + 8 * t > page_size)
+            t --;
+        return t;
+    }
+    /** 第一个不小于e的位置 */
+    static int lower(const Node& x, const T& e)
+    {
+        int lo = 0, hi = *x.n;
+        while (lo < hi)
+        {
+            int mi = (lo + hi) >> 1;
+            if (dsa::less_than(x.key[mi], e)) lo = mi + 1;
+            else hi = mi;
+        }
+        return lo;
+    }
+    /** FNV-1a校验和 */
+    static unsigned checksum(const void* p, int n, unsigned h = 2166136261u)
+    {
+        const unsigned char* s = static_cast<const unsigned char*>(p);
+        for (int k = 0; k < n; k ++)
+            h = (h ^ s[k]) * 16777619u;
+        return h;
+    }
+    static unsigned meta_sum(const Meta& m) {return checksum(&m, (int)offsetof(Meta, sum));}
+    /** 记录的校验和，rec指向记录头（sum字段不参与计算） */
+    static unsigned rec_sum(const char* rec)
+    {
+        unsigned h = checksum(rec, (int)offsetof(LogRec, sum));
+        return checksum(rec + sizeof(LogRec), (int)sizeof(T), h);
+    }
+    /** 从第0页中选出有效且txn较大的元数据 */
+    static bool pick_meta(const char* page0, Meta& m)
+    {
+        Meta a, b;
+        std::memcpy(&a, page0, sizeof(Meta));
+        std::memcpy(&b, page0 + DBT_META_SLOT, sizeof(Meta));
+        bool va = a.magic == DBT_DURABLE_MAGIC && a.sum == meta_sum(a) && a.key_size == (int)sizeof(T);
+        bool vb = b.magic == DBT_DURABLE_MAGIC && b.sum == meta_sum(b) && b.key_size == (int)sizeof(T);
+        if (!va && !vb)
+            return false;
+        m = (va && (!vb || a.txn > b.txn)) ? a : b;
+        return true;
+    }
+
+    int     alloc_page();
+    void    retire(int, unsigned long long);
+    int     cow(int);
+    int     own_child(Node&, int);
+    int     key_count(int);
+    bool    write_meta(const Meta&);
+    bool    load_free();
+    bool    replay();
+    bool    log(int, const T&);
+    bool    split_child(Node&, int, Node&, dsa::PageGuard&);
+    void    merge_child(Node&, int, Node&, Node&);
+    bool    edge_key(int, bool, T&);
+    bool    do_insert(const T&);
+    bool    do_remove(const T&);
+    /** 记录插入/删除中途失败，返回false */
+    bool    fail() {this->m_error = true; return false;}
+    template <typename VST>
+    void    traverse_at(int, VST&);
+
+public:
+    DurableBTree() : m_pool(nullptr), m_child_off(0), m_txn(0), m_lsn(0),
+                     m_logbuf(nullptr), m_logn(0), m_logcap(0), m_group(WAL_GROUP_DEFAULT),
+                     m_error(false) {}
+    ~DurableBTree() {this->close();}
+    DurableBTree(const DurableBTree&) = delete;
+    DurableBTree& operator= (const DurableBTree&) = delete;
+
+    bool    open(const char* path, const char* log_path, int page_size = PAGE_SIZE_DEFAULT,
+                 int frames = DBT_FRAMES_DEFAULT, int t = 0);
+    bool    commit();
+    bool    checkpoint();
+    void    close();
+    bool    is_open() const {return this->m_pool != nullptr;}
+    /** 设置组提交的记录数，1表示每次操作都提交 */
+    void    set_group(int n) {this->m_group = n < 1 ? 1 : n;}
+
+    /** 返回关键码总数 */
+    int     size() const {return this->m_meta.size;}
+    /** 返回树高 */
+    int     height() const {return this->m_meta.height;}
+    /** 返回最小度数 */
+    int     min_degree() const {return this->m_meta.t;}
+    /** 返回页文件的页数 */
+    int     pages() const {return this->m_file.pages();}
+    /** 返回最后一个检查点的编号 */
+    unsigned long long last_checkpoint() const {return this->m_meta.txn;}
+    /** 获取缓冲池统计 */
+    const dsa::BufferPool::PoolStat& stat() const {return this->m_pool->stat();}
+    /** 清零缓冲池统计 */
+    void    reset_stat() {this->m_pool->reset_stat();}
+
+    bool    search(const T& e, T* out = nullptr);
+    bool    insert(const T& e);
+    int     insert(const T* A, int n);
+    bool    remove(const T& e);
+    /** 按顺序访问所有关键码，visit(const T&) */
+    template <typename VST>
+    void    traverse(VST& visit) {this->traverse_at(this->m_meta.root, visit);}
+};
+
+/*!
+ * @brief 以只读方式映射页文件中最后一个检查点
+ *
+ * <pre>
+ * open只读取第0页的元数据，之后的查找直接访问映射的内存，由操作系统按需调页，
+ * 故启动代价与树的大小无关，且多个进程可共享同一份页缓存。
+ * 不重放日志：上一个检查点之后提交的操作不可见（DurableBTree::close会先做检查点）。
+ * 映射期间页文件不能被写者继续修改（新的检查点可能复用旧检查点的页）。
+ * 非DSAS_LINUX下将整个文件读入内存。
+ * </pre>
+ */
+template <typename T>
+class DurableBTree<T>::Mapped
+{
+private:
+    char*       m_base;
+    long long   m_len;
+    Meta        m_meta;
+    int         m_child_off;
+
+    Node    view(int id) const
+    {
+        char* p = this->m_base + (long long)id * this->m_meta.page_size;
+        Node x;
+        x.n = reinterpret_cast<int*>(p);
+        x.leaf = reinterpret_cast<int*>(p) + 1;
+        x.txn = reinterpret_cast<unsigned long long*>(p + 8);
+        x.key = reinterpret_cast<T*>(p + 16);
+        x.child = reinterpret_cast<int*>(p + this->m_child_off);
+        return x;
+    }
+    template <typename VST>
+    void    traverse_at(int id, VST& visit) const
+    {
+        Node x = this->view(id);
+        for (int k = 0; k < *x.n; k ++)
+        {
+            if (!*x.leaf)
+                this->traverse_at(x.child[k], visit);
+            visit(x.key[k]);
+        }
+        if (!*x.leaf)
+            this->traverse_at(x.child[*x.n], visit);
+    }
+
+public:
+    Mapped() : m_base(nullptr), m_len(0), m_child_off(0) {}
+    ~Mapped() {this->close();}
+    Mapped(const Mapped&) = delete;
+    Mapped& operator= (const Mapped&) = delete;
+
+    /*!
+     * @brief 映射页文件
+     *
+     * @param path: DurableBTree的页文件路径
+     * @return 打开失败或没有有效检查点时返回false
+     * @retval None
+     */
+    bool    open(const char* path)
+    {
+        this->close();
+#if defined DSAS_LINUX
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < 2 * DBT_META_SLOT)
+        {
+            ::close(fd);
+            return false;
+        }
+        void* p = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);                        // 映射在close后仍然有效
+        if (p == MAP_FAILED)
+            return false;
+        this->m_base = static_cast<char*>(p);
+        this->m_len = st.st_size;
+#else
+        std::FILE* fp = std::fopen(path, "rb");
+        if (!fp)
+            return false;
+        std::fseek(fp, 0, SEEK_END);
+        long len = std::ftell(fp);
+        std::fseek(fp, 0, SEEK_SET);
+        if (len < 2 * DBT_META_SLOT)
+        {
+            std::fclose(fp);
+            return false;
+        }
+        this->m_base = new char[len];
+        this->m_len = len;
+        bool ok = std::fread(this->m_base, 1, len, fp) == (size_t)len;
+        std::fclose(fp);
+        if (!ok)
+        {
+            this->close();
+            return false;
+        }
+#endif
+        if (!DurableBTree<T>::pick_meta(this->m_base, this->m_meta)
+            || (long long)this->m_meta.pages * this->m_meta.page_size > this->m_len)
+        {
+            this->close();
+            return false;
+        }
+        this->m_child_off = DurableBTree<T>::child_offset(this->m_meta.t);
+        return true;
+    }
+    /** 解除映射 */
+    void    close()
+    {
+        if (this->m_base)
+        {
+#if defined DSAS_LINUX
+            ::munmap(this->m_base, this->m_len);
+#else
+            delete[] this->m_base;
+#endif
+        }
+        this->m_base = nullptr;
+        this->m_len = 0;
+    }
+    bool    is_open() const {return this->m_base != nullptr;}
+    int     size() const {return this->m_meta.size;}
+    int     height() const {return this->m_meta.height;}
+
+    /*!
+     * @brief 查找
+     *
+     * @param e: 查找目标
+     * @param out: 不为nullptr时，返回树中与e相等的关键码
+     * @return 不存在时返回false
+     * @retval None
+     */
+    bool    search(const T& e, T* out = nullptr) const
+    {
+        int id = this->m_meta.root;
+        for (;;)
+        {
+            Node x = this->view(id);
+            int i = DurableBTree<T>::lower(x, e);
+            if (i < *x.n && !dsa::less_than(e, x.key[i]))
+            {
+                if (out) *out = x.key[i];
+                return true;
+            }
+            if (*x.leaf)
+                return false;
+            id = x.child[i];
+        }
+    }
+    /** 按顺序访问所有关键码，visit(const T&) */
+    template <typename VST>
+    void    traverse(VST& visit) const {this->traverse_at(this->m_meta.root, visit);}
+};
+
+/*! @} */
+
+
+/*!
+ * @brief 打开（或创建）b-tree文件，并从日志恢复
+ *
+ * @param path: 页文件路径
+ * @param log_path: 日志文件路径
+ * @param page_size: 页大小（字节），至少为2*DBT_META_SLOT，打开已有文件时以文件中记录的为准
+ * @param frames: 缓冲池页帧数
+ * @param t: 最小度数，0表示由页大小决定（创建文件时有效）
+ * @return 打开失败、文件格式不符或没有有效检查点时返回false
+ * @retval None
+ */
+template <typename T>
+bool DurableBTree<T>::open(const char* path, const char* log_path, int page_size, int frames, int t)
+{
+    this->close();
+    if (page_size < 2 * DBT_META_SLOT)
+        page_size = 2 * DBT_META_SLOT;
+    if (!this->m_file.open(path, page_size) || !this->m_log.open(log_path))
+    {
+        this->close();
+        return false;
+    }
+    this->m_free.clear();
+    this->m_pending.clear();
+    this->m_chain.clear();
+    this->m_logn = 0;
+    this->m_error = false;
+
+    if (this->m_file.pages() > 0)
+    {
+        // 已有文件：载入最后一个有效的检查点，丢弃其后未提交的页
+        char* buf = new char[page_size];
+        bool ok = this->m_file.read(0, buf) && pick_meta(buf, this->m_meta);
+        delete[] buf;
+        if (!ok || this->m_meta.page_size < 2 * DBT_META_SLOT
+            || (this->m_meta.page_size != page_size && !this->m_file.open(path, this->m_meta.page_size)))
+        {
+            this->close();
+            return false;
+        }
+        this->m_file.resize(this->m_meta.pages);
+        this->m_child_off = child_offset(this->m_meta.t);
+        this->m_txn = this->m_meta.txn + 1;
+        this->m_lsn = this->m_meta.lsn;
+        this->m_pool = new dsa::BufferPool(this->m_file, frames);
+        if (!this->load_free() || !this->replay() || this->m_error)
+        {
+            this->close();
+            return false;
+        }
+        return true;
+    }
+
+    // 新文件：元数据页与一个空的根节点，作为第1个检查点
+    int tmax = max_degree(page_size);
+    std::memset(&this->m_meta, 0, sizeof(Meta));
+    this->m_meta.magic = DBT_DURABLE_MAGIC;
+    this->m_meta.page_size = page_size;
+    this->m_meta.t = (t >= 2 && t < tmax) ? t : tmax;
+    this->m_meta.key_size = (int)sizeof(T);
+    this->m_meta.height = 1;
+    this->m_meta.free_head = -1;
+    this->m_child_off = child_offset(this->m_meta.t);
+    this->m_txn = 1;
+    this->m_lsn = 0;
+    this->m_log.truncate(0);
+    this->m_pool = new dsa::BufferPool(this->m_file, frames);
+    this->m_file.allocate();
+    this->m_meta.root = this->alloc_page();
+    {
+        dsa::PageGuard g(*this->m_pool, this->m_meta.root, true);
+        if (!g.data())
+            this->m_error = true;
+        else
+        {
+            Node r = this->view(g.data());
+            *r.n = 0;
+            *r.leaf = 1;
+            *r.txn = this->m_txn;
+        }
+    }
+    if (!this->checkpoint())
+    {
+        this->close();
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * @brief 提交日志缓冲（组提交）：一次写入并fsync，之后这些操作在崩溃后仍然有效
+ *
+ * 写入失败时日志截回原长度，缓冲中的记录保留，下次提交时从同一位置重写，日志中不会留下缺口。
+ *
+ * @param None
+ * @return 写入失败时返回false
+ * @retval None
+ */
+template <typename T>
+bool DurableBTree<T>::commit()
+{
+    if (!this->m_pool)
+        return false;
+    if (this->m_logn == 0)
+        return true;
+    long long at = this->m_log.size();
+    if (!this->m_log.append(this->m_logbuf, (long long)this->m_logn * REC_SIZE) || !this->m_log.sync())
+    {
+        this->m_log.truncate(at);
+        return false;
+    }
+    this->m_logn = 0;
+    return this->m_log.size() < WAL_CHECKPOINT_SIZE || this->checkpoint();
+}
+
+/*!
+ * @brief 检查点：写回新页，原子切换元数据，之后清空日志
+ *
+ * @param None
+ * @return 写入失败或此前插入/删除中途失败时返回false（此时上一个检查点与日志仍然有效）
+ * @retval None
+ */
+template <typename T>
+bool DurableBTree<T>::checkpoint()
+{
+    if (this->m_error || !this->commit())
+        return false;
+
+    // 空闲页表：现有空闲页 + 本轮待回收的页 + 上一个空闲页表的页；
+    // 表页取自现有空闲页（不足时在文件末尾分配），上一个空闲页表的页在新元数据落盘前不能覆盖
+    const int per = (this->m_meta.page_size - 8) / 4;
+    const int rest = this->m_pending.size() + this->m_chain.size();
+    int nf = this->m_free.size();
+    int need = 0;
+    while ((nf - (need < nf ? need : nf) + rest + per - 1) / per > need)
+        need ++;
+    dsa::Vector<int> chain(need);
+    for (int k = 0; k < need; k ++)
+        chain.push_back(k < nf ? this->m_free[nf - 1 - k] : this->m_file.allocate());
+    dsa::Vector<int> all(nf + rest + 1);
+    for (int k = 0; k < nf - need; k ++)
+        all.push_back(this->m_free[k]);
+    all += this->m_pending;
+    all += this->m_chain;
+    while (chain.size() > 0 && (all.size() + per - 1) / per < chain.size())
+        all.push_back(chain.remove(chain.size() - 1));  // 多取的表页仍为空闲页
+
+    int head = -1;
+    for (int c = 0, lo = (all.size() - 1) / per * per; lo >= 0 && all.size() > 0; c ++, lo -= per)
+    {
+        int cnt = (all.size() - lo < per) ? all.size() - lo : per;
+        int id = chain[c];
+        dsa::PageGuard g(*this->m_pool, id, true);
+        if (!g.data())
+            return false;
+        int* p = reinterpret_cast<int*>(g.data());
+        p[0] = head;
+        p[1] = cnt;
+        for (int k = 0; k < cnt; k ++)
+            p[2 + k] = all[lo + k];
+        head = id;
+    }
+    if (!this->m_pool->flush() || !this->m_file.sync())
+        return false;
+
+    Meta m = this->m_meta;
+    m.txn = this->m_txn;
+    m.lsn = this->m_lsn;
+    m.pages = this->m_file.pages();
+    m.free_head = head;
+    m.free_count = all.size();
+    m.sum = meta_sum(m);
+    if (!this->write_meta(m))
+        return false;
+
+    this->m_meta = m;
+    this->m_free = all;
+    this->m_pending.clear();
+    this->m_chain = chain;
+    this->m_txn ++;
+    this->m_log.truncate(0);                // 截断前崩溃也无妨：lsn不大于检查点的记录不会重放
+    return true;
+}
+
+/** 关闭文件（先做检查点） */
+template <typename T>
+void DurableBTree<T>::close()
+{
+    if (this->m_pool)
+    {
+        this->checkpoint();
+        delete this->m_pool;
+        this->m_pool = nullptr;
+    }
+    this->m_file.close();
+    this->m_log.close();
+    delete[] this->m_logbuf;
+    this->m_logbuf = nullptr;
+    this->m_logn = 0;
+    this->m_logcap = 0;
+}
+
+/** 只将元数据写入槽(txn % 2)并刷到磁盘，另一个槽（位于另一扇区）不被重写 */
+template <typename T>
+bool DurableBTree<T>::write_meta(const Meta& m)
+{
+    return this->m_file.write(0, (int)(m.txn % 2) * DBT_META_SLOT, &m, (int)sizeof(Meta)) && this->m_file.sync();
+}
+
+/** 读取检查点的空闲页表 */
+template <typename T>
+bool DurableBTree<T>::load_free()
+{
+    for (int id = this->m_meta.free_head; id >= 0; )
+    {
+        if (id >= this->m_meta.pages || this->m_chain.size() > this->m_meta.pages)
+            return false;
+        dsa::PageGuard g(*this->m_pool, id);
+        if (!g.data())
+            return false;
+        const int* p = reinterpret_cast<const int*>(g.data());
+        for (int k = 0; k < p[1]; k ++)
+            this->m_free.push_back(p[2 + k]);
+        this->m_chain.push_back(id);
+        id = p[0];
+    }
+    return this->m_free.size() == this->m_meta.free_count;
+}
+
+/*!
+ * @brief 重放日志中检查点之后的记录
+ *
+ * 记录的lsn须从检查点的lsn+1开始连续递增；校验和错误（写入不完整）或序号不连续时停止，
+ * 并截掉其后的部分，之后的记录从这里继续追加。
+ *
+ * @param None
+ * @return 读取日志失败时返回false
+ * @retval None
+ */
+template <typename T>
+bool DurableBTree<T>::replay()
+{
+    long long len = this->m_log.size();
+    if (len == 0)
+        return true;
+    char* buf = new char[len];
+    if (!this->m_log.read(0, buf, len))
+    {
+        delete[] buf;
+        return false;
+    }
+    long long off = 0;
+    for (; off + REC_SIZE <= len; off += REC_SIZE)
+    {
+        LogRec h;
+        std::memcpy(&h, buf + off, sizeof(LogRec));
+        if (h.sum != rec_sum(buf + off))
+            break;
+        if (h.lsn <= this->m_meta.lsn)
+            continue;                       // 已并入检查点（检查点后截断日志前崩溃）
+        if (h.lsn != this->m_lsn + 1)
+            break;
+        T key;
+        std::memcpy(&key, buf + off + sizeof(LogRec), sizeof(T));
+        if (h.op == OP_INSERT)
+            this->do_insert(key);
+        else
+            this->do_remove(key);
+        this->m_lsn = h.lsn;
+    }
+    delete[] buf;
+    return off == len || this->m_log.truncate(off);
+}
+
+/*!
+ * @brief 向日志缓冲追加一条记录，缓冲满一组时提交
+ *
+ * @param op: OP_INSERT或OP_REMOVE
+ * @param e: 关键码
+ * @return 提交失败时返回false
+ * @retval None
+ */
+template <typename T>
+bool DurableBTree<T>::log(int op, const T& e)
+{
+    if (this->m_logn >= this->m_logcap)
+    {
+        int cap = this->m_logcap ? 2 * this->m_logcap : (this->m_group < 64 ? 64 : this->m_group);
+        char* nb = new char[(long long)cap * REC_SIZE];
+        if (this->m_logbuf)
+            std::memcpy(nb, this->m_logbuf, (long long)this->m_logn * REC_SIZE);
+        delete[] this->m_logbuf;
+        this->m_logbuf = nb;
+        this->m_logcap = cap;
+    }
+    char* rec = this->m_logbuf + (long long)this->m_logn * REC_SIZE;
+    LogRec h;
+    std::memset(&h, 0, sizeof(LogRec));
+    h.lsn = ++ this->m_lsn;
+    h.op = op;
+    std::memcpy(rec, &h, sizeof(LogRec));
+    std::memcpy(rec + sizeof(LogRec), &e, sizeof(T));
+    h.sum = rec_sum(rec);
+    std::memcpy(rec, &h, sizeof(LogRec));
+    this->m_logn ++;
+    return this->m_logn < this->m_group || this->commit();
+}
+
+/** 分配一页，优先复用空闲页；调用者需以fresh方式固定该页 */
+template <typename T>
+int DurableBTree<T>::alloc_page()
+{
+    if (this->m_free.is_empty())
+        return this->m_file.allocate();
+    return this->m_free.remove(this->m_free.size() - 1);
+}
+
+/** 回收一页：当前检查点分配的页可直接复用，否则须等下一个检查点完成 */
+template <typename T>
+void DurableBTree<T>::retire(int id, unsigned long long txn)
+{
+    if (txn == this->m_txn)
+        this->m_free.push_back(id);
+    else
+        this->m_pending.push_back(id);
+}
+
+/*!
+ * @brief 写时复制：节点不属于当前检查点时，复制到新页
+ *
+ * @param id: 节点页号
+ * @return 返回可原地修改的页号（调用者负责更新父节点中的页号），固定页失败时返回-1
+ * @retval None
+ */
+template <typename T>
+int DurableBTree<T>::cow(int id)
+{
+    dsa::PageGuard g(*this->m_pool, id);
+    if (!g.data())
+        return -1;
+    Node x = this->view(g.data());
+    if (*x.txn == this->m_txn)
+        return id;
+    int nid = this->alloc_page();
+    dsa::PageGuard ng(*this->m_pool, nid, true);
+    if (!ng.data())
+    {
+        this->m_free.push_back(nid);
+        return -1;
+    }
+    std::memcpy(ng.data(), g.data(), this->m_meta.page_size);
+    *this->view(ng.data()).txn = this->m_txn;
+    this->retire(id, *x.txn);
+    return nid;
+}
+
+/** 复制x的第i个子节点并更新x中的页号（x已属于当前检查点，调用者负责标记为脏页），失败时返回-1且x不变 */
+template <typename T>
+int DurableBTree<T>::own_child(Node& x, int i)
+{
+    int id = this->cow(x.child[i]);
+    if (id >= 0)
+        x.child[i] = id;
+    return id;
+}
+
+/** 节点的关键码数，固定页失败时返回-1 */
+template <typename T>
+int DurableBTree<T>::key_count(int id)
+{
+    dsa::PageGuard g(*this->m_pool, id);
+    return g.data() ? *this->view(g.data()).n : -1;
+}
+
+/*!
+ * @brief 分裂x的第i个子节点y（y已满），与DiskBTree::split_child相同
+ *
+ * @param x: 父节点（不满，已属于当前检查点），调用者负责标记为脏页
+ * @param i: y在x中的位置
+ * @param y: 满的子节点（已属于当前检查点）
+ * @param yg: y的页固定
+ * @return 固定新页失败时返回false，此时x与y不变
+ * @retval None
+ */
+template <typename T>
+bool DurableBTree<T>::split_child(Node& x, int i, Node& y, dsa::PageGuard& yg)
+{
+    const int t = this->m_meta.t;
+    int zid = this->alloc_page();
+    dsa::PageGuard zg(*this->m_pool, zid, true);
+    if (!zg.data())
+    {
+        this->m_free.push_back(zid);
+        return false;
+    }
+    Node z = this->view(zg.data());
+
+    *z.leaf = *y.leaf;
+    *z.txn = this->m_txn;
+    *z.n = t - 1;
+    std::memcpy(z.key, y.key + t, (t - 1) * sizeof(T));
+    if (!*y.leaf)
+        std::memcpy(z.child, y.child + t, t * sizeof(int));
+    *y.n = t - 1;
+    yg.mark_dirty();
+
+    std::memmove(x.key + i + 1, x.key + i, (*x.n - i) * sizeof(T));
+    std::memmove(x.child + i + 2, x.child + i + 1, (*x.n - i) * sizeof(int));
+    x.child[i + 1] = zid;
+    x.key[i] = y.key[t - 1];
+    (*x.n) ++;
+    return true;
+}
+
+/*!
+ * @brief 合并x的第i个与第i+1个子节点：y吸收x.key[i]与z的全部内容，z的页被回收
+ *
+ * @param x: 父节点（已属于当前检查点），调用者负责标记为脏页
+ * @param i: y在x中的位置
+ * @param y: 左子节点（已属于当前检查点），调用者负责标记为脏页
+ * @param z: 右子节点（只读）
+ * @return
+ * @retval None
+ */
+template <typename T>
+void DurableBTree<T>::merge_child(Node& x, int i, Node& y, Node& z)
+{
+    int n = *y.n;
+    int zid = x.child[i + 1];
+    y.key[n] = x.key[i];
+    std::memcpy(y.key + n + 1, z.key, *z.n * sizeof(T));
+    if (!*y.leaf)
+        std::memcpy(y.child + n + 1, z.child, (*z.n + 1) * sizeof(int));
+    *y.n = n + 1 + *z.n;
+
+    std::memmove(x.key + i, x.key + i + 1, (*x.n - 1 - i) * sizeof(T));
+    std::memmove(x.child + i + 1, x.child + i + 2, (*x.n - 1 - i) * sizeof(int));
+    (*x.n) --;
+    this->retire(zid, *z.txn);
+}
+
+/** 子树中的最大（max为true）或最小关键码，固定页失败时返回false */
+template <typename T>
+bool DurableBTree<T>::edge_key(int id, bool max, T& out)
+{
+    for (;;)
+    {
+        dsa::PageGuard g(*this->m_pool, id);
+        if (!g.data())
+            return false;
+        Node x = this->view(g.data());
+        if (*x.leaf)
+        {
+            out = x.key[max ? *x.n - 1 : 0];
+            return true;
+        }
+        id = x.child[max ? *x.n : 0];
+    }
+}
+
+/*!
+ * @brief 查找
+ *
+ * @param e: 查找目标
+ * @param out: 不为nullptr时，返回树中与e相等的关键码
+ * @return 不存在或读取页失败时返回false
+ * @retval None
+ */
+template <typename T>
+bool DurableBTree<T>::search(const T& e, T* out)
+{
+    int id = this->m_meta.root;
+    for (;;)
+    {
+        dsa::PageGuard g(*this->m_pool, id);
+        if (!g.data())
+            return false;
+        Node x = this->view(g.data());
+        int i = lower(x, e);
+        if (i < *x.n && !dsa::less_than(e, x.key[i]))
+        {
+            if (out) *out = x.key[i];
+            return true;
+        }
+        if (*x.leaf)
+            return false;
+        id = x.child[i];
+    }
+}
+
+/*!
+ * @brief 插入，修改后写日志（可能触发组提交）
+ *
+ * @param e: 插入目标
+ * @return 已存在、读写页失败或提交失败时返回false
+ * @retval None
+ */
+template <typename T>
+bool DurableBTree<T>::insert(const T& e)
+{
+    return this->do_insert(e) && this->log(OP_INSERT, e);
+}
+
+/*!
+ * @brief 批量插入，最后提交一次
+ *
+ * @param A: 关键码数组
+ * @param n: 关键码数
+ * @return 返回插入的关键码数（不含已存在的），提交失败时返回-1
+ * @retval None
+ */
+template <typename T>
+int DurableBTree<T>::insert(const T* A, int n)
+{
+    int cnt = 0;
+    for (int k = 0; k < n; k ++)
+    {
+        if (!this->do_insert(A[k]))
+            continue;
+        cnt ++;
+        if (!this->log(OP_INSERT, A[k]))
+            return -1;
+    }
+    return this->commit() ? cnt : -1;
+}
+
+/*!
+ * @brief 删除，修改后写日志（可能触发组提交）
+ *
+ * @param e: 删除目标
+ * @return 不存在、读写页失败或提交失败时返回false
+ * @retval None
+ */
+template <typename T>
+bool DurableBTree<T>::remove(const T& e)
+{
+    return this->do_remove(e) && this->log(OP_REMOVE, e);
+}
+
+/*!
+ * @brief 插入（自顶向下，沿途复制并分裂满节点）
+ *
+ * 先只读查找，关键码已存在时不复制路径上的节点。
+ * 固定页失败时停止（见类说明(6)）。
+ *
+ * @param e: 插入目标
+ * @return 已存在或固定页失败时返回false
+ * @retval None
+ */
+template <typename T>
+bool DurableBTree<T>::do_insert(const T& e)
+{
+    if (this->m_error || this->search(e))
+        return false;
+    const int t = this->m_meta.t;
+    int rid = this->cow(this->m_meta.root);
+    if (rid < 0)
+        return this->fail();
+    this->m_meta.root = rid;
+    {
+        // 树根已满：新建树根，原树根作为其唯一的子节点后分裂，树高加1
+        dsa::PageGuard rg(*this->m_pool, this->m_meta.root);
+        if (!rg.data())
+            return this->fail();
+        Node r = this->view(rg.data());
+        if (*r.n == 2 * t - 1)
+        {
+            int sid = this->alloc_page();
+            dsa::PageGuard sg(*this->m_pool, sid, true);
+            if (!sg.data())
+            {
+                this->m_free.push_back(sid);
+                return this->fail();
+            }
+            Node s = this->view(sg.data());
+            *s.leaf = 0;
+            *s.n = 0;
+            *s.txn = this->m_txn;
+            s.child[0] = this->m_meta.root;
+            if (!this->split_child(s, 0, r, rg))
+            {
+                this->m_free.push_back(sid);
+                return this->fail();
+            }
+            this->m_meta.root = sid;
+            this->m_meta.height ++;
+        }
+    }
+
+    int id = this->m_meta.root;
+    for (;;)
+    {
+        dsa::PageGuard g(*this->m_pool, id);
+        if (!g.data())
+            return this->fail();
+        Node x = this->view(g.data());
+        int i = lower(x, e);
+        g.mark_dirty();
+        if (*x.leaf)
+        {
+            std::memmove(x.key + i + 1, x.key + i, (*x.n - i) * sizeof(T));
+            x.key[i] = e;
+            (*x.n) ++;
+            this->m_meta.size ++;
+            return true;
+        }
+
+        int cid = this->own_child(x, i);
+        if (cid < 0)
+            return this->fail();
+        dsa::PageGuard cg(*this->m_pool, cid);
+        if (!cg.data())
+            return this->fail();
+        Node c = this->view(cg.data());
+        if (*c.n == 2 * t - 1)
+        {
+            if (!this->split_child(x, i, c, cg))
+                return this->fail();
+            if (dsa::less_than(x.key[i], e))
+                cid = x.child[i + 1];
+        }
+        id = cid;
+    }
+}
+
+/*!
+ * @brief 删除（自顶向下，下降前复制子节点并保证其至少有t个关键码）
+ *
+ * 各情形与DiskBTree::remove相同；兄弟节点只在被修改（借出关键码或作为合并的左节点）时复制，
+ * 被合并掉的右节点只读取后回收。先只读查找，关键码不存在时不复制路径上的节点。
+ * 固定页失败时停止，此时树可能已不完整（见类说明(6)）。
+ *
+ * @param e: 删除目标
+ * @return 不存在或固定页失败时返回false
+ * @retval None
+ */
+template <typename T>
+bool DurableBTree<T>::do_remove(const T& e)
+{
+    if (this->m_error || !this->search(e))
+        return false;
+    const int t = this->m_meta.t;
+    T key = e;
+    int rid = this->cow(this->m_meta.root);
+    if (rid < 0)
+        return this->fail();
+    this->m_meta.root = rid;
+    int id = this->m_meta.root;
+    for (;;)
+    {
+        dsa::PageGuard g(*this->m_pool, id);
+        if (!g.data())
+            return this->fail();
+        Node x = this->view(g.data());
+        int i = lower(x, key);
+        bool hit = i < *x.n && !dsa::less_than(key, x.key[i]);
+        g.mark_dirty();
+
+        if (*x.leaf)
+        {
+            // 查找已确认存在，内部节点中的目标已替换为前驱或后继，故目标必在叶节点x中
+            if (hit)
+            {
+                std::memmove(x.key + i, x.key + i + 1, (*x.n - 1 - i) * sizeof(T));
+                (*x.n) --;
+            }
+            break;
+        }
+
+        if (hit)
+        {
+            int yn = this->key_count(x.child[i]);
+            int zn = (yn >= 0 && yn < t) ? this->key_count(x.child[i + 1]) : 0;
+            if (yn < 0 || zn < 0)
+                return this->fail();
+            if (yn >= t || zn >= t)
+            {
+                int side = (yn >= t) ? i : i + 1;               // (2a)前驱 或 (2b)后继
+                int cid = this->own_child(x, side);
+                if (cid < 0 || !this->edge_key(cid, yn >= t, key))
+                    return this->fail();
+                x.key[i] = key;
+                id = cid;
+                continue;
+            }
+            int yid = this->own_child(x, i);                   // (2c)
+            if (yid < 0)
+                return this->fail();
+            dsa::PageGuard yg(*this->m_pool, yid);
+            dsa::PageGuard zg(*this->m_pool, x.child[i + 1]);
+            if (!yg.data() || !zg.data())
+                return this->fail();
+            Node y = this->view(yg.data()), z = this->view(zg.data());
+            this->merge_child(x, i, y, z);
+            yg.mark_dirty();
+            id = yid;
+            continue;
+        }
+
+        int cn = this->key_count(x.child[i]);
+        if (cn < 0)
+            return this->fail();
+        if (cn == t - 1)
+        {
+            int ln = (i > 0) ? this->key_count(x.child[i - 1]) : -1;
+            int rn = (i < *x.n) ? this->key_count(x.child[i + 1]) : -1;
+            if ((i > 0 && ln < 0) || (i < *x.n && rn < 0))
+                return this->fail();
+            if (ln >= t)
+            {
+                // (3a) 从左兄弟借
+                int lid = this->own_child(x, i - 1), cid = (lid < 0) ? -1 : this->own_child(x, i);
+                if (cid < 0)
+                    return this->fail();
+                dsa::PageGuard lg(*this->m_pool, lid), cg(*this->m_pool, cid);
+                if (!lg.data() || !cg.data())
+                    return this->fail();
+                Node l = this->view(lg.data()), c = this->view(cg.data());
+                std::memmove(c.key + 1, c.key, *c.n * sizeof(T));
+                if (!*c.leaf)
+                {
+                    std::memmove(c.child + 1, c.child, (*c.n + 1) * sizeof(int));
+                    c.child[0] = l.child[*l.n];
+                }
+                c.key[0] = x.key[i - 1];
+                x.key[i - 1] = l.key[*l.n - 1];
+                (*l.n) --;
+                (*c.n) ++;
+                lg.mark_dirty();
+                cg.mark_dirty();
+                id = cid;
+                continue;
+            }
+            if (rn >= t)
+            {
+                // (3a) 从右兄弟借
+                int cid = this->own_child(x, i), rid = (cid < 0) ? -1 : this->own_child(x, i + 1);
+                if (rid < 0)
+                    return this->fail();
+                dsa::PageGuard cg(*this->m_pool, cid), rg(*this->m_pool, rid);
+                if (!cg.data() || !rg.data())
+                    return this->fail();
+                Node c = this->view(cg.data()), r = this->view(rg.data());
+                c.key[*c.n] = x.key[i];
+                if (!*c.leaf)
+                {
+                    c.child[*c.n + 1] = r.child[0];
+                    std::memmove(r.child, r.child + 1, *r.n * sizeof(int));
+                }
+                x.key[i] = r.key[0];
+                std::memmove(r.key, r.key + 1, (*r.n - 1) * sizeof(T));
+                (*r.n) --;
+                (*c.n) ++;
+                rg.mark_dirty();
+                cg.mark_dirty();
+                id = cid;
+                continue;
+            }
+            if (rn >= 0)
+                i ++;                       // (3b) 与右兄弟合并，否则与左兄弟合并：均合并child[i-1]与child[i]
+            int lid = this->own_child(x, i - 1);
+            if (lid < 0)
+                return this->fail();
+            dsa::PageGuard lg(*this->m_pool, lid);
+            dsa::PageGuard cg(*this->m_pool, x.child[i]);
+            if (!lg.data() || !cg.data())
+                return this->fail();
+            Node l = this->view(lg.data()), c = this->view(cg.data());
+            this->merge_child(x, i - 1, l, c);
+            lg.mark_dirty();
+            id = lid;
+            continue;
+        }
+        id = this->own_child(x, i);
+        if (id < 0)
+            return this->fail();
+    }
+
+    // 树根变空（且不是叶节点）时，唯一的子节点成为新树根
+    {
+        dsa::PageGuard rg(*this->m_pool, this->m_meta.root);
+        if (!rg.data())
+            return this->fail();
+        Node r = this->view(rg.data());
+        if (*r.n == 0 && !*r.leaf)
+        {
+            int old = this->m_meta.root;
+            unsigned long long txn = *r.txn;
+            this->m_meta.root = r.child[0];
+            this->m_meta.height --;
+            rg.release();
+            this->retire(old, txn);
+        }
+    }
+    this->m_meta.size --;
+    return true;
+}
+
+/** 中序遍历以id为根的子树，递归前解除固定，同时固定的页数不随树高增加 */
+template <typename T>
+template <typename VST>
+void DurableBTree<T>::traverse_at(int id, VST& visit)
+{
+    int n;
+    {
+        dsa::PageGuard g(*this->m_pool, id);
+        if (!g.data())
+            return;
+        Node x = this->view(g.data());
+        n = *x.n;
+        if (*x.leaf)
+        {
+            for (int k = 0; k < n; k ++)
+                visit(x.key[k]);
+            return;
+        }
+    }
+    for (int k = 0; k <= n; k ++)
+    {
+        int c;
+        T key;
+        {
+            dsa::PageGuard g(*this->m_pool, id);
+            if (!g.data())
+                return;
+            Node x = this->view(g.data());
+            c = x.child[k];
+            if (k < n) key = x.key[k];
+        }
+        this->traverse_at(c, visit);
+        if (k < n)
+            visit(key);
+    }
+}
+
+} /* dsa */
+
+#endif /* ifndef DSAS_B_TREE_DURABLE_H */
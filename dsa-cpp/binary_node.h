@@ -14,6 +14,7 @@
 #ifndef DSAS_BINARY_NODE_H
 #define DSAS_BINARY_NODE_H
 
+#include "share/pool.h"
 #include "stack.h"
 #include "queue.h"
 
@@ -44,7 +45,7 @@ namespace dsa
 /** 获取节点x在父节点中的孩子节点指针引用，用于设置父节点的孩子节点，m_root为BinTree中的根节点 */
 #define RefFromParent(x)    (BN_IsRoot(x) ? this->m_root : (BN_IsLeftChild(x) ? (x).parent->left : (x).parent->right))
 
-#define BN_IsBlack(x)       (!(x) || (dsa::RBColor::Black == (x)->color))   // 红黑树external nodes均为黑
+#define BN_IsBlack(x)       (!(x) || (dsa::RBColor::Black == (x)->get_color()))  // 红黑树external nodes均为黑
 #define BN_IsRed(x)         (!BN_IsBlack(x))                                // 非黑即红
 
 /** 检测黑高度是否正确 */
@@ -52,6 +53,23 @@ namespace dsa
    ( BN_Stature((x).left) == BN_Stature((x).right)) && \
    ((x).height == ( BN_IsRed(&x) ? BN_Stature((x).left) : BN_Stature((x).left )+1)))
 
+/** 节点从共享的NodePool分配（定义为0时，使用全局new/delete，便于内存检测工具定位问题） */
+#ifndef BN_USE_POOL
+#define BN_USE_POOL         1
+#endif
+
+/** 节点维护子树规模cnt，用于select/rank等顺序统计（定义为0时不维护） */
+#ifndef BN_ORDER_STAT
+#define BN_ORDER_STAT       1
+#endif
+
+#if BN_ORDER_STAT
+#define BN_Count(x)         ((x) ? (x)->cnt : 0)        /**< 子树节点数量（空树为0） */
+#define BN_UpdateCount(x)   ((x).cnt = 1 + BN_Count((x).left) + BN_Count((x).right))
+#else
+#define BN_UpdateCount(x)   ((void)0)
+#endif
+
 /*! @} */
 
 
@@ -60,8 +78,8 @@ namespace dsa
  * @{
  */
 
-/** 红黑节点 */
-typedef enum
+/** 红黑节点（只占一个字节） */
+typedef enum : unsigned char
 {
     Red,
     Black
@@ -85,39 +103,34 @@ using BinNodePtr = struct BinNode<T>*;
 
 
 /*!
- * @brief 二叉树节点
- * T类型需要实现'<'运算符，或用CmpOperator对T进行封装。
+ * @brief 二叉树节点的公共操作
+ *
+ * <pre>
+ * 以CRTP方式被各节点类型（BinNode，BinNodeAvl，BinNodeRb，BinNodeIdx）继承，本身不含数据成员。
+ * N需要提供parent/left/right/data成员，以及链接类型N::Link：
+ * 链接可以是指针，也可以是能与N*相互转换的代理（如ColorParent，IndexLink），
+ * 故树中凡是要修改链接本身的引用（如RefFromParent），类型都是typename N::Link&。
+ * </pre>
  */
-template <typename T> struct BinNode
+template <typename N> struct BinNodeBase
 {
-    BinNodePtr<T> parent;
-    BinNodePtr<T> left;
-    BinNodePtr<T> right;
-    T             data;
-    int           height;
-    int           npl;      /**< Null Path Length */
-    RBColor       color;
-
-    BinNode()
-        : parent(nullptr), left(nullptr), right(nullptr), height(0), npl(1),color(RBColor::Red) {}
-    BinNode(const T& e, BinNodePtr<T> p = nullptr, BinNodePtr<T> ll = nullptr, BinNodePtr<T> rr = nullptr,
-            int h = 0, int n = 1, RBColor c = RBColor::Red)
-        : data(e), parent(p), left(ll), right(rr), height(h), npl(n), color(c) {}
+    N*       self()       {return static_cast<N*>(this);}
+    const N* self() const {return static_cast<const N*>(this);}
 
     /** 插入左子节点 */
-    BinNodePtr<T> insert_left(BinNodePtr<T> n) {return this->left = n; n->parent = this;}
+    N* insert_left(N* n) {this->self()->left = n; n->parent = this->self(); return n;}
     /** 插入右子节点 */
-    BinNodePtr<T> insert_right(BinNodePtr<T> n) {return this->right = n; n->parent = this;}
+    N* insert_right(N* n) {this->self()->right = n; n->parent = this->self(); return n;}
     /** 获取子树节点数量 */
     int size() const
     {
         int sum = 1;
-        if(this->left) sum += this->left->size();
-        if(this->right) sum += this->right->size();
+        if(this->self()->left) sum += this->self()->left->size();
+        if(this->self()->right) sum += this->self()->right->size();
         return sum;
     }
-    BinNodePtr<T> successor();
-    BinNodePtr<T> predecessor();
+    N* successor();
+    N* predecessor();
     // 遍历算法
     template <typename VST> void traverse(VST& visit, TraverseType type = DLR);
     template <typename VST> void traverse_DLR(VST& visit);      // 先序
@@ -125,20 +138,273 @@ template <typename T> struct BinNode
     template <typename VST> void traverse_LRD(VST& visit);      // 后序
     template <typename VST> void traverse_LO(VST& visit);       // 层次
     // 运算符重写
-    bool operator<  (const BinNode& bn) {return this->data < bn.data;}
-    bool operator>  (const BinNode& bn) {return bn.data < this->data;}
-    bool operator== (const BinNode& bn) {return !(this->data < bn.data || bn.data < this->data);}
-    bool operator!= (const BinNode& bn) {return  (this->data < bn.data || bn.data < this->data);}
-    //BinNodePtr<T> zig();                  // 顺时针旋转
-    //BinNodePtr<T> zag();                  // 逆时针旋转
+    bool operator<  (const N& bn) {return this->self()->data < bn.data;}
+    bool operator>  (const N& bn) {return bn.data < this->self()->data;}
+    bool operator== (const N& bn) {return !(this->self()->data < bn.data || bn.data < this->self()->data);}
+    bool operator!= (const N& bn) {return  (this->self()->data < bn.data || bn.data < this->self()->data);}
+    //N* zig();                  // 顺时针旋转
+    //N* zag();                  // 逆时针旋转
+};
+
+
+/*!
+ * @brief 二叉树节点
+ * T类型需要实现'<'运算符，或用CmpOperator对T进行封装。
+ *
+ * <pre>
+ * 所有树（BinSearchTree，AvlTree，SplayTree，RedBlackTree，PqLeftHeap等）默认使用BinNode<T>，
+ * 树通过new N创建节点，故在BinNode中重载operator new/delete，即可让所有树共享同一个NodePool（每种T一个）。
+ * npl与color分别用short与unsigned char存储，但节点按指针（8字节）对齐，
+ * BinNode<int>无论如何排列字段都是40字节（3个指针24字节 + 字段15字节，补齐到40），并未因此变小。
+ * cnt(BN_ORDER_STAT)为子树节点数量，由各树的update_height与update_size_above维护；
+ * 对于BinNode<int>等，cnt恰好占用对齐后的空隙，不增加节点大小。
+ * 需要更小的节点时，可通过树的模板参数N选用BinNodeAvl，BinNodeRb或BinNodeIdx。
+ * </pre>
+ */
+template <typename T> struct BinNode : public BinNodeBase<BinNode<T> >
+{
+    typedef BinNode<T>* Link;
+
+    BinNodePtr<T> parent;
+    BinNodePtr<T> left;
+    BinNodePtr<T> right;
+    T             data;
+    int           height;
+    short         npl;      /**< Null Path Length */
+    RBColor       color;
+#if BN_ORDER_STAT
+    int           cnt;      /**< 子树节点数量 */
+#endif
+
+    BinNode()
+        : parent(nullptr), left(nullptr), right(nullptr), height(0), npl(1),color(RBColor::Red)
+#if BN_ORDER_STAT
+        , cnt(1)
+#endif
+    {}
+    BinNode(const T& e, BinNodePtr<T> p = nullptr, BinNodePtr<T> ll = nullptr, BinNodePtr<T> rr = nullptr,
+            int h = 0, int n = 1, RBColor c = RBColor::Red)
+        : data(e), parent(p), left(ll), right(rr), height(h), npl(n), color(c)
+#if BN_ORDER_STAT
+        , cnt(1 + BN_Count(ll) + BN_Count(rr))
+#endif
+    {}
+
+#if BN_USE_POOL
+    /** 节点内存池 */
+    static dsa::NodePool& pool()
+    {
+        // 不析构：静态对象（如全局的树）析构时仍可能释放节点
+        static dsa::NodePool* p = new dsa::NodePool(sizeof(BinNode<T>), alignof(BinNode<T>));
+        return *p;
+    }
+    static void* operator new(std::size_t) {return pool().alloc();}
+    static void operator delete(void* p) {pool().free(p);}
+#endif
+
+    RBColor get_color() const {return this->color;}
+    void    set_color(RBColor c) {this->color = c;}
+};
+
+
+/*!
+ * @brief 最低位存放红黑颜色的父节点指针
+ *
+ * 节点至少按4字节对齐，指针的最低位恒为0，可用来存放颜色（1为黑）。
+ * 赋值指针时保留颜色，赋值ColorParent时只复制指针。
+ */
+template <typename N> class ColorParent
+{
+private:
+    std::uintptr_t m_bits;
+
+public:
+    explicit ColorParent(N* p = nullptr, RBColor c = RBColor::Red)
+        : m_bits(reinterpret_cast<std::uintptr_t>(p) | c)
+    {static_assert(alignof(N) >= 2, "ColorParent: node must be at least 2-byte aligned");}
+    ColorParent(const ColorParent&) = default;
+    ColorParent& operator= (N* p)
+    {
+        this->m_bits = reinterpret_cast<std::uintptr_t>(p) | (this->m_bits & 1);
+        return *this;
+    }
+    ColorParent& operator= (const ColorParent& cp) {return *this = static_cast<N*>(cp);}
+    operator N* () const {return reinterpret_cast<N*>(this->m_bits & ~std::uintptr_t(1));}
+    N* operator-> () const {return static_cast<N*>(*this);}
+
+    RBColor color() const {return static_cast<RBColor>(this->m_bits & 1);}
+    void    set_color(RBColor c) {this->m_bits = (this->m_bits & ~std::uintptr_t(1)) | c;}
 };
 
-template <typename T, typename VST> static void traverse_DLR_iteration(BinNodePtr<T> node, VST& visit);
-template <typename T, typename VST> static void traverse_DLR_recursion(BinNodePtr<T> node, VST& visit);
-template <typename T, typename VST> static void traverse_LDR_iteration(BinNodePtr<T> node, VST& visit);
-template <typename T, typename VST> static void traverse_LDR_recursion(BinNodePtr<T> node, VST& visit);
-template <typename T, typename VST> static void traverse_LRD_iteration(BinNodePtr<T> node, VST& visit);
-template <typename T, typename VST> static void traverse_LRD_recursion(BinNodePtr<T> node, VST& visit);
+/*!
+ * @brief 以IndexPool下标表示的节点链接（4字节）
+ *
+ * 下标0表示空；N需要提供id成员（节点自身的下标）与静态函数at(id)。
+ */
+template <typename N> class IndexLink
+{
+private:
+    uint32_t m_id;
+
+public:
+    explicit IndexLink(N* p = nullptr) : m_id(p ? p->id : 0) {}
+    IndexLink& operator= (N* p) {this->m_id = p ? p->id : 0; return *this;}
+    operator N* () const {return this->m_id ? N::at(this->m_id) : nullptr;}
+    N* operator-> () const {return N::at(this->m_id);}
+};
+
+/*!
+ * @brief AVL树的精简节点
+ *
+ * <pre>
+ * AVL树高不超过1.44*log2(n)，用int8_t存储高度即可；不存储npl与颜色（get_color恒为黑，set_color无效），
+ * 故只能用于AvlTree（以及不依赖颜色的BinSearchTree，SplayTree）。
+ * 这里存储高度而非平衡因子，AvlTree的算法无需改动。
+ * 节点大小（64位）：BinNodeAvl<int>仍为40字节（3个指针 + data + cnt + 1字节，补齐到40），
+ * 8字节的T从48字节降为40字节；BN_ORDER_STAT为0时，BinNodeAvl<int>为32字节。
+ * </pre>
+ */
+template <typename T> struct BinNodeAvl : public BinNodeBase<BinNodeAvl<T> >
+{
+    typedef BinNodeAvl<T>* Link;
+
+    Link    parent;
+    Link    left;
+    Link    right;
+    T       data;
+#if BN_ORDER_STAT
+    int     cnt;        /**< 子树节点数量 */
+#endif
+    int8_t  height;
+
+    BinNodeAvl(const T& e = T(), Link p = nullptr, Link ll = nullptr, Link rr = nullptr,
+               int h = 0, int n = 1, RBColor c = RBColor::Red)
+        : parent(p), left(ll), right(rr), data(e)
+#if BN_ORDER_STAT
+        , cnt(1 + BN_Count(ll) + BN_Count(rr))
+#endif
+        , height(static_cast<int8_t>(h))
+    {(void)n; (void)c;}
+
+#if BN_USE_POOL
+    static dsa::NodePool& pool()
+    {
+        static dsa::NodePool* p = new dsa::NodePool(sizeof(BinNodeAvl<T>), alignof(BinNodeAvl<T>));
+        return *p;
+    }
+    static void* operator new(std::size_t) {return pool().alloc();}
+    static void operator delete(void* p) {pool().free(p);}
+#endif
+
+    RBColor get_color() const {return RBColor::Black;}
+    void    set_color(RBColor) {}
+};
+
+/*!
+ * @brief 红黑树的精简节点
+ *
+ * <pre>
+ * 颜色存放在parent指针的最低位（ColorParent），黑高度不超过2*log2(n)，用int8_t存储；不存储npl。
+ * 节点大小（64位）与BinNodeAvl相同。
+ * </pre>
+ */
+template <typename T> struct BinNodeRb : public BinNodeBase<BinNodeRb<T> >
+{
+    typedef BinNodeRb<T>* Link;
+
+    ColorParent<BinNodeRb<T> > parent;
+    Link    left;
+    Link    right;
+    T       data;
+#if BN_ORDER_STAT
+    int     cnt;        /**< 子树节点数量 */
+#endif
+    int8_t  height;     /**< 黑高度 */
+
+    BinNodeRb(const T& e = T(), Link p = nullptr, Link ll = nullptr, Link rr = nullptr,
+              int h = 0, int n = 1, RBColor c = RBColor::Red)
+        : parent(p, c), left(ll), right(rr), data(e)
+#if BN_ORDER_STAT
+        , cnt(1 + BN_Count(ll) + BN_Count(rr))
+#endif
+        , height(static_cast<int8_t>(h))
+    {(void)n;}
+
+#if BN_USE_POOL
+    static dsa::NodePool& pool()
+    {
+        static dsa::NodePool* p = new dsa::NodePool(sizeof(BinNodeRb<T>), alignof(BinNodeRb<T>));
+        return *p;
+    }
+    static void* operator new(std::size_t) {return pool().alloc();}
+    static void operator delete(void* p) {pool().free(p);}
+#endif
+
+    RBColor get_color() const {return this->parent.color();}
+    void    set_color(RBColor c) {this->parent.set_color(c);}
+};
+
+/*!
+ * @brief 以32位下标链接的节点
+ *
+ * <pre>
+ * 节点总是从IndexPool分配（不受BN_USE_POOL影响），parent/left/right均为4字节的IndexLink，
+ * 节点另存自身的下标id（构造时由IndexPool查得），用于把节点赋值给链接。
+ * 保留int高度与颜色，可用于所有的树；节点数不超过 POOL_INDEX_CHUNKS << POOL_INDEX_BITS。
+ * 节点大小：BinNodeIdx<int>为32字节（BinNode<int>为40字节），8字节的T为40字节（BinNode为48字节）。
+ * 代价是每次经链接访问节点都要多查一次chunk表。
+ * </pre>
+ */
+template <typename T> struct BinNodeIdx : public BinNodeBase<BinNodeIdx<T> >
+{
+    typedef IndexLink<BinNodeIdx<T> > Link;
+
+    uint32_t id;        /**< 节点自身的下标 */
+    Link     parent;
+    Link     left;
+    Link     right;
+    T        data;
+    int      height;
+#if BN_ORDER_STAT
+    int      cnt;       /**< 子树节点数量 */
+#endif
+    RBColor  color;
+
+    BinNodeIdx(const T& e = T(), BinNodeIdx* p = nullptr, BinNodeIdx* ll = nullptr, BinNodeIdx* rr = nullptr,
+               int h = 0, int n = 1, RBColor c = RBColor::Red)
+        : id(pool().id_of(this)), parent(p), left(ll), right(rr), data(e), height(h)
+#if BN_ORDER_STAT
+        , cnt(1 + BN_Count(ll) + BN_Count(rr))
+#endif
+        , color(c)
+    {(void)n;}
+
+    /** 节点内存池 */
+    static dsa::IndexPool& pool()
+    {
+        static dsa::IndexPool* p = new dsa::IndexPool(sizeof(BinNodeIdx<T>), alignof(BinNodeIdx<T>));
+        return *p;
+    }
+    static BinNodeIdx* at(uint32_t id) {return static_cast<BinNodeIdx*>(pool().at(id));}
+    static void* operator new(std::size_t)
+    {
+        void* p = pool().alloc();
+        if (!p)
+            throw std::bad_alloc();
+        return p;
+    }
+    static void operator delete(void* p) {pool().free(p);}
+
+    RBColor get_color() const {return this->color;}
+    void    set_color(RBColor c) {this->color = c;}
+};
+
+template <typename N, typename VST> static void traverse_DLR_iteration(N* node, VST& visit);
+template <typename N, typename VST> static void traverse_DLR_recursion(N* node, VST& visit);
+template <typename N, typename VST> static void traverse_LDR_iteration(N* node, VST& visit);
+template <typename N, typename VST> static void traverse_LDR_recursion(N* node, VST& visit);
+template <typename N, typename VST> static void traverse_LRD_iteration(N* node, VST& visit);
+template <typename N, typename VST> static void traverse_LRD_recursion(N* node, VST& visit);
 
 /*! @} */
 
@@ -170,13 +436,13 @@ template <typename T, typename VST> static void traverse_LRD_recursion(BinNodePt
  * @return 返回直接后继节点
  * @retval None
  */
-template <typename T>
-BinNodePtr<T> BinNode<T>::successor()
+template <typename N>
+N* BinNodeBase<N>::successor()
 {
-    BinNodePtr<T> s = this;
-    if (this->right)
+    N* s = this->self();
+    if (s->right)
     {
-        s = this->right;
+        s = s->right;
         while(s->left) s = s->left;     //为右子树中最靠左（最小）的节点
     }
     else
@@ -198,13 +464,13 @@ BinNodePtr<T> BinNode<T>::successor()
  * @return 返回直接前趋节点
  * @retval None
  */
-template <typename T>
-BinNodePtr<T> BinNode<T>::predecessor()
+template <typename N>
+N* BinNodeBase<N>::predecessor()
 {
-    BinNodePtr<T> s = this;
-    if (this->left)
+    N* s = this->self();
+    if (s->left)
     {
-        s = this->left;
+        s = s->left;
         while(s->right) s = s->right;     //为左子树中最靠右（最大）的节点
     }
     else
@@ -225,9 +491,9 @@ BinNodePtr<T> BinNode<T>::predecessor()
  * @return
  * @retval None
  */
-template <typename T>
+template <typename N>
 template<typename VST>
-void BinNode<T>::traverse(VST& visit, TraverseType type)
+void BinNodeBase<N>::traverse(VST& visit, TraverseType type)
 {
     switch (type)
     {
@@ -275,10 +541,10 @@ void BinNode<T>::traverse(VST& visit, TraverseType type)
  * @return
  * @retval None
  */
-template <typename T, typename VST>
-static void traverse_DLR_iteration(BinNodePtr<T> node, VST& visit)
+template <typename N, typename VST>
+static void traverse_DLR_iteration(N* node, VST& visit)
 {
-    dsa::Stack<BinNodePtr<T> > s;
+    dsa::Stack<N*> s;
     s.push(node);
     while (!s.is_empty())
     {
@@ -302,13 +568,13 @@ static void traverse_DLR_iteration(BinNodePtr<T> node, VST& visit)
  * @return
  * @retval None
  */
-template <typename T, typename VST>
-static void traverse_DLR_recursion(BinNodePtr<T> node, VST& visit)
+template <typename N, typename VST>
+static void traverse_DLR_recursion(N* node, VST& visit)
 {
     if(!node) return;
     visit(node->data);
-    traverse_DLR_recursion(node->left, visit);
-    traverse_DLR_recursion(node->right, visit);
+    traverse_DLR_recursion<N>(node->left, visit);
+    traverse_DLR_recursion<N>(node->right, visit);
 }
 
 /*!
@@ -318,12 +584,12 @@ static void traverse_DLR_recursion(BinNodePtr<T> node, VST& visit)
  * @return
  * @retval None
  */
-template <typename T>
+template <typename N>
 template<typename VST>
-void BinNode<T>::traverse_DLR(VST& visit)
+void BinNodeBase<N>::traverse_DLR(VST& visit)
 {
-    //traverse_DLR_recursion(this, visit);
-    traverse_DLR_iteration(this, visit);
+    //traverse_DLR_recursion(this->self(), visit);
+    traverse_DLR_iteration(this->self(), visit);
 }
 
 
@@ -359,10 +625,10 @@ void BinNode<T>::traverse_DLR(VST& visit)
  * @return
  * @retval None
  */
-template <typename T, typename VST>
-static void traverse_LDR_iteration(BinNodePtr<T> node, VST& visit)
+template <typename N, typename VST>
+static void traverse_LDR_iteration(N* node, VST& visit)
 {
-    dsa::Stack<BinNodePtr<T> > s;
+    dsa::Stack<N*> s;
     while(1)
     {
         while(node)
@@ -385,13 +651,13 @@ static void traverse_LDR_iteration(BinNodePtr<T> node, VST& visit)
  * @return
  * @retval None
  */
-template <typename T, typename VST>
-static void traverse_LDR_recursion(BinNodePtr<T> node, VST& visit)
+template <typename N, typename VST>
+static void traverse_LDR_recursion(N* node, VST& visit)
 {
     if(!node) return;
-    traverse_LDR_recursion(node->left, visit);
+    traverse_LDR_recursion<N>(node->left, visit);
     visit(node->data);
-    traverse_LDR_recursion(node->right, visit);
+    traverse_LDR_recursion<N>(node->right, visit);
 }
 
 /*!
@@ -401,12 +667,12 @@ static void traverse_LDR_recursion(BinNodePtr<T> node, VST& visit)
  * @return
  * @retval None
  */
-template <typename T>
+template <typename N>
 template<typename VST>
-void BinNode<T>::traverse_LDR(VST& visit)
+void BinNodeBase<N>::traverse_LDR(VST& visit)
 {
-    //traverse_LDR_recursion(this, visit);
-    traverse_LDR_iteration(this, visit);
+    //traverse_LDR_recursion(this->self(), visit);
+    traverse_LDR_iteration(this->self(), visit);
 }
 
 
@@ -440,11 +706,11 @@ void BinNode<T>::traverse_LDR(VST& visit)
  * @return
  * @retval None
  */
-template <typename T, typename VST>
-static void traverse_LRD_iteration(BinNodePtr<T> node, VST& visit)
+template <typename N, typename VST>
+static void traverse_LRD_iteration(N* node, VST& visit)
 {
-    dsa::Stack<BinNodePtr<T> > s;
-    BinNodePtr<T> last_visited = nullptr;
+    dsa::Stack<N*> s;
+    N* last_visited = nullptr;
 
     while(node)
     {
@@ -479,12 +745,12 @@ static void traverse_LRD_iteration(BinNodePtr<T> node, VST& visit)
  * @param visit: 遍历函数
  * @retval None
  */
-template <typename T, typename VST>
-static void traverse_LRD_recursion(BinNodePtr<T> node, VST& visit)
+template <typename N, typename VST>
+static void traverse_LRD_recursion(N* node, VST& visit)
 {
     if(!node) return;
-    traverse_LRD_recursion(node->left, visit);
-    traverse_LRD_recursion(node->right, visit);
+    traverse_LRD_recursion<N>(node->left, visit);
+    traverse_LRD_recursion<N>(node->right, visit);
     visit(node->data);
 }
 
@@ -495,12 +761,12 @@ static void traverse_LRD_recursion(BinNodePtr<T> node, VST& visit)
  * @return
  * @retval None
  */
-template <typename T>
+template <typename N>
 template <typename VST>
-void BinNode<T>::traverse_LRD(VST& visit)
+void BinNodeBase<N>::traverse_LRD(VST& visit)
 {
-    //traverse_LRD_recursion(this, visit);
-    traverse_LRD_iteration(this, visit);
+    //traverse_LRD_recursion(this->self(), visit);
+    traverse_LRD_iteration(this->self(), visit);
 }
 
 
@@ -524,12 +790,12 @@ void BinNode<T>::traverse_LRD(VST& visit)
  * @return
  * @retval None
  */
-template <typename T>
+template <typename N>
 template <typename VST>
-void BinNode<T>::traverse_LO(VST& visit)
+void BinNodeBase<N>::traverse_LO(VST& visit)
 {
-    dsa::Queue<BinNodePtr<T> > q;
-    BinNodePtr<T> node = this;
+    dsa::Queue<N*> q;
+    N* node = this->self();
     q.enqueue(node);
     while(!q.is_empty())
     {
@@ -17,6 +17,11 @@
 #include "share/swap.h"
 #include "share/compare.h"
 
+/** 区间扫描迭代器内置栈的容量（超出时退化为沿parent指针回溯） */
+#ifndef BST_SCAN_STACK
+#define BST_SCAN_STACK      64
+#endif
+
 namespace dsa
 {
 
@@ -35,24 +40,191 @@ namespace dsa
  * search, insert, remove在最坏情况下需要O(h)时间。
  * </pre>
  */
-template <typename T>
-class BinSearchTree : public BinTree<T>
+template <typename T, typename N = BinNode<T> >
+class BinSearchTree : public BinTree<T,N>
 {
 public:
-    virtual BinNodePtr<T>&  search(const T&);
-    virtual BinNodePtr<T>   insert(const T&);
+    /*!
+     * @brief 区间扫描迭代器，可正向或反向按中序遍历
+     *
+     * <pre>
+     * 使用固定容量的栈保存尚未访问的祖先节点，迭代过程中不分配堆内存，也不沿parent指针回溯；
+     * 正向扫描时，栈中为沿left下行经过的节点，反向扫描时，栈中为沿right下行经过的节点；
+     * 当树高超过BST_SCAN_STACK时（如退化的BST、伸展树），改为使用successor/predecessor继续迭代。
+     * </pre>
+     */
+    class ScanIterator
+    {
+    private:
+        N*              m_stack[BST_SCAN_STACK];
+        int             m_top;      /**< 栈顶位置，-1表示栈已溢出，改为沿parent指针回溯 */
+        N*              m_cur;
+        T               m_bound;    /**< 正向为上界(不含)，反向为下界(含) */
+        bool            m_bounded;
+        bool            m_reverse;
+
+        void    push(N* node)
+        {
+            if (this->m_top < 0)
+                return;
+            if (this->m_top >= BST_SCAN_STACK)
+                this->m_top = -1;
+            else
+                this->m_stack[this->m_top++] = node;
+        }
+        void    push_spine(N* node)
+        {
+            for (; node; node = this->m_reverse ? node->right : node->left)
+                this->push(node);
+        }
+        void    check_bound()
+        {
+            if (this->m_cur && this->m_bounded)
+            {
+                if (this->m_reverse ? dsa::less_than(this->m_cur->data, this->m_bound)
+                                    : !dsa::less_than(this->m_cur->data, this->m_bound))
+                    this->m_cur = nullptr;
+            }
+        }
+        void    next()
+        {
+            if (this->m_top < 0)
+                this->m_cur = this->m_reverse ? this->m_cur->predecessor() : this->m_cur->successor();
+            else
+            {
+                this->push_spine(this->m_reverse ? this->m_cur->left : this->m_cur->right);
+                if (this->m_top < 0)
+                    this->m_cur = this->m_reverse ? this->m_cur->predecessor() : this->m_cur->successor();
+                else
+                    this->m_cur = this->m_top > 0 ? this->m_stack[--this->m_top] : nullptr;
+            }
+            this->check_bound();
+        }
+
+    public:
+        ScanIterator() : m_top(0), m_cur(nullptr), m_bounded(false), m_reverse(false) {}
+
+        /*!
+         * @brief 定位到扫描起点
+         *
+         * @param root: 树根节点
+         * @param start: 扫描起点（正向为第一个>=start的节点，反向为最后一个<start的节点）
+         * @param has_start: 是否有起点，没有则从最小（反向为最大）节点开始
+         * @param bound: 扫描终点（正向扫描至<bound，反向扫描至>=bound）
+         * @param has_bound: 是否有终点
+         * @param reverse: 是否反向扫描
+         */
+        ScanIterator(N* root, const T& start, bool has_start, const T& bound, bool has_bound, bool reverse)
+            : m_top(0), m_cur(nullptr), m_bound(bound), m_bounded(has_bound), m_reverse(reverse)
+        {
+            N* node = root;
+            N* hit = nullptr;               // 栈溢出时，记录最后一个满足条件的节点
+            while (node)
+            {
+                bool take = !has_start ||
+                    (reverse ? dsa::less_than(node->data, start) : !dsa::less_than(node->data, start));
+                if (take)
+                {
+                    hit = node;
+                    this->push(node);
+                    node = reverse ? node->right : node->left;
+                }
+                else
+                    node = reverse ? node->left : node->right;
+            }
+            if (this->m_top < 0)
+                this->m_cur = hit;
+            else
+                this->m_cur = this->m_top > 0 ? this->m_stack[--this->m_top] : nullptr;
+            this->check_bound();
+        }
+
+        /** 重写*，获取BinNode数据 */
+        T& operator*() {return this->m_cur->data;}
+        /** 获取当前节点 */
+        N* node() const {return this->m_cur;}
+        /** 重写== */
+        bool operator== (const ScanIterator& itr) const {return this->m_cur == itr.m_cur;}
+        /** 重写！= */
+        bool operator!= (const ScanIterator& itr) const {return this->m_cur != itr.m_cur;}
+        /** 重写前置++ */
+        ScanIterator& operator++() {this->next(); return *this;}
+    };
+
+    /*!
+     * @brief 扫描区间，用于range-based for循环
+     */
+    class Range
+    {
+    private:
+        ScanIterator    m_begin;
+
+    public:
+        Range(const ScanIterator& itr) : m_begin(itr) {}
+        ScanIterator begin() const {return this->m_begin;}
+        ScanIterator end() const {return ScanIterator();}
+    };
+
+public:
+    virtual typename N::Link& search(const T&);
+    virtual N*              insert(const T&);
     virtual bool            remove(const T&);
 
+    typename BinTree<T,N>::Iterator   lower_bound(const T&);
+    typename BinTree<T,N>::Iterator   upper_bound(const T&);
+#if BN_ORDER_STAT
+    N*              select(int) const;
+    int             rank(const T&) const;
+    /** 区间[lo, hi)内的节点数量 */
+    int             count_range(const T& lo, const T& hi) const
+    {
+        return dsa::less_than(lo, hi) ? this->rank(hi) - this->rank(lo) : 0;
+    }
+#endif
+    /** 区间[lo, hi)扫描，reverse为true时由大到小 */
+    Range   range(const T& lo, const T& hi, bool reverse = false)
+    {
+        return reverse ? Range(ScanIterator(this->m_root, hi, true, lo, true, true))
+                       : Range(ScanIterator(this->m_root, lo, true, hi, true, false));
+    }
+    /** 全树扫描，reverse为true时由大到小 */
+    Range   scan(bool reverse = false) {return Range(ScanIterator(this->m_root, T(), false, T(), false, reverse));}
+
+    void    build_from_sorted(const dsa::Vector<T>&);
+    int     insert_many(const dsa::Vector<T>&);
+    bool    join(BinSearchTree<T,N>& other) {return this->join_tree(other);}
+    void    split(const T& e, BinSearchTree<T,N>& other) {this->split_tree(e, other);}
+
 protected:
-    BinNodePtr<T>       m_hot;
-    BinNodePtr<T>       connect34(
-            BinNodePtr<T>, BinNodePtr<T>, BinNodePtr<T>,
-            BinNodePtr<T>, BinNodePtr<T>, BinNodePtr<T>, BinNodePtr<T>);
-    BinNodePtr<T>       rotate_at(BinNodePtr<T>);
-    BinNodePtr<T>       remove_at(BinNodePtr<T>&, BinNodePtr<T>&);
-    BinNodePtr<T>&      search_in(BinNodePtr<T>&, const T&, BinNodePtr<T>&);
+    N*                  m_hot;
+    N*                  connect34(N*, N*, N*, N*, N*, N*, N*);
+    N*                  rotate_at(N*);
+    N*                  remove_at(typename N::Link&, N*&);
+    typename N::Link&   search_in(typename N::Link&, const T&, N*&);
+
+    N*                  build_at(const dsa::Vector<T>&, int, int, N*, int, int);
+    virtual N*          join_at(N*, N*, N*);
+    void                split_at(N*, const T&, N*&, N*&);
+    bool                join_tree(BinSearchTree<T,N>&);
+    void                split_tree(const T&, BinSearchTree<T,N>&);
 };
 
+/*!
+ * @brief 判断向量是否严格递增（即有序且无重复）
+ *
+ * @param v: 向量
+ * @return
+ * @retval None
+ */
+template <typename T>
+static bool is_strictly_sorted(const dsa::Vector<T>& v)
+{
+    for (int k = 1; k < v.size(); k ++)
+        if (!dsa::less_than(v[k-1], v[k]))
+            return false;
+    return true;
+}
+
 /*! @} */
 
 
@@ -65,11 +237,11 @@ protected:
  * @return 返回命中节点，命中节点可能为nullptr(即未查找到目标)，也可能为目标节点。
  * @retval None
  */
-template <typename T>
-BinNodePtr<T>& BinSearchTree<T>::search_in(
-        BinNodePtr<T>& node,
+template <typename T, typename N>
+typename N::Link& BinSearchTree<T,N>::search_in(
+        typename N::Link& node,
         const T& e,
-        BinNodePtr<T>& hot)
+        N*& hot)
 {
     if (!node || dsa::is_equal(e, node->data))
         return node;
@@ -85,12 +257,378 @@ BinNodePtr<T>& BinSearchTree<T>::search_in(
  * @return
  * @retval None
  */
-template <typename T>
-BinNodePtr<T>& BinSearchTree<T>::search(const T& e)
+template <typename T, typename N>
+typename N::Link& BinSearchTree<T,N>::search(const T& e)
 {
     return this->search_in(this->m_root, e, this->m_hot = nullptr);
 }
 
+/*!
+ * @brief 查找第一个不小于e的节点
+ *
+ * @param e: 查找目标
+ * @return 返回指向该节点的迭代器，不存在时返回end()
+ * @retval None
+ */
+template <typename T, typename N>
+typename BinTree<T,N>::Iterator BinSearchTree<T,N>::lower_bound(const T& e)
+{
+    N* node = this->m_root;
+    N* hit = nullptr;
+    while (node)
+    {
+        if (!dsa::less_than(node->data, e))
+        {
+            hit = node;
+            node = node->left;
+        }
+        else
+            node = node->right;
+    }
+    return typename BinTree<T,N>::Iterator(hit);
+}
+
+/*!
+ * @brief 查找第一个大于e的节点
+ *
+ * @param e: 查找目标
+ * @return 返回指向该节点的迭代器，不存在时返回end()
+ * @retval None
+ */
+template <typename T, typename N>
+typename BinTree<T,N>::Iterator BinSearchTree<T,N>::upper_bound(const T& e)
+{
+    N* node = this->m_root;
+    N* hit = nullptr;
+    while (node)
+    {
+        if (dsa::less_than(e, node->data))
+        {
+            hit = node;
+            node = node->left;
+        }
+        else
+            node = node->right;
+    }
+    return typename BinTree<T,N>::Iterator(hit);
+}
+
+#if BN_ORDER_STAT
+/*!
+ * @brief 查找中序第k个（从0开始计数，即第k+1小的）节点
+ *
+ * 利用子树规模cnt，沿根向下只走一条路径，O(h)时间。
+ *
+ * @param k: 中序位置
+ * @return 返回目标节点，k越界时返回nullptr
+ * @retval None
+ */
+template <typename T, typename N>
+N* BinSearchTree<T,N>::select(int k) const
+{
+    if (k < 0 || k >= this->m_size)
+        return nullptr;
+    N* node = this->m_root;
+    while (node)
+    {
+        int l = BN_Count(node->left);
+        if (k < l)
+            node = node->left;
+        else if (k == l)
+            return node;
+        else
+        {
+            k -= l + 1;
+            node = node->right;
+        }
+    }
+    return nullptr;
+}
+
+/*!
+ * @brief 查找小于e的节点数量
+ *
+ * 若e在树中，返回值即为e的中序位置（select(rank(e))->data == e）。
+ *
+ * @param e: 查找目标
+ * @return 返回小于e的节点数量
+ * @retval None
+ */
+template <typename T, typename N>
+int BinSearchTree<T,N>::rank(const T& e) const
+{
+    int r = 0;
+    N* node = this->m_root;
+    while (node)
+    {
+        if (dsa::less_than(node->data, e))
+        {
+            r += BN_Count(node->left) + 1;
+            node = node->right;
+        }
+        else
+            node = node->left;
+    }
+    return r;
+}
+#endif
+
+/*!
+ * @brief 由有序序列构建子树v[lo, hi)
+ *
+ * <pre>
+ * 取中点作为子树根节点，左右子树规模相差不超过1，故全树深度为floor(log2(n))；
+ * 除最深一层(red_depth)的节点为红外，其余节点均为黑，
+ * 因为所有外部节点的深度只可能为red_depth或red_depth+1，故各路径黑节点数相同，满足红黑树条件；
+ * 对于BST与AvlTree，颜色无意义，树本身即为AVL平衡。
+ * </pre>
+ *
+ * @param v: 严格递增的序列
+ * @param lo,hi: 子树对应的区间[lo, hi)
+ * @param parent: 子树根节点的父节点
+ * @param depth: 子树根节点的深度
+ * @param red_depth: 染红的深度，-1表示全部为黑
+ * @return 返回子树根节点
+ * @retval None
+ */
+template <typename T, typename N>
+N* BinSearchTree<T,N>::build_at(
+        const dsa::Vector<T>& v, int lo, int hi,
+        N* parent, int depth, int red_depth)
+{
+    if (lo >= hi)
+        return nullptr;
+    int mi = lo + (hi - lo) / 2;
+    N* node = new N(v[mi], parent);
+    node->set_color((depth == red_depth) ? RBColor::Red : RBColor::Black);
+    node->left = this->build_at(v, lo, mi, node, depth + 1, red_depth);
+    node->right = this->build_at(v, mi + 1, hi, node, depth + 1, red_depth);
+    this->update_height(node);      // 虚函数，红黑树更新黑高度
+    return node;
+}
+
+/*!
+ * @brief 由有序序列构建平衡树，O(n)
+ *
+ * 原有节点全部删除；序列无序或有重复元素时，先排序去重。
+ *
+ * @param v: 有序序列
+ * @return
+ * @retval None
+ */
+template <typename T, typename N>
+void BinSearchTree<T,N>::build_from_sorted(const dsa::Vector<T>& v)
+{
+    if (this->m_root)
+    {
+        BinTree<T,N>::remove(this->m_root);
+        this->m_root = nullptr;
+    }
+
+    dsa::Vector<T> u(0);
+    const dsa::Vector<T>* src = &v;
+    if (!is_strictly_sorted(v))
+    {
+        u = v;
+        u.sort();
+        u.uniquify();
+        src = &u;
+    }
+
+    int n = src->size();
+    int red_depth = 0;              // floor(log2(n))
+    while ((n >> (red_depth + 1)) > 0)
+        red_depth ++;
+    this->m_root = this->build_at(*src, 0, n, nullptr, 0, red_depth > 0 ? red_depth : -1);
+    this->m_size = n;
+}
+
+/*!
+ * @brief 批量插入
+ *
+ * <pre>
+ * 先排序去重，再根据规模选择插入方式：
+ * 待插入的数量m相对于树的规模n较小（m*log(n) < n）时，逐个插入（有序插入，访问路径局部性好）；
+ * 否则与原树的中序序列归并后，使用build_from_sorted重建，O(n+m)。
+ * </pre>
+ *
+ * @param v: 待插入的元素
+ * @return 返回新插入的元素数量
+ * @retval None
+ */
+template <typename T, typename N>
+int BinSearchTree<T,N>::insert_many(const dsa::Vector<T>& v)
+{
+    int old = this->m_size;
+    dsa::Vector<T> s(v);
+    if (!is_strictly_sorted(s))
+    {
+        s.sort();
+        s.uniquify();
+    }
+    if (!this->m_root)
+    {
+        this->build_from_sorted(s);
+        return this->m_size;
+    }
+
+    int n = this->m_size, m = s.size(), lg = 1;
+    while ((n >> lg) > 0)
+        lg ++;
+    if ((long long)m * lg < n)
+    {
+        for (int k = 0; k < m; k ++)
+            this->insert(s[k]);
+        return this->m_size - old;
+    }
+
+    dsa::Vector<T> all(n + m);
+    int k = 0;
+    for (T& e : this->scan())
+    {
+        while (k < m && dsa::less_than(s[k], e))
+            all.push_back(s[k++]);
+        if (k < m && !dsa::less_than(e, s[k]))
+            k ++;                   // 与原有元素相同，保留原有元素
+        all.push_back(e);
+    }
+    while (k < m)
+        all.push_back(s[k++]);
+    this->build_from_sorted(all);
+    return this->m_size - old;
+}
+
+/*!
+ * @brief 以k为根节点，连接子树l与r（l中元素 < k < r中元素）
+ *
+ * 普通BST直接连接，不做平衡；AvlTree与RedBlackTree重写为O(log(n))的平衡连接。
+ * 调用期间m_root被用作暂存，返回时m_root即为连接后的根节点。
+ *
+ * @param l: 左子树根节点（parent为nullptr）
+ * @param k: 独立的节点
+ * @param r: 右子树根节点（parent为nullptr）
+ * @return 返回连接后的根节点
+ * @retval None
+ */
+template <typename T, typename N>
+N* BinSearchTree<T,N>::join_at(N* l, N* k, N* r)
+{
+    k->parent = nullptr;
+    k->left = l;
+    k->right = r;
+    if (l) l->parent = k;
+    if (r) r->parent = k;
+    this->update_height(k);
+    return this->m_root = k;
+}
+
+/*!
+ * @brief 将子树node分裂为 < e 与 >= e 两部分
+ *
+ * 沿查找路径向下，将路径两侧的子树逐个join_at，各次连接的代价之和为O(log(n))。
+ *
+ * @param node: 子树根节点
+ * @param e: 分裂点
+ * @param l: 返回 < e 部分的根节点
+ * @param r: 返回 >= e 部分的根节点
+ * @return
+ * @retval None
+ */
+template <typename T, typename N>
+void BinSearchTree<T,N>::split_at(N* node, const T& e, N*& l, N*& r)
+{
+    if (!node)
+    {
+        l = r = nullptr;
+        return;
+    }
+    N* nl = node->left;
+    N* nr = node->right;
+    if (nl) nl->parent = nullptr;
+    if (nr) nr->parent = nullptr;
+
+    N *a, *b;
+    if (dsa::less_than(node->data, e))
+    {
+        this->split_at(nr, e, a, b);
+        l = this->join_at(nl, node, a);
+        r = b;
+    }
+    else
+    {
+        this->split_at(nl, e, a, b);
+        l = a;
+        r = this->join_at(b, node, nr);
+    }
+}
+
+/*!
+ * @brief 将other中的元素全部并入本树，要求本树所有元素均小于other中的元素
+ *
+ * 取出other的最小元素作为连接节点，O(log(n))。
+ *
+ * @param other: 同类型的树，完成后为空树
+ * @return 不满足大小关系时返回false，两棵树均不变
+ * @retval None
+ */
+template <typename T, typename N>
+bool BinSearchTree<T,N>::join_tree(BinSearchTree<T,N>& other)
+{
+    if (!other.m_root)
+        return true;
+    if (this->m_root)
+    {
+        N* mx = this->m_root;
+        while (mx->right) mx = mx->right;
+        N* mn = other.m_root;
+        while (mn->left) mn = mn->left;
+        if (!dsa::less_than(mx->data, mn->data))
+            return false;
+    }
+
+    N* mn = other.m_root;
+    while (mn->left) mn = mn->left;
+    T pivot = mn->data;
+    other.remove(pivot);
+
+    int n = this->m_size + other.m_size + 1;
+    N* r = other.m_root;
+    other.m_root = nullptr;
+    other.m_size = 0;
+    this->join_at(this->m_root, new N(pivot), r);
+    this->m_size = n;
+    return true;
+}
+
+/*!
+ * @brief 分裂：本树保留 < e 的元素，>= e 的元素移入other
+ *
+ * @param e: 分裂点
+ * @param other: 同类型的树，原有元素会被删除
+ * @return
+ * @retval None
+ */
+template <typename T, typename N>
+void BinSearchTree<T,N>::split_tree(const T& e, BinSearchTree<T,N>& other)
+{
+    if (other.m_root)
+    {
+        other.BinTree<T,N>::remove(other.m_root);
+        other.m_root = nullptr;
+    }
+    int n = this->m_size;
+    N *l, *r;
+    this->split_at(this->m_root, e, l, r);
+    this->m_root = l;
+    other.m_root = r;
+#if BN_ORDER_STAT
+    this->m_size = BN_Count(l);
+#else
+    this->m_size = l ? l->size() : 0;
+#endif
+    other.m_size = n - this->m_size;
+}
+
 /*!
  * @brief 插入节点
  *
@@ -98,13 +636,13 @@ BinNodePtr<T>& BinSearchTree<T>::search(const T& e)
  * @return
  * @retval None
  */
-template <typename T>
-BinNodePtr<T> BinSearchTree<T>::insert(const T& e)
+template <typename T, typename N>
+N* BinSearchTree<T,N>::insert(const T& e)
 {
-    BinNodePtr<T>& node = this->search(e);
+    typename N::Link& node = this->search(e);
     if (!node)      // 禁止相同元素
     {
-        node = new BinNode<T>(e, this->m_hot);      // node一定是m_hot的子节点，见search代码
+        node = new N(e, this->m_hot);               // node一定是m_hot的子节点，见search代码
         this->m_size++;
         this->update_height_above(node);
     }
@@ -142,13 +680,13 @@ BinNodePtr<T> BinSearchTree<T>::insert(const T& e)
  * @return 返回被删除节点位置的新节点，hot为返回节点的父节点
  * @retval None
  */
-template <typename T>
-BinNodePtr<T> BinSearchTree<T>::remove_at(
-        BinNodePtr<T>& node,
-        BinNodePtr<T>& hot)
+template <typename T, typename N>
+N* BinSearchTree<T,N>::remove_at(
+        typename N::Link& node,
+        N*& hot)
 {
-    BinNodePtr<T> w = node;
-    BinNodePtr<T> succ = nullptr;
+    N* w = node;
+    N* succ = nullptr;
     // 只有右子树(或左右子树均没有，则返回nullptr，即被删除节点位置没有新节点)
     if(!node->left) succ = node = node->right;
     // 只有左子树
@@ -160,7 +698,7 @@ BinNodePtr<T> BinSearchTree<T>::remove_at(
         w = w->successor();
         // 交换直接后继w与目标节点的数据，交换完后，w成为待删除的目标节点
         dsa::swap(w->data, node->data);
-        BinNodePtr<T> u = w->parent;
+        N* u = w->parent;
         // 后继节点w只可能有右子树，不可能有左子树
         if (u == node)
         {
@@ -177,6 +715,7 @@ BinNodePtr<T> BinSearchTree<T>::remove_at(
     // succ不为nullptr，则hot为succ的父节点
     // succ为nullptr，则hot的子节点w被删除后，也为nullptr
     if (succ) succ->parent = hot;   // 设置接替节点的父节点
+    this->update_size_above(hot);   // 更新祖先的子树规模
     delete w;                       // 删除节点
 
     return succ;
@@ -189,10 +728,10 @@ BinNodePtr<T> BinSearchTree<T>::remove_at(
  * @return
  * @retval None
  */
-template <typename T>
-bool BinSearchTree<T>::remove(const T& e)
+template <typename T, typename N>
+bool BinSearchTree<T,N>::remove(const T& e)
 {
-    BinNodePtr<T>& node = this->search(e);
+    typename N::Link& node = this->search(e);
     if (!node) return false;
     this->remove_at(node, m_hot);
     this->m_size--;
@@ -221,10 +760,10 @@ bool BinSearchTree<T>::remove(const T& e)
  * @return 新子树的根节点
  * @retval None
  */
-template <typename T>
-BinNodePtr<T> BinSearchTree<T>::connect34(
-        BinNodePtr<T> a, BinNodePtr<T> b, BinNodePtr<T> c,
-        BinNodePtr<T> T0, BinNodePtr<T> T1, BinNodePtr<T> T2, BinNodePtr<T> T3)
+template <typename T, typename N>
+N* BinSearchTree<T,N>::connect34(
+        N* a, N* b, N* c,
+        N* T0, N* T1, N* T2, N* T3)
 {
     a->left = T0;
     a->right = T1;
@@ -276,11 +815,11 @@ BinNodePtr<T> BinSearchTree<T>::connect34(
  * @return 子树的根节点
  * @retval None
  */
-template <typename T>
-BinNodePtr<T> BinSearchTree<T>::rotate_at(BinNodePtr<T> v)
+template <typename T, typename N>
+N* BinSearchTree<T,N>::rotate_at(N* v)
 {
-    BinNodePtr<T> p = v->parent;
-    BinNodePtr<T> g = p->parent;
+    N* p = v->parent;
+    N* g = p->parent;
     if (BN_IsLeftChild(*p))
     {
         if (BN_IsLeftChild(*v))
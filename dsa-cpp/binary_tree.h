@@ -59,9 +59,12 @@ namespace dsa
  * n = h+1时，树成为单链
  * n = 2^(h+1)-1时，二叉树为满树
  *
+ * (3) 节点类型N：默认为BinNode<T>，也可选用精简节点BinNodeAvl，BinNodeRb或BinNodeIdx（见binary_node.h）
+ * 树中的节点指针均为N*，需要修改链接本身时（如根节点，父节点中的孩子链接）使用typename N::Link&。
+ *
  * </pre>
  */
-template <typename T>
+template <typename T, typename N = BinNode<T> >
 class BinTree
 {
 public:
@@ -73,10 +76,10 @@ public:
 class Iterator
 {
 private:
-    BinNodePtr<T> m_cur;
+    N* m_cur;
 
 public:
-    Iterator(BinNodePtr<T> node = nullptr) : m_cur(node) {}
+    Iterator(N* node = nullptr) : m_cur(node) {}
 
     /** 重写*，获取BinNode数据 */
     T& operator*() {return this->m_cur->data;}
@@ -119,16 +122,17 @@ public:
 
 protected:
     int             m_size;     /**< 节点数量 */
-    BinNodePtr<T>   m_root;     /**< 树根节点 */
+    typename N::Link m_root;    /**< 树根节点 */
 
 protected:
-    virtual int update_height(BinNodePtr<T> node);
-    void        update_height_above(BinNodePtr<T> node);
-    int         remove_at(BinNodePtr<T> node);
+    virtual int update_height(N* node);
+    void        update_height_above(N* node);
+    void        update_size_above(N* node);
+    int         remove_at(N* node);
 
 public:
     BinTree() : m_size(0), m_root(nullptr) {}
-    BinTree(const T& ele) : m_size(1) {this->m_root = new BinNode<T>(ele, nullptr);}
+    BinTree(const T& ele) : m_size(1), m_root(new N(ele, nullptr)) {}
     ~BinTree() {if (m_root) this->remove(m_root);}
 
     Iterator begin();
@@ -136,18 +140,18 @@ public:
 
     int     size() const {return this->m_size;}
     bool    is_empty() const {return !this->m_root;}
-    int     remove(BinNodePtr<T>);
+    int     remove(N*);
 
     /** 返回根节点 */
-    BinNodePtr<T> root() {return this->m_root;}
+    N* root() {return this->m_root;}
     /** 插入根节点 */
-    BinNodePtr<T> insert_root(const T& ele) {return this->m_root = new BinNode<T>(ele, nullptr);}
-    BinNodePtr<T> insert_left(BinNodePtr<T> node, const T& ele);
-    BinNodePtr<T> insert_right(BinNodePtr<T> node, const T& ele);
+    N* insert_root(const T& ele) {return this->m_root = new N(ele, nullptr);}
+    N* insert_left(N* node, const T& ele);
+    N* insert_right(N* node, const T& ele);
 };
 
-template <typename T> static void construct_bintree_pre_in(const dsa::Vector<T>& pre, const dsa::Vector<T>& in, BinNodePtr<T>& node);
-template <typename T> void construct_bintree(const dsa::Vector<T>& pre, const dsa::Vector<T>& in, BinTree<T>& bt);
+template <typename T, typename N> static void construct_bintree_pre_in(const dsa::Vector<T>& pre, const dsa::Vector<T>& in, N*& node);
+template <typename T, typename N> void construct_bintree(const dsa::Vector<T>& pre, const dsa::Vector<T>& in, BinTree<T,N>& bt);
 
 /*! @} */
 
@@ -159,13 +163,13 @@ template <typename T> void construct_bintree(const dsa::Vector<T>& pre, const ds
  * @return
  * @retval None
  */
-template <typename T>
-typename BinTree<T>::Iterator BinTree<T>::begin()
+template <typename T, typename N>
+typename BinTree<T,N>::Iterator BinTree<T,N>::begin()
 {
-    BinNodePtr<T> node = this->m_root;
+    N* node = this->m_root;
     while(node && node->left)
         node = node->left;
-    return BinTree<T>::Iterator(node);
+    return BinTree<T,N>::Iterator(node);
 }
 
 /*!
@@ -175,10 +179,10 @@ typename BinTree<T>::Iterator BinTree<T>::begin()
  * @return
  * @retval None
  */
-template <typename T>
-typename BinTree<T>::Iterator BinTree<T>::end()
+template <typename T, typename N>
+typename BinTree<T,N>::Iterator BinTree<T,N>::end()
 {
-    return BinTree<T>::Iterator(nullptr);
+    return BinTree<T,N>::Iterator(nullptr);
 }
 
 /*!
@@ -188,12 +192,13 @@ typename BinTree<T>::Iterator BinTree<T>::end()
  * @return 返回节点高度
  * @retval None
  */
-template <typename T>
-int BinTree<T>::update_height(BinNodePtr<T> node)
+template <typename T, typename N>
+int BinTree<T,N>::update_height(N* node)
 {
     // 叶子结点没有子结点了，其高度为 1 + (-1) = 0
     int a = node->left ? node->left->height : -1;
     int b = node->right ? node->right->height : -1;
+    BN_UpdateCount(*node);
     return node->height = 1 + ((a>=b)?a:b);
 }
 
@@ -204,8 +209,8 @@ int BinTree<T>::update_height(BinNodePtr<T> node)
  * @return
  * @retval None
  */
-template <typename T>
-void BinTree<T>::update_height_above(BinNodePtr<T> node)
+template <typename T, typename N>
+void BinTree<T,N>::update_height_above(N* node)
 {
     while(node)
     {
@@ -214,6 +219,24 @@ void BinTree<T>::update_height_above(BinNodePtr<T> node)
     }
 }
 
+/*!
+ * @brief 更新node及祖先的子树规模
+ *
+ * 只更新cnt，不更新高度（红黑树调整过程中，祖先的黑高度由solve_double_red/black负责）。
+ *
+ * @param node: BinNode节点
+ * @return
+ * @retval None
+ */
+template <typename T, typename N>
+void BinTree<T,N>::update_size_above(N* node)
+{
+#if BN_ORDER_STAT
+    for (; node; node = node->parent)
+        BN_UpdateCount(*node);
+#endif
+}
+
 /*!
  * @brief 删除以位置node处节点为根的子树
  *
@@ -221,8 +244,8 @@ void BinTree<T>::update_height_above(BinNodePtr<T> node)
  * @return 返回删除的节点总数
  * @retval None
  */
-template <typename T>
-int BinTree<T>::remove_at(BinNodePtr<T> node)
+template <typename T, typename N>
+int BinTree<T,N>::remove_at(N* node)
 {
     if (!node) return 0;
     int n = 1 + this->remove_at(node->left) + this->remove_at(node->right);
@@ -238,10 +261,10 @@ int BinTree<T>::remove_at(BinNodePtr<T> node)
  * @return 返回该子树原先的规模
  * @retval None
  */
-template <typename T>
-int BinTree<T>::remove(BinNodePtr<T> node)
+template <typename T, typename N>
+int BinTree<T,N>::remove(N* node)
 {
-    BinNodePtr<T> p = node->parent;
+    N* p = node->parent;
     if (p)
     {
         if (p->left == node) p->left = nullptr;
@@ -261,11 +284,11 @@ int BinTree<T>::remove(BinNodePtr<T> node)
  * @return 返回新结点的指针
  * @retval None
  */
-template <typename T>
-BinNodePtr<T> BinTree<T>::insert_left(BinNodePtr<T> node, const T& ele)
+template <typename T, typename N>
+N* BinTree<T,N>::insert_left(N* node, const T& ele)
 {
     this->m_size ++;
-    node->insert_left(new BinNode<T>(ele, node));
+    node->insert_left(new N(ele, node));
     this->update_height_above(node);    // 新加结点后，高度变化
     return node->left;
 }
@@ -278,11 +301,11 @@ BinNodePtr<T> BinTree<T>::insert_left(BinNodePtr<T> node, const T& ele)
  * @return 返回新结点的指针
  * @retval None
  */
-template <typename T>
-BinNodePtr<T> BinTree<T>::insert_right(BinNodePtr<T> node, const T& ele)
+template <typename T, typename N>
+N* BinTree<T,N>::insert_right(N* node, const T& ele)
 {
     this->m_size ++;
-    node->insert_right(new BinNode<T>(ele, node));
+    node->insert_right(new N(ele, node));
     this->update_height_above(node);
     return node->right;
 }
@@ -297,11 +320,11 @@ BinNodePtr<T> BinTree<T>::insert_right(BinNodePtr<T> node, const T& ele)
  * @return
  * @retval None
  */
-template <typename T>
+template <typename T, typename N>
 static void construct_bintree_pre_in(
         const dsa::Vector<T>& pre,
         const dsa::Vector<T>& in,
-        BinNodePtr<T>& node)
+        N*& node)
 {
     // 查找子树的根节点
     int d_index = in.find(pre[0], 0, in.size());
@@ -324,13 +347,13 @@ static void construct_bintree_pre_in(
     if(!l_pre.is_empty())
     {
         // 插件子树的根节点
-        BinNodePtr<T> left = node->insert_left(new BinNode<T>(l_pre[0], left));
+        N* left = node->insert_left(new N(l_pre[0], node));
         // 继续重构左子树与右子树
         construct_bintree_pre_in(l_pre, l_in, left);
     }
     if(!r_pre.is_empty())
     {
-        BinNodePtr<T> right = node->insert_right(new BinNode<T>(r_pre[0], right));
+        N* right = node->insert_right(new N(r_pre[0], node));
         construct_bintree_pre_in(r_pre, r_in, right);
     }
 }
@@ -348,14 +371,14 @@ static void construct_bintree_pre_in(
  * @return
  * @retval None
  */
-template <typename T>
+template <typename T, typename N>
 void construct_bintree(
         const dsa::Vector<T>& pre,
         const dsa::Vector<T>& in,
-        BinTree<T>& bt)
+        BinTree<T,N>& bt)
 {
     bt.insert_root(pre[0]);
-    BinNodePtr<T> root = bt.root();
+    N* root = bt.root();
     construct_bintree_pre_in(pre, in, root);
 }
 
@@ -16,6 +16,7 @@
 
 #include <cstdio>
 #include <cstring>
+#include <cstdint>
 
 namespace dsa
 {
@@ -48,25 +49,32 @@ namespace dsa
  * char[n]  : n = k/8 = k>>3
  * bit[n-1] : n = 0x80 >> (k%8) = 0x80 >> (k&0x07)
  *
+ * (3) 对齐：可指定m_cap[]起始地址的对齐要求（如缓存行），扩展后仍保持对齐。
  * </pre>
  */
 class Bitmap
 {
 private:
+    char*   m_raw;      /**< 申请的内存，m_cap[]位于其中按m_align对齐的位置 */
     char*   m_cap;      /**< Bitmap内存空间m_cap[] */
     int     m_len;      /**< m_cap[]的长度，数据范围[0, m_len*8) */
+    int     m_align;    /**< m_cap[]起始地址的对齐要求（字节，2的幂），1表示不要求 */
 
 public:
-    Bitmap(int n = 8) {this->init(n);}
+    /*!
+     * @param n: 数据范围[0, n)
+     * @param align: m_cap[]起始地址的对齐要求（字节，2的幂）
+     */
+    Bitmap(int n = 8, int align = 1) : m_align(align) {this->init(n);}
     /** 用char数组生成Bitmap */
-    Bitmap(int len, const char bm[])
+    Bitmap(int len, const char bm[]) : m_align(1)
     {
         this->m_len = len;
-        this->m_cap = new char[this->m_len];
+        this->alloc();
         std::memcpy(this->m_cap, bm, len);
     }
     /** 从文件中读取数据 */
-    Bitmap(const char* file, int n)
+    Bitmap(const char* file, int n) : m_align(1)
     {
         this->init(n);
         std::FILE* fp = std::fopen(file, "rb");
@@ -74,25 +82,32 @@ public:
         std::fclose(fp);
     }
     /** 拷贝构造函数 */
-    Bitmap(const Bitmap& bm)
+    Bitmap(const Bitmap& bm) : m_align(bm.m_align)
     {
         this->m_len = bm.m_len;
-        this->m_cap = new char[this->m_len];
+        this->alloc();
         std::memcpy(this->m_cap, bm.m_cap, this->m_len);
     }
-    ~Bitmap() {delete[] this->m_cap; this->m_cap = nullptr;}
+    ~Bitmap() {delete[] this->m_raw; this->m_raw = this->m_cap = nullptr;}
 
     /** 标记对应k的bit为1，即插入数据 */
     void set(int k)   {this->expand(k); m_cap[k>>3] |=   (0x80 >> (k & 0x07));}
     /** 标记对应k的bit为0，即删除数据 */
     void clear(int k) {this->expand(k); m_cap[k>>3] &= (~(0x80 >> (k & 0x07)));}
     /** 返回对应k的bit，即数据存在与否 */
-    bool test(int k)
+    bool test(int k) const
     {
         if (k >= this->m_len*8) return false;
         return (m_cap[k>>3] & (0x80 >> (k & 0x07)));
     }
 
+    /** 将所有bit标记为0 */
+    void reset() {std::memset(this->m_cap, 0, this->m_len);}
+    /** 返回m_cap[]的起始地址 */
+    const char* data() const {return this->m_cap;}
+    /** 返回m_cap[]的长度（字节） */
+    int  size() const {return this->m_len;}
+
     /** 将Bitmap导出到二进制文件 */
     void dump(const char* file)
     {
@@ -102,11 +117,19 @@ public:
     }
 
 protected:
+    /** 申请m_len字节的内存，new只保证基本对齐，多申请m_align-1字节后手动对齐起始位置 */
+    void alloc()
+    {
+        this->m_raw = new char[this->m_len + this->m_align - 1];
+        std::uintptr_t a = reinterpret_cast<std::uintptr_t>(this->m_raw);
+        this->m_cap = reinterpret_cast<char*>((a + this->m_align - 1) & ~(std::uintptr_t)(this->m_align - 1));
+    }
+
     /** 初始化Bitmap，按语义，数据范围为[0, n) */
     void init(int n)
     {
         this->m_len = (n + 7) / 8;  // 对n/8上取整
-        this->m_cap = new char[this->m_len];
+        this->alloc();
         std::memset(this->m_cap, 0, this->m_len);
     }
 
@@ -115,10 +138,11 @@ protected:
     {
         if (k < this->m_len * 8) return;
         int old_len = this->m_len;
+        char* old_raw = this->m_raw;
         char* old_cap = this->m_cap;
         this->init(2*k);
         std::memcpy(this->m_cap, old_cap, old_len);
-        delete[] old_cap;
+        delete[] old_raw;
     }
 };
 
@@ -0,0 +1,770 @@
+
+//==============================================================================
+/*!
+ * @file bplus_tree.h
+ * @brief b+树(b+ tree)类
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_BPLUS_TREE_H
+#define DSAS_BPLUS_TREE_H
+
+#include <new>
+#include "vector.h"
+#include "share/macro.h"
+#include "share/compare.h"
+#include "share/pool.h"
+
+#ifndef BPT_USE_SIMD
+#define BPT_USE_SIMD        1       /**< 节点内查找使用SIMD（目前只有int关键码，且需要SSE2） */
+#endif
+
+#if BPT_USE_SIMD && defined(__SSE2__)
+#include <emmintrin.h>
+#define BPT_SIMD_SSE2
+#endif
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup TBTree
+ * @{
+ */
+
+#ifndef BPT_NODE_LINES
+#define BPT_NODE_LINES      2       /**< 叶节点（内部节点的关键码部分）占用的缓存行数，取1~4 */
+#endif
+#define BPT_MAX_HEIGHT      32      /**< 树高上限（每个非根内部节点至少有2个以上分支，远大于实际需要） */
+
+/*!
+ * @brief 节点内查找，通用版本为二分查找
+ *
+ * lower返回第一个不小于e的位置，upper返回第一个大于e的位置，范围均为[0, n]。
+ */
+template <typename T>
+struct BptSearch
+{
+    static int lower(const T* key, int n, const T& e)
+    {
+        int lo = 0, hi = n;
+        while (lo < hi)
+        {
+            int mi = (lo + hi) >> 1;
+            if (dsa::less_than(key[mi], e)) lo = mi + 1;
+            else hi = mi;
+        }
+        return lo;
+    }
+    static int upper(const T* key, int n, const T& e)
+    {
+        int lo = 0, hi = n;
+        while (lo < hi)
+        {
+            int mi = (lo + hi) >> 1;
+            if (dsa::less_than(e, key[mi])) hi = mi;
+            else lo = mi + 1;
+        }
+        return lo;
+    }
+};
+
+#ifdef BPT_SIMD_SSE2
+/*!
+ * @brief int关键码的节点内查找，SSE2每次比较4个关键码
+ *
+ * <pre>
+ * 关键码数组按缓存行对齐，容量为4的倍数，故可以按16字节对齐读取，
+ * 超出n的部分（未初始化）通过掩码排除；
+ * 关键码有序，比较结果的掩码总是低位连续的1，遇到不全为1的分组即可结束，
+ * 结果为该分组之前的关键码数加上掩码中1的个数。
+ * 与二分查找相比，没有难以预测的分支，且一个缓存行内的关键码只需要4次比较。
+ * </pre>
+ */
+template <>
+struct BptSearch<int>
+{
+    static int ones(int m)
+    {
+        static const char cnt[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+        return cnt[m];
+    }
+    static int lower(const int* key, int n, const int& e)
+    {
+        __m128i v = _mm_set1_epi32(e);
+        for (int k = 0; k < n; k += 4)
+        {
+            __m128i x = _mm_load_si128(reinterpret_cast<const __m128i*>(key + k));
+            int m = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(x, v)));   // key < e
+            if (m != 0xF)
+                return k + ones(m & (n - k >= 4 ? 0xF : (1 << (n - k)) - 1));
+        }
+        return n;
+    }
+    static int upper(const int* key, int n, const int& e)
+    {
+        __m128i v = _mm_set1_epi32(e);
+        for (int k = 0; k < n; k += 4)
+        {
+            __m128i x = _mm_load_si128(reinterpret_cast<const __m128i*>(key + k));
+            int m = ~_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(x, v))) & 0xF;   // key <= e
+            if (m != 0xF)
+                return k + ones(m & (n - k >= 4 ? 0xF : (1 << (n - k)) - 1));
+        }
+        return n;
+    }
+};
+#endif
+
+/*!
+ * @brief b+树(b+ tree)类
+ *
+ * <pre>
+ * 与BTree相比：
+ * (1) 关键码只存放在叶节点中，内部节点只保存分隔码（右侧子树的下界）用于导航：
+ *         child[i]中的关键码 < key[i] <= child[i+1]中的关键码
+ * (2) 叶节点按关键码顺序串成单链表，区间扫描定位到起点后只需沿链表前进，不必再回到内部节点；
+ * (3) 节点为定长结构，关键码数组内联存放、按缓存行对齐，每个节点只有一次分配（来自节点池），
+ *     叶节点恰好占用BPT_NODE_LINES个缓存行；BTree的节点则是BTNode、key、child三次分配。
+ *
+ *                 [ 30 | 60 ]                      内部节点：只有分隔码
+ *               /      |      \
+ *   [5|10|20] -> [30|40|50] -> [60|70|80] -> nullptr    叶节点：全部关键码，单链表
+ *
+ * 设每个节点容量为CAP，除树根外，每个节点至少有CAP/2个关键码：
+ * 插入：叶节点上溢时分裂为两半，右半部分的第一个关键码作为分隔码插入父节点，父节点上溢时继续分裂；
+ * 删除：节点下溢时，先尝试从相邻兄弟借一个关键码，兄弟也不足时与其合并，并删除父节点中的分隔码。
+ * 删除不会更新分隔码，分隔码可能已不在叶节点中，但仍然是正确的导航边界。
+ * </pre>
+ *
+ */
+template <typename T>
+class BPlusTree
+{
+public:
+    /** 节点关键码容量：叶节点（除去链接与计数）恰好占用BPT_NODE_LINES个缓存行，且为4的倍数（便于SIMD） */
+    static const int CAP = ((BPT_NODE_LINES * DSAS_CACHELINE - 2 * (int)sizeof(void*)) / (int)sizeof(T)) / 4 * 4 < 4
+                         ? 4 : ((BPT_NODE_LINES * DSAS_CACHELINE - 2 * (int)sizeof(void*)) / (int)sizeof(T)) / 4 * 4;
+    /** 非根节点的最少关键码数 */
+    static const int MIN = CAP / 2;
+
+private:
+    /** 节点（也即叶节点），关键码数组位于节点开头，与缓存行对齐 */
+    struct alignas(DSAS_CACHELINE) Node
+    {
+        T       key[CAP];
+        int     n;          /**< 关键码数量 */
+        bool    leaf;
+        Node*   next;       /**< 叶节点：右侧相邻的叶节点 */
+
+        Node(bool lf = true) : n(0), leaf(lf), next(nullptr) {}
+    };
+    /** 内部节点，n个分隔码，n+1个分支 */
+    struct Inner : Node
+    {
+        Node*   child[CAP + 1];
+
+        Inner() : Node(false) {}
+    };
+    using Search = BptSearch<T>;
+
+    Node*           m_root;
+    Node*           m_first;    /**< 最左侧叶节点 */
+    int             m_size;     /**< 关键码总数 */
+    int             m_height;   /**< 树高（只有叶节点时为1） */
+    dsa::NodePool   m_lpool;    /**< 叶节点池 */
+    dsa::NodePool   m_ipool;    /**< 内部节点池 */
+
+protected:
+    Node*   new_leaf() {return new (this->m_lpool.alloc()) Node();}
+    Inner*  new_inner() {return new (this->m_ipool.alloc()) Inner();}
+    void    free_node(Node* x)
+    {
+        if (x->leaf)
+        {
+            x->~Node();
+            this->m_lpool.free(x);
+        }
+        else
+        {
+            static_cast<Inner*>(x)->~Inner();
+            this->m_ipool.free(x);
+        }
+    }
+    void    clear(Node*);
+    const Node* find_leaf(const T&) const;
+    T       split_inner(Inner*, Inner*, int, const T&, Node*);
+    void    fix_leaf(Inner*, int);
+    void    fix_inner(Inner*, int);
+    void    erase_at(Inner*, int);
+
+public:
+    /*!
+     * @brief 叶节点链表上的迭代器（只读）
+     */
+    class Iterator
+    {
+    private:
+        const Node* m_leaf;
+        int         m_pos;
+
+        /** 越过叶节点末尾时，移到下一个叶节点 */
+        void    normalize()
+        {
+            while (this->m_leaf && this->m_pos >= this->m_leaf->n)
+            {
+                this->m_leaf = this->m_leaf->next;
+                this->m_pos = 0;
+            }
+        }
+
+    public:
+        Iterator(const Node* leaf = nullptr, int pos = 0) : m_leaf(leaf), m_pos(pos) {this->normalize();}
+
+        const T& operator*() const {return this->m_leaf->key[this->m_pos];}
+        const T* operator->() const {return &this->m_leaf->key[this->m_pos];}
+        bool operator== (const Iterator& itr) const {return this->m_leaf == itr.m_leaf && this->m_pos == itr.m_pos;}
+        bool operator!= (const Iterator& itr) const {return !(*this == itr);}
+        Iterator& operator++() {this->m_pos ++; this->normalize(); return *this;}
+    };
+
+    BPlusTree()
+        : m_size(0), m_height(1),
+          m_lpool(sizeof(Node), alignof(Node)), m_ipool(sizeof(Inner), alignof(Inner))
+    {
+        this->m_root = this->m_first = this->new_leaf();
+    }
+    ~BPlusTree() {this->clear(this->m_root);}
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator= (const BPlusTree&) = delete;
+
+    /** 返回关键码总数 */
+    int     size() const {return this->m_size;}
+    /** 是否没有关键码 */
+    bool    is_empty() const {return this->m_size == 0;}
+    /** 返回树高（只有叶节点时为1） */
+    int     height() const {return this->m_height;}
+
+    const T* search(const T& e) const;
+    bool    insert(const T& e);
+    bool    remove(const T& e);
+    void    build_from_sorted(const dsa::Vector<T>& v);
+
+    Iterator begin() const {return Iterator(this->m_first, 0);}
+    Iterator end() const {return Iterator();}
+    /** 第一个不小于e的关键码 */
+    Iterator lower_bound(const T& e) const
+    {
+        const Node* x = this->find_leaf(e);
+        return Iterator(x, Search::lower(x->key, x->n, e));
+    }
+    /** 第一个大于e的关键码 */
+    Iterator upper_bound(const T& e) const
+    {
+        const Node* x = this->find_leaf(e);
+        return Iterator(x, Search::upper(x->key, x->n, e));
+    }
+
+    /*!
+     * @brief 按顺序访问区间[lo, hi)内的关键码
+     *
+     * @param lo,hi: 区间[lo, hi)
+     * @param visit: 访问函数，visit(const T&)
+     * @return 返回访问的关键码数量
+     * @retval None
+     */
+    template <typename VST>
+    int     range(const T& lo, const T& hi, VST& visit) const
+    {
+        int cnt = 0;
+        const Node* x = this->find_leaf(lo);
+        for (int k = Search::lower(x->key, x->n, lo); x; x = x->next, k = 0)
+        {
+            for (; k < x->n; k ++, cnt ++)
+            {
+                if (!dsa::less_than(x->key[k], hi))
+                    return cnt;
+                visit(x->key[k]);
+            }
+        }
+        return cnt;
+    }
+};
+
+/*! @} */
+
+
+/*!
+ * @brief 释放以x为根的子树
+ *
+ * @param x: 子树根节点
+ * @return
+ * @retval None
+ */
+template <typename T>
+void BPlusTree<T>::clear(Node* x)
+{
+    if (!x->leaf)
+    {
+        Inner* in = static_cast<Inner*>(x);
+        for (int k = 0; k <= in->n; k ++)
+            this->clear(in->child[k]);
+    }
+    this->free_node(x);
+}
+
+/*!
+ * @brief 查找e所在（或应插入）的叶节点
+ *
+ * @param e: 查找目标
+ * @return
+ * @retval None
+ */
+template <typename T>
+const typename BPlusTree<T>::Node* BPlusTree<T>::find_leaf(const T& e) const
+{
+    const Node* x = this->m_root;
+    while (!x->leaf)
+    {
+        const Inner* in = static_cast<const Inner*>(x);
+        x = in->child[Search::upper(in->key, in->n, e)];
+    }
+    return x;
+}
+
+/*!
+ * @brief 查找
+ *
+ * @param e: 查找目标
+ * @return 返回指向关键码的指针，不存在时返回nullptr
+ * @retval None
+ */
+template <typename T>
+const T* BPlusTree<T>::search(const T& e) const
+{
+    const Node* x = this->find_leaf(e);
+    int k = Search::lower(x->key, x->n, e);
+    return (k < x->n && !dsa::less_than(e, x->key[k])) ? &x->key[k] : nullptr;
+}
+
+/*!
+ * @brief 分裂上溢的内部节点
+ *
+ * <pre>
+ * 在p中插入分隔码sep（位置i）与分支rc（位置i+1）后，共有CAP+1个分隔码，CAP+2个分支：
+ * 前CAP/2个分隔码留在p中，第CAP/2个上移至父节点，其余移到新节点q中。
+ * </pre>
+ *
+ * @param p: 已满的内部节点
+ * @param q: 新的（空）内部节点，作为p的右兄弟
+ * @param i: 插入位置
+ * @param sep,rc: 插入的分隔码及其右侧分支
+ * @return 返回需要插入父节点的分隔码
+ * @retval None
+ */
+template <typename T>
+T BPlusTree<T>::split_inner(Inner* p, Inner* q, int i, const T& sep, Node* rc)
+{
+    T       key[CAP + 1];
+    Node*   child[CAP + 2];
+    for (int k = 0; k <= CAP; k ++)
+        key[k] = (k < i) ? p->key[k] : ((k == i) ? sep : p->key[k - 1]);
+    for (int k = 0; k <= CAP + 1; k ++)
+        child[k] = (k <= i) ? p->child[k] : ((k == i + 1) ? rc : p->child[k - 1]);
+
+    const int M = CAP / 2;
+    p->n = M;
+    for (int k = 0; k < M; k ++)
+        p->key[k] = key[k];
+    for (int k = 0; k <= M; k ++)
+        p->child[k] = child[k];
+    q->n = CAP - M;
+    for (int k = 0; k < q->n; k ++)
+        q->key[k] = key[M + 1 + k];
+    for (int k = 0; k <= q->n; k ++)
+        q->child[k] = child[M + 1 + k];
+    return key[M];
+}
+
+/*!
+ * @brief 插入
+ *
+ * @param e: 插入目标
+ * @return 已存在时返回false
+ * @retval None
+ */
+template <typename T>
+bool BPlusTree<T>::insert(const T& e)
+{
+    Inner*  path[BPT_MAX_HEIGHT];
+    int     idx[BPT_MAX_HEIGHT];
+    int     d = 0;
+
+    Node* x = this->m_root;
+    while (!x->leaf)
+    {
+        Inner* in = static_cast<Inner*>(x);
+        path[d] = in;
+        idx[d] = Search::upper(in->key, in->n, e);
+        x = in->child[idx[d ++]];
+    }
+    int pos = Search::lower(x->key, x->n, e);
+    if (pos < x->n && !dsa::less_than(e, x->key[pos]))
+        return false;
+    this->m_size ++;
+
+    if (x->n < CAP)
+    {
+        for (int k = x->n; k > pos; k --)
+            x->key[k] = x->key[k - 1];
+        x->key[pos] = e;
+        x->n ++;
+        return true;
+    }
+
+    // 叶节点上溢：CAP+1个关键码，前L个留在x中，其余移到新节点r中
+    const int L = (CAP + 1) / 2;
+    Node* r = this->new_leaf();
+    if (pos < L)
+    {
+        for (int k = L - 1; k < CAP; k ++)
+            r->key[k - L + 1] = x->key[k];
+        for (int k = L - 1; k > pos; k --)
+            x->key[k] = x->key[k - 1];
+        x->key[pos] = e;
+    }
+    else
+    {
+        int j = 0;
+        for (int k = L; k < CAP; k ++)
+        {
+            if (k == pos) r->key[j ++] = e;
+            r->key[j ++] = x->key[k];
+        }
+        if (pos == CAP) r->key[j ++] = e;
+    }
+    x->n = L;
+    r->n = CAP + 1 - L;
+    r->next = x->next;
+    x->next = r;
+
+    // 分隔码与新节点逐层插入父节点
+    T sep = r->key[0];
+    Node* rc = r;
+    while (d > 0)
+    {
+        Inner* p = path[-- d];
+        int i = idx[d];
+        if (p->n < CAP)
+        {
+            for (int k = p->n; k > i; k --)
+            {
+                p->key[k] = p->key[k - 1];
+                p->child[k + 1] = p->child[k];
+            }
+            p->key[i] = sep;
+            p->child[i + 1] = rc;
+            p->n ++;
+            return true;
+        }
+        Inner* q = this->new_inner();
+        sep = this->split_inner(p, q, i, sep, rc);
+        rc = q;
+    }
+
+    // 树根分裂，树高加1
+    Inner* root = this->new_inner();
+    root->n = 1;
+    root->key[0] = sep;
+    root->child[0] = this->m_root;
+    root->child[1] = rc;
+    this->m_root = root;
+    this->m_height ++;
+    return true;
+}
+
+/*!
+ * @brief 删除内部节点p的第i个分隔码及其右侧分支
+ *
+ * @param p: 内部节点
+ * @param i: 分隔码位置
+ * @return
+ * @retval None
+ */
+template <typename T>
+void BPlusTree<T>::erase_at(Inner* p, int i)
+{
+    for (int k = i; k < p->n - 1; k ++)
+    {
+        p->key[k] = p->key[k + 1];
+        p->child[k + 1] = p->child[k + 2];
+    }
+    p->n --;
+}
+
+/*!
+ * @brief 修复叶节点p->child[i]的下溢
+ *
+ * <pre>
+ * 左兄弟富余：借入其最大关键码，分隔码更新为借入的关键码；
+ * 右兄弟富余：借入其最小关键码，分隔码更新为右兄弟新的最小关键码；
+ * 否则与左（或右）兄弟合并，右侧节点并入左侧节点后释放，并删除父节点中两者之间的分隔码。
+ * </pre>
+ *
+ * @param p: 父节点
+ * @param i: 下溢节点在p中的分支位置
+ * @return
+ * @retval None
+ */
+template <typename T>
+void BPlusTree<T>::fix_leaf(Inner* p, int i)
+{
+    Node* c = p->child[i];
+    Node* ls = (i > 0) ? p->child[i - 1] : nullptr;
+    Node* rs = (i < p->n) ? p->child[i + 1] : nullptr;
+
+    if (ls && ls->n > MIN)
+    {
+        for (int k = c->n; k > 0; k --)
+            c->key[k] = c->key[k - 1];
+        c->key[0] = ls->key[-- ls->n];
+        c->n ++;
+        p->key[i - 1] = c->key[0];
+    }
+    else if (rs && rs->n > MIN)
+    {
+        c->key[c->n ++] = rs->key[0];
+        for (int k = 0; k < rs->n - 1; k ++)
+            rs->key[k] = rs->key[k + 1];
+        rs->n --;
+        p->key[i] = rs->key[0];
+    }
+    else
+    {
+        // 合并：r并入l
+        Node* l = ls ? ls : c;
+        Node* r = ls ? c : rs;
+        for (int k = 0; k < r->n; k ++)
+            l->key[l->n + k] = r->key[k];
+        l->n += r->n;
+        l->next = r->next;
+        this->erase_at(p, ls ? i - 1 : i);
+        this->free_node(r);
+    }
+}
+
+/*!
+ * @brief 修复内部节点p->child[i]的下溢
+ *
+ * <pre>
+ * 与BTree相同，借关键码时经过父节点旋转：
+ * 左兄弟富余：父节点的分隔码下移为c的第一个分隔码，左兄弟的最后一个分隔码上移，最后一个分支移到c；
+ * 右兄弟富余：对称；
+ * 否则将父节点的分隔码下移，与左（或右）兄弟合并。
+ * </pre>
+ *
+ * @param p: 父节点
+ * @param i: 下溢节点在p中的分支位置
+ * @return
+ * @retval None
+ */
+template <typename T>
+void BPlusTree<T>::fix_inner(Inner* p, int i)
+{
+    Inner* c = static_cast<Inner*>(p->child[i]);
+    Inner* ls = (i > 0) ? static_cast<Inner*>(p->child[i - 1]) : nullptr;
+    Inner* rs = (i < p->n) ? static_cast<Inner*>(p->child[i + 1]) : nullptr;
+
+    if (ls && ls->n > MIN)
+    {
+        c->child[c->n + 1] = c->child[c->n];
+        for (int k = c->n; k > 0; k --)
+        {
+            c->key[k] = c->key[k - 1];
+            c->child[k] = c->child[k - 1];
+        }
+        c->key[0] = p->key[i - 1];
+        c->child[0] = ls->child[ls->n];
+        c->n ++;
+        p->key[i - 1] = ls->key[-- ls->n];
+    }
+    else if (rs && rs->n > MIN)
+    {
+        c->key[c->n] = p->key[i];
+        c->child[c->n + 1] = rs->child[0];
+        c->n ++;
+        p->key[i] = rs->key[0];
+        for (int k = 0; k < rs->n - 1; k ++)
+        {
+            rs->key[k] = rs->key[k + 1];
+            rs->child[k] = rs->child[k + 1];
+        }
+        rs->child[rs->n - 1] = rs->child[rs->n];
+        rs->n --;
+    }
+    else
+    {
+        // 合并：分隔码下移，r并入l
+        Inner* l = ls ? ls : c;
+        Inner* r = ls ? c : rs;
+        int s = ls ? i - 1 : i;
+        l->key[l->n] = p->key[s];
+        for (int k = 0; k < r->n; k ++)
+            l->key[l->n + 1 + k] = r->key[k];
+        for (int k = 0; k <= r->n; k ++)
+            l->child[l->n + 1 + k] = r->child[k];
+        l->n += 1 + r->n;
+        this->erase_at(p, s);
+        this->free_node(r);
+    }
+}
+
+/*!
+ * @brief 删除
+ *
+ * @param e: 删除目标
+ * @return 不存在时返回false
+ * @retval None
+ */
+template <typename T>
+bool BPlusTree<T>::remove(const T& e)
+{
+    Inner*  path[BPT_MAX_HEIGHT];
+    int     idx[BPT_MAX_HEIGHT];
+    int     d = 0;
+
+    Node* x = this->m_root;
+    while (!x->leaf)
+    {
+        Inner* in = static_cast<Inner*>(x);
+        path[d] = in;
+        idx[d] = Search::upper(in->key, in->n, e);
+        x = in->child[idx[d ++]];
+    }
+    int pos = Search::lower(x->key, x->n, e);
+    if (pos >= x->n || dsa::less_than(e, x->key[pos]))
+        return false;
+    for (int k = pos; k < x->n - 1; k ++)
+        x->key[k] = x->key[k + 1];
+    x->n --;
+    this->m_size --;
+
+    // 自底向上修复下溢
+    Node* c = x;
+    while (d > 0 && c->n < MIN)
+    {
+        Inner* p = path[-- d];
+        if (c->leaf)
+            this->fix_leaf(p, idx[d]);
+        else
+            this->fix_inner(p, idx[d]);
+        c = p;
+    }
+
+    // 树根只剩一个分支时，树高减1
+    if (!this->m_root->leaf && this->m_root->n == 0)
+    {
+        Node* r = this->m_root;
+        this->m_root = static_cast<Inner*>(r)->child[0];
+        this->free_node(r);
+        this->m_height --;
+    }
+    return true;
+}
+
+/*!
+ * @brief 由有序序列批量构建（原有的关键码被清除）
+ *
+ * <pre>
+ * 自底向上逐层构建，O(n)：
+ * (1) 将n个关键码均分到ceil(n/CAP)个叶节点中，并串成链表；
+ * (2) 将一层的节点均分到ceil(c/(CAP+1))个父节点中，第k个分支的分隔码为其子树的最小关键码；
+ * (3) 重复(2)直到只剩一个节点。
+ * 均分保证了除树根外，每个节点至少有CAP/2个关键码，且叶节点几乎是满的，扫描时缓存利用率最高。
+ * v不是严格递增时，先排序去重。
+ * </pre>
+ *
+ * @param v: 有序序列
+ * @return
+ * @retval None
+ */
+template <typename T>
+void BPlusTree<T>::build_from_sorted(const dsa::Vector<T>& v)
+{
+    dsa::Vector<T> u(0);
+    const dsa::Vector<T>* src = &v;
+    for (int k = 1; k < v.size(); k ++)
+    {
+        if (!dsa::less_than(v[k-1], v[k]))
+        {
+            u = v;
+            u.sort();
+            u.uniquify();
+            src = &u;
+            break;
+        }
+    }
+
+    this->clear(this->m_root);
+    this->m_size = src->size();
+    this->m_height = 1;
+    int n = src->size();
+    if (n == 0)
+    {
+        this->m_root = this->m_first = this->new_leaf();
+        return;
+    }
+
+    // 叶节点层
+    int c = (n + CAP - 1) / CAP;
+    dsa::Vector<Node*> level(c);
+    dsa::Vector<T> low(c);          // 每个节点子树的最小关键码
+    Node* prev = nullptr;
+    for (int j = 0, s = 0; j < c; j ++)
+    {
+        Node* x = this->new_leaf();
+        x->n = n / c + (j < n % c ? 1 : 0);
+        for (int k = 0; k < x->n; k ++)
+            x->key[k] = (*src)[s ++];
+        if (prev) prev->next = x;
+        else this->m_first = x;
+        prev = x;
+        level.push_back(x);
+        low.push_back(x->key[0]);
+    }
+
+    // 逐层向上
+    while (c > 1)
+    {
+        int np = (c + CAP) / (CAP + 1);
+        dsa::Vector<Node*> up(np);
+        dsa::Vector<T> ulow(np);
+        for (int j = 0, s = 0; j < np; j ++)
+        {
+            Inner* in = this->new_inner();
+            int m = c / np + (j < c % np ? 1 : 0);
+            for (int k = 0; k < m; k ++, s ++)
+            {
+                in->child[k] = level[s];
+                if (k > 0) in->key[k - 1] = low[s];
+            }
+            in->n = m - 1;
+            up.push_back(in);
+            ulow.push_back(low[s - m]);
+        }
+        level = up;
+        low = ulow;
+        c = np;
+        this->m_height ++;
+    }
+    this->m_root = level[0];
+}
+
+} /* dsa */
+
+#endif /* ifndef DSAS_BPLUS_TREE_H */
@@ -0,0 +1,439 @@
+
+//==============================================================================
+/*!
+ * @file buffer_pool.h
+ * @brief 页文件与缓冲池
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_BUFFER_POOL_H
+#define DSAS_BUFFER_POOL_H
+
+#include <cstdio>
+#include <cstring>
+#include "share/macro.h"
+#include "hash.h"
+#if defined DSAS_LINUX
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup TBTree
+ *
+ * @{
+ */
+
+#define PAGE_SIZE_MIN       512         /**< 页大小下限（字节） */
+#define PAGE_SIZE_DEFAULT   4096        /**< 默认页大小（字节） */
+#define BUFFER_FRAMES_MIN   8           /**< 缓冲池的最少页帧数（须大于同时固定的页数） */
+
+/*!
+ * @brief 页文件：以定长页为单位读写的文件
+ *
+ * 页号从0开始，第k页位于文件偏移 k*page_size 处。
+ * DSAS_LINUX下使用pread/pwrite（不依赖文件位置，可用于大于2GB的文件），否则使用std::FILE。
+ */
+class PageFile
+{
+private:
+#if defined DSAS_LINUX
+    int         m_fd;
+#else
+    std::FILE*  m_fp;
+#endif
+    int         m_page_size;
+    int         m_pages;        /**< 页数（包括已分配但尚未写入的页） */
+
+public:
+#if defined DSAS_LINUX
+    PageFile() : m_fd(-1), m_page_size(0), m_pages(0) {}
+#else
+    PageFile() : m_fp(nullptr), m_page_size(0), m_pages(0) {}
+#endif
+    ~PageFile() {this->close();}
+    PageFile(const PageFile&) = delete;
+    PageFile& operator= (const PageFile&) = delete;
+
+    /*!
+     * @brief 打开页文件，不存在时创建
+     *
+     * @param path: 文件路径
+     * @param page_size: 页大小（字节）
+     * @return 失败时返回false
+     * @retval None
+     */
+    bool    open(const char* path, int page_size)
+    {
+        this->close();
+        this->m_page_size = page_size;
+        long long len = 0;
+#if defined DSAS_LINUX
+        this->m_fd = ::open(path, O_RDWR | O_CREAT, 0644);
+        if (this->m_fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(this->m_fd, &st) == 0)
+            len = st.st_size;
+#else
+        this->m_fp = std::fopen(path, "r+b");
+        if (!this->m_fp)
+            this->m_fp = std::fopen(path, "w+b");
+        if (!this->m_fp)
+            return false;
+        std::fseek(this->m_fp, 0, SEEK_END);
+        len = std::ftell(this->m_fp);
+#endif
+        this->m_pages = (int)((len + page_size - 1) / page_size);
+        return true;
+    }
+    /** 关闭文件 */
+    void    close()
+    {
+#if defined DSAS_LINUX
+        if (this->m_fd >= 0)
+            ::close(this->m_fd);
+        this->m_fd = -1;
+#else
+        if (this->m_fp)
+            std::fclose(this->m_fp);
+        this->m_fp = nullptr;
+#endif
+    }
+#if defined DSAS_LINUX
+    bool    is_open() const {return this->m_fd >= 0;}
+#else
+    bool    is_open() const {return this->m_fp != nullptr;}
+#endif
+    int     page_size() const {return this->m_page_size;}
+    int     pages() const {return this->m_pages;}
+    /** 在文件末尾分配一个新页（写入前不占用磁盘） */
+    int     allocate() {return this->m_pages ++;}
+    /** 重设页数，其后的页视为未分配（如丢弃崩溃前未提交的页），不改变文件长度 */
+    void    resize(int pages) {this->m_pages = pages;}
+
+    /*!
+     * @brief 读取一页，超出文件末尾的部分填0
+     *
+     * @param id: 页号
+     * @param buf: 缓冲区，至少page_size字节
+     * @return 读取失败时返回false
+     * @retval None
+     */
+    bool    read(int id, void* buf)
+    {
+        long long off = (long long)id * this->m_page_size;
+#if defined DSAS_LINUX
+        ssize_t n = ::pread(this->m_fd, buf, this->m_page_size, off);
+        if (n < 0)
+            return false;
+#else
+        if (std::fseek(this->m_fp, (long)off, SEEK_SET) != 0)
+            return false;
+        size_t n = std::fread(buf, 1, this->m_page_size, this->m_fp);
+#endif
+        if ((int)n < this->m_page_size)
+            std::memset(static_cast<char*>(buf) + n, 0, this->m_page_size - n);
+        return true;
+    }
+    /*!
+     * @brief 写入一页
+     *
+     * @param id: 页号
+     * @param buf: 页数据
+     * @return 写入失败时返回false
+     * @retval None
+     */
+    bool    write(int id, const void* buf)
+    {
+        long long off = (long long)id * this->m_page_size;
+#if defined DSAS_LINUX
+        return ::pwrite(this->m_fd, buf, this->m_page_size, off) == this->m_page_size;
+#else
+        if (std::fseek(this->m_fp, (long)off, SEEK_SET) != 0)
+            return false;
+        return std::fwrite(buf, 1, this->m_page_size, this->m_fp) == (size_t)this->m_page_size;
+#endif
+    }
+    /*!
+     * @brief 写入一页中的一段，页中其余部分保持不变
+     *
+     * @param id: 页号
+     * @param off: 页内偏移（字节）
+     * @param buf: 数据
+     * @param n: 字节数，off + n不超过page_size
+     * @return 写入失败时返回false
+     * @retval None
+     */
+    bool    write(int id, int off, const void* buf, int n)
+    {
+        long long pos = (long long)id * this->m_page_size + off;
+#if defined DSAS_LINUX
+        return ::pwrite(this->m_fd, buf, n, pos) == n;
+#else
+        if (std::fseek(this->m_fp, (long)pos, SEEK_SET) != 0)
+            return false;
+        return std::fwrite(buf, 1, n, this->m_fp) == (size_t)n;
+#endif
+    }
+    /** 将已写入的数据刷到磁盘 */
+    bool    sync()
+    {
+#if defined DSAS_LINUX
+        return ::fsync(this->m_fd) == 0;
+#else
+        return std::fflush(this->m_fp) == 0;
+#endif
+    }
+};
+
+/*!
+ * @brief 缓冲池：在内存中缓存页文件的页，CLOCK替换
+ *
+ * <pre>
+ * 每个页帧记录：页号、固定计数pin、脏标记dirty、访问位ref；
+ * pin(page)：命中时直接返回页帧，否则选一个未固定的页帧换出（脏页先写回），再读入目标页；
+ * unpin(page, dirty)：固定计数减1，dirty为true时标记为脏页，脏页在换出或flush时写回；
+ * CLOCK：时钟指针循环扫描页帧，跳过被固定的页帧，ref为1的清0（给第二次机会），ref为0的即为换出对象；
+ * 命中时只设置ref=1，不需要像LRU那样移动链表节点。
+ *
+ * 被固定的页帧不会被换出，其数据地址在unpin之前保持有效；
+ * 同时固定的页数不能超过页帧数（B树操作最多同时固定3页）。
+ * </pre>
+ */
+class BufferPool
+{
+public:
+    /** 缓冲池统计 */
+    struct PoolStat
+    {
+        long long hits;     /**< 命中次数 */
+        long long misses;   /**< 未命中次数 */
+        long long reads;    /**< 从文件读取的页数 */
+        long long writes;   /**< 写回文件的页数 */
+    };
+
+private:
+    struct Frame
+    {
+        int     page;       /**< 页号，-1表示空闲 */
+        int     pin;
+        bool    dirty;
+        bool    ref;
+    };
+
+    dsa::PageFile*  m_file;
+    int             m_frames;
+    char*           m_buf;      /**< 页帧数据，m_frames * page_size */
+    Frame*          m_fr;
+    int             m_hand;     /**< 时钟指针 */
+    dsa::HashTable<int, int> m_table;   /**< 页号 -> 页帧 */
+    PoolStat        m_stat;
+
+protected:
+    char*   frame_data(int f) {return this->m_buf + (long long)f * this->m_file->page_size();}
+    /** CLOCK选择换出的页帧，所有页帧均被固定时返回-1 */
+    int     victim()
+    {
+        for (int k = 0; k < 2 * this->m_frames; k ++)
+        {
+            Frame& fr = this->m_fr[this->m_hand];
+            int f = this->m_hand;
+            this->m_hand = (this->m_hand + 1) % this->m_frames;
+            if (fr.pin > 0)
+                continue;
+            if (fr.ref)
+            {
+                fr.ref = false;
+                continue;
+            }
+            return f;
+        }
+        return -1;
+    }
+
+public:
+    /*!
+     * @param file: 页文件（须已打开）
+     * @param frames: 页帧数
+     */
+    BufferPool(dsa::PageFile& file, int frames)
+        : m_file(&file), m_frames(frames < BUFFER_FRAMES_MIN ? BUFFER_FRAMES_MIN : frames), m_hand(0),
+          m_table(2 * (frames < BUFFER_FRAMES_MIN ? BUFFER_FRAMES_MIN : frames))
+    {
+        this->m_buf = new char[(long long)this->m_frames * file.page_size()];
+        this->m_fr = new Frame[this->m_frames];
+        for (int k = 0; k < this->m_frames; k ++)
+        {
+            this->m_fr[k].page = -1;
+            this->m_fr[k].pin = 0;
+            this->m_fr[k].dirty = false;
+            this->m_fr[k].ref = false;
+        }
+        this->reset_stat();
+    }
+    /** 析构时写回所有脏页 */
+    ~BufferPool()
+    {
+        this->flush();
+        delete[] this->m_buf;
+        delete[] this->m_fr;
+    }
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator= (const BufferPool&) = delete;
+
+    /*!
+     * @brief 固定一页
+     *
+     * @param page: 页号
+     * @param fresh: 为true时表示新分配的页，不从文件读取，直接清0（并标记为脏页）
+     * @return 返回页数据，读取失败或所有页帧均被固定时返回nullptr
+     * @retval None
+     */
+    char*   pin(int page, bool fresh = false)
+    {
+        int* pf = this->m_table.get(page);
+        if (pf)
+        {
+            Frame& fr = this->m_fr[*pf];
+            fr.pin ++;
+            fr.ref = true;
+            this->m_stat.hits ++;
+            if (fresh)
+            {
+                std::memset(this->frame_data(*pf), 0, this->m_file->page_size());
+                fr.dirty = true;
+            }
+            return this->frame_data(*pf);
+        }
+
+        this->m_stat.misses ++;
+        int f = this->victim();
+        if (f < 0)
+            return nullptr;
+        Frame& fr = this->m_fr[f];
+        char* data = this->frame_data(f);
+        if (fr.page >= 0)
+        {
+            if (fr.dirty)
+            {
+                if (!this->m_file->write(fr.page, data))
+                    return nullptr;
+                this->m_stat.writes ++;
+            }
+            this->m_table.remove(fr.page);
+            fr.page = -1;
+        }
+        if (fresh)
+            std::memset(data, 0, this->m_file->page_size());
+        else
+        {
+            if (!this->m_file->read(page, data))
+                return nullptr;
+            this->m_stat.reads ++;
+        }
+        fr.page = page;
+        fr.pin = 1;
+        fr.dirty = fresh;
+        fr.ref = true;
+        this->m_table.put(page, f);
+        return data;
+    }
+    /*!
+     * @brief 解除固定
+     *
+     * @param page: 页号
+     * @param dirty: 页数据是否被修改
+     * @return
+     * @retval None
+     */
+    void    unpin(int page, bool dirty)
+    {
+        int* pf = this->m_table.get(page);
+        if (!pf)
+            return;
+        Frame& fr = this->m_fr[*pf];
+        if (fr.pin > 0)
+            fr.pin --;
+        fr.dirty = fr.dirty || dirty;
+    }
+    /*!
+     * @brief 写回所有脏页
+     *
+     * @param None
+     * @return 写入失败时返回false
+     * @retval None
+     */
+    bool    flush()
+    {
+        bool ok = true;
+        for (int k = 0; k < this->m_frames; k ++)
+        {
+            Frame& fr = this->m_fr[k];
+            if (fr.page >= 0 && fr.dirty)
+            {
+                if (this->m_file->write(fr.page, this->frame_data(k)))
+                {
+                    fr.dirty = false;
+                    this->m_stat.writes ++;
+                }
+                else
+                    ok = false;
+            }
+        }
+        return ok;
+    }
+
+    int     frames() const {return this->m_frames;}
+    /** 获取统计 */
+    const PoolStat& stat() const {return this->m_stat;}
+    /** 清零统计 */
+    void    reset_stat() {this->m_stat.hits = 0; this->m_stat.misses = 0; this->m_stat.reads = 0; this->m_stat.writes = 0;}
+};
+
+/*!
+ * @brief 作用域页固定，构造时pin，析构时unpin
+ *
+ */
+class PageGuard
+{
+private:
+    dsa::BufferPool*    m_pool;
+    int                 m_page;
+    char*               m_data;
+    bool                m_dirty;
+
+public:
+    PageGuard(dsa::BufferPool& pool, int page, bool fresh = false)
+        : m_pool(&pool), m_page(page), m_dirty(fresh) {this->m_data = pool.pin(page, fresh);}
+    ~PageGuard() {this->release();}
+    PageGuard(const PageGuard&) = delete;
+    PageGuard& operator= (const PageGuard&) = delete;
+
+    /** 提前解除固定 */
+    void    release()
+    {
+        if (this->m_data)
+            this->m_pool->unpin(this->m_page, this->m_dirty);
+        this->m_data = nullptr;
+    }
+    /** 标记页数据已修改 */
+    void    mark_dirty() {this->m_dirty = true;}
+    int     page() const {return this->m_page;}
+    char*   data() const {return this->m_data;}
+};
+
+/*! @} */
+
+} /* dsa */
+
+#endif /* ifndef DSAS_BUFFER_POOL_H */
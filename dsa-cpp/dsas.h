@@ -211,6 +211,8 @@ DSAS是数据结构与算法的学习过程。
 #include "share/prime.h"
 #include "share/compare.h"
 #include "share/algorithm.h"
+#include "share/lock.h"
+#include "share/epoch.h"
 
 #include "array.h"
 #include "vector.h"
@@ -220,11 +222,21 @@ DSAS是数据结构与算法的学习过程。
 #include "priority_queue.h"
 #include "pq_list.h"
 #include "pq_complete_heap.h"
+#include "pq_index_heap.h"
+#include "pq_dary_heap.h"
 #include "pq_left_heap.h"
+#include "pq_pairing_heap.h"
+#include "pq_fib_heap.h"
+#include "pq_multiqueue.h"
+#include "pq_radix_heap.h"
+#include "pq_bucket_queue.h"
 //#include "string.h"
 #include "string_match.h"
 #include "bitmap.h"
 #include "hash.h"
+#include "hash_concurrent.h"
+#include "hash_bucket.h"
+#include "hash_frozen.h"
 
 #include "binary_node.h"
 #include "binary_tree.h"
@@ -233,12 +245,20 @@ DSAS是数据结构与算法的学习过程。
 #include "splay_tree.h"
 #include "b_node.h"
 #include "b_tree.h"
+#include "bplus_tree.h"
+#include "buffer_pool.h"
+#include "b_tree_disk.h"
+#include "b_tree_durable.h"
 #include "redblack_tree.h"
 #include "map_rbt.h"
+#include "map_skiplist.h"
+#include "persistent_tree.h"
 #include "kdtree.h"
 #include "trie_tree.h"
 
 #include "graph.h"
 #include "graph_matrix.h"
+#include "graph_csr.h"
+#include "graph_path.h"
 
 #endif /* ifndef DSAS_DSAS_H */
@@ -0,0 +1,384 @@
+
+//==============================================================================
+/*!
+ * @file filter.h
+ * @brief 近似成员查询（Bloom过滤器，分块Bloom过滤器，Cuckoo过滤器）
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_FILTER_H
+#define DSAS_FILTER_H
+
+#include <cmath>
+#include <cstring>
+#include "share/macro.h"
+#include "bitmap.h"
+#include "hash_func.h"
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup LBitmap
+ *
+ * @{
+ */
+
+#define FILTER_BLOCK_BITS   512     /**< 分块Bloom过滤器的块大小（一个缓存行） */
+#define FILTER_CUCKOO_SLOTS 4       /**< Cuckoo过滤器每个桶的指纹数 */
+#define FILTER_CUCKOO_KICKS 500     /**< Cuckoo过滤器插入时的最大踢出次数 */
+
+/** 由每个键的位数，计算最优的Hash函数个数：k = ln2 * m/n */
+inline int filter_hashes(int bits_per_key)
+{
+    int k = static_cast<int>(bits_per_key * 0.69 + 0.5);
+    return k < 1 ? 1 : (k > 16 ? 16 : k);
+}
+
+/*!
+ * @brief Bloom过滤器
+ *
+ * <pre>
+ * m位的Bitmap，每个键置位k个Hash位置；查询时k个位置全为1，则“可能存在”，否则“一定不存在”。
+ * k个位置由一个64位Hash值的高低两半双重散列得到：g_i = h1 + i*h2（Kirsch-Mitzenmacher）。
+ * 误判率约为 (1 - e^(-kn/m))^k，每个键10位时约1%。
+ * 不支持删除。
+ * </pre>
+ *
+ */
+template <typename K, typename HF=dsa::Hash64<K>>
+class BloomFilter
+{
+private:
+    dsa::Bitmap* m_bm;      /**< 位图 */
+    int     m_bits;         /**< 位数m */
+    int     m_k;            /**< Hash函数个数k */
+    int     m_count;        /**< 插入的键数n */
+    HF      hash_func;      /**< 计算Hash的函数 */
+
+public:
+    /*!
+     * @param n: 预计插入的键数
+     * @param bits_per_key: 每个键占用的位数
+     */
+    BloomFilter(int n, int bits_per_key = 10)
+        : m_bits(n * bits_per_key > 64 ? n * bits_per_key : 64), m_k(filter_hashes(bits_per_key)), m_count(0)
+    {
+        this->m_bm = new dsa::Bitmap(this->m_bits);
+    }
+    ~BloomFilter() {delete this->m_bm;}
+    BloomFilter(const BloomFilter&) = delete;
+    BloomFilter& operator= (const BloomFilter&) = delete;
+
+    /** 插入键 */
+    void    insert(const K& key) {this->insert_hash(this->hash_func(key));}
+    /** 查询键是否可能存在 */
+    bool    contains(const K& key) const {return this->contains_hash(this->hash_func(key));}
+    /** 清空 */
+    void    clear() {delete this->m_bm; this->m_bm = new dsa::Bitmap(this->m_bits); this->m_count = 0;}
+    /** 获取插入的键数 */
+    int     count() const {return this->m_count;}
+    /** 获取位数 */
+    int     bits() const {return this->m_bits;}
+    /** 估算当前的误判率 */
+    double  expected_fpr() const {return std::pow(1.0 - std::exp(-(double)this->m_k * this->m_count / this->m_bits), this->m_k);}
+
+    /** 按Hash值插入 */
+    void insert_hash(uint64 h)
+    {
+        uint h1 = static_cast<uint>(h), h2 = static_cast<uint>(h >> 32) | 1;
+        for (int i = 0; i < this->m_k; i ++, h1 += h2)
+            this->m_bm->set(dsa::hash_range(h1, this->m_bits));
+        this->m_count ++;
+    }
+    /** 按Hash值查询 */
+    bool contains_hash(uint64 h) const
+    {
+        uint h1 = static_cast<uint>(h), h2 = static_cast<uint>(h >> 32) | 1;
+        for (int i = 0; i < this->m_k; i ++, h1 += h2)
+            if (!this->m_bm->test(dsa::hash_range(h1, this->m_bits)))
+                return false;
+        return true;
+    }
+};
+
+/*!
+ * @brief 分块Bloom过滤器
+ *
+ * <pre>
+ * 将位图划分为512位（一个缓存行）的块，位图按缓存行对齐，一个键的k个位全部落在同一块中：
+ *   [block 0: 512 bits][block 1: 512 bits]......
+ * Hash值的高32位选择块，低位经混合后每9位确定块内的一个位。
+ * 每次查询只访问一个缓存行（普通Bloom过滤器需访问k个），
+ * 代价是各块负载不均，相同位数下误判率略高。
+ * 不支持删除。
+ * </pre>
+ *
+ */
+template <typename K, typename HF=dsa::Hash64<K>>
+class BloomBlocked
+{
+private:
+    static_assert(FILTER_BLOCK_BITS == DSAS_CACHELINE * 8, "BloomBlocked: a block must be one cache line");
+
+    int     m_blocks;       /**< 块数 */
+    dsa::Bitmap* m_bm;      /**< 位图，起始地址按缓存行对齐，每块占用一个缓存行 */
+    int     m_k;            /**< 块内的Hash位数k */
+    int     m_count;        /**< 插入的键数n */
+    HF      hash_func;      /**< 计算Hash的函数 */
+
+    /** 块数，至少为1 */
+    static int blocks(int n, int bits_per_key)
+    {
+        long bits = (long)n * bits_per_key;
+        int b = static_cast<int>((bits + FILTER_BLOCK_BITS - 1) / FILTER_BLOCK_BITS);
+        return b < 1 ? 1 : b;
+    }
+
+public:
+    /*!
+     * @param n: 预计插入的键数
+     * @param bits_per_key: 每个键占用的位数
+     */
+    BloomBlocked(int n, int bits_per_key = 10)
+        : m_blocks(blocks(n, bits_per_key)), m_k(filter_hashes(bits_per_key)), m_count(0)
+    {
+        this->m_bm = new dsa::Bitmap(this->m_blocks * FILTER_BLOCK_BITS, DSAS_CACHELINE);
+    }
+    ~BloomBlocked() {delete this->m_bm;}
+    BloomBlocked(const BloomBlocked&) = delete;
+    BloomBlocked& operator= (const BloomBlocked&) = delete;
+
+    /** 插入键 */
+    void    insert(const K& key) {this->insert_hash(this->hash_func(key));}
+    /** 查询键是否可能存在 */
+    bool    contains(const K& key) const {return this->contains_hash(this->hash_func(key));}
+    /** 清空 */
+    void    clear() {this->m_bm->reset(); this->m_count = 0;}
+    /** 获取插入的键数 */
+    int     count() const {return this->m_count;}
+    /** 获取位数 */
+    int     bits() const {return this->m_blocks * FILTER_BLOCK_BITS;}
+
+    /** 按Hash值插入 */
+    void insert_hash(uint64 h)
+    {
+        int base = dsa::hash_range(static_cast<uint>(h >> 32), this->m_blocks) * FILTER_BLOCK_BITS;
+        uint64 x = dsa::hash_mix64(h);
+        for (int i = 0; i < this->m_k; i ++, x >>= 9)
+        {
+            if (i && i % 7 == 0)
+                x = dsa::hash_mix64(x + i);     // 64位只够7个9位，之后重新混合
+            this->m_bm->set(base + static_cast<int>(x & (FILTER_BLOCK_BITS - 1)));
+        }
+        this->m_count ++;
+    }
+    /** 按Hash值查询 */
+    bool contains_hash(uint64 h) const
+    {
+        int base = dsa::hash_range(static_cast<uint>(h >> 32), this->m_blocks) * FILTER_BLOCK_BITS;
+        uint64 x = dsa::hash_mix64(h);
+        for (int i = 0; i < this->m_k; i ++, x >>= 9)
+        {
+            if (i && i % 7 == 0)
+                x = dsa::hash_mix64(x + i);
+            if (!this->m_bm->test(base + static_cast<int>(x & (FILTER_BLOCK_BITS - 1))))
+                return false;
+        }
+        return true;
+    }
+};
+
+/*!
+ * @brief Cuckoo过滤器
+ *
+ * <pre>
+ * 桶数为2的幂，每个桶存放4个16位指纹（0表示空）：
+ *   bucket: [fp][fp][fp][fp]
+ * 每个键有两个候选桶：i1 = h & mask，i2 = i1 ^ (Hash(fp) & mask)；
+ * 由于i2只依赖i1与指纹，从任一候选桶都能算出另一个，故可以踢出指纹而不需要原键。
+ * 插入时两个桶均满，则随机踢出一个指纹到它的另一个候选桶，最多踢出FILTER_CUCKOO_KICKS次；
+ * 最后无处安放的指纹存入victim，victim被占用时插入失败（过滤器已满）。
+ * 支持删除（只能删除插入过的键）；误判率约为 8/2^16。
+ * </pre>
+ *
+ */
+template <typename K, typename HF=dsa::Hash64<K>>
+class CuckooFilter
+{
+private:
+    unsigned short* m_tab;  /**< 指纹数组，m_nb * FILTER_CUCKOO_SLOTS */
+    int     m_nb;           /**< 桶数 */
+    int     m_count;        /**< 指纹数 */
+    unsigned short m_vfp;   /**< victim指纹，0表示没有 */
+    int     m_vidx;         /**< victim所在的桶 */
+    unsigned int m_rnd;     /**< 踢出时使用的随机数状态 */
+    HF      hash_func;      /**< 计算Hash的函数 */
+
+protected:
+    inline int mask() const {return this->m_nb - 1;}
+    inline unsigned short fingerprint(uint64 h) const
+    {
+        unsigned short fp = static_cast<unsigned short>(h >> 48);
+        return fp ? fp : 1;
+    }
+    inline int alt_index(int i, unsigned short fp) const
+    {
+        return (i ^ static_cast<int>(dsa::hash_mix64(fp))) & this->mask();
+    }
+    inline bool bucket_has(int i, unsigned short fp) const
+    {
+        const unsigned short* b = this->m_tab + i * FILTER_CUCKOO_SLOTS;
+        return b[0] == fp || b[1] == fp || b[2] == fp || b[3] == fp;
+    }
+    inline bool bucket_put(int i, unsigned short fp)
+    {
+        unsigned short* b = this->m_tab + i * FILTER_CUCKOO_SLOTS;
+        for (int k = 0; k < FILTER_CUCKOO_SLOTS; k ++)
+            if (!b[k]) {b[k] = fp; return true;}
+        return false;
+    }
+    inline bool bucket_del(int i, unsigned short fp)
+    {
+        unsigned short* b = this->m_tab + i * FILTER_CUCKOO_SLOTS;
+        for (int k = 0; k < FILTER_CUCKOO_SLOTS; k ++)
+            if (b[k] == fp) {b[k] = 0; return true;}
+        return false;
+    }
+
+public:
+    /*!
+     * @param n: 预计插入的键数（按95%的装填率分配桶）
+     */
+    CuckooFilter(int n) : m_count(0), m_vfp(0), m_vidx(0), m_rnd(2463534242u)
+    {
+        long need = (long)n * 100 / 95 / FILTER_CUCKOO_SLOTS + 1;
+        this->m_nb = 1;
+        while (this->m_nb < need)
+            this->m_nb <<= 1;
+        this->m_tab = new unsigned short[this->m_nb * FILTER_CUCKOO_SLOTS];
+        std::memset(this->m_tab, 0, sizeof(unsigned short) * this->m_nb * FILTER_CUCKOO_SLOTS);
+    }
+    ~CuckooFilter() {delete[] this->m_tab;}
+    CuckooFilter(const CuckooFilter&) = delete;
+    CuckooFilter& operator= (const CuckooFilter&) = delete;
+
+    /** 插入键，过滤器已满时返回false */
+    bool    insert(const K& key) {return this->insert_hash(this->hash_func(key));}
+    /** 查询键是否可能存在 */
+    bool    contains(const K& key) const {return this->contains_hash(this->hash_func(key));}
+    /** 删除键（必须是插入过的键） */
+    bool    remove(const K& key) {return this->remove_hash(this->hash_func(key));}
+    /** 获取指纹数 */
+    int     count() const {return this->m_count;}
+    /** 获取指纹容量 */
+    int     capacity() const {return this->m_nb * FILTER_CUCKOO_SLOTS;}
+    /** 获取占用的位数 */
+    long    bits() const {return (long)this->m_nb * FILTER_CUCKOO_SLOTS * 16;}
+
+    bool    insert_hash(uint64 h);
+    bool    contains_hash(uint64 h) const;
+    bool    remove_hash(uint64 h);
+};
+
+/*! @} */
+
+
+/*!
+ * @brief 按Hash值插入
+ *
+ * @param h: 64位Hash值
+ * @return 过滤器已满（victim被占用）时返回false
+ * @retval None
+ */
+template <typename K, typename HF>
+bool CuckooFilter<K,HF>::insert_hash(uint64 h)
+{
+    if (this->m_vfp)
+        return false;
+    unsigned short fp = this->fingerprint(h);
+    int i = static_cast<int>(h) & this->mask();
+    int j = this->alt_index(i, fp);
+    this->m_count ++;
+    if (this->bucket_put(i, fp) || this->bucket_put(j, fp))
+        return true;
+    // 两个桶都满，从随机的一个桶开始，随机踢出指纹到它的另一个候选桶
+    if (this->m_rnd & 0x10)
+        i = j;
+    for (int n = 0; n < FILTER_CUCKOO_KICKS; n ++)
+    {
+        this->m_rnd ^= this->m_rnd << 13;
+        this->m_rnd ^= this->m_rnd >> 17;
+        this->m_rnd ^= this->m_rnd << 5;
+        unsigned short& slot = this->m_tab[i * FILTER_CUCKOO_SLOTS + (this->m_rnd & (FILTER_CUCKOO_SLOTS - 1))];
+        unsigned short t = slot;
+        slot = fp;
+        fp = t;
+        i = this->alt_index(i, fp);
+        if (this->bucket_put(i, fp))
+            return true;
+    }
+    this->m_vfp = fp;
+    this->m_vidx = i;
+    return true;
+}
+
+/*!
+ * @brief 按Hash值查询
+ *
+ * @param h: 64位Hash值
+ * @return
+ * @retval None
+ */
+template <typename K, typename HF>
+bool CuckooFilter<K,HF>::contains_hash(uint64 h) const
+{
+    unsigned short fp = this->fingerprint(h);
+    int i = static_cast<int>(h) & this->mask();
+    int j = this->alt_index(i, fp);
+    return this->bucket_has(i, fp) || this->bucket_has(j, fp)
+        || (this->m_vfp == fp && (this->m_vidx == i || this->m_vidx == j));
+}
+
+/*!
+ * @brief 按Hash值删除
+ *
+ * 删除后，尝试将victim放回表中。
+ *
+ * @param h: 64位Hash值
+ * @return
+ * @retval None
+ */
+template <typename K, typename HF>
+bool CuckooFilter<K,HF>::remove_hash(uint64 h)
+{
+    unsigned short fp = this->fingerprint(h);
+    int i = static_cast<int>(h) & this->mask();
+    int j = this->alt_index(i, fp);
+    bool ok = false;
+    if (this->bucket_del(i, fp) || this->bucket_del(j, fp))
+        ok = true;
+    else if (this->m_vfp == fp && (this->m_vidx == i || this->m_vidx == j))
+    {
+        this->m_vfp = 0;
+        ok = true;
+    }
+    if (!ok)
+        return false;
+    this->m_count --;
+    // 腾出了空位，尝试将victim放回它的候选桶
+    if (this->m_vfp
+        && (this->bucket_put(this->m_vidx, this->m_vfp)
+            || this->bucket_put(this->alt_index(this->m_vidx, this->m_vfp), this->m_vfp)))
+        this->m_vfp = 0;
+    return true;
+}
+
+} /* dsa */
+
+#endif /* ifndef DSAS_FILTER_H */
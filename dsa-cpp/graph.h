@@ -54,6 +54,12 @@ typedef enum { UnDiscovered, Discovered, Visited } VStatus;
 typedef enum { UnDetermined, Tree, Cross, Forward, Backward } EStatus;
 
 
+/*!
+ * @brief Dijkstra中选取下一个最近顶点所用的优先级队列
+ *
+ */
+typedef enum { ScanQueue, RadixQueue, BucketQueue } DijkstraQueue;
+
 #define INIT_PRIORITY 2147483647        // 
 
 /*!
@@ -0,0 +1,651 @@
+
+//==============================================================================
+/*!
+ * @file graph_csr.h
+ * @brief Graph压缩稀疏行（CSR）类
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_GRAPH_CSR_H
+#define DSAS_GRAPH_CSR_H
+
+#include "vector.h"
+#include "graph.h"
+#include "pq_radix_heap.h"
+#include "pq_bucket_queue.h"
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup Graph
+ *
+ * @{
+ */
+
+
+/*!
+ * @brief 压缩稀疏行（邻接数组）类
+ *
+ * <pre>
+ * 所有顶点的出边按起点顺序存放在连续的数组中，m_offset[i]为顶点i第一条出边的下标：
+ *
+ *   0 -> 1, 3      m_offset: [0, 2, 3, 3, 4]
+ *   1 -> 2         m_target: [1, 3, 2, 0]
+ *   2              m_weight: [5, 1, 2, 7]
+ *   3 -> 0
+ *
+ * 顶点i的出边为[m_offset[i], m_offset[i+1])，每个顶点的邻居按编号升序排列：
+ * 枚举邻居为O(deg)且顺序访问内存，exist_edge为O(log(deg))，内存为O(n+e)。
+ * GraphMatrix的内存为O(n^2)，枚举邻居为O(n)。
+ *
+ * 顶点与边的属性按数组分别存放（而不是每个顶点/边一个对象），遍历时只读取需要的数组。
+ * 批量建图使用build（两遍计数排序，O(n+e)）；insert_edge/remove_edge/remove_vertex
+ * 需要移动数组，为O(n+e)，只适合少量修改。
+ * bfs/dfs/dijkstra均不递归，可用于10^7个顶点的图。
+ * </pre>
+ *
+ */
+template <typename Tv, typename Te>
+class GraphCSR : public Graph<Tv, Te>
+{
+private:
+    // 顶点属性
+    dsa::Vector<Tv>         m_vdata;
+    dsa::Vector<int>        m_indeg;
+    dsa::Vector<VStatus>    m_status;
+    dsa::Vector<int>        m_dtime;
+    dsa::Vector<int>        m_ftime;
+    dsa::Vector<int>        m_parent;
+    dsa::Vector<int>        m_priority;
+    // 边属性
+    dsa::Vector<int>        m_offset;   /**< n+1个，顶点i的出边为[m_offset[i], m_offset[i+1]) */
+    dsa::Vector<int>        m_target;
+    dsa::Vector<int>        m_weight;
+    dsa::Vector<Te>         m_edata;
+    dsa::Vector<EStatus>    m_estatus;
+
+    /** 重置顶点和边 */
+    void reset()
+    {
+        for (int i = 0; i < this->m_vnum; i ++)
+        {
+            this->m_status[i] = VStatus::UnDiscovered;
+            this->m_dtime[i] = -1;
+            this->m_ftime[i] = -1;
+            this->m_parent[i] = -1;
+            this->m_priority[i] = INIT_PRIORITY;
+        }
+        for (int k = 0; k < this->m_enum; k ++)
+            this->m_estatus[k] = EStatus::UnDetermined;
+    }
+    void    resize_vertex(int n);
+    int     lower_edge(int i, int j);
+    void    mark_tree();
+
+public:
+    GraphCSR()
+    {
+        this->m_vnum = 0;
+        this->m_enum = 0;
+        this->m_offset.push_back(0);
+    }
+
+    bool    build(int n, const int* src, const int* dst, const int* w, int m, const Te* e = nullptr);
+
+    // 基本数据获取
+    int     vertex_size() const {return this->m_vnum;}
+    Tv      vertex_data(int i) {return this->m_vdata[i];}
+    void    set_vertex_data(int i, const Tv& d) {this->m_vdata[i] = d;}
+    int     vertex_indeg(int i) {return this->m_indeg[i];}
+    int     vertex_outdeg(int i) {return this->m_offset[i+1] - this->m_offset[i];}
+    VStatus vertex_status(int i) {return this->m_status[i];}
+    int     vertex_ftime(int i) {return this->m_ftime[i];}
+    int     vertex_dtime(int i) {return this->m_dtime[i];}
+    int     vertex_parent(int i) {return this->m_parent[i];}
+    int     vertex_priority(int i) {return this->m_priority[i];}
+    int     edge_size() const {return this->m_enum;}
+    Te      edge_data(int i, int j) {return this->m_edata[this->find_edge(i, j)];}
+    int     edge_weight(int i, int j) {return this->m_weight[this->find_edge(i, j)];}
+    EStatus edge_status(int i, int j) {return this->m_estatus[this->find_edge(i, j)];}
+
+    // 按边的下标访问：顶点i的出边为[edge_begin(i), edge_end(i))
+    int     edge_begin(int i) const {return this->m_offset[i];}
+    int     edge_end(int i) const {return this->m_offset[i+1];}
+    int     edge_target(int k) const {return this->m_target[k];}
+    int     edge_weight_at(int k) const {return this->m_weight[k];}
+    int     find_edge(int i, int j);
+
+    // 顶点遍历（按编号升序）
+    int     first_nbr(int i) {return this->vertex_outdeg(i) ? this->m_target[this->m_offset[i]] : -1;}
+    int     next_nbr(int i, int j);
+
+    // 顶点操作
+    virtual int     insert_vertex(const Tv& vertex);
+    virtual Tv      remove_vertex(int i);
+
+    // 边操作
+    virtual bool    exist_edge(int i, int j) {return this->find_edge(i, j) >= 0;}
+    virtual void    insert_edge(const Te& edge, int w, int i, int j);
+    virtual Te      remove_edge(int i, int j);
+
+    // 图的搜索
+    void    bfs(int s);
+    void    BFS(int vindex, int& clock, dsa::Vector<int>& q);
+    void    dfs(int s);
+    void    DFS(int vindex, int& clock, dsa::Vector<int>& stack, dsa::Vector<int>& cursor);
+    void    dijkstra(int s, DijkstraQueue q = RadixQueue);
+
+protected:
+    template <typename PQT>
+    void    dijkstra_pq(int s, PQT& pq);
+};
+
+/*! @} */
+
+
+/** 顶点数量调整为n，新顶点的属性取默认值 */
+template <typename Tv, typename Te>
+void GraphCSR<Tv,Te>::resize_vertex(int n)
+{
+    this->m_vdata.resize(n);
+    this->m_indeg.resize(n, 0);
+    this->m_status.resize(n, VStatus::UnDiscovered);
+    this->m_dtime.resize(n, -1);
+    this->m_ftime.resize(n, -1);
+    this->m_parent.resize(n, -1);
+    this->m_priority.resize(n, INIT_PRIORITY);
+    this->m_vnum = n;
+}
+
+/** 顶点i的出边中，第一条终点不小于j的边的下标 */
+template <typename Tv, typename Te>
+int GraphCSR<Tv,Te>::lower_edge(int i, int j)
+{
+    int lo = this->m_offset[i], hi = this->m_offset[i+1];
+    while (lo < hi)
+    {
+        int mi = (lo + hi) >> 1;
+        if (this->m_target[mi] < j)
+            lo = mi + 1;
+        else
+            hi = mi;
+    }
+    return lo;
+}
+
+/** 按parent将最短路径树的边标记为Tree，平行边取权重最小者 */
+template <typename Tv, typename Te>
+void GraphCSR<Tv,Te>::mark_tree()
+{
+    for (int v = 0; v < this->m_vnum; v ++)
+    {
+        int p = this->m_parent[v];
+        if (p < 0)
+            continue;
+        int k = this->lower_edge(p, v);
+        for (int j = k + 1; j < this->m_offset[p+1] && this->m_target[j] == v; j ++)
+            if (this->m_weight[j] < this->m_weight[k])
+                k = j;
+        this->m_estatus[k] = EStatus::Tree;
+    }
+}
+
+/*!
+ * @brief 从边表批量建图，原有的顶点与边全部清除
+ *
+ * <pre>
+ * 两遍计数排序：先按终点排序，再按起点稳定地分配到各顶点的区间中，
+ * 则每个顶点的出边已按终点升序排列，总时间为O(n+m)。
+ * </pre>
+ *
+ * @param n: 顶点数量，顶点数据为Tv()，可用set_vertex_data设置
+ * @param src,dst,w: 第k条边为src[k] -> dst[k]，权重为w[k]
+ * @param m: 边的数量
+ * @param e: 边的数据，为nullptr时均为Te()
+ * @return 有端点超出[0,n)时返回false，图不变
+ * @retval None
+ */
+template <typename Tv, typename Te>
+bool GraphCSR<Tv,Te>::build(int n, const int* src, const int* dst, const int* w, int m, const Te* e)
+{
+    for (int k = 0; k < m; k ++)
+        if (src[k] < 0 || src[k] >= n || dst[k] < 0 || dst[k] >= n)
+            return false;
+
+    this->m_vnum = 0;
+    this->resize_vertex(0);
+    this->resize_vertex(n);
+    this->m_enum = m;
+
+    // 第一遍：按终点计数排序，order为边的编号
+    dsa::Vector<int> cnt;
+    cnt.resize(n + 1, 0);
+    for (int k = 0; k < m; k ++)
+        cnt[dst[k] + 1] ++;
+    for (int i = 0; i < n; i ++)
+    {
+        this->m_indeg[i] = cnt[i+1];
+        cnt[i+1] += cnt[i];
+    }
+    dsa::Vector<int> order;
+    order.resize(m);
+    for (int k = 0; k < m; k ++)
+        order[cnt[dst[k]] ++] = k;
+
+    // 第二遍：按起点稳定分配
+    this->m_offset.clear();
+    this->m_offset.resize(n + 1, 0);
+    for (int k = 0; k < m; k ++)
+        this->m_offset[src[k] + 1] ++;
+    for (int i = 0; i < n; i ++)
+        this->m_offset[i+1] += this->m_offset[i];
+    for (int i = 0; i <= n; i ++)
+        cnt[i] = this->m_offset[i];
+    this->m_target.resize(m);
+    this->m_weight.resize(m);
+    this->m_edata.resize(m);
+    this->m_estatus.resize(m, EStatus::UnDetermined);
+    for (int t = 0; t < m; t ++)
+    {
+        int k = order[t];
+        int p = cnt[src[k]] ++;
+        this->m_target[p] = dst[k];
+        this->m_weight[p] = w[k];
+        this->m_edata[p] = e ? e[k] : Te();
+    }
+    return true;
+}
+
+/*!
+ * @brief 查找边(i,j)
+ *
+ * @param i,j: 起点与终点
+ * @return 返回边的下标，不存在则返回-1
+ * @retval None
+ */
+template <typename Tv, typename Te>
+int GraphCSR<Tv,Te>::find_edge(int i, int j)
+{
+    int k = this->lower_edge(i, j);
+    return (k < this->m_offset[i+1] && this->m_target[k] == j) ? k : -1;
+}
+
+/*!
+ * @brief 顶点i在邻居j之后的下一个邻居
+ *
+ * @param i: 顶点i
+ * @param j: 上一个邻居
+ * @return 返回下一个邻居，不存在则返回-1
+ * @retval None
+ */
+template <typename Tv, typename Te>
+int GraphCSR<Tv,Te>::next_nbr(int i, int j)
+{
+    int k = this->lower_edge(i, j + 1);
+    return k < this->m_offset[i+1] ? this->m_target[k] : -1;
+}
+
+/*!
+ * @brief 插入顶点，O(1)
+ *
+ * @param vertex: 顶点数据
+ * @return 返回顶点的下标
+ * @retval None
+ */
+template <typename Tv, typename Te>
+int GraphCSR<Tv,Te>::insert_vertex(const Tv& vertex)
+{
+    this->resize_vertex(this->m_vnum + 1);
+    this->m_vdata[this->m_vnum - 1] = vertex;
+    this->m_offset.push_back(this->m_enum);
+    return this->m_vnum - 1;
+}
+
+/*!
+ * @brief 删除顶点及其关联的边，编号大于i的顶点编号减1，O(n+e)
+ *
+ * @param i: 顶点下标
+ * @return 返回顶点数据
+ * @retval None
+ */
+template <typename Tv, typename Te>
+Tv GraphCSR<Tv,Te>::remove_vertex(int i)
+{
+    Tv d = this->m_vdata[i];
+    int w = 0;
+    for (int u = 0; u < this->m_vnum; u ++)
+    {
+        int lo = this->m_offset[u], hi = this->m_offset[u+1];
+        this->m_offset[u] = w;
+        for (int k = lo; k < hi; k ++)
+        {
+            int t = this->m_target[k];
+            if (u == i)
+            {
+                this->m_indeg[t] --;
+                continue;
+            }
+            if (t == i)
+                continue;
+            this->m_target[w] = t > i ? t - 1 : t;
+            this->m_weight[w] = this->m_weight[k];
+            this->m_edata[w] = this->m_edata[k];
+            this->m_estatus[w] = this->m_estatus[k];
+            w ++;
+        }
+    }
+    this->m_offset[this->m_vnum] = w;
+    this->m_offset.remove(i);
+    this->m_target.resize(w);
+    this->m_weight.resize(w);
+    this->m_edata.resize(w);
+    this->m_estatus.resize(w);
+    this->m_enum = w;
+
+    this->m_vdata.remove(i);
+    this->m_indeg.remove(i);
+    this->m_status.remove(i);
+    this->m_dtime.remove(i);
+    this->m_ftime.remove(i);
+    this->m_parent.remove(i);
+    this->m_priority.remove(i);
+    this->m_vnum --;
+    return d;
+}
+
+/*!
+ * @brief 插入边(i,j)，保持邻居有序，O(n+e)
+ *
+ * @param edge: 边数据
+ * @param w: 权重
+ * @param i,j: 起点与终点
+ * @return
+ * @retval None
+ */
+template <typename Tv, typename Te>
+void GraphCSR<Tv,Te>::insert_edge(const Te& edge, int w, int i, int j)
+{
+    int k = this->lower_edge(i, j);
+    this->m_target.insert(k, j);
+    this->m_weight.insert(k, w);
+    this->m_edata.insert(k, edge);
+    this->m_estatus.insert(k, EStatus::UnDetermined);
+    for (int u = i + 1; u <= this->m_vnum; u ++)
+        this->m_offset[u] ++;
+    this->m_indeg[j] ++;
+    this->m_enum ++;
+}
+
+/*!
+ * @brief 删除边(i,j)，O(n+e)
+ *
+ * @param i,j: 起点与终点，边必须存在
+ * @return 返回边数据
+ * @retval None
+ */
+template <typename Tv, typename Te>
+Te GraphCSR<Tv,Te>::remove_edge(int i, int j)
+{
+    int k = this->find_edge(i, j);
+    Te e = this->m_edata.remove(k);
+    this->m_target.remove(k);
+    this->m_weight.remove(k);
+    this->m_estatus.remove(k);
+    for (int u = i + 1; u <= this->m_vnum; u ++)
+        this->m_offset[u] --;
+    this->m_indeg[j] --;
+    this->m_enum --;
+    return e;
+}
+
+/*!
+ * @brief 广度优先搜索（全图遍历）
+ *
+ * @param s: 起始顶点。
+ * @return
+ * @retval None
+ */
+template <typename Tv, typename Te>
+void GraphCSR<Tv,Te>::bfs(int s)
+{
+    if (this->m_vnum == 0)
+        return;
+    this->reset();
+    int clock = 0;
+    dsa::Vector<int> q;
+    q.resize(this->m_vnum);
+    int v = s;
+    do
+    {
+        if (this->m_status[v] == VStatus::UnDiscovered)
+            this->BFS(v, clock, q);
+        v = (v + 1) % this->m_vnum;     // 按序号顺序访问所有顶点
+    } while (s != v);
+}
+
+/*!
+ * @brief 广度优先搜索（对图中的一个连通/可达分量遍历）
+ *
+ * 每个顶点只入队一次，故用长度为n的数组作为队列。
+ *
+ * @param vindex: 顶点下标。
+ * @param clock: 时间标签
+ * @param q: 长度不小于n的数组
+ * @return
+ * @retval None
+ */
+template <typename Tv, typename Te>
+void GraphCSR<Tv,Te>::BFS(int vindex, int& clock, dsa::Vector<int>& q)
+{
+    int head = 0, tail = 0;
+    this->m_status[vindex] = VStatus::Discovered;
+    q[tail ++] = vindex;
+    while (head < tail)
+    {
+        int v = q[head ++];
+        this->m_dtime[v] = ++clock;
+        for (int k = this->m_offset[v]; k < this->m_offset[v+1]; k ++)
+        {
+            int u = this->m_target[k];
+            if (VStatus::UnDiscovered == this->m_status[u])
+            {
+                this->m_status[u] = VStatus::Discovered;
+                q[tail ++] = u;
+                this->m_parent[u] = v;
+                this->m_estatus[k] = EStatus::Tree;
+            }
+            else
+                this->m_estatus[k] = EStatus::Cross;
+        }
+        this->m_status[v] = VStatus::Visited;
+    }
+}
+
+/*!
+ * @brief 深度优先搜索（全图遍历）
+ *
+ * @param s: 起始顶点。
+ * @return
+ * @retval None
+ */
+template <typename Tv, typename Te>
+void GraphCSR<Tv,Te>::dfs(int s)
+{
+    if (this->m_vnum == 0)
+        return;
+    this->reset();
+    int clock = 0;
+    dsa::Vector<int> stack, cursor;
+    int v = s;
+    do
+    {
+        if (this->m_status[v] == VStatus::UnDiscovered)
+            this->DFS(v, clock, stack, cursor);
+        v = (v + 1) % this->m_vnum;
+    } while (s != v);
+}
+
+/*!
+ * @brief 深度优先搜索（对图中的一个连通/可达分量遍历）
+ *
+ * <pre>
+ * 以显式栈代替递归：栈中每个顶点对应一个游标，指向下一条待检查的出边；
+ * 游标到达区间末尾时，顶点访问完毕出栈。边的分类与GraphMatrix::DFS相同。
+ * </pre>
+ *
+ * @param vindex: 顶点下标。
+ * @param clock: 时间标签
+ * @param stack,cursor: 工作栈（可复用）
+ * @return
+ * @retval None
+ */
+template <typename Tv, typename Te>
+void GraphCSR<Tv,Te>::DFS(int vindex, int& clock, dsa::Vector<int>& stack, dsa::Vector<int>& cursor)
+{
+    this->m_status[vindex] = VStatus::Discovered;
+    this->m_dtime[vindex] = ++clock;
+    stack.push_back(vindex);
+    cursor.push_back(this->m_offset[vindex]);
+    while (!stack.is_empty())
+    {
+        int top = stack.size() - 1;
+        int v = stack[top];
+        int k = cursor[top];
+        if (k == this->m_offset[v+1])
+        {
+            this->m_status[v] = VStatus::Visited;
+            this->m_ftime[v] = ++clock;
+            stack.remove(top);
+            cursor.remove(top);
+            continue;
+        }
+        cursor[top] ++;
+        int u = this->m_target[k];
+        switch (this->m_status[u])
+        {
+            case VStatus::UnDiscovered:
+                this->m_estatus[k] = EStatus::Tree;
+                this->m_parent[u] = v;
+                this->m_status[u] = VStatus::Discovered;
+                this->m_dtime[u] = ++clock;
+                stack.push_back(u);
+                cursor.push_back(this->m_offset[u]);
+                break;
+            case VStatus::Discovered:
+                this->m_estatus[k] = EStatus::Backward;
+                break;
+            case VStatus::Visited:
+                this->m_estatus[k] = (this->m_dtime[v] < this->m_dtime[u]) ? EStatus::Forward : EStatus::Cross;
+                break;
+        }
+    }
+}
+
+/*!
+ * @brief Dijkstra最短路径算法
+ *
+ * <pre>
+ * 边权须非负，选取下一个最近顶点的方式见GraphMatrix::dijkstra；
+ * 枚举邻居为O(deg)，使用RadixQueue/BucketQueue时总代价为O(n+e)乘以队列操作的代价。
+ * ScanQueue为O(n^2)，只适合很小的图。
+ * </pre>
+ *
+ * @param s: 起始顶点。
+ * @param q: 优先级队列的类型
+ * @return
+ * @retval None
+ */
+template <typename Tv, typename Te>
+void GraphCSR<Tv,Te>::dijkstra(int s, DijkstraQueue q)
+{
+    if (q == BucketQueue)
+    {
+        int w = 0;
+        for (int k = 0; k < this->m_enum; k ++)
+            if (this->m_weight[k] > w)
+                w = this->m_weight[k];
+        dsa::PqBucketQueue<int> pq(w + 1);
+        this->dijkstra_pq(s, pq);
+        return;
+    }
+    if (q == RadixQueue)
+    {
+        dsa::PqRadixHeap<unsigned int, int> pq;
+        this->dijkstra_pq(s, pq);
+        return;
+    }
+
+    this->reset();
+    this->m_priority[s] = 0;
+    while (s >= 0)
+    {
+        this->m_status[s] = VStatus::Visited;
+        for (int k = this->m_offset[s]; k < this->m_offset[s+1]; k ++)
+        {
+            int u = this->m_target[k];
+            int d = this->m_priority[s] + this->m_weight[k];
+            if (this->m_status[u] == VStatus::UnDiscovered && this->m_priority[u] > d)
+            {
+                this->m_priority[u] = d;
+                this->m_parent[u] = s;
+            }
+        }
+        int next = -1;
+        for (int min = INIT_PRIORITY, j = 0; j < this->m_vnum; j ++)
+        {
+            if (this->m_status[j] == VStatus::UnDiscovered && min > this->m_priority[j])
+            {
+                min = this->m_priority[j];
+                next = j;
+            }
+        }
+        s = next;
+    }
+    this->mark_tree();
+}
+
+/*!
+ * @brief Dijkstra最短路径算法（使用单调优先级队列，懒惰删除）
+ *
+ * @param s: 起始顶点。
+ * @param pq: 空的优先级队列，词条为(距离, 顶点)
+ * @return
+ * @retval None
+ */
+template <typename Tv, typename Te>
+template <typename PQT>
+void GraphCSR<Tv,Te>::dijkstra_pq(int s, PQT& pq)
+{
+    this->reset();
+    this->m_priority[s] = 0;
+    pq.push(0, s);
+    while (!pq.is_empty())
+    {
+        int v = pq.del_max().value;
+        if (this->m_status[v] == VStatus::Visited)
+            continue;
+        this->m_status[v] = VStatus::Visited;
+        for (int k = this->m_offset[v]; k < this->m_offset[v+1]; k ++)
+        {
+            int u = this->m_target[k];
+            int d = this->m_priority[v] + this->m_weight[k];
+            if (this->m_status[u] == VStatus::UnDiscovered && this->m_priority[u] > d)
+            {
+                this->m_priority[u] = d;
+                this->m_parent[u] = v;
+                pq.push(d, u);
+            }
+        }
+    }
+    this->mark_tree();
+}
+
+} /* dsa */
+
+#endif /* ifndef DSAS_GRAPH_CSR_H */
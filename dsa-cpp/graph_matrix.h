@@ -17,6 +17,8 @@
 #include "vector.h"
 #include "queue.h"
 #include "graph.h"
+#include "pq_radix_heap.h"
+#include "pq_bucket_queue.h"
 
 namespace dsa
 {
@@ -109,7 +111,12 @@ public:
     void    BFS(int vindex, int& clock);
     void    dfs(int s);
     void    DFS(int vindex, int& clock);
-    void    dijkstra(int s);
+    void    dijkstra(int s, DijkstraQueue q = ScanQueue);
+
+protected:
+    void    dijkstra_scan(int s);
+    template <typename PQT>
+    void    dijkstra_pq(int s, PQT& pq);
 };
 
 /*! @} */
@@ -398,14 +405,53 @@ void GraphMatrix<Tv,Te>::DFS(int vindex, int& clock)
  * @brief Dijkstra最短路径算法
  *
  * Dijkstra算法可以计算顶点s到其余各点的最短路径及长度，所有最短路径可以组成一棵树。
- * 注意：图中边的权重需要为正。
+ * 注意：图中边的权重需要为非负。
+ *
+ * <pre>
+ * 选取下一个最近顶点的方式：
+ * ScanQueue:   每次扫描所有顶点，O(n^2)；
+ * RadixQueue:  基数堆（PqRadixHeap），距离单调不减，每个元素均摊O(32)；
+ * BucketQueue: 桶队列（PqBucketQueue），环的大小取最大边权+1，O(e + 最大距离)。
+ * 后两者松弛时插入新的(距离, 顶点)，出队时跳过已访问的顶点（懒惰删除）。
+ * 邻接矩阵枚举邻居本身需要O(n)，故在邻接矩阵上总代价仍为O(n^2)，只是省去了扫描。
+ * </pre>
  *
  * @param s: 起始顶点。
+ * @param q: 优先级队列的类型
  * @return
  * @retval None
  */
 template <typename Tv, typename Te>
-void GraphMatrix<Tv,Te>::dijkstra(int s)
+void GraphMatrix<Tv,Te>::dijkstra(int s, DijkstraQueue q)
+{
+    if (q == RadixQueue)
+    {
+        dsa::PqRadixHeap<unsigned int, int> pq;
+        this->dijkstra_pq(s, pq);
+    }
+    else if (q == BucketQueue)
+    {
+        int w = 0;
+        for (int i = 0; i < this->m_vnum; i ++)
+            for (int j = 0; j < this->m_vnum; j ++)
+                if (this->exist_edge(i, j) && this->m_e[i][j]->weight > w)
+                    w = this->m_e[i][j]->weight;
+        dsa::PqBucketQueue<int> pq(w + 1);
+        this->dijkstra_pq(s, pq);
+    }
+    else
+        this->dijkstra_scan(s);
+}
+
+/*!
+ * @brief Dijkstra最短路径算法（扫描所有顶点选取最近者）
+ *
+ * @param s: 起始顶点。
+ * @return
+ * @retval None
+ */
+template <typename Tv, typename Te>
+void GraphMatrix<Tv,Te>::dijkstra_scan(int s)
 {
     this->reset();
     // 用priority表示距离的优先级，距离越小，优先级越高，优先并入最短路径
@@ -420,7 +466,7 @@ void GraphMatrix<Tv,Te>::dijkstra(int s)
         for (int j = this->first_nbr(s); j > -1; j = this->next_nbr(s, j))
         {
             if (this->m_v[j]->status == VStatus::UnDiscovered
-                    && this->m_v[j]->priority > this->m_v[j]->priority + this->m_e[s][j]->weight)
+                    && this->m_v[j]->priority > this->m_v[s]->priority + this->m_e[s][j]->weight)
             {
                 // 更新s到j的距离
                 this->m_v[j]->priority = this->m_v[s]->priority + this->m_e[s][j]->weight;
@@ -428,14 +474,54 @@ void GraphMatrix<Tv,Te>::dijkstra(int s)
             }
 
         }
-        // 遍历查找下一个最近的顶点
+        // 遍历查找下一个最近的顶点，剩余顶点均不可达时结束
+        int next = -1;
         for (int min = INIT_PRIORITY, j = 0; j < this->m_vnum; j ++)
         {
             if (this->m_v[j]->status == VStatus::UnDiscovered
                     && min > this->m_v[j]->priority)
             {
                 min = this->m_v[j]->priority;
-                s = j;
+                next = j;
+            }
+        }
+        if (next < 0)
+            break;
+        s = next;
+    }
+}
+
+/*!
+ * @brief Dijkstra最短路径算法（使用单调优先级队列）
+ *
+ * @param s: 起始顶点。
+ * @param pq: 空的优先级队列，词条为(距离, 顶点)，key越小越先出队
+ * @return
+ * @retval None
+ */
+template <typename Tv, typename Te>
+template <typename PQT>
+void GraphMatrix<Tv,Te>::dijkstra_pq(int s, PQT& pq)
+{
+    this->reset();
+    this->m_v[s]->priority = 0;
+    pq.push(0, s);
+    while (!pq.is_empty())
+    {
+        int v = pq.del_max().value;
+        if (this->m_v[v]->status == VStatus::Visited)
+            continue;               // 已出队过，这是较早插入的、更长的距离
+        this->m_v[v]->status = VStatus::Visited;
+        if (-1 != this->m_v[v]->parent)
+            this->m_e[this->m_v[v]->parent][v]->status = EStatus::Tree;
+        for (int j = this->first_nbr(v); j > -1; j = this->next_nbr(v, j))
+        {
+            int d = this->m_v[v]->priority + this->m_e[v][j]->weight;
+            if (this->m_v[j]->status == VStatus::UnDiscovered && this->m_v[j]->priority > d)
+            {
+                this->m_v[j]->priority = d;
+                this->m_v[j]->parent = v;
+                pq.push(d, j);
             }
         }
     }
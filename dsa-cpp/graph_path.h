@@ -0,0 +1,458 @@
+
+//==============================================================================
+/*!
+ * @file graph_path.h
+ * @brief 最短路径查询类（堆优化Dijkstra、多源、双向、A*）
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_GRAPH_PATH_H
+#define DSAS_GRAPH_PATH_H
+
+#include "vector.h"
+#include "graph.h"
+#include "graph_csr.h"
+#include "pq_index_heap.h"
+#include "share/compare.h"
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup Graph
+ *
+ * @{
+ */
+
+#define PATH_HEAP_ARITY     4       /**< 索引堆的叉数 */
+
+/*!
+ * @brief 最短路径查询类
+ *
+ * <pre>
+ * 构造（或load）时将图G的边复制为正向与反向两份邻接数组，之后的查询只访问这些数组：
+ *
+ *   正向: 0 -> 1(5), 3(1)      反向: 1 <- 0(5)
+ *         1 -> 2(2)                  2 <- 1(2)
+ *         3 -> 2(1)                  2 <- 3(1)
+ *
+ * 每次查询使用以顶点编号为句柄的索引堆（PqIndexHeap），松弛时直接更新距离（decrease-key），
+ * 堆中至多n个元素，时间复杂度O((n + e) log n)。
+ *
+ * 距离与父节点存放在数组中，由dist()/parent()返回，不可达的顶点距离为INIT_PRIORITY、父节点为-1。
+ * 只重置上一次查询访问过的顶点，故点对点查询的代价只与搜索到的范围有关，与n无关。
+ *
+ * 支持的查询：
+ *   dijkstra(s)              单源，计算s到所有顶点的距离；
+ *   dijkstra(s, t)           点对点，t出堆即结束；
+ *   dijkstra_multi(S, k, t)  多源，S中的顶点距离均为0（如"到最近的设施"）；
+ *   bidirectional(s, t)      双向，从s正向、从t反向交替扩展，两侧堆顶距离之和不小于
+ *                            已知最短路径时结束，搜索范围约为单向的两个半径为d/2的球；
+ *   astar(s, t, h)           A*，h(v)为v到t距离的下界（可采纳），h越接近真实距离，扩展的顶点越少。
+ *
+ * 边权须非负。图修改后须调用load重新复制。
+ * G须提供vertex_size()、first_nbr()、next_nbr()与edge_weight()，如GraphMatrix；GraphCSR直接复制边数组。
+ * </pre>
+ *
+ */
+template <typename G>
+class GraphPath
+{
+protected:
+    /** 零启发函数，A*退化为Dijkstra */
+    struct NoHeuristic
+    {
+        int operator() (int) const {return 0;}
+    };
+
+    typedef dsa::PqIndexHeap<int, dsa::Greater<int>, PATH_HEAP_ARITY> Heap;
+
+    G*                  m_graph;
+    int                 m_vnum;
+
+    // 正向与反向邻接数组，[off[i], off[i+1])为顶点i的边
+    dsa::Vector<int>    m_off[2];
+    dsa::Vector<int>    m_adj[2];
+    dsa::Vector<int>    m_wt[2];
+
+    // 查询状态，下标0为正向，1为反向（双向搜索）
+    dsa::Vector<int>    m_dist[2];
+    dsa::Vector<int>    m_parent[2];
+    dsa::Vector<int>    m_touched[2];   /**< 本次查询修改过的顶点，用于重置 */
+    Heap                m_pq[2];
+
+    template <typename X>
+    void    append_edges(X& g, int i);
+    template <typename Tv, typename Te>
+    void    append_edges(GraphCSR<Tv,Te>& g, int i);
+    void    reset(int side);
+    void    relax(int side, int v, int d, int p, int key);
+    template <typename H>
+    int     search(int t, H& h);
+
+public:
+    GraphPath(G& g) : m_graph(&g), m_vnum(0) {this->load();}
+    GraphPath(const GraphPath&) = delete;
+    GraphPath& operator= (const GraphPath&) = delete;
+
+    void    load();
+
+    /** 顶点数量 */
+    int     vertex_size() const {return this->m_vnum;}
+    /** 最近一次查询的距离数组，下标为顶点 */
+    const int* dist() const {return &this->m_dist[0][0];}
+    /** 最近一次查询的父节点数组，下标为顶点 */
+    const int* parent() const {return &this->m_parent[0][0];}
+    int     path(int t, dsa::Vector<int>& p) const;
+
+    void    dijkstra(int s);
+    int     dijkstra(int s, int t);
+    int     dijkstra_multi(const int* src, int k, int t = -1);
+    int     bidirectional(int s, int t);
+    template <typename H>
+    int     astar(int s, int t, H h);
+};
+
+/*! @} */
+
+
+/*!
+ * @brief 从图中复制正向与反向邻接数组，并清空查询状态
+ *
+ * @param None
+ * @return
+ * @retval None
+ */
+template <typename G>
+void GraphPath<G>::load()
+{
+    const int n = this->m_graph->vertex_size();
+    this->m_vnum = n;
+
+    // 正向：按顶点顺序追加出边
+    dsa::Vector<int>& off = this->m_off[0];
+    off.clear();
+    this->m_adj[0].clear();
+    this->m_wt[0].clear();
+    off.push_back(0);
+    for (int i = 0; i < n; i ++)
+    {
+        this->append_edges(*this->m_graph, i);
+        off.push_back(this->m_adj[0].size());
+    }
+
+    // 反向：按终点计数排序
+    const int m = this->m_adj[0].size();
+    dsa::Vector<int>& roff = this->m_off[1];
+    roff.clear();
+    roff.resize(n + 1, 0);
+    for (int k = 0; k < m; k ++)
+        roff[this->m_adj[0][k] + 1] ++;
+    for (int i = 0; i < n; i ++)
+        roff[i + 1] += roff[i];
+    this->m_adj[1].resize(m);
+    this->m_wt[1].resize(m);
+    dsa::Vector<int> pos;
+    pos.resize(n);
+    for (int i = 0; i < n; i ++)
+        pos[i] = roff[i];
+    for (int i = 0; i < n; i ++)
+    {
+        for (int k = off[i]; k < off[i + 1]; k ++)
+        {
+            int at = pos[this->m_adj[0][k]] ++;
+            this->m_adj[1][at] = i;
+            this->m_wt[1][at] = this->m_wt[0][k];
+        }
+    }
+
+    for (int side = 0; side < 2; side ++)
+    {
+        // 至少一个元素，使dist()/parent()对空图也返回有效地址
+        int len = n > 0 ? n : 1;
+        this->m_dist[side].clear();
+        this->m_dist[side].resize(len, INIT_PRIORITY);
+        this->m_parent[side].clear();
+        this->m_parent[side].resize(len, -1);
+        this->m_touched[side].clear();
+        this->m_pq[side].clear();
+        this->m_pq[side].reserve(n);
+    }
+}
+
+/** 通过邻居枚举复制顶点i的出边 */
+template <typename G>
+template <typename X>
+void GraphPath<G>::append_edges(X& g, int i)
+{
+    for (int j = g.first_nbr(i); j > -1; j = g.next_nbr(i, j))
+    {
+        this->m_adj[0].push_back(j);
+        this->m_wt[0].push_back(g.edge_weight(i, j));
+    }
+}
+
+/** 直接复制GraphCSR中顶点i的出边（包括平行边，邻居枚举只能看到其中一条） */
+template <typename G>
+template <typename Tv, typename Te>
+void GraphPath<G>::append_edges(GraphCSR<Tv,Te>& g, int i)
+{
+    for (int k = g.edge_begin(i); k < g.edge_end(i); k ++)
+    {
+        this->m_adj[0].push_back(g.edge_target(k));
+        this->m_wt[0].push_back(g.edge_weight_at(k));
+    }
+}
+
+/** 重置上一次查询修改过的顶点 */
+template <typename G>
+void GraphPath<G>::reset(int side)
+{
+    dsa::Vector<int>& tv = this->m_touched[side];
+    for (int k = 0; k < tv.size(); k ++)
+    {
+        int v = tv[k];
+        this->m_dist[side][v] = INIT_PRIORITY;
+        this->m_parent[side][v] = -1;
+    }
+    tv.clear();
+    this->m_pq[side].clear();
+}
+
+/*!
+ * @brief 松弛：v的距离更新为d，父节点为p，以key入堆或更新堆中的关键码
+ *
+ * 已出堆的顶点重新入堆（A*的启发函数不一致时可能发生，Dijkstra不会）。
+ *
+ * @param side: 0为正向，1为反向
+ * @param v: 顶点
+ * @param d: 新距离，须小于原距离
+ * @param p: 父节点
+ * @param key: 堆中的关键码（Dijkstra为d，A*为d + h(v)）
+ * @return
+ * @retval None
+ */
+template <typename G>
+void GraphPath<G>::relax(int side, int v, int d, int p, int key)
+{
+    if (this->m_dist[side][v] == INIT_PRIORITY)
+        this->m_touched[side].push_back(v);
+    this->m_dist[side][v] = d;
+    this->m_parent[side][v] = p;
+    if (!this->m_pq[side].increase_key(v, key))
+        this->m_pq[side].insert(v, key);
+}
+
+/*!
+ * @brief 正向搜索的主循环，源点须已入堆
+ *
+ * @param t: 目标顶点，出堆即结束；-1表示搜索所有可达顶点
+ * @param h: 启发函数，h(v)为v到t距离的下界
+ * @return 返回t的距离，t为-1或不可达时返回INIT_PRIORITY
+ * @retval None
+ */
+template <typename G>
+template <typename H>
+int GraphPath<G>::search(int t, H& h)
+{
+    Heap& pq = this->m_pq[0];
+    const int* off = &this->m_off[0][0];
+    const int* adj = this->m_adj[0].size() ? &this->m_adj[0][0] : nullptr;
+    const int* wt = this->m_wt[0].size() ? &this->m_wt[0][0] : nullptr;
+    int* dist = &this->m_dist[0][0];
+
+    while (!pq.is_empty())
+    {
+        int u = pq.pop();
+        if (u == t)
+            return dist[u];
+        for (int k = off[u]; k < off[u + 1]; k ++)
+        {
+            int v = adj[k];
+            int d = dist[u] + wt[k];
+            if (d < dist[v])
+                this->relax(0, v, d, u, d + h(v));
+        }
+    }
+    return INIT_PRIORITY;
+}
+
+/*!
+ * @brief 单源最短路径，计算s到所有顶点的距离
+ *
+ * @param s: 起始顶点
+ * @return
+ * @retval None
+ */
+template <typename G>
+void GraphPath<G>::dijkstra(int s)
+{
+    this->dijkstra_multi(&s, 1, -1);
+}
+
+/*!
+ * @brief 点对点最短路径，t出堆即结束
+ *
+ * @param s: 起始顶点
+ * @param t: 目标顶点
+ * @return 返回s到t的距离，不可达时返回INIT_PRIORITY
+ * @retval None
+ */
+template <typename G>
+int GraphPath<G>::dijkstra(int s, int t)
+{
+    return this->dijkstra_multi(&s, 1, t);
+}
+
+/*!
+ * @brief 多源最短路径：所有源点的距离为0，每个顶点的距离为到最近源点的距离
+ *
+ * @param src: 源点数组
+ * @param k: 源点数量
+ * @param t: 目标顶点，出堆即结束；-1表示搜索所有可达顶点
+ * @return 返回t的距离，t为-1或不可达时返回INIT_PRIORITY
+ * @retval None
+ */
+template <typename G>
+int GraphPath<G>::dijkstra_multi(const int* src, int k, int t)
+{
+    this->reset(0);
+    this->reset(1);
+    for (int i = 0; i < k; i ++)
+        if (this->m_dist[0][src[i]] != 0)
+            this->relax(0, src[i], 0, -1, 0);
+    NoHeuristic h;
+    return this->search(t, h);
+}
+
+/*!
+ * @brief A*最短路径
+ *
+ * <pre>
+ * 以 距离 + h(v) 为关键码，优先扩展"看起来"离t更近的顶点。
+ * h须可采纳（不超过v到t的真实距离），结果才是最短路径；
+ * 若h还满足一致性（h(u) <= w(u,v) + h(v)，如平面图上的直线距离），每个顶点至多出堆一次。
+ * h恒为0时即为Dijkstra。
+ * </pre>
+ *
+ * @param s: 起始顶点
+ * @param t: 目标顶点
+ * @param h: 启发函数，int h(int v)
+ * @return 返回s到t的距离，不可达时返回INIT_PRIORITY
+ * @retval None
+ */
+template <typename G>
+template <typename H>
+int GraphPath<G>::astar(int s, int t, H h)
+{
+    this->reset(0);
+    this->reset(1);
+    this->relax(0, s, 0, -1, h(s));
+    return this->search(t, h);
+}
+
+/*!
+ * @brief 双向Dijkstra最短路径
+ *
+ * <pre>
+ * 正向从s、反向从t（沿反向边）交替扩展，每次扩展堆顶距离较小的一侧。
+ * 松弛边(u, v)时，若v在另一侧已有距离，则 d(u) + w + d'(v) 是一条s到t的路径，记录其中最短的mu。
+ * 两侧堆顶距离之和 >= mu 时，任何未发现的路径都不会更短，结束。
+ *
+ * 结束后将反向一侧的路径（相遇点到t）写入正向的dist/parent，
+ * 故dist()[t]与path(t)可直接使用；其他顶点的距离只是上界。
+ * </pre>
+ *
+ * @param s: 起始顶点
+ * @param t: 目标顶点
+ * @return 返回s到t的距离，不可达时返回INIT_PRIORITY
+ * @retval None
+ */
+template <typename G>
+int GraphPath<G>::bidirectional(int s, int t)
+{
+    this->reset(0);
+    this->reset(1);
+    this->relax(0, s, 0, -1, 0);
+    this->relax(1, t, 0, -1, 0);
+
+    int mu = (s == t) ? 0 : INIT_PRIORITY;
+    int meet = (s == t) ? s : -1;
+    while (!this->m_pq[0].is_empty() && !this->m_pq[1].is_empty())
+    {
+        int top0 = this->m_pq[0].get_max();
+        int top1 = this->m_pq[1].get_max();
+        if (mu != INIT_PRIORITY && top0 + top1 >= mu)
+            break;
+
+        int side = (top0 <= top1) ? 0 : 1;
+        int other = 1 - side;
+        int u = this->m_pq[side].pop();
+        const dsa::Vector<int>& off = this->m_off[side];
+        for (int k = off[u]; k < off[u + 1]; k ++)
+        {
+            int v = this->m_adj[side][k];
+            int d = this->m_dist[side][u] + this->m_wt[side][k];
+            if (d < this->m_dist[side][v])
+                this->relax(side, v, d, u, d);
+            if (this->m_dist[other][v] != INIT_PRIORITY && d + this->m_dist[other][v] < mu)
+            {
+                mu = d + this->m_dist[other][v];
+                meet = v;
+            }
+        }
+    }
+    if (meet < 0)
+        return INIT_PRIORITY;
+
+    // 将相遇点到t的路径写入正向数组
+    for (int v = meet; v != t; )
+    {
+        int n = this->m_parent[1][v];
+        int d = this->m_dist[0][v] + (this->m_dist[1][v] - this->m_dist[1][n]);
+        if (d < this->m_dist[0][n])
+        {
+            if (this->m_dist[0][n] == INIT_PRIORITY)
+                this->m_touched[0].push_back(n);
+            this->m_dist[0][n] = d;
+            this->m_parent[0][n] = v;
+        }
+        v = n;
+    }
+    return mu;
+}
+
+/*!
+ * @brief 沿父节点从t回溯到源点，得到最近一次查询的最短路径
+ *
+ * @param t: 目标顶点
+ * @param p: 返回路径上的顶点，从源点到t
+ * @return 返回路径的顶点数，不可达时返回0
+ * @retval None
+ */
+template <typename G>
+int GraphPath<G>::path(int t, dsa::Vector<int>& p) const
+{
+    p.clear();
+    if (t < 0 || t >= this->m_vnum || this->m_dist[0][t] == INIT_PRIORITY)
+        return 0;
+    for (int v = t; v != -1; v = this->m_parent[0][v])
+        p.push_back(v);
+    // 翻转为源点到t的顺序
+    for (int i = 0, j = p.size() - 1; i < j; i ++, j --)
+    {
+        int x = p[i];
+        p[i] = p[j];
+        p[j] = x;
+    }
+    return p.size();
+}
+
+} /* dsa */
+
+#endif /* ifndef DSAS_GRAPH_PATH_H */
@@ -17,9 +17,11 @@
 #include "share/entry.h"
 #include "share/prime.h"
 #include "share/compare.h"
+#include "share/epoch.h"
 #include "list.h"
 #include "bitmap.h"
 #include "hash_func.h"
+#include "filter.h"
 
 namespace dsa
 {
@@ -34,12 +36,23 @@ namespace dsa
 #define HASH_PROBE_QUAD     0x02
 #define HASH_PROBE          HASH_PROBE_QUAD
 
+#define HASH_REHASH_FULL    0x01
+#define HASH_REHASH_INCR    0x02
+#define HASH_REHASH         HASH_REHASH_INCR
+
+#define HASH_REHASH_STEP    16      /**< 渐进式重散列时，每次操作至多迁移的旧单元数 */
+#define HASH_SHRINK_FACTOR  8       /**< 装填因子低于 1/HASH_SHRINK_FACTOR 时，收缩散列表 */
+
 /*!
  * @brief 散列表模板类
  *
  * <pre>
  * 装填因子： N/M = size/cap
  *
+ * 定位
+ * 键的64位Hash（见Hash64Of）取高32位，用乘法与移位映射到[0, cap)（hash_range64），
+ * 不做取模；容量仍取素数，供双向平方试探使用。
+ *
  * 冲突
  * (1): 使用链表
  * [*]
@@ -68,6 +81,43 @@ namespace dsa
  * 基于平方试控，不过试控距离变成 1, -1, 4, -4, 9, -9......
  * 散列容量取为 M = 4k+3 的素数，可以保证双平方试探的查找链的前 M 项均互异。
  *
+ * 重散列
+ * (1): HASH_REHASH_FULL
+ * 装填因子超过50%时，在一次put中，将所有词条转移到容量加倍的新散列表。
+ * 词条数量很大时，这一次put的耗时会非常长。
+ *
+ * (2): HASH_REHASH_INCR
+ * 渐进式重散列，新旧两个散列表同时存在：
+ *    old: [*][*][ ][*][*][ ][*][*][ ][*][*]
+ *                      ^
+ *                    m_mig（之前的单元均已迁移）
+ *    new: [ ][*][ ][ ][*][ ][ ][*][ ][ ][ ][ ][*][ ][ ][ ][ ][ ][*][ ][ ][ ]
+ * 之后的每次put/get/remove，只迁移旧表中 HASH_REHASH_STEP 个单元；
+ * 查找时，同时查找新旧两个散列表；新插入的词条只放入新表。
+ * 旧表容量为M，则至多M/HASH_REHASH_STEP次操作后，迁移完成，旧表被释放。
+ * 迁移只转移词条指针，故get返回的指针在迁移前后依然有效。
+ *
+ * 装填因子低于 1/HASH_SHRINK_FACTOR 时，以同样的方式收缩散列表，但不小于初始容量。
+ *
+ * 懒惰删除
+ * 删除的单元带有懒惰删除标记（墓碑），查找时需跳过，因此墓碑同样会拉长查找链：
+ * (1): 装填因子按 (size+墓碑数)/cap 计算，超过50%时重散列；
+ *      若有效词条不足25%，说明主要是墓碑，则以相同容量重建，只清除墓碑而不扩容；
+ * (2): 查找未命中时，记录查找链上的第一个墓碑，插入时直接复用该单元并清除其标记；
+ * (3): 统计查找链长度（见stat()），用于观察墓碑与冲突的影响。
+ *
+ * 前置过滤器
+ * enable_filter()后，散列表维护一个分块Bloom过滤器（每个单元一份，按最大装填量分配），
+ * get/find/remove先查询过滤器，过滤器判定不存在的键不再试探散列表。
+ * 删除不会清除过滤器中的位，过滤器在每次重散列时重建；
+ * 渐进式重散列时，新旧散列表各有一个过滤器。
+ *
+ * 无锁读者
+ * enable_epoch()后，删除的词条、重散列替换下的单元数组、懒惰删除标记与过滤器，
+ * 均通过EpochDomain退休，待可能访问它们的读者离开后再释放。
+ * 读者在EpochGuard内用view()取快照，再用find(view, key)沿快照试探；
+ * 写者可能同时修改散列表，快照与查找结果是否有效，由调用者校验（见HashTableConcurrent）。
+ * 试探至多进行cap次，快照中的旧表即使已全部迁移（只剩墓碑），查找也能结束。
  * </pre>
  *
  */
@@ -85,54 +135,184 @@ public:
 private:
     PairPtr* m_ht;          /**< 散列容量数组，存放词条指针 */
     int     m_cap;          /**< 散列容量 */
-    int     m_size;         /**< 实际插入的键值对元素 */
+    int     m_size;         /**< 实际插入的键值对元素（包括新旧两个散列表） */
+    int     m_removed;      /**< 新散列表中的墓碑数量（带懒惰删除标记的空单元） */
     dsa::Bitmap* lazy_rm;   /**< 懒惰删除标记，保证查找链不会中断 */
-#define Is_Lazy_Removed(x)  (this->lazy_rm->test(x))
-#define Mark_As_Removed(x)  (this->lazy_rm->set(x))
-    HF      hash_func;      /**< 计算Hash的函数 */
+#define Is_Lazy_Removed(rm, x)  ((rm)->test(x))
+#define Mark_As_Removed(rm, x)  ((rm)->set(x))
+#define Clear_Removed(rm, x)    ((rm)->clear(x))
+    using Hash64F = typename dsa::Hash64Of<K,HF>::type;
+    Hash64F hash_func;      /**< 计算64位Hash的函数（由HF决定，见Hash64Of） */
+
+    PairPtr* m_old_ht;      /**< 渐进式重散列时的旧散列表，不在重散列时为nullptr */
+    int     m_old_cap;      /**< 旧散列表容量 */
+    dsa::Bitmap* m_old_rm;  /**< 旧散列表的懒惰删除标记 */
+    int     m_mig;          /**< 旧散列表中[0, m_mig)的单元已迁移完成 */
+    int     m_min_cap;      /**< 初始容量，收缩时不低于此容量 */
+
+    using Filter = dsa::BloomBlocked<K, dsa::HashMix64<Hash64F>>;
+    Filter* m_filter;       /**< 新散列表的前置过滤器，nullptr表示未开启 */
+    Filter* m_old_filter;   /**< 旧散列表的前置过滤器 */
+    int     m_filter_bpk;   /**< 过滤器每个键的位数，0表示未开启 */
+
+public:
+    /** 查找链统计 */
+    struct ProbeStat
+    {
+        long long lookups;  /**< probe_hit的次数 */
+        long long probes;   /**< 查找链的总长度（跳过的单元数） */
+        int       max_probe;/**< 最长的查找链 */
+    };
+
+    /** 散列表的快照：新旧散列表的单元数组、容量、懒惰删除标记与过滤器 */
+    struct View
+    {
+        PairPtr*            ht;
+        int                 cap;
+        const dsa::Bitmap*  rm;
+        PairPtr*            old_ht;
+        int                 old_cap;
+        const dsa::Bitmap*  old_rm;
+        const Filter*       filter;
+        const Filter*       old_filter;
+    };
+
+private:
+    mutable ProbeStat m_stat;
+    bool    m_stat_on;      /**< 是否统计查找链（多线程并发读时需关闭） */
+    bool    m_epoch;        /**< 是否通过EpochDomain退休被摘除的词条与数组 */
 
 protected:
-    /** 沿查找链，查找是否已经存在key */
-    inline int probe_hit(const K& key)
+    /** 查找链的起点：64位Hash的高位映射到[0, cap) */
+    inline int index_of(const K& key, int cap) const {return static_cast<int>(dsa::hash_range64(this->hash_func(key), cap));}
+    /** 沿查找链，查找是否已经存在key；tomb不为nullptr时，记录查找链上第一个墓碑 */
+    inline int probe_hit(const K& key, PairPtr* ht, int cap, const dsa::Bitmap* rm, int* tomb = nullptr) const
     {
 #if HASH_PROBE == HASH_PROBE_LINE
-        return probe_line_hit(key);
+        return probe_line_hit(key, ht, cap, rm, tomb);
 #elif HASH_PROBE == HASH_PROBE_QUAD
-        return probe_quad_hit(key);
+        return probe_quad_hit(key, ht, cap, rm, tomb);
 #endif
     }
     /** 沿查找链，查找可用空单元 */
-    inline int probe_free(const K& key)
+    inline int probe_free(const K& key, PairPtr* ht, int cap) const
     {
 #if HASH_PROBE == HASH_PROBE_LINE
-        return probe_line_free(key);
+        return probe_line_free(key, ht, cap);
 #elif HASH_PROBE == HASH_PROBE_QUAD
-        return probe_quad_free(key);
+        return probe_quad_free(key, ht, cap);
 #endif
     }
 
-    int probe_line_hit(const K&);
-    int probe_line_free(const K&);
-    int probe_quad_hit(const K&);
-    int probe_quad_free(const K&);
+    int probe_line_hit(const K&, PairPtr*, int, const dsa::Bitmap*, int*) const;
+    int probe_line_free(const K&, PairPtr*, int) const;
+    int probe_quad_hit(const K&, PairPtr*, int, const dsa::Bitmap*, int*) const;
+    int probe_quad_free(const K&, PairPtr*, int) const;
+    /** 双向平方试探的下一个单元：先 i+s^2，再 i-s^2，然后s加1 */
+    static inline void quad_step(int i, int cap, int& p, int& d, bool& pos, int& r)
+    {
+        if (pos)
+        {
+            r = i + p;
+            if (r >= cap)
+                r -= cap;
+        }
+        else
+        {
+            r = i - p;
+            if (r < 0)
+                r += cap;
+            for (p += d, d += 2; p >= cap; )
+                p -= cap;
+        }
+        pos = !pos;
+    }
+    /** 记录一次查找的查找链长度 */
+    inline void record_probe(int n) const
+    {
+        if (!this->m_stat_on)
+            return;
+        this->m_stat.lookups ++;
+        this->m_stat.probes += n;
+        if (n > this->m_stat.max_probe)
+            this->m_stat.max_probe = n;
+    }
+
+    /** 是否处于渐进式重散列 */
+    bool is_rehashing() const {return this->m_old_ht != nullptr;}
+    PairPtr* locate(const K&) const;
+    /** 按当前容量创建过滤器 */
+    Filter* new_filter() const {return this->m_filter_bpk ? new Filter(this->m_cap / 2 + 1, this->m_filter_bpk) : nullptr;}
+    bool filter_reject(const K&, const Filter*, const Filter*) const;
+    /** 释放被摘除的对象：开启epoch回收时退休至EpochDomain，否则立即释放 */
+    template <typename X> void dispose(X* p) const
+    {
+        if (p && this->m_epoch)
+            dsa::EpochDomain::instance().retire(p, [](void* x) {delete static_cast<X*>(x);});
+        else
+            delete p;
+    }
+    /** 释放被替换下的单元数组 */
+    void dispose_array(PairPtr* a) const
+    {
+        if (a && this->m_epoch)
+            dsa::EpochDomain::instance().retire(a, [](void* x) {delete[] static_cast<PairPtr*>(x);});
+        else
+            delete[] a;
+    }
 
     void init(int);
-    void rehash();
+    void resize(int);
+    void rehash(int);
+    void rehash_start(int);
+    void rehash_step();
+    void rehash_finish();
 
 public:
-    HashTable(int n = 5) {this->init(n);}
+    HashTable(int n = 5)
+        : m_size(0), m_old_ht(nullptr), m_old_cap(0), m_old_rm(nullptr), m_mig(0),
+          m_filter(nullptr), m_old_filter(nullptr), m_filter_bpk(0), m_stat_on(true), m_epoch(false)
+    {
+        this->init(n);
+        this->m_min_cap = this->m_cap;
+        this->reset_stat();
+    }
     ~HashTable();
 
     /** 重载[]，仿问和修改已有词条，不能插入词条 */
-    V& operator[] (const K key) {return this->m_ht[this->probe_hit(key)]->value;}
+    V& operator[] (const K key) {return (*this->locate(key))->value;}
     /** 重载[]，仿问已有词条，不能插入词条 */
-    const V& operator[] (const K key) const {return this->m_ht[this->probe_hit(key)]->value;}
+    const V& operator[] (const K key) const {return (*this->locate(key))->value;}
 
     /** 获取键值对数量 */
     int     size() const {return this->m_size;}
+    /** 获取散列容量（重散列时为新散列表的容量） */
+    int     capacity() const {return this->m_cap;}
+    /** 获取墓碑数量 */
+    int     tombstones() const {return this->m_removed;}
+    /** 获取查找链统计 */
+    const ProbeStat& stat() const {return this->m_stat;}
+    /** 清零查找链统计 */
+    void    reset_stat() {this->m_stat.lookups = 0; this->m_stat.probes = 0; this->m_stat.max_probe = 0;}
+    /** 开启或关闭查找链统计 */
+    void    enable_stat(bool on) {this->m_stat_on = on;}
+    /** 开启或关闭epoch回收（供无锁读者使用） */
+    void    enable_epoch(bool on) {this->m_epoch = on;}
+    void    enable_filter(int bits_per_key = 10);
     bool    put(K, V);
     V*      get(K);
     bool    remove(K);
+    const V* find(const K&) const;
+    /** 获取当前散列表的快照 */
+    View    view() const
+    {
+        View v = {this->m_ht, this->m_cap, this->lazy_rm, this->m_old_ht, this->m_old_cap, this->m_old_rm,
+                  this->m_filter, this->m_old_filter};
+        return v;
+    }
+    const V* find(const View&, const K&) const;
+
+    template <typename VST> void traverse(VST& visit);
 };
 
 
@@ -157,7 +337,10 @@ private:
     dsa::List<Pair>* m_ht;  /**< 散列容量数组，存放词条指针 */
     int     m_cap;          /**< 散列容量 */
     int     m_size;         /**< 实际插入的键值对元素 */
-    HF      hash_func;      /**< 计算Hash的函数 */
+    typename dsa::Hash64Of<K,HF>::type hash_func;   /**< 计算64位Hash的函数（由HF决定，见Hash64Of） */
+
+    /** 键所在的链表：64位Hash的高位映射到[0, m_cap) */
+    inline int index_of(const K& key) const {return static_cast<int>(dsa::hash_range64(this->hash_func(key), this->m_cap));}
 
 public:
     HashTableList(int n = 5);
@@ -166,12 +349,12 @@ public:
     /** 重载[]，仿问和修改已有词条，不能插入词条 */
     V& operator[] (const K key)
     {
-        return (this->m_ht[this->hash_func(key) % this->m_cap].find(key)->data.value);
+        return (this->m_ht[this->index_of(key)].find(key)->data.value);
     }
     /** 重载[]，仿问已有词条，不能插入词条 */
     const V& operator[] (const K key) const
     {
-        return (this->m_ht[this->hash_func(key) % this->m_cap].find(key)->data.value);
+        return (this->m_ht[this->index_of(key)].find(key)->data.value);
     }
 
     /** 获取键值对数量 */
@@ -179,6 +362,8 @@ public:
     bool    put(K, V);
     V*      get(K);
     bool    remove(K);
+
+    template <typename VST> void traverse(VST& visit);
 };
 
 
@@ -195,6 +380,18 @@ HashTable<K,V,HF,CMP>::~HashTable()
     }
     delete[] this->m_ht;
     delete this->lazy_rm;
+    delete this->m_filter;
+    delete this->m_old_filter;
+    if (this->is_rehashing())
+    {
+        for (int k = this->m_mig; k < this->m_old_cap; k ++)
+        {
+            if (this->m_old_ht[k])
+                delete this->m_old_ht[k];
+        }
+        delete[] this->m_old_ht;
+        delete this->m_old_rm;
+    }
 }
 
 /*!
@@ -202,6 +399,7 @@ HashTable<K,V,HF,CMP>::~HashTable()
  *
  * 这里使用dsa::prime_1048576来生成不小于n的素数。
  * 故创建散列表时，容量不应超过1048576，否则无法生成正确的素数。
+ * init只初始化新散列表，不改变m_size；新散列表没有墓碑。
  *
  * @param n: 散列表容量为 >= n 的素数
  * @return
@@ -215,11 +413,78 @@ void HashTable<K,V,HF,CMP>::init(int n)
 #elif HASH_PROBE == HASH_PROBE_QUAD
     this->m_cap = dsa::prime_1048576_4k3(n);
 #endif
-    this->m_size = 0;
     this->m_ht = new PairPtr[this->m_cap];
     for (int k = 0; k < this->m_cap; k ++)
         this->m_ht[k] = nullptr;
     this->lazy_rm = new dsa::Bitmap(this->m_cap);
+    this->m_removed = 0;
+}
+
+/*!
+ * @brief 在新旧散列表中查找key
+ *
+ * @param key: 键
+ * @return 返回key所在单元的指针，若不存在key，则返回nullptr
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+typename HashTable<K,V,HF,CMP>::PairPtr* HashTable<K,V,HF,CMP>::locate(const K& key) const
+{
+    PairPtr* p = &this->m_ht[this->probe_hit(key, this->m_ht, this->m_cap, this->lazy_rm)];
+    if (*p)
+        return p;
+    if (this->is_rehashing())
+    {
+        p = &this->m_old_ht[this->probe_hit(key, this->m_old_ht, this->m_old_cap, this->m_old_rm)];
+        if (*p)
+            return p;
+    }
+    return nullptr;
+}
+
+/*!
+ * @brief 过滤器是否判定key一定不存在
+ *
+ * @param key: 键
+ * @param filter,old_filter: 新旧散列表的过滤器
+ * @return 未开启过滤器时，总是返回false
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+bool HashTable<K,V,HF,CMP>::filter_reject(const K& key, const Filter* filter, const Filter* old_filter) const
+{
+    if (!filter)
+        return false;
+    uint64 h = dsa::hash_mix64(this->hash_func(key));
+    if (filter->contains_hash(h))
+        return false;
+    if (old_filter && old_filter->contains_hash(h))
+        return false;
+    return true;
+}
+
+/*!
+ * @brief 开启或关闭前置过滤器
+ *
+ * 开启时，用已有的词条构建过滤器。
+ *
+ * @param bits_per_key: 过滤器每个键的位数，0表示关闭
+ * @return
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+void HashTable<K,V,HF,CMP>::enable_filter(int bits_per_key)
+{
+    this->rehash_finish();
+    this->dispose(this->m_filter);
+    this->m_filter_bpk = bits_per_key > 0 ? bits_per_key : 0;
+    this->m_filter = this->new_filter();
+    if (this->m_filter)
+    {
+        for (int k = 0; k < this->m_cap; k ++)
+            if (this->m_ht[k])
+                this->m_filter->insert(this->m_ht[k]->key);
+    }
 }
 
 /*!
@@ -233,16 +498,32 @@ void HashTable<K,V,HF,CMP>::init(int n)
 template <typename K, typename V, typename HF, typename CMP>
 bool HashTable<K,V,HF,CMP>::put(K key, V val)
 {
+    this->rehash_step();
     // 先检测key是否存在，若已存在key，则放弃插入key-val
-    if (this->m_ht[this->probe_hit(key)])
+    int tomb = -1;
+    int index = this->probe_hit(key, this->m_ht, this->m_cap, this->lazy_rm, &tomb);
+    if (this->m_ht[index])
         return false;
-    // 试探出空单元，用于插入key-val
-    uint index = this->probe_free(key);
-    this->m_ht[index] = new Entry<K,V,CMP>(key, val);
+    if (this->is_rehashing()
+        && this->m_old_ht[this->probe_hit(key, this->m_old_ht, this->m_old_cap, this->m_old_rm)])
+        return false;
+    // 新词条只插入新散列表：优先复用查找链上的墓碑，否则使用查找链末端的空单元
+    if (tomb >= 0)
+    {
+        index = tomb;
+        Clear_Removed(this->lazy_rm, index);
+        this->m_removed --;
+    }
+    PairPtr e = new Entry<K,V,CMP>(key, val);
+    std::atomic_thread_fence(std::memory_order_release);    // 无锁读者看到指针时，词条已构造完成
+    this->m_ht[index] = e;
     this->m_size ++;
-    // 装填因子 >50% 时，重散列，保证恒有一定的空单元
-    if (this->m_size * 2 > this->m_cap)
-        this->rehash();
+    if (this->m_filter)
+        this->m_filter->insert(key);
+    // 装填因子（含墓碑）>50% 时，重散列，保证恒有一定的空单元；
+    // 有效词条不足25%时，以相同容量重建，只清除墓碑
+    if ((this->m_size + this->m_removed) * 2 > this->m_cap)
+        this->resize(this->m_size * 4 > this->m_cap ? 2*this->m_cap : this->m_cap);
     return true;
 }
 
@@ -258,9 +539,53 @@ bool HashTable<K,V,HF,CMP>::put(K key, V val)
 template <typename K, typename V, typename HF, typename CMP>
 V* HashTable<K,V,HF,CMP>::get(K key)
 {
-    int index = this->probe_hit(key);
+    this->rehash_step();
+    if (this->filter_reject(key, this->m_filter, this->m_old_filter))
+        return nullptr;
+    PairPtr* p = this->locate(key);
     // 若不存在key，则返回nullptr
-    return this->m_ht[index] ? &(this->m_ht[index]->value) : nullptr;
+    return p ? &((*p)->value) : nullptr;
+}
+
+/*!
+ * @brief 根据键查找值
+ *
+ * 与get不同，find不推进渐进式重散列，不修改散列表；
+ * 关闭查找链统计（enable_stat(false)）后，可由多个读者并发调用。
+ *
+ * @param key: 键
+ * @return 返回对应value的指针，或nullptr
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+const V* HashTable<K,V,HF,CMP>::find(const K& key) const
+{
+    if (this->filter_reject(key, this->m_filter, this->m_old_filter))
+        return nullptr;
+    PairPtr* p = this->locate(key);
+    return p ? &((*p)->value) : nullptr;
+}
+
+/*!
+ * @brief 沿快照查找值
+ *
+ * 在EpochGuard内调用，快照中的数组与词条在此期间不会被释放；
+ * 写者并发修改时，结果可能不准确，需由调用者校验后重试。
+ *
+ * @param v: view()返回的快照
+ * @param key: 键
+ * @return 返回对应value的指针，或nullptr
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+const V* HashTable<K,V,HF,CMP>::find(const View& v, const K& key) const
+{
+    if (this->filter_reject(key, v.filter, v.old_filter))
+        return nullptr;
+    PairPtr p = v.ht[this->probe_hit(key, v.ht, v.cap, v.rm)];
+    if (!p && v.old_ht)
+        p = v.old_ht[this->probe_hit(key, v.old_ht, v.old_cap, v.old_rm)];
+    return p ? &(p->value) : nullptr;
 }
 
 /*!
@@ -273,18 +598,51 @@ V* HashTable<K,V,HF,CMP>::get(K key)
 template <typename K, typename V, typename HF, typename CMP>
 bool HashTable<K,V,HF,CMP>::remove(K key)
 {
+    this->rehash_step();
     // 先检测key是否存在，若不存在key，则放弃删除
-    int index = this->probe_hit(key);
-    if (!this->m_ht[index])
+    if (this->filter_reject(key, this->m_filter, this->m_old_filter))
+        return false;
+    PairPtr* p = this->locate(key);
+    if (!p)
         return false;
-    // 删除key，并将单元置空，并添加懒惰删除标记
-    delete this->m_ht[index];
-    this->m_ht[index] = nullptr;
+    // 删除key，并将单元置空，并在所在的散列表中添加懒惰删除标记
+    this->dispose(*p);
+    *p = nullptr;
     this->m_size --;
-    Mark_As_Removed(index);
+    if (this->m_ht <= p && p < this->m_ht + this->m_cap)
+    {
+        Mark_As_Removed(this->lazy_rm, p - this->m_ht);
+        this->m_removed ++;
+    }
+    else
+        Mark_As_Removed(this->m_old_rm, p - this->m_old_ht);
+    // 装填因子过低时，收缩散列表
+    if (this->m_cap > this->m_min_cap && this->m_size * HASH_SHRINK_FACTOR < this->m_cap)
+        this->resize(this->m_size * 4 > this->m_min_cap ? this->m_size * 4 : this->m_min_cap);
     return true;
 }
 
+/*!
+ * @brief 调整散列表容量
+ *
+ * 根据HASH_REHASH，选择一次性重散列，或渐进式重散列。
+ *
+ * @param n: 新散列表容量为 >= n 的素数
+ * @return
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+void HashTable<K,V,HF,CMP>::resize(int n)
+{
+#if HASH_REHASH == HASH_REHASH_FULL
+    this->rehash(n);
+#elif HASH_REHASH == HASH_REHASH_INCR
+    // 上一次渐进式重散列还未完成，则先完成上一次重散列
+    this->rehash_finish();
+    this->rehash_start(n);
+#endif
+}
+
 /*!
  * @brief 重散列
  *
@@ -293,27 +651,142 @@ bool HashTable<K,V,HF,CMP>::remove(K key)
  * 不可简单地（通过memcpy()）将原单元数组复制到新单元数组，否则存在两个问题：
  * (1)会继承原有冲突；
  * (2)可能导致查找链在后端断裂，即便为所有扩单元设置懒惰删除标志也无济于事；
+ * 因为词条的key互异，故转移时只需试探空单元，并直接转移词条指针。
  * </pre>
  *
- * @param None
+ * @param n: 新散列表容量为 >= n 的素数
  * @return
  * @retval None
  */
 template <typename K, typename V, typename HF, typename CMP>
-void HashTable<K,V,HF,CMP>::rehash()
+void HashTable<K,V,HF,CMP>::rehash(int n)
 {
+    this->rehash_finish();
     int old_cap = this->m_cap;
     PairPtr* old_ht = this->m_ht;
     // 重新初始化散列单元
-    delete this->lazy_rm;
-    this->init(2*old_cap);
+    this->dispose(this->lazy_rm);
+    this->init(n);
+    this->dispose(this->m_filter);
+    this->m_filter = this->new_filter();
     // 转移散列单元
     for (int k = 0; k < old_cap; k ++)
-        if (old_ht[k]) this->put(old_ht[k]->key, old_ht[k]->value);
+    {
+        if (old_ht[k])
+        {
+            this->m_ht[this->probe_free(old_ht[k]->key, this->m_ht, this->m_cap)] = old_ht[k];
+            if (this->m_filter)
+                this->m_filter->insert(old_ht[k]->key);
+        }
+    }
     // 释放原有散列单元
-    for (int k = 0; k < old_cap; k ++)
-        if (old_ht[k]) delete old_ht[k];
-    delete[] old_ht;
+    this->dispose_array(old_ht);
+}
+
+/*!
+ * @brief 开始渐进式重散列
+ *
+ * 当前散列表成为旧散列表，并创建新散列表，之后由rehash_step逐步迁移旧表中的词条。
+ *
+ * @param n: 新散列表容量为 >= n 的素数
+ * @return
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+void HashTable<K,V,HF,CMP>::rehash_start(int n)
+{
+    this->m_old_ht = this->m_ht;
+    this->m_old_cap = this->m_cap;
+    this->m_old_rm = this->lazy_rm;
+    this->m_old_filter = this->m_filter;
+    this->m_mig = 0;
+    this->init(n);
+    this->m_filter = this->new_filter();
+}
+
+/*!
+ * @brief 渐进式重散列的一步
+ *
+ * 从旧散列表中迁移至多HASH_REHASH_STEP个单元至新散列表，全部迁移完成后释放旧散列表。
+ *
+ * @param None
+ * @return
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+void HashTable<K,V,HF,CMP>::rehash_step()
+{
+    if (!this->is_rehashing())
+        return;
+    for (int n = 0; n < HASH_REHASH_STEP && this->m_mig < this->m_old_cap; n ++, this->m_mig ++)
+    {
+        PairPtr e = this->m_old_ht[this->m_mig];
+        if (e)
+        {
+            // 新散列表中可能已有墓碑（重散列期间的删除），复用时需清除标记
+            int r = this->probe_free(e->key, this->m_ht, this->m_cap);
+            if (Is_Lazy_Removed(this->lazy_rm, r))
+            {
+                Clear_Removed(this->lazy_rm, r);
+                this->m_removed --;
+            }
+            this->m_ht[r] = e;
+            if (this->m_filter)
+                this->m_filter->insert(e->key);
+            // 已迁移的单元需要懒惰删除标记，否则旧表中经过此单元的查找链会断裂
+            this->m_old_ht[this->m_mig] = nullptr;
+            Mark_As_Removed(this->m_old_rm, this->m_mig);
+        }
+    }
+    if (this->m_mig >= this->m_old_cap)
+    {
+        this->dispose_array(this->m_old_ht);
+        this->dispose(this->m_old_rm);
+        this->dispose(this->m_old_filter);
+        this->m_old_ht = nullptr;
+        this->m_old_rm = nullptr;
+        this->m_old_filter = nullptr;
+        this->m_old_cap = 0;
+        this->m_mig = 0;
+    }
+}
+
+/*!
+ * @brief 立即完成渐进式重散列
+ *
+ * @param None
+ * @return
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+void HashTable<K,V,HF,CMP>::rehash_finish()
+{
+    while (this->is_rehashing())
+        this->rehash_step();
+}
+
+/*!
+ * @brief 遍历所有词条
+ *
+ * 重散列时，同时遍历新散列表与旧散列表中未迁移的部分。
+ *
+ * @param visit: 访问函数，参数为词条(Pair&)
+ * @return
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+template <typename VST>
+void HashTable<K,V,HF,CMP>::traverse(VST& visit)
+{
+    for (int k = 0; k < this->m_cap; k ++)
+        if (this->m_ht[k])
+            visit(*this->m_ht[k]);
+    if (this->is_rehashing())
+    {
+        for (int k = this->m_mig; k < this->m_old_cap; k ++)
+            if (this->m_old_ht[k])
+                visit(*this->m_old_ht[k]);
+    }
 }
 
 /*!
@@ -322,8 +795,8 @@ void HashTable<K,V,HF,CMP>::rehash()
  * <pre>
  *
  * 无论散列表中是否已经存在key，均会返回一个下标r。
- * (1) 当 m_ht[r] == nullptr时，说明散列表没有以key为键的单元（一定没有懒惰删除标记）；
- * (2) 当 m_ht[r] != nullptr时，说明散列表已经有以key为键的单元（无论带有懒惰删除标记与否）；
+ * (1) 当 ht[r] == nullptr时，说明散列表没有以key为键的单元（一定没有懒惰删除标记）；
+ * (2) 当 ht[r] != nullptr时，说明散列表已经有以key为键的单元（无论带有懒惰删除标记与否）；
  *
  * Lazy_Removed标记    空单元
  *         /           /
@@ -335,18 +808,27 @@ void HashTable<K,V,HF,CMP>::rehash()
  * </pre>
  *
  * @param key: 键
+ * @param ht,cap,rm: 散列表，散列容量，懒惰删除标记
+ * @param tomb: 不为nullptr时，返回查找链上第一个墓碑的下标（没有则为-1）
  * @return
  * @retval None
  */
 template <typename K, typename V, typename HF, typename CMP>
-int HashTable<K,V,HF,CMP>::probe_line_hit(const K& key)
+int HashTable<K,V,HF,CMP>::probe_line_hit(const K& key, PairPtr* ht, int cap, const dsa::Bitmap* rm, int* tomb) const
 {
-    int r = this->hash_func(key) % this->m_cap;
-    while((this->m_ht[r] && *(this->m_ht[r]) != key)    // 试探：跳过冲突的单元（优先跳过不为nullptr的单元）
-        ||(!this->m_ht[r] && Is_Lazy_Removed(r)))       // 试探：跳过查找链上带懒惰删除标记的单元
+    int r = this->index_of(key, cap);
+    int n = 0;
+    while (n < cap                                  // 至多试探cap次（见类说明：无锁读者）
+        && ((ht[r] && *(ht[r]) != key)              // 试探：跳过冲突的单元（优先跳过不为nullptr的单元）
+          ||(!ht[r] && Is_Lazy_Removed(rm, r))))    // 试探：跳过查找链上带懒惰删除标记的单元
     {
-        r = (r + 1) % this->m_cap;
+        if (tomb && *tomb < 0 && !ht[r])
+            *tomb = r;
+        if (++ r == cap)
+            r = 0;
+        n ++;
     }
+    this->record_probe(n);
     return r;
 }
 
@@ -354,15 +836,17 @@ int HashTable<K,V,HF,CMP>::probe_line_hit(const K& key)
  * @brief 线性试探，查找空单元用于插入新元素
  *
  * @param key: 键
+ * @param ht,cap: 散列表，散列容量
  * @return
  * @retval None
  */
 template <typename K, typename V, typename HF, typename CMP>
-int HashTable<K,V,HF,CMP>::probe_line_free(const K& key)
+int HashTable<K,V,HF,CMP>::probe_line_free(const K& key, PairPtr* ht, int cap) const
 {
-    int r = this->hash_func(key) % this->m_cap;
-    while (this->m_ht[r])
-        r = (r + 1) % this->m_cap;  // 线性试探，直到找到一个空单元（无论带有懒惰删除标记与否）
+    int r = this->index_of(key, cap);
+    while (ht[r])               // 线性试探，直到找到一个空单元（无论带有懒惰删除标记与否）
+        if (++ r == cap)
+            r = 0;
     return r;
 }
 
@@ -370,25 +854,34 @@ int HashTable<K,V,HF,CMP>::probe_line_free(const K& key)
  * @brief 平方试探，查看散列表是否已经存在key
  *
  * 试探距离： 1, -1, 2^2, -2^2, 3^2, -3^2......
+ * 用 (s+1)^2 = s^2 + 2s+1 递推 p = s^2 mod cap，每步只需加减，不做除法；
+ * 正向 i+p 超出cap时减去cap，负向 i-p 小于0时加上cap。
  *
  * @param key: 键
+ * @param ht,cap,rm: 散列表，散列容量，懒惰删除标记
+ * @param tomb: 不为nullptr时，返回查找链上第一个墓碑的下标（没有则为-1）
  * @return
  * @retval None
  */
 template <typename K, typename V, typename HF, typename CMP>
-int HashTable<K,V,HF,CMP>::probe_quad_hit(const K& key)
+int HashTable<K,V,HF,CMP>::probe_quad_hit(const K& key, PairPtr* ht, int cap, const dsa::Bitmap* rm, int* tomb) const
 {
-    int i = this->hash_func(key) % this->m_cap;
-    int r = i, s = 1;
-    while((this->m_ht[r] && *(this->m_ht[r]) != key)    // 试探：跳过冲突的单元（优先跳过不为nullptr的单元）
-        ||(!this->m_ht[r] && Is_Lazy_Removed(r)))       // 试探：跳过查找链上带懒惰删除标记的单元
+    int i = this->index_of(key, cap);
+    int p = 1;                  // p = s^2 mod cap
+    int d = 3;                  // d = 2s+1
+    bool pos = true;            // 下一步向正方向试探
+    int r = i;
+    int n = 0;
+    while (n < cap                                  // 至多试探cap次（见类说明：无锁读者）
+        && ((ht[r] && *(ht[r]) != key)              // 试探：跳过冲突的单元（优先跳过不为nullptr的单元）
+          ||(!ht[r] && Is_Lazy_Removed(rm, r))))    // 试探：跳过查找链上带懒惰删除标记的单元
     {
-        if (s > 0)
-            r = (i + s*s) % this->m_cap;
-        else
-            r = (i - s*s) % this->m_cap;
-        s = (s > 0) ? -s : -(--s);
+        if (tomb && *tomb < 0 && !ht[r])
+            *tomb = r;
+        n ++;
+        this->quad_step(i, cap, p, d, pos, r);
     }
+    this->record_probe(n);
     return r;
 }
 
@@ -396,23 +889,19 @@ int HashTable<K,V,HF,CMP>::probe_quad_hit(const K& key)
  * @brief 平方试探，查找空单元用于插入新元素
  *
  * @param key: 键
+ * @param ht,cap: 散列表，散列容量
  * @return
  * @retval None
  */
 template <typename K, typename V, typename HF, typename CMP>
-int HashTable<K,V,HF,CMP>::probe_quad_free(const K& key)
+int HashTable<K,V,HF,CMP>::probe_quad_free(const K& key, PairPtr* ht, int cap) const
 {
-    int i = this->hash_func(key) % this->m_cap;
-    int r = i, s = 1;
-    while (this->m_ht[r])
-    {
-        //平方试探，直到找到一个空单元（无论带有懒惰删除标记与否）
-        if (s > 0)
-            r = (i + s*s) % this->m_cap;
-        else
-            r = (i - s*s) % this->m_cap;
-        s = (s > 0) ? -s : -(--s);
-    }
+    int i = this->index_of(key, cap);
+    int p = 1, d = 3;
+    bool pos = true;
+    int r = i;
+    while (ht[r])               // 平方试探，直到找到一个空单元（无论带有懒惰删除标记与否）
+        this->quad_step(i, cap, p, d, pos, r);
     return r;
 }
 
@@ -446,7 +935,7 @@ HashTableList<K,V,HF,CMP>::HashTableList(int n)
 template <typename K, typename V, typename HF, typename CMP>
 bool HashTableList<K,V,HF,CMP>::put(K key, V val)
 {
-    int r = this->hash_func(key) % this->m_cap;
+    int r = this->index_of(key);
     // 已存在key，放弃插入key-val
     if (m_ht[r].find(key))
         return false;
@@ -467,7 +956,7 @@ bool HashTableList<K,V,HF,CMP>::put(K key, V val)
 template <typename K, typename V, typename HF, typename CMP>
 V* HashTableList<K,V,HF,CMP>::get(K key)
 {
-    int r = this->hash_func(key) % this->m_cap;
+    int r = this->index_of(key);
     dsa::ListNodePtr<Pair> node = this->m_ht[r].find(key);
     return node ? &(node->data.value) : nullptr;
 }
@@ -482,7 +971,7 @@ V* HashTableList<K,V,HF,CMP>::get(K key)
 template <typename K, typename V, typename HF, typename CMP>
 bool HashTableList<K,V,HF,CMP>::remove(K key)
 {
-    int r = this->hash_func(key) % this->m_cap;
+    int r = this->index_of(key);
     dsa::ListNodePtr<Pair> node = this->m_ht[r].find(key);
     // 若不存在key，则放弃删除
     if (!node)
@@ -492,6 +981,21 @@ bool HashTableList<K,V,HF,CMP>::remove(K key)
     return true;
 }
 
+/*!
+ * @brief 遍历所有词条
+ *
+ * @param visit: 访问函数，参数为词条(Pair&)
+ * @return
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+template <typename VST>
+void HashTableList<K,V,HF,CMP>::traverse(VST& visit)
+{
+    for (int k = 0; k < this->m_cap; k ++)
+        this->m_ht[k].traverse(visit);
+}
+
 } /* dsa */
 
 #endif /* ifndef DSAS_HASH_H */
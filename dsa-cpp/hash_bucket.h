@@ -0,0 +1,341 @@
+
+//==============================================================================
+/*!
+ * @file hash_bucket.h
+ * @brief 内联桶的链式散列表
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_HASH_BUCKET_H
+#define DSAS_HASH_BUCKET_H
+
+#include "share/entry.h"
+#include "share/compare.h"
+#include "vector.h"
+#include "hash_func.h"
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup LHash
+ *
+ * @{
+ */
+
+/*!
+ * @brief 内联桶的链式散列表模板类
+ *
+ * <pre>
+ * 与HashTableList一样使用链表解决冲突，但：
+ * (1): 每个桶直接存放前B个词条，没有哨兵节点，查找时通常只访问一个缓存行；
+ * (2): 超出B个的词条放入共享的节点池，用int下标（而非指针）串成溢出链；
+ *      删除的节点挂到空闲链表上，供之后的插入复用；
+ * (3): 桶数量为2的幂，取64位Hash的高位定位桶：h >> (64 - log2(m_nb))，不做取模。
+ *
+ *   bucket:  [cnt|next|k0 v0|k1 v1]
+ *   bucket:  [cnt|next|k0 v0|k1 v1] --> pool[7] --> pool[3] --> -1
+ *   bucket:  [ 0 | -1 |  ...  ... ]
+ *
+ * 桶内词条总是先填满内联槽位，再使用溢出链；
+ * 词条数量超过桶数量（装填因子>1）时，桶数量加倍并重散列。
+ * </pre>
+ *
+ */
+template <
+    typename K,
+    typename V,
+    typename HF=dsa::Hash<K>,
+    typename CMP=dsa::Less<K>,
+    int B = 2>
+class HashTableBucket : public dsa::Dict<K, V>
+{
+private:
+    /** 桶，内联存放前B个词条 */
+    struct Bucket
+    {
+        int     cnt;        /**< 内联词条数量 */
+        int     next;       /**< 溢出链的首节点下标，-1表示没有 */
+        K       key[B];
+        V       val[B];
+    };
+    /** 溢出链节点 */
+    struct Node
+    {
+        K       key;
+        V       val;
+        int     next;       /**< 下一个节点下标，-1表示链尾 */
+    };
+
+    Bucket* m_bk;           /**< 桶数组 */
+    int     m_nb;           /**< 桶数量，为2的幂（至少为2） */
+    int     m_shift;        /**< 定位桶时Hash右移的位数：64 - log2(m_nb) */
+    int     m_size;         /**< 词条数量 */
+    dsa::Vector<Node> m_pool;   /**< 溢出节点池 */
+    int     m_free;         /**< 空闲节点链表的首节点，-1表示没有 */
+    int     m_over;         /**< 正在使用的溢出节点数量 */
+    typename dsa::Hash64Of<K,HF>::type hash_func;   /**< 计算64位Hash的函数（由HF决定，见Hash64Of） */
+    CMP     cmp;            /**< 比较函数 */
+
+protected:
+    /** 判断两个键是否相等 */
+    inline bool equal(const K& a, const K& b) const {return !(this->cmp(a, b) || this->cmp(b, a));}
+    /** 计算key所在的桶 */
+    inline int bucket_of(const K& key) const {return static_cast<int>(this->hash_func(key) >> this->m_shift);}
+    int     alloc_node();
+    void    free_node(int);
+    void    insert_to(Bucket&, const K&, const V&);
+    void    init(int);
+    void    rehash(int);
+
+public:
+    HashTableBucket(int n = 8);
+    ~HashTableBucket() {delete[] this->m_bk;}
+    HashTableBucket(const HashTableBucket&) = delete;
+    HashTableBucket& operator= (const HashTableBucket&) = delete;
+
+    /** 重载[]，仿问和修改已有词条，不能插入词条 */
+    V& operator[] (const K key) {return *this->get(key);}
+
+    /** 获取键值对数量 */
+    int     size() const {return this->m_size;}
+    /** 获取桶数量 */
+    int     buckets() const {return this->m_nb;}
+    /** 获取溢出链上的词条数量 */
+    int     overflow() const {return this->m_over;}
+    /** 估算占用的内存（字节） */
+    long    memory() const {return (long)sizeof(Bucket) * this->m_nb + (long)sizeof(Node) * this->m_pool.size();}
+    bool    put(K, V);
+    V*      get(K);
+    bool    remove(K);
+};
+
+/*! @} */
+
+
+/*!
+ * @brief 创建散列表
+ *
+ * @param n: 桶数量为 >= n 的2的幂
+ * @return
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP, int B>
+HashTableBucket<K,V,HF,CMP,B>::HashTableBucket(int n)
+    : m_size(0), m_pool(8), m_free(-1), m_over(0)
+{
+    this->init(n);
+}
+
+/*!
+ * @brief 初始化桶数组
+ *
+ * @param n: 桶数量为 >= n 的2的幂
+ * @return
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP, int B>
+void HashTableBucket<K,V,HF,CMP,B>::init(int n)
+{
+    this->m_nb = 2;         // 至少2个桶，保证右移位数小于64
+    this->m_shift = 63;
+    while (this->m_nb < n)
+    {
+        this->m_nb <<= 1;
+        this->m_shift --;
+    }
+    this->m_bk = new Bucket[this->m_nb];
+    for (int k = 0; k < this->m_nb; k ++)
+    {
+        this->m_bk[k].cnt = 0;
+        this->m_bk[k].next = -1;
+    }
+}
+
+/*!
+ * @brief 从节点池分配一个节点，优先复用空闲节点
+ *
+ * @param None
+ * @return 节点下标
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP, int B>
+int HashTableBucket<K,V,HF,CMP,B>::alloc_node()
+{
+    this->m_over ++;
+    if (this->m_free >= 0)
+    {
+        int r = this->m_free;
+        this->m_free = this->m_pool[r].next;
+        return r;
+    }
+    return this->m_pool.push_back(Node());
+}
+
+/** 将节点归还到空闲链表 */
+template <typename K, typename V, typename HF, typename CMP, int B>
+void HashTableBucket<K,V,HF,CMP,B>::free_node(int r)
+{
+    this->m_over --;
+    this->m_pool[r].key = K();
+    this->m_pool[r].val = V();
+    this->m_pool[r].next = this->m_free;
+    this->m_free = r;
+}
+
+/** 将词条插入桶中（不检查key是否已存在） */
+template <typename K, typename V, typename HF, typename CMP, int B>
+void HashTableBucket<K,V,HF,CMP,B>::insert_to(Bucket& bk, const K& key, const V& val)
+{
+    if (bk.cnt < B)
+    {
+        bk.key[bk.cnt] = key;
+        bk.val[bk.cnt] = val;
+        bk.cnt ++;
+    }
+    else
+    {
+        // 新节点插入到溢出链首
+        int r = this->alloc_node();
+        this->m_pool[r].key = key;
+        this->m_pool[r].val = val;
+        this->m_pool[r].next = bk.next;
+        bk.next = r;
+    }
+}
+
+/*!
+ * @brief 重散列，桶数量调整为n
+ *
+ * 先只把溢出链上的词条取出（空闲节点直接丢弃），清空节点池后，内联词条与这些词条逐个重新插入，
+ * 重散列后节点池是紧凑的：正在使用的溢出节点即为前m_over个。
+ *
+ * @param n: 新的桶数量（2的幂）
+ * @return
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP, int B>
+void HashTableBucket<K,V,HF,CMP,B>::rehash(int n)
+{
+    Bucket* old_bk = this->m_bk;
+    int old_nb = this->m_nb;
+    dsa::Vector<Node> live(this->m_over + 1);
+    for (int b = 0; b < old_nb; b ++)
+        for (int r = old_bk[b].next; r >= 0; r = this->m_pool[r].next)
+            live.push_back(this->m_pool[r]);
+    this->m_pool.clear();
+    this->m_free = -1;
+    this->m_over = 0;
+    this->init(n);
+    for (int b = 0; b < old_nb; b ++)
+    {
+        const Bucket& bk = old_bk[b];
+        for (int k = 0; k < bk.cnt; k ++)
+            this->insert_to(this->m_bk[this->bucket_of(bk.key[k])], bk.key[k], bk.val[k]);
+    }
+    for (int k = 0; k < live.size(); k ++)
+        this->insert_to(this->m_bk[this->bucket_of(live[k].key)], live[k].key, live[k].val);
+    delete[] old_bk;
+}
+
+/*!
+ * @brief 插入字典键-值对
+ *
+ * @param key: 待插入的键
+ * @param val: 待插入的值
+ * @return 若已存在key，则放弃插入，返回false
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP, int B>
+bool HashTableBucket<K,V,HF,CMP,B>::put(K key, V val)
+{
+    if (this->get(key))
+        return false;
+    this->insert_to(this->m_bk[this->bucket_of(key)], key, val);
+    this->m_size ++;
+    // 装填因子 >1 时，桶数量加倍
+    if (this->m_size > this->m_nb)
+        this->rehash(this->m_nb << 1);
+    return true;
+}
+
+/*!
+ * @brief 根据键获取或修改值
+ *
+ * @param key: 键
+ * @return 返回对应key-value的指针，或nullptr
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP, int B>
+V* HashTableBucket<K,V,HF,CMP,B>::get(K key)
+{
+    Bucket& bk = this->m_bk[this->bucket_of(key)];
+    for (int k = 0; k < bk.cnt; k ++)
+        if (this->equal(bk.key[k], key))
+            return &bk.val[k];
+    for (int r = bk.next; r >= 0; r = this->m_pool[r].next)
+        if (this->equal(this->m_pool[r].key, key))
+            return &this->m_pool[r].val;
+    return nullptr;
+}
+
+/*!
+ * @brief 根据键删除值
+ *
+ * 删除内联词条时，用最后一个内联词条填补空位，再从溢出链首取一个词条补满内联槽位。
+ *
+ * @param key: 键
+ * @return 返回删除成功与否的结果
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP, int B>
+bool HashTableBucket<K,V,HF,CMP,B>::remove(K key)
+{
+    Bucket& bk = this->m_bk[this->bucket_of(key)];
+    for (int k = 0; k < bk.cnt; k ++)
+    {
+        if (this->equal(bk.key[k], key))
+        {
+            int last = bk.cnt - 1;
+            bk.key[k] = bk.key[last];
+            bk.val[k] = bk.val[last];
+            if (bk.next >= 0)
+            {
+                int r = bk.next;
+                bk.key[last] = this->m_pool[r].key;
+                bk.val[last] = this->m_pool[r].val;
+                bk.next = this->m_pool[r].next;
+                this->free_node(r);
+            }
+            else
+            {
+                bk.key[last] = K();
+                bk.val[last] = V();
+                bk.cnt --;
+            }
+            this->m_size --;
+            return true;
+        }
+    }
+    for (int* p = &bk.next; *p >= 0; p = &this->m_pool[*p].next)
+    {
+        if (this->equal(this->m_pool[*p].key, key))
+        {
+            int r = *p;
+            *p = this->m_pool[r].next;
+            this->free_node(r);
+            this->m_size --;
+            return true;
+        }
+    }
+    return false;
+}
+
+} /* dsa */
+
+#endif /* ifndef DSAS_HASH_BUCKET_H */
@@ -0,0 +1,429 @@
+
+//==============================================================================
+/*!
+ * @file hash_concurrent.h
+ * @brief 并发散列表
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_HASH_CONCURRENT_H
+#define DSAS_HASH_CONCURRENT_H
+
+#include <cstdint>
+#include <new>
+#include "share/macro.h"
+#include "share/lock.h"
+#include "share/epoch.h"
+#include "hash.h"
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup LHash
+ *
+ * @{
+ */
+
+/*!
+ * @brief 分片并发散列表模板类
+ *
+ * <pre>
+ * 将键空间划分到 N = 2^k 个相互独立的HashTable（分片）中，每个分片有一把写锁和一个版本号：
+ *   shard[0]: [lock][seq][ht] -> HashTable
+ *   shard[1]: [lock][seq][ht] -> HashTable
+ *   ......
+ * 不同分片上的操作互不阻塞；同一分片上的写操作互斥，读操作不加锁。
+ * 每个分片独占一个缓存行，避免相邻分片的锁产生伪共享。
+ *
+ * 分片号取64位Hash的低k位，分片内的HashTable则用高32位做区间映射（hash_range64），
+ * 二者使用的是散列值的不同部分，同一分片内的键不会在HashTable中聚集。
+ *
+ * 读操作（seqlock + epoch）：
+ * (1) 写者持锁，修改前后各将seq加1，写期间seq为奇数；
+ * (2) 读者在EpochGuard内读取seq（为奇数则等待），取HashTable的快照并校验seq，
+ *     再沿快照试探（HashTable::find(view, key)），最后再次校验seq，seq变化则重试；
+ * (3) 分片内的HashTable开启了epoch回收：删除的词条与重散列替换下的数组均退休至EpochDomain，
+ *     读者在临界区内读到的数组与词条不会被释放，重试前的读取也不会访问已释放的内存。
+ * 读者不写任何共享数据，读操作的开销不随读线程数增加。
+ * 读操作通过拷贝返回值，而不是返回指针，因为指针在离开临界区后可能随时失效。
+ *
+ * put_batch/get_batch先按分片对键分组，每个分片只加一次锁（或只校验一次seq）。
+ * </pre>
+ *
+ */
+template <
+    typename K,
+    typename V,
+    typename HF=dsa::Hash<K>,
+    typename CMP=dsa::Less<K> >
+class HashTableConcurrent
+{
+public:
+    using Table = dsa::HashTable<K,V,HF,CMP>;
+
+private:
+    /** 分片，按缓存行对齐，独占一个缓存行 */
+    struct alignas(DSAS_CACHELINE) Shard
+    {
+        dsa::SpinLock lock;             /**< 写锁 */
+        std::atomic<unsigned> seq;      /**< 版本号，写期间为奇数 */
+        Table*  ht;
+        Shard() : seq(0), ht(nullptr) {}
+    };
+
+    /** 写操作的作用域：加写锁，写期间版本号为奇数 */
+    class WriteGuard
+    {
+    private:
+        Shard&  m_s;
+    public:
+        explicit WriteGuard(Shard& s) : m_s(s)
+        {
+            this->m_s.lock.lock();
+            this->m_s.seq.store(this->m_s.seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);    // seq先于之后的修改可见
+        }
+        ~WriteGuard()
+        {
+            this->m_s.seq.store(this->m_s.seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            this->m_s.lock.unlock();
+        }
+        WriteGuard(const WriteGuard&) = delete;
+        WriteGuard& operator= (const WriteGuard&) = delete;
+    };
+
+    void*   m_raw;          /**< 分片数组的原始内存 */
+    Shard*  m_shards;       /**< 分片数组，起始地址按缓存行对齐 */
+    int     m_num;          /**< 分片数量，为2的幂 */
+    int     m_bits;         /**< m_num = 2^m_bits */
+    typename dsa::Hash64Of<K,HF>::type hash_func;   /**< 计算64位Hash的函数，与分片内的HashTable一致 */
+
+protected:
+    /** 计算key所在的分片 */
+    inline int shard_of(const K& key) const
+    {
+        return static_cast<int>(this->hash_func(key) & static_cast<uint64>(this->m_num - 1));
+    }
+    void group(const K*, int, int*, int*) const;
+    /** 等待分片的写操作结束，返回此时的版本号 */
+    static unsigned read_begin(const Shard& s)
+    {
+        dsa::Backoff b;
+        unsigned v;
+        while ((v = s.seq.load(std::memory_order_acquire)) & 1)
+            b.pause();
+        return v;
+    }
+    /** 自read_begin以来，分片是否没有被修改 */
+    static bool read_valid(const Shard& s, unsigned v)
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);    // 之前的读取先于seq的再次读取
+        return s.seq.load(std::memory_order_relaxed) == v;
+    }
+    const V* lookup(const Shard&, const K&) const;
+
+public:
+    HashTableConcurrent(int shards = 64, int n = 5);
+    ~HashTableConcurrent();
+    HashTableConcurrent(const HashTableConcurrent&) = delete;
+    HashTableConcurrent& operator= (const HashTableConcurrent&) = delete;
+
+    /** 获取分片数量 */
+    int     shards() const {return this->m_num;}
+    int     size() const;
+    bool    put(const K&, const V&);
+    bool    get(const K&, V&) const;
+    bool    contains(const K&) const;
+    bool    remove(const K&);
+    int     put_batch(const K*, const V*, int, bool* ok = nullptr);
+    int     get_batch(const K*, int, V*, bool*) const;
+};
+
+/*! @} */
+
+
+/*!
+ * @brief 创建并发散列表
+ *
+ * @param shards: 分片数量，向上取为2的幂（不超过65536）
+ * @param n: 每个分片的初始容量
+ * @return
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+HashTableConcurrent<K,V,HF,CMP>::HashTableConcurrent(int shards, int n)
+{
+    this->m_bits = 0;
+    while ((1 << this->m_bits) < shards && this->m_bits < 16)
+        this->m_bits ++;
+    this->m_num = 1 << this->m_bits;
+    // operator new只保证alignof(std::max_align_t)，多申请一个缓存行，手动对齐起始位置
+    this->m_raw = ::operator new(sizeof(Shard) * this->m_num + DSAS_CACHELINE);
+    std::uintptr_t a = reinterpret_cast<std::uintptr_t>(this->m_raw);
+    this->m_shards = reinterpret_cast<Shard*>((a + DSAS_CACHELINE - 1) / DSAS_CACHELINE * DSAS_CACHELINE);
+    for (int k = 0; k < this->m_num; k ++)
+    {
+        new (&this->m_shards[k]) Shard();
+        this->m_shards[k].ht = new Table(n);
+        this->m_shards[k].ht->enable_stat(false);   // 多个读者并发find时，不能写统计数据
+        this->m_shards[k].ht->enable_epoch(true);   // 读者不加锁，摘除的词条与数组需延迟释放
+    }
+}
+
+template <typename K, typename V, typename HF, typename CMP>
+HashTableConcurrent<K,V,HF,CMP>::~HashTableConcurrent()
+{
+    for (int k = 0; k < this->m_num; k ++)
+    {
+        delete this->m_shards[k].ht;
+        this->m_shards[k].~Shard();
+    }
+    ::operator delete(this->m_raw);
+}
+
+/*!
+ * @brief 获取键值对数量
+ *
+ * 逐个分片读取并累加，并发修改时只是一个近似值。
+ *
+ * @param None
+ * @return
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+int HashTableConcurrent<K,V,HF,CMP>::size() const
+{
+    int n = 0;
+    for (int k = 0; k < this->m_num; k ++)
+    {
+        const Shard& s = this->m_shards[k];
+        unsigned v;
+        int c;
+        do {
+            v = read_begin(s);
+            c = s.ht->size();
+        } while (!read_valid(s, v));
+        n += c;
+    }
+    return n;
+}
+
+/*!
+ * @brief 在分片中无锁查找key
+ *
+ * 调用者需持有EpochGuard，返回的指针只在临界区内有效。
+ * 先校验快照再试探，保证试探时数组与容量相互匹配；试探后再次校验，保证结果有效。
+ *
+ * @param s: 分片
+ * @param key: 键
+ * @return 返回对应value的指针，或nullptr
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+const V* HashTableConcurrent<K,V,HF,CMP>::lookup(const Shard& s, const K& key) const
+{
+    for (;;)
+    {
+        unsigned v = read_begin(s);
+        typename Table::View tv = s.ht->view();
+        if (!read_valid(s, v))
+            continue;
+        const V* p = s.ht->find(tv, key);
+        if (read_valid(s, v))
+            return p;
+    }
+}
+
+/*!
+ * @brief 插入字典键-值对
+ *
+ * @param key: 待插入的键
+ * @param val: 待插入的值
+ * @return 若已存在key，则放弃插入，返回false
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+bool HashTableConcurrent<K,V,HF,CMP>::put(const K& key, const V& val)
+{
+    Shard& s = this->m_shards[this->shard_of(key)];
+    WriteGuard g(s);
+    return s.ht->put(key, val);
+}
+
+/*!
+ * @brief 根据键获取值
+ *
+ * @param key: 键
+ * @param val: 返回值的拷贝
+ * @return 是否存在key
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+bool HashTableConcurrent<K,V,HF,CMP>::get(const K& key, V& val) const
+{
+    dsa::EpochGuard eg;
+    const V* p = this->lookup(this->m_shards[this->shard_of(key)], key);
+    if (p)
+        val = *p;       // 词条的值插入后不再修改，且在临界区内不会被释放
+    return p != nullptr;
+}
+
+/*!
+ * @brief 是否存在key
+ *
+ * @param key: 键
+ * @return
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+bool HashTableConcurrent<K,V,HF,CMP>::contains(const K& key) const
+{
+    dsa::EpochGuard eg;
+    return this->lookup(this->m_shards[this->shard_of(key)], key) != nullptr;
+}
+
+/*!
+ * @brief 根据键删除值
+ *
+ * @param key: 键
+ * @return 返回删除成功与否的结果
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+bool HashTableConcurrent<K,V,HF,CMP>::remove(const K& key)
+{
+    Shard& s = this->m_shards[this->shard_of(key)];
+    WriteGuard g(s);
+    return s.ht->remove(key);
+}
+
+/*!
+ * @brief 按分片对键分组（计数排序）
+ *
+ * @param keys,n: 键数组
+ * @param order: 返回按分片排序后的键下标，长度为n
+ * @param start: 返回各分片在order中的起始位置，长度为m_num+1
+ * @return
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+void HashTableConcurrent<K,V,HF,CMP>::group(const K* keys, int n, int* order, int* start) const
+{
+    int* sid = new int[n];
+    for (int k = 0; k <= this->m_num; k ++)
+        start[k] = 0;
+    for (int k = 0; k < n; k ++)
+    {
+        sid[k] = this->shard_of(keys[k]);
+        start[sid[k] + 1] ++;
+    }
+    for (int k = 0; k < this->m_num; k ++)
+        start[k + 1] += start[k];
+    int* pos = new int[this->m_num];
+    for (int k = 0; k < this->m_num; k ++)
+        pos[k] = start[k];
+    for (int k = 0; k < n; k ++)
+        order[pos[sid[k]] ++] = k;
+    delete[] pos;
+    delete[] sid;
+}
+
+/*!
+ * @brief 批量插入键-值对
+ *
+ * 先按分片分组，每个分片只加一次写锁。
+ *
+ * @param keys,vals,n: 键数组，值数组，数组长度
+ * @param ok: 不为nullptr时，返回每个键值对是否插入成功
+ * @return 插入成功的数量
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+int HashTableConcurrent<K,V,HF,CMP>::put_batch(const K* keys, const V* vals, int n, bool* ok)
+{
+    int* order = new int[n];
+    int* start = new int[this->m_num + 1];
+    this->group(keys, n, order, start);
+    int cnt = 0;
+    for (int s = 0; s < this->m_num; s ++)
+    {
+        if (start[s] == start[s + 1])
+            continue;
+        WriteGuard g(this->m_shards[s]);
+        for (int k = start[s]; k < start[s + 1]; k ++)
+        {
+            int i = order[k];
+            bool r = this->m_shards[s].ht->put(keys[i], vals[i]);
+            if (ok)
+                ok[i] = r;
+            cnt += r;
+        }
+    }
+    delete[] start;
+    delete[] order;
+    return cnt;
+}
+
+/*!
+ * @brief 批量获取值
+ *
+ * 先按分片分组，每个分片取一次快照、校验一次版本号；版本号变化时，重试该分片的整组键。
+ *
+ * @param keys,n: 键数组，数组长度
+ * @param vals: 返回值的拷贝（不存在的键对应的值不修改）
+ * @param found: 返回每个键是否存在
+ * @return 存在的键的数量
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+int HashTableConcurrent<K,V,HF,CMP>::get_batch(const K* keys, int n, V* vals, bool* found) const
+{
+    int* order = new int[n];
+    int* start = new int[this->m_num + 1];
+    const V** ptr = new const V*[n];
+    this->group(keys, n, order, start);
+    int cnt = 0;
+    dsa::EpochGuard eg;
+    for (int s = 0; s < this->m_num; s ++)
+    {
+        if (start[s] == start[s + 1])
+            continue;
+        const Shard& sh = this->m_shards[s];
+        for (;;)
+        {
+            unsigned v = read_begin(sh);
+            typename Table::View tv = sh.ht->view();
+            if (!read_valid(sh, v))
+                continue;
+            for (int k = start[s]; k < start[s + 1]; k ++)
+                ptr[order[k]] = sh.ht->find(tv, keys[order[k]]);
+            if (read_valid(sh, v))
+                break;
+        }
+        // 校验通过后再拷贝值，重试不会修改vals
+        for (int k = start[s]; k < start[s + 1]; k ++)
+        {
+            int i = order[k];
+            found[i] = (ptr[i] != nullptr);
+            if (ptr[i])
+            {
+                vals[i] = *ptr[i];
+                cnt ++;
+            }
+        }
+    }
+    delete[] ptr;
+    delete[] start;
+    delete[] order;
+    return cnt;
+}
+
+} /* dsa */
+
+#endif /* ifndef DSAS_HASH_CONCURRENT_H */
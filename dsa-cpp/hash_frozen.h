@@ -0,0 +1,515 @@
+
+//==============================================================================
+/*!
+ * @file hash_frozen.h
+ * @brief 只读的完美散列表
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_HASH_FROZEN_H
+#define DSAS_HASH_FROZEN_H
+
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include "share/macro.h"
+#include "share/entry.h"
+#include "share/compare.h"
+#include "vector.h"
+#include "hash_func.h"
+#include "hash.h"
+#if defined DSAS_LINUX
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup LHash
+ *
+ * @{
+ */
+
+#define HASH_FROZEN_LAMBDA  4           /**< 每个桶的平均键数 */
+#define HASH_FROZEN_MAX_D   (1 << 20)   /**< 单个桶的位移值上限，超过则构建失败 */
+
+/*!
+ * @brief 只读的完美散列表模板类
+ *
+ * <pre>
+ * 使用CHD（Compress, Hash and Displace）构造完美散列：
+ * (1): n个键先散列到 r = n/λ 个桶，每个桶平均λ个键；
+ * (2): 按桶的大小降序，为每个桶b寻找位移值d，使桶内所有键的
+ *      pos = f(h(key), d) % m 均落在空单元且互不冲突，记 disp[b] = d；
+ * (3): 查找时只需：h = Hash64(key)，b = g(h)，pos = f(h, disp[b])，比较slot[pos].key。
+ * 任意查找均为两次散列计算与两次访存，没有查找链与懒惰删除标记。
+ *
+ *   disp: [d0][d1][d2]......[dr-1]            r = n/4 个uint
+ *   used: [bits ..........................]   m 个bit
+ *   slot: [k,v][k,v][   ][k,v]......[k,v]     m = n*1.06 个单元
+ *
+ * 可以保存到文件，并通过mmap直接加载（只支持可平凡复制的K,V）：
+ *   [Header][disp][pad][used][slot]
+ * </pre>
+ *
+ */
+template <
+    typename K,
+    typename V,
+    typename HF=dsa::Hash64<K>,
+    typename CMP=dsa::Less<K> >
+class HashFrozen
+{
+public:
+    /** 单元 */
+    struct Slot
+    {
+        K   key;
+        V   value;
+    };
+
+private:
+    /** 文件头 */
+    struct Header
+    {
+        char    magic[8];
+        uint64  n, m, r;
+        uint64  ksize, vsize, ssize;
+    };
+
+    int     m_n;            /**< 键值对数量 */
+    int     m_m;            /**< 单元数量 */
+    int     m_r;            /**< 桶数量 */
+    uint*   m_disp;         /**< 桶的位移值 */
+    uint64* m_used;         /**< 单元是否被占用 */
+    Slot*   m_slot;         /**< 单元数组 */
+    void*   m_map;          /**< mmap的映射地址，nullptr表示数组为new分配 */
+    long    m_maplen;       /**< mmap的映射长度 */
+    HF      hash_func;      /**< 计算Hash的函数 */
+    CMP     cmp;            /**< 比较函数 */
+
+protected:
+    /** 计算键所在的桶 */
+    inline int bucket_of(uint64 h) const {return static_cast<int>(dsa::hash_range(static_cast<uint>(h >> 32), this->m_r));}
+    /** 根据位移值计算键所在的单元 */
+    inline int slot_of(uint64 h, uint d) const
+    {
+        return static_cast<int>(dsa::hash_range(static_cast<uint>(dsa::hash_mix64(h + d * 0x9e3779b97f4a7c15ULL)), this->m_m));
+    }
+    inline bool is_used(int k) const {return (this->m_used[k >> 6] >> (k & 63)) & 1;}
+    inline void set_used(int k) {this->m_used[k >> 6] |= (1ULL << (k & 63));}
+    inline bool equal(const K& a, const K& b) const {return !(this->cmp(a, b) || this->cmp(b, a));}
+    /** 各数组在文件中的偏移 */
+    static long align8(long x) {return (x + 7) & ~7L;}
+    long    disp_offset() const {return sizeof(Header);}
+    long    used_offset() const {return align8(this->disp_offset() + (long)sizeof(uint) * this->m_r);}
+    long    slot_offset() const {return align8(this->used_offset() + (long)sizeof(uint64) * ((this->m_m + 63) >> 6));}
+    void    alloc(int n, int m, int r);
+    void    release();
+
+public:
+    HashFrozen() : m_n(0), m_m(0), m_r(0), m_disp(nullptr), m_used(nullptr), m_slot(nullptr), m_map(nullptr), m_maplen(0) {}
+    HashFrozen(HashFrozen&& fz);
+    HashFrozen& operator= (HashFrozen&& fz);
+    HashFrozen(const HashFrozen&) = delete;
+    HashFrozen& operator= (const HashFrozen&) = delete;
+    ~HashFrozen() {this->release();}
+
+    /** 获取键值对数量 */
+    int     size() const {return this->m_n;}
+    /** 获取单元数量 */
+    int     capacity() const {return this->m_m;}
+    /** 是否由mmap加载 */
+    bool    is_mapped() const {return this->m_map != nullptr;}
+    /** 估算占用的内存（字节） */
+    long    memory() const {return this->slot_offset() + (long)sizeof(Slot) * this->m_m;}
+    /** 是否存在key */
+    bool    contains(const K& key) const {return this->get(key) != nullptr;}
+
+    bool    build(const K*, const V*, int);
+    const V* get(const K&) const;
+    bool    save(const char*) const;
+    bool    load(const char*);
+};
+
+/*! @} */
+
+
+/** 分配数组 */
+template <typename K, typename V, typename HF, typename CMP>
+void HashFrozen<K,V,HF,CMP>::alloc(int n, int m, int r)
+{
+    this->release();
+    this->m_n = n;
+    this->m_m = m;
+    this->m_r = r;
+    this->m_disp = new uint[r];
+    this->m_used = new uint64[(m + 63) >> 6];
+    this->m_slot = new Slot[m];
+    std::memset(this->m_disp, 0, sizeof(uint) * r);
+    std::memset(this->m_used, 0, sizeof(uint64) * ((m + 63) >> 6));
+}
+
+/** 释放数组或解除映射 */
+template <typename K, typename V, typename HF, typename CMP>
+void HashFrozen<K,V,HF,CMP>::release()
+{
+    if (this->m_map)
+    {
+#if defined DSAS_LINUX
+        munmap(this->m_map, this->m_maplen);
+#endif
+    }
+    else
+    {
+        delete[] this->m_disp;
+        delete[] this->m_used;
+        delete[] this->m_slot;
+    }
+    this->m_n = this->m_m = this->m_r = 0;
+    this->m_disp = nullptr;
+    this->m_used = nullptr;
+    this->m_slot = nullptr;
+    this->m_map = nullptr;
+    this->m_maplen = 0;
+}
+
+template <typename K, typename V, typename HF, typename CMP>
+HashFrozen<K,V,HF,CMP>::HashFrozen(HashFrozen&& fz)
+    : m_n(fz.m_n), m_m(fz.m_m), m_r(fz.m_r), m_disp(fz.m_disp), m_used(fz.m_used), m_slot(fz.m_slot),
+      m_map(fz.m_map), m_maplen(fz.m_maplen)
+{
+    fz.m_disp = nullptr;
+    fz.m_used = nullptr;
+    fz.m_slot = nullptr;
+    fz.m_map = nullptr;
+    fz.release();
+}
+
+template <typename K, typename V, typename HF, typename CMP>
+HashFrozen<K,V,HF,CMP>& HashFrozen<K,V,HF,CMP>::operator= (HashFrozen&& fz)
+{
+    if (this != &fz)
+    {
+        this->release();
+        this->m_n = fz.m_n;
+        this->m_m = fz.m_m;
+        this->m_r = fz.m_r;
+        this->m_disp = fz.m_disp;
+        this->m_used = fz.m_used;
+        this->m_slot = fz.m_slot;
+        this->m_map = fz.m_map;
+        this->m_maplen = fz.m_maplen;
+        fz.m_disp = nullptr;
+        fz.m_used = nullptr;
+        fz.m_slot = nullptr;
+        fz.m_map = nullptr;
+        fz.release();
+    }
+    return *this;
+}
+
+/*!
+ * @brief 构建完美散列表
+ *
+ * <pre>
+ * 桶按大小降序处理：大桶需要同时为多个键找到空单元，应在单元较空时处理；
+ * 最后处理的单键桶，期望 m/(m-n) 次尝试即可找到空单元。
+ * </pre>
+ *
+ * @param keys,vals,n: 键数组，值数组，数组长度
+ * @return 若keys中有重复的键（或64位Hash值相同的键），则构建失败，返回false
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+bool HashFrozen<K,V,HF,CMP>::build(const K* keys, const V* vals, int n)
+{
+    int r = n / HASH_FROZEN_LAMBDA + 1;
+    int m = n + n / 16 + 1;
+    this->alloc(n, m, r);
+
+    // 按桶分组（计数排序）
+    uint64* h = new uint64[n];
+    int* start = new int[r + 1];
+    int* order = new int[n];
+    for (int k = 0; k <= r; k ++)
+        start[k] = 0;
+    for (int k = 0; k < n; k ++)
+    {
+        h[k] = this->hash_func(keys[k]);
+        start[this->bucket_of(h[k]) + 1] ++;
+    }
+    int maxb = 0;
+    for (int k = 0; k < r; k ++)
+    {
+        if (start[k + 1] > maxb)
+            maxb = start[k + 1];
+        start[k + 1] += start[k];
+    }
+    int* pos = new int[r];
+    for (int k = 0; k < r; k ++)
+        pos[k] = start[k];
+    for (int k = 0; k < n; k ++)
+        order[pos[this->bucket_of(h[k])] ++] = k;
+
+    // 按桶的大小降序排列桶（计数排序）
+    int* cnt = new int[maxb + 2];
+    int* bks = new int[r];
+    for (int k = 0; k <= maxb + 1; k ++)
+        cnt[k] = 0;
+    for (int b = 0; b < r; b ++)
+        cnt[maxb - (start[b + 1] - start[b]) + 1] ++;
+    for (int k = 0; k <= maxb; k ++)
+        cnt[k + 1] += cnt[k];
+    for (int b = 0; b < r; b ++)
+        bks[cnt[maxb - (start[b + 1] - start[b])] ++] = b;
+
+    // 桶内Hash值相同的键，无论位移值如何都会冲突
+    bool ok = true;
+    for (int b = 0; b < r && ok; b ++)
+        for (int i = start[b]; i < start[b + 1] && ok; i ++)
+            for (int j = i + 1; j < start[b + 1] && ok; j ++)
+                ok = h[order[i]] != h[order[j]];
+
+    // 逐个桶寻找位移值
+    delete[] pos;
+    pos = new int[maxb + 1];
+    for (int i = 0; i < r && ok; i ++)
+    {
+        int b = bks[i];
+        int lo = start[b], hi = start[b + 1];
+        if (lo == hi)
+            break;                              // 之后都是空桶
+        uint d = 0;
+        for (; d < HASH_FROZEN_MAX_D; d ++)
+        {
+            int k = lo;
+            for (; k < hi; k ++)
+            {
+                int p = this->slot_of(h[order[k]], d);
+                if (this->is_used(p))
+                    break;
+                pos[k - lo] = p;
+                this->set_used(p);              // 暂时占用，以检查桶内冲突
+            }
+            if (k == hi)
+                break;
+            for (int j = lo; j < k; j ++)       // 回退本次尝试
+                this->m_used[pos[j - lo] >> 6] &= ~(1ULL << (pos[j - lo] & 63));
+        }
+        if (d == HASH_FROZEN_MAX_D)
+            ok = false;
+        if (!ok)
+            break;
+        this->m_disp[b] = d;
+        for (int k = lo; k < hi; k ++)
+        {
+            this->m_slot[pos[k - lo]].key = keys[order[k]];
+            this->m_slot[pos[k - lo]].value = vals[order[k]];
+        }
+    }
+
+    delete[] bks;
+    delete[] cnt;
+    delete[] pos;
+    delete[] order;
+    delete[] start;
+    delete[] h;
+    if (!ok)
+        this->release();
+    return ok;
+}
+
+/*!
+ * @brief 根据键获取值
+ *
+ * @param key: 键
+ * @return 返回对应value的指针，或nullptr
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+const V* HashFrozen<K,V,HF,CMP>::get(const K& key) const
+{
+    if (this->m_n == 0)
+        return nullptr;
+    uint64 h = this->hash_func(key);
+    int p = this->slot_of(h, this->m_disp[this->bucket_of(h)]);
+    if (this->is_used(p) && this->equal(this->m_slot[p].key, key))
+        return &this->m_slot[p].value;
+    return nullptr;
+}
+
+/*!
+ * @brief 保存到文件
+ *
+ * 只支持可平凡复制的K,V；文件与机器的字节序、类型大小相关。
+ *
+ * @param file: 文件名
+ * @return 是否保存成功
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+bool HashFrozen<K,V,HF,CMP>::save(const char* file) const
+{
+    static_assert(std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value,
+                  "HashFrozen::save requires trivially copyable K and V");
+    std::FILE* fp = std::fopen(file, "wb");
+    if (!fp)
+        return false;
+    Header hd;
+    std::memcpy(hd.magic, "DSASHFZ1", 8);
+    hd.n = this->m_n;
+    hd.m = this->m_m;
+    hd.r = this->m_r;
+    hd.ksize = sizeof(K);
+    hd.vsize = sizeof(V);
+    hd.ssize = sizeof(Slot);
+    const char zero[8] = {0};
+    bool ok = std::fwrite(&hd, sizeof(Header), 1, fp) == 1;
+    ok = ok && std::fwrite(this->m_disp, sizeof(uint), this->m_r, fp) == (size_t)this->m_r;
+    long pad = this->used_offset() - this->disp_offset() - (long)sizeof(uint) * this->m_r;
+    ok = ok && std::fwrite(zero, 1, pad, fp) == (size_t)pad;
+    ok = ok && std::fwrite(this->m_used, sizeof(uint64), (this->m_m + 63) >> 6, fp) == (size_t)((this->m_m + 63) >> 6);
+    ok = ok && std::fwrite(this->m_slot, sizeof(Slot), this->m_m, fp) == (size_t)this->m_m;
+    std::fclose(fp);
+    return ok;
+}
+
+/*!
+ * @brief 从文件加载
+ *
+ * DSAS_LINUX下使用只读mmap直接映射文件，不复制数据；否则使用fread读入。
+ *
+ * @param file: 文件名
+ * @return 是否加载成功
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+bool HashFrozen<K,V,HF,CMP>::load(const char* file)
+{
+    static_assert(std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value,
+                  "HashFrozen::load requires trivially copyable K and V");
+    static_assert(alignof(Slot) <= 8, "HashFrozen: Slot alignment must not exceed 8");
+    this->release();
+    Header hd;
+#if defined DSAS_LINUX
+    int fd = open(file, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (long)sizeof(Header))
+    {
+        close(fd);
+        return false;
+    }
+    void* base = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return false;
+    std::memcpy(&hd, base, sizeof(Header));
+#else
+    std::FILE* fp = std::fopen(file, "rb");
+    if (!fp)
+        return false;
+    if (std::fread(&hd, sizeof(Header), 1, fp) != 1)
+    {
+        std::fclose(fp);
+        return false;
+    }
+#endif
+    bool ok = std::memcmp(hd.magic, "DSASHFZ1", 8) == 0
+           && hd.ksize == sizeof(K) && hd.vsize == sizeof(V) && hd.ssize == sizeof(Slot);
+    this->m_n = static_cast<int>(hd.n);
+    this->m_m = static_cast<int>(hd.m);
+    this->m_r = static_cast<int>(hd.r);
+    long len = this->slot_offset() + (long)sizeof(Slot) * this->m_m;
+#if defined DSAS_LINUX
+    ok = ok && len <= (long)st.st_size;
+    if (!ok)
+    {
+        munmap(base, st.st_size);
+        this->m_n = this->m_m = this->m_r = 0;
+        return false;
+    }
+    this->m_map = base;
+    this->m_maplen = st.st_size;
+    this->m_disp = reinterpret_cast<uint*>(static_cast<char*>(base) + this->disp_offset());
+    this->m_used = reinterpret_cast<uint64*>(static_cast<char*>(base) + this->used_offset());
+    this->m_slot = reinterpret_cast<Slot*>(static_cast<char*>(base) + this->slot_offset());
+#else
+    if (ok)
+    {
+        int n = this->m_n, m = this->m_m, r = this->m_r;
+        this->alloc(n, m, r);
+        std::fseek(fp, this->disp_offset(), SEEK_SET);
+        ok = std::fread(this->m_disp, sizeof(uint), r, fp) == (size_t)r;
+        std::fseek(fp, this->used_offset(), SEEK_SET);
+        ok = ok && std::fread(this->m_used, sizeof(uint64), (m + 63) >> 6, fp) == (size_t)((m + 63) >> 6);
+        std::fseek(fp, this->slot_offset(), SEEK_SET);
+        ok = ok && std::fread(this->m_slot, sizeof(Slot), m, fp) == (size_t)m;
+    }
+    std::fclose(fp);
+    if (!ok)
+        this->release();
+#endif
+    (void)len;
+    return ok;
+}
+
+/*!
+ * @brief 收集词条的访问函数
+ *
+ */
+template <typename K, typename V>
+struct FrozenCollector
+{
+    dsa::Vector<K> keys;
+    dsa::Vector<V> vals;
+    FrozenCollector(int n) : keys(n > 0 ? n : 1), vals(n > 0 ? n : 1) {}
+    template <typename P> void operator() (P& e) {this->keys.push_back(e.key); this->vals.push_back(e.value);}
+};
+
+/*!
+ * @brief 将HashTable冻结为只读的完美散列表
+ *
+ * @param ht: 散列表
+ * @param fz: 返回的完美散列表，其Hash由ht的HF决定（见Hash64Of）
+ * @return 构建失败（存在Hash值相同的键）时返回false，fz为空
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+bool freeze(HashTable<K,V,HF,CMP>& ht, HashFrozen<K,V,typename dsa::Hash64Of<K,HF>::type,CMP>& fz)
+{
+    FrozenCollector<K,V> c(ht.size());
+    ht.traverse(c);
+    return fz.build(&c.keys[0], &c.vals[0], c.keys.size());
+}
+
+/*!
+ * @brief 将HashTableList冻结为只读的完美散列表
+ *
+ * @param ht: 散列表
+ * @param fz: 返回的完美散列表，其Hash由ht的HF决定（见Hash64Of）
+ * @return 构建失败（存在Hash值相同的键）时返回false，fz为空
+ * @retval None
+ */
+template <typename K, typename V, typename HF, typename CMP>
+bool freeze(HashTableList<K,V,HF,CMP>& ht, HashFrozen<K,V,typename dsa::Hash64Of<K,HF>::type,CMP>& fz)
+{
+    FrozenCollector<K,V> c(ht.size());
+    ht.traverse(c);
+    return fz.build(&c.keys[0], &c.vals[0], c.keys.size());
+}
+
+} /* dsa */
+
+#endif /* ifndef DSAS_HASH_FROZEN_H */
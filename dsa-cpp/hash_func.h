@@ -13,7 +13,9 @@
 #ifndef DSAS_HASH_FUNC_H
 #define DSAS_HASH_FUNC_H
 
+#include "share/entry.h"
 #include "string.h"
+#include "array.h"
 
 namespace dsa
 {
@@ -26,77 +28,325 @@ namespace dsa
 
 /** 计算出的Hash值均为uint类型 */
 typedef unsigned int uint;
-
-/** Hash仿函数模板 */
-template <typename T> struct Hash;
+/** 64位Hash值 */
+typedef unsigned long long uint64;
 
 /*!
- * @name Hash函数实例化
+ * @name 64位Hash的基础函数
  * @{
  */
 
-/** 计算Hash<bool> */
-template <> struct Hash<bool>
-{ uint operator() (bool h) const {return static_cast<uint>(h);} };
+/*!
+ * @brief 64位整数混合函数（murmur3 fmix64）
+ *
+ * 输入的每一位都会影响输出的每一位（雪崩），连续或等间隔的整数也会被打散。
+ *
+ * @param x: 64位整数
+ * @return
+ * @retval None
+ */
+inline uint64 hash_mix64(uint64 x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
 
-/** 计算Hash<char> */
-template <> struct Hash<char>
-{ uint operator() (char h) const {return static_cast<uint>(h);} };
+/** 64x64->128位乘法，a,b分别返回低64位与高64位 */
+inline void hash_mum(uint64& a, uint64& b)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 r = a;
+    r *= b;
+    a = static_cast<uint64>(r);
+    b = static_cast<uint64>(r >> 64);
+#else
+    uint64 ha = a >> 32, hb = b >> 32, la = static_cast<unsigned int>(a), lb = static_cast<unsigned int>(b);
+    uint64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64 t = rl + (rm0 << 32);
+    uint64 c = t < rl;
+    uint64 lo = t + (rm1 << 32);
+    c += lo < t;
+    a = lo;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+/** 128位乘积的高低64位异或 */
+inline uint64 hash_wymix(uint64 a, uint64 b) {hash_mum(a, b); return a ^ b;}
 
-/** 计算Hash<unsigned char> */
-template <> struct Hash<unsigned char>
-{ uint operator() (unsigned char h) const {return static_cast<uint>(h);} };
+/** 按小端读取8字节（编译器会将其优化为一次读取） */
+inline uint64 hash_read64(const unsigned char* p)
+{
+    return  static_cast<uint64>(p[0])        | (static_cast<uint64>(p[1]) << 8)
+         | (static_cast<uint64>(p[2]) << 16) | (static_cast<uint64>(p[3]) << 24)
+         | (static_cast<uint64>(p[4]) << 32) | (static_cast<uint64>(p[5]) << 40)
+         | (static_cast<uint64>(p[6]) << 48) | (static_cast<uint64>(p[7]) << 56);
+}
+
+/** 按小端读取4字节 */
+inline uint64 hash_read32(const unsigned char* p)
+{
+    return  static_cast<uint64>(p[0])        | (static_cast<uint64>(p[1]) << 8)
+         | (static_cast<uint64>(p[2]) << 16) | (static_cast<uint64>(p[3]) << 24);
+}
 
-/** 计算Hash<char*> */
-template <> struct Hash<char*>
+/*!
+ * @brief 字节串的64位Hash（wyhash）
+ *
+ * <pre>
+ * 核心是 mix(a,b) = lo(a*b) ^ hi(a*b)，一次64x64->128位乘法即可充分混合16字节。
+ * (1) len <= 16: 读取首尾重叠的两个4或8字节，无循环；
+ * (2) len >  48: 三路并行，每步处理48字节，三路之间没有数据依赖；
+ * (3) 余下的数据每步处理16字节，最后16字节从尾部读取（可与前面重叠）。
+ * </pre>
+ *
+ * @param key,len: 字节串与长度
+ * @param seed: 种子
+ * @return
+ * @retval None
+ */
+inline uint64 hash_bytes64(const void* key, unsigned long len, uint64 seed = 0)
 {
-    uint operator() (char h[]) const
+    const uint64 s0 = 0xa0761d6478bd642fULL, s1 = 0xe7037ed1a0b428dbULL;
+    const uint64 s2 = 0x8ebc6af09c88c6e3ULL, s3 = 0x589965cc75374cc3ULL;
+    const unsigned char* p = static_cast<const unsigned char*>(key);
+    uint64 a, b;
+    seed ^= hash_wymix(seed ^ s0, s1);
+    if (len <= 16)
     {
-        int hc = 0;
-        const char* p = h;
-        while (*p != '\0')
+        if (len >= 4)
+        {
+            unsigned long d = (len >> 3) << 2;
+            a = (hash_read32(p) << 32) | hash_read32(p + d);
+            b = (hash_read32(p + len - 4) << 32) | hash_read32(p + len - 4 - d);
+        }
+        else if (len > 0)
+        {
+            a = (static_cast<uint64>(p[0]) << 16) | (static_cast<uint64>(p[len >> 1]) << 8) | p[len - 1];
+            b = 0;
+        }
+        else
+            a = b = 0;
+    }
+    else
+    {
+        unsigned long i = len;
+        if (i > 48)
+        {
+            uint64 see1 = seed, see2 = seed;
+            do
+            {
+                seed = hash_wymix(hash_read64(p)      ^ s1, hash_read64(p + 8)  ^ seed);
+                see1 = hash_wymix(hash_read64(p + 16) ^ s2, hash_read64(p + 24) ^ see1);
+                see2 = hash_wymix(hash_read64(p + 32) ^ s3, hash_read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16)
         {
-            hc = (hc << 5) | (hc >> 27);
-            hc += static_cast<int>(*p);         // 近似“多项式散列码”，参考秦九韶算法
-            p++;
+            seed = hash_wymix(hash_read64(p) ^ s1, hash_read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
         }
-        return static_cast<uint>(hc);
+        a = hash_read64(p + i - 16);
+        b = hash_read64(p + i - 8);
+    }
+    a ^= s1;
+    b ^= seed;
+    hash_mum(a, b);
+    return hash_wymix(a ^ s0 ^ len, b ^ s1);
+}
+
+/** 合并两个Hash值（用于数组、元组等复合类型） */
+inline uint64 hash_combine(uint64 seed, uint64 h)
+{
+    return hash_wymix(seed ^ 0xa0761d6478bd642fULL, h ^ 0xe7037ed1a0b428dbULL);
+}
+
+/*!
+ * @brief 将Hash值映射到[0, n)
+ *
+ * 用乘法与移位代替取模（Lemire的快速区间映射）：(h * n) >> 32。
+ * 只依赖h的高位，要求h的各位都已充分混合（Hash64/Hash均满足）；
+ * 与 h & (n-1) 一样，可以用于任意容量（不必是素数）的散列表。
+ *
+ * @param h: 32位Hash值
+ * @param n: 区间大小
+ * @return
+ * @retval None
+ */
+inline uint hash_range(uint h, uint n)
+{
+    return static_cast<uint>((static_cast<uint64>(h) * n) >> 32);
+}
+
+/*!
+ * @brief 将64位Hash值映射到[0, n)
+ *
+ * 取h的高32位做快速区间映射，低32位留给其它用途（如分片号）。
+ *
+ * @param h: 64位Hash值
+ * @param n: 区间大小
+ * @return
+ * @retval None
+ */
+inline uint hash_range64(uint64 h, uint n)
+{
+    return static_cast<uint>(((h >> 32) * n) >> 32);
+}
+
+/*! @} */
+
+
+/** 64位Hash仿函数模板 */
+template <typename T> struct Hash64;
+
+/*!
+ * @brief Hash仿函数模板
+ *
+ * 由Hash64<T>折叠为32位：高32位与低32位异或。
+ * 自定义类型只需特化Hash64（或直接特化Hash）。
+ *
+ */
+template <typename T> struct Hash
+{
+    uint operator() (const T& h) const
+    {
+        uint64 x = Hash64<T>()(h);
+        return static_cast<uint>(x ^ (x >> 32));
+    }
+};
+
+/*!
+ * @name Hash64函数实例化
+ * @{
+ */
+
+/** 整数Hash64，均使用fmix64混合 */
+#define DSAS_HASH64_INTEGER(T) \
+    template <> struct Hash64<T> \
+    { uint64 operator() (T h) const {return hash_mix64(static_cast<uint64>(h));} };
+
+DSAS_HASH64_INTEGER(bool)
+DSAS_HASH64_INTEGER(char)
+DSAS_HASH64_INTEGER(signed char)
+DSAS_HASH64_INTEGER(unsigned char)
+DSAS_HASH64_INTEGER(short)
+DSAS_HASH64_INTEGER(unsigned short)
+DSAS_HASH64_INTEGER(int)
+DSAS_HASH64_INTEGER(unsigned int)
+DSAS_HASH64_INTEGER(long)
+DSAS_HASH64_INTEGER(unsigned long)
+DSAS_HASH64_INTEGER(long long)
+DSAS_HASH64_INTEGER(unsigned long long)
+#undef DSAS_HASH64_INTEGER
+
+/** 计算Hash64<float>，+0.0与-0.0相等，故Hash值也相同 */
+template <> struct Hash64<float>
+{
+    uint64 operator() (float h) const
+    {
+        if (h == 0.0f)
+            return 0;
+        union {float f; unsigned int u;} v;
+        v.f = h;
+        return hash_mix64(v.u);
     }
 };
 
-/** 计算Hash<String> */
-template <> struct Hash<dsa::String>
+/** 计算Hash64<double>，+0.0与-0.0相等，故Hash值也相同 */
+template <> struct Hash64<double>
 {
-    uint operator() (const dsa::String& h) const
+    uint64 operator() (double h) const
     {
-        int hc = 0;
-        for (int k = 0; k < h.size(); k ++)
-        {
-            hc = (hc << 5) | (hc >> 27);
-            hc += static_cast<int>(h[k]);       // 近似“多项式散列码”，参考秦九韶算法
-        }
-        return static_cast<uint>(hc);
+        if (h == 0.0)
+            return 0;
+        union {double f; uint64 u;} v;
+        v.f = h;
+        return hash_mix64(v.u);
+    }
+};
+
+/** 计算Hash64<const char*> */
+template <> struct Hash64<const char*>
+{
+    uint64 operator() (const char* h) const
+    {
+        unsigned long len = 0;
+        while (h[len] != '\0')
+            len ++;
+        return hash_bytes64(h, len);
     }
 };
 
-/** 计算Hash<int> */
-template <> struct Hash<int>
-{ uint operator() (int h) const {return static_cast<uint>(h);} };
+/** 计算Hash64<char*> */
+template <> struct Hash64<char*>
+{ uint64 operator() (const char* h) const {return Hash64<const char*>()(h);} };
 
-/** 计算Hash<unsigned int> */
-template <> struct Hash<unsigned int>
-{ uint operator() (unsigned int h) const {return static_cast<uint>(h);} };
+/** 计算Hash64<String> */
+template <> struct Hash64<dsa::String>
+{ uint64 operator() (const dsa::String& h) const {return hash_bytes64(h.data(), h.size());} };
 
-/** 计算Hash<float> */
-template <> struct Hash<float>
-{ uint operator() (float h) const {return h != 0.0 ? (*(uint*)&h) : 0;} };
+/** 计算Hash64<Entry>，只由key决定 */
+template <typename K, typename V, typename CMP> struct Hash64<dsa::Entry<K,V,CMP>>
+{ uint64 operator() (const dsa::Entry<K,V,CMP>& h) const {return Hash64<K>()(h.key);} };
 
-/** 计算Hash<double> */
-template <> struct Hash<double>
-{ uint operator() (double h) const {return h != 0.0 ? (*(uint*)&h) : 0;} };
+/** 计算Hash64<Array>，逐个合并元素的Hash值 */
+template <typename T, int N> struct Hash64<dsa::Array<T,N>>
+{
+    uint64 operator() (const dsa::Array<T,N>& h) const
+    {
+        uint64 seed = static_cast<uint64>(h.max_size());
+        for (int k = 0; k < h.max_size(); k ++)
+            seed = hash_combine(seed, Hash64<T>()(h[k]));
+        return seed;
+    }
+};
 
 /*! @} */
 
+/*!
+ * @brief 由32位Hash函数得到64位Hash值
+ *
+ * 用于只提供了32位Hash（如自定义HF）的场合。
+ *
+ */
+template <typename HF>
+struct HashMix64
+{
+    HF hf;
+    template <typename K> uint64 operator() (const K& key) const {return dsa::hash_mix64(this->hf(key));}
+};
+
+/*!
+ * @brief HF对应的64位Hash类型
+ *
+ * <pre>
+ * 散列表以HF为模板参数，但定位单元需要64位Hash值（高位做区间映射）。
+ * HF为默认的dsa::Hash<K>时，直接使用其来源Hash64<K>，省去折叠；
+ * 自定义的HF经HashMix64扩展为64位：分布均匀，但不同键的Hash值只有2^32种，
+ * 键很多时可能出现相同的Hash值（HashFrozen此时build失败，freeze返回false）。
+ * </pre>
+ *
+ */
+template <typename K, typename HF>
+struct Hash64Of
+{
+    typedef HashMix64<HF> type;
+};
+
+template <typename K>
+struct Hash64Of<K, dsa::Hash<K> >
+{
+    typedef dsa::Hash64<K> type;
+};
+
 /*! @} */
 
 } /* dsa */
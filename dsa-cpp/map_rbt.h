@@ -36,6 +36,7 @@ class MapRBT : public dsa::Dict<K,V>
 public:
     using Pair = dsa::Entry<K,V,CMP>;
     using Iterator = typename dsa::BinTree<Pair>::Iterator;
+    using Range = typename dsa::BinSearchTree<Pair>::Range;
 
 private:
     RedBlackTree<Pair>  m_rb;
@@ -47,6 +48,24 @@ public:
     Iterator    begin() {return this->m_rb.begin();};
     /** 迭代结束 */
     Iterator    end() {return this->m_rb.end();}
+    /** 第一个键不小于key的位置 */
+    Iterator    lower_bound(K key) {return this->m_rb.lower_bound(Pair(key));}
+    /** 第一个键大于key的位置 */
+    Iterator    upper_bound(K key) {return this->m_rb.upper_bound(Pair(key));}
+    /** 键区间[lo, hi)扫描，reverse为true时由大到小 */
+    Range       range(K lo, K hi, bool reverse = false) {return this->m_rb.range(Pair(lo), Pair(hi), reverse);}
+#if BN_ORDER_STAT
+    /** 键第k小（从0开始）的键值对，k越界时返回nullptr */
+    Pair*       select(int k)
+    {
+        BinNodePtr<Pair> p = this->m_rb.select(k);
+        return p ? &(p->data) : nullptr;
+    }
+    /** 键小于key的键值对数量 */
+    int         rank(K key) const {return this->m_rb.rank(Pair(key));}
+    /** 键在[lo, hi)内的键值对数量 */
+    int         count_range(K lo, K hi) const {return this->m_rb.count_range(Pair(lo), Pair(hi));}
+#endif
     /** 遍历Map键值对 */
     template <typename VST> void traverse(VST& visit, dsa::TraverseType type = DLR)
     {
@@ -0,0 +1,294 @@
+
+//==============================================================================
+/*!
+ * @file map_skiplist.h
+ * @brief 基于跳表实现的并发有序Map结构
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_MAP_SKIPLIST_H
+#define DSAS_MAP_SKIPLIST_H
+
+#include <atomic>
+#include <new>
+#include "share/entry.h"
+#include "share/compare.h"
+#include "share/lock.h"
+#include "share/epoch.h"
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup TMap
+ *
+ * @{
+ */
+
+#define SKIPLIST_MAX_LEVEL  20      /**< 跳表最大层数（每层晋升概率1/4，可容纳约4^20个节点） */
+
+/*!
+ * @brief 基于跳表实现的并发有序Map（读多写少）
+ *
+ * <pre>
+ * level 2: head ------------------> 30 ---------------------> nullptr
+ * level 1: head -------> 10 ------> 30 ------> 50 ----------> nullptr
+ * level 0: head -> 5 -> 10 -> 20 -> 30 -> 40 -> 50 -> 60 ---> nullptr
+ *
+ * 读操作(get/range/traverse)无锁：只在EpochGuard临界区内沿原子指针(acquire)遍历；
+ * 写操作(put/remove)之间由一把自旋锁串行化，与读操作互不阻塞：
+ * (1) 插入：先设置新节点各层的next，再自底向上逐层发布(release)，读者看到新节点时，其next已就绪；
+ * (2) 删除：自顶向下逐层摘除，被摘除节点的next保持不变，正停留在该节点上的读者仍可继续前进；
+ *           摘除后通过EpochDomain退休，待所有可能访问它的读者离开后再释放；
+ * (3) 覆盖：值通过指针保存，put覆盖已有键时，原子替换值指针，旧值同样退休。
+ *
+ * 读者之间没有共享写（只写各自的epoch槽位），故读吞吐随核数线性增长。
+ * </pre>
+ *
+ */
+template <typename K, typename V, typename CMP = dsa::Less<K>>
+class MapSkipList : public dsa::Dict<K,V>
+{
+private:
+    /** 跳表节点，next数组按层数分配在节点尾部 */
+    struct Node
+    {
+        K                   key;
+        std::atomic<V*>     value;
+        int                 level;
+        std::atomic<Node*>  next[1];
+
+        Node(const K& k, V* v, int lv) : key(k), value(v), level(lv) {}
+    };
+
+    Node*               m_head;
+    std::atomic<int>    m_level;    /**< 当前最高层数 */
+    std::atomic<int>    m_size;
+    dsa::SpinLock       m_wlock;    /**< 写者锁 */
+    unsigned int        m_seed;     /**< 随机层数的种子，只在写锁内使用 */
+    CMP                 cmp;
+
+protected:
+    /** 创建节点 */
+    static Node* create(const K& key, V* value, int level)
+    {
+        void* mem = ::operator new(sizeof(Node) + (level - 1) * sizeof(std::atomic<Node*>));
+        Node* n = new (mem) Node(key, value, level);
+        for (int k = 0; k < level; k ++)
+            new (&n->next[k]) std::atomic<Node*>(nullptr);
+        return n;
+    }
+    /** 释放节点及其值 */
+    static void destroy(void* p)
+    {
+        Node* n = static_cast<Node*>(p);
+        delete n->value.load(std::memory_order_relaxed);
+        n->~Node();
+        ::operator delete(n);
+    }
+    /** 释放值 */
+    static void destroy_value(void* p) {delete static_cast<V*>(p);}
+
+    /** 随机层数：每层以1/4的概率晋升 */
+    int     random_level()
+    {
+        // xorshift32
+        this->m_seed ^= this->m_seed << 13;
+        this->m_seed ^= this->m_seed >> 17;
+        this->m_seed ^= this->m_seed << 5;
+        unsigned int r = this->m_seed;
+        int lv = 1;
+        while (lv < SKIPLIST_MAX_LEVEL && (r & 3) == 0)
+        {
+            lv ++;
+            r >>= 2;
+        }
+        return lv;
+    }
+
+    /*!
+     * @brief 查找第一个不小于key的节点
+     *
+     * @param key: 查找目标
+     * @param preds: 若不为nullptr，返回每层中最后一个小于key的节点（写者使用）
+     * @return 返回level 0上第一个不小于key的节点，没有则为nullptr
+     * @retval None
+     */
+    Node*   find_ge(const K& key, Node** preds) const
+    {
+        Node* x = this->m_head;
+        Node* nx = nullptr;
+        for (int i = this->m_level.load(std::memory_order_acquire) - 1; i >= 0; i --)
+        {
+            while ((nx = x->next[i].load(std::memory_order_acquire)) && this->cmp(nx->key, key))
+                x = nx;
+            if (preds)
+                preds[i] = x;
+        }
+        // 返回循环中读到的节点，不能再次读取x->next[0]（期间可能插入了小于key的节点）
+        return nx;
+    }
+
+    /** 节点的键是否等于key */
+    bool    equal(const Node* n, const K& key) const
+    {
+        return n && !this->cmp(key, n->key);   // n->key >= key 已由find_ge保证
+    }
+
+public:
+    MapSkipList() : m_level(1), m_size(0), m_seed(2463534242u)
+    {
+        this->m_head = create(K(), nullptr, SKIPLIST_MAX_LEVEL);
+    }
+    /** 析构时不能有并发的读写 */
+    ~MapSkipList()
+    {
+        Node* x = this->m_head->next[0].load(std::memory_order_relaxed);
+        while (x)
+        {
+            Node* nx = x->next[0].load(std::memory_order_relaxed);
+            destroy(x);
+            x = nx;
+        }
+        destroy(this->m_head);
+    }
+    MapSkipList(const MapSkipList&) = delete;
+    MapSkipList& operator= (const MapSkipList&) = delete;
+
+    /** 获取键值对数量 */
+    int     size() const {return this->m_size.load(std::memory_order_relaxed);}
+
+    /*!
+     * @brief 插入键值对（若键存在，则覆盖value）
+     *
+     * @param key: 键
+     * @param val: 值
+     * @return
+     * @retval None
+     */
+    bool    put(K key, V val)
+    {
+        dsa::LockGuard<dsa::SpinLock> g(this->m_wlock);
+        Node* preds[SKIPLIST_MAX_LEVEL];
+        Node* x = this->find_ge(key, preds);
+        if (this->equal(x, key))
+        {
+            V* old = x->value.exchange(new V(val), std::memory_order_acq_rel);
+            dsa::EpochDomain::instance().retire(old, destroy_value);
+            return true;
+        }
+
+        int lv = this->random_level();
+        int cur = this->m_level.load(std::memory_order_relaxed);
+        for (int i = cur; i < lv; i ++)
+            preds[i] = this->m_head;
+        Node* n = create(key, new V(val), lv);
+        for (int i = 0; i < lv; i ++)
+            n->next[i].store(preds[i]->next[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        // 自底向上发布
+        for (int i = 0; i < lv; i ++)
+            preds[i]->next[i].store(n, std::memory_order_release);
+        if (lv > cur)
+            this->m_level.store(lv, std::memory_order_release);
+        this->m_size.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /*!
+     * @brief 删除键值对
+     *
+     * @param key: 键
+     * @return 键不存在时返回false
+     * @retval None
+     */
+    bool    remove(K key)
+    {
+        dsa::LockGuard<dsa::SpinLock> g(this->m_wlock);
+        Node* preds[SKIPLIST_MAX_LEVEL];
+        Node* x = this->find_ge(key, preds);
+        if (!this->equal(x, key))
+            return false;
+        // 自顶向下摘除，x的next保持不变
+        for (int i = x->level - 1; i >= 0; i --)
+            preds[i]->next[i].store(x->next[i].load(std::memory_order_relaxed), std::memory_order_release);
+        this->m_size.fetch_sub(1, std::memory_order_relaxed);
+        dsa::EpochDomain::instance().retire(x, destroy);
+        return true;
+    }
+
+    /*!
+     * @brief 获取值的指针
+     *
+     * 返回的指针只在调用者持有EpochGuard期间有效（之后可能因覆盖或删除而被释放），
+     * 且通过指针修改值时，不能与其它线程的读写并发；并发场景请使用get(key, val)。
+     *
+     * @param key: 键
+     * @return 键不存在时返回nullptr
+     * @retval None
+     */
+    V*      get(K key)
+    {
+        dsa::EpochGuard eg;
+        Node* x = this->find_ge(key, nullptr);
+        return this->equal(x, key) ? x->value.load(std::memory_order_acquire) : nullptr;
+    }
+
+    /*!
+     * @brief 获取值的拷贝，可与写操作并发
+     *
+     * @param key: 键
+     * @param val: 返回值
+     * @return 键不存在时返回false
+     * @retval None
+     */
+    bool    get(const K& key, V& val) const
+    {
+        dsa::EpochGuard eg;
+        Node* x = this->find_ge(key, nullptr);
+        if (!this->equal(x, key))
+            return false;
+        val = *x->value.load(std::memory_order_acquire);
+        return true;
+    }
+
+    /*!
+     * @brief 按键的顺序，访问键在[lo, hi)内的键值对，可与写操作并发
+     *
+     * 遍历期间插入或删除的键，可能被访问到，也可能没有。
+     *
+     * @param lo,hi: 键区间[lo, hi)
+     * @param visit: 访问函数，visit(const K&, const V&)
+     * @return 返回访问的键值对数量
+     * @retval None
+     */
+    template <typename VST>
+    int     range(const K& lo, const K& hi, VST& visit) const
+    {
+        dsa::EpochGuard eg;
+        int n = 0;
+        for (Node* x = this->find_ge(lo, nullptr); x && this->cmp(x->key, hi);
+             x = x->next[0].load(std::memory_order_acquire), n ++)
+            visit(x->key, *x->value.load(std::memory_order_acquire));
+        return n;
+    }
+
+    /** 按键的顺序访问所有键值对，visit(const K&, const V&) */
+    template <typename VST>
+    void    traverse(VST& visit) const
+    {
+        dsa::EpochGuard eg;
+        for (Node* x = this->m_head->next[0].load(std::memory_order_acquire); x;
+             x = x->next[0].load(std::memory_order_acquire))
+            visit(x->key, *x->value.load(std::memory_order_acquire));
+    }
+};
+
+/*! @} */
+
+} /* dsa */
+#endif /* ifndef DSAS_MAP_SKIPLIST_H */
@@ -0,0 +1,476 @@
+
+//==============================================================================
+/*!
+ * @file persistent_tree.h
+ * @brief 持久化（路径复制）平衡二叉搜索树
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_PERSISTENT_TREE_H
+#define DSAS_PERSISTENT_TREE_H
+
+#include <atomic>
+#include "binary_node.h"
+#include "share/compare.h"
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup TBinarySearchTree
+ * @{
+ */
+
+/*!
+ * @brief 持久化树节点
+ *
+ * 节点可被多个版本共享，故没有parent指针；ref为指向该节点的指针数量（父节点或树根）。
+ */
+template <typename T>
+struct PNode
+{
+    T                   data;
+    PNode<T>*           left;
+    PNode<T>*           right;
+    std::atomic<int>    ref;
+    int                 height;
+    RBColor             color;
+
+    PNode(const T& e, PNode<T>* ll = nullptr, PNode<T>* rr = nullptr, int h = 0, RBColor c = RBColor::Red)
+        : data(e), left(ll), right(rr), ref(1), height(h), color(c) {}
+};
+
+/*!
+ * @brief 持久化二叉搜索树的基类
+ *
+ * <pre>
+ * 每个树对象即是一个版本，拷贝（快照）只需增加根节点的引用计数，O(1)；
+ * 修改节点前先通过own()取得独占：
+ *   ref == 1：节点只属于当前版本，直接原地修改；
+ *   ref >  1：节点与其它版本共享，复制一个新节点（子节点引用计数加1），原节点引用计数减1；
+ * 从树根向下修改时，每一层都先own()，故insert/remove只复制查找路径上的O(log(n))个节点，
+ * 其余子树在各版本间共享；没有快照时，不会发生任何复制。
+ * 节点的引用计数减为0时释放，并递归减少子节点的引用计数。
+ *
+ * 引用计数为原子变量：快照可以交给其它线程只读访问（或继续修改），与原版本的修改并发；
+ * 同一个树对象的修改与拷贝需要由调用者串行化。
+ * </pre>
+ */
+template <typename T>
+class PersistentTree
+{
+protected:
+    using Node = PNode<T>;
+
+    Node*   m_root;
+    int     m_size;
+
+    /** 增加引用 */
+    static Node* retain(Node* n)
+    {
+        if (n)
+            n->ref.fetch_add(1, std::memory_order_relaxed);
+        return n;
+    }
+    /** 减少引用，减为0时释放节点 */
+    static void release(Node* n)
+    {
+        while (n && n->ref.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            Node* r = n->right;
+            release(n->left);
+            delete n;
+            n = r;          // 右子树迭代处理，减少递归深度
+        }
+    }
+    /*!
+     * @brief 取得节点的独占
+     *
+     * @param n: 由当前版本独占的父节点（或树根）所指向的节点
+     * @return 返回可以原地修改的节点，调用者需要用它替换父节点中的指针
+     * @retval None
+     */
+    static Node* own(Node* n)
+    {
+        if (!n || n->ref.load(std::memory_order_acquire) == 1)
+            return n;
+        Node* c = new Node(n->data, retain(n->left), retain(n->right), n->height, n->color);
+        release(n);
+        return c;
+    }
+
+    template <typename VST>
+    static void traverse_at(const Node* n, VST& visit)
+    {
+        while (n)
+        {
+            traverse_at(n->left, visit);
+            visit(n->data);
+            n = n->right;
+        }
+    }
+
+public:
+    PersistentTree() : m_root(nullptr), m_size(0) {}
+    /** 快照，O(1) */
+    PersistentTree(const PersistentTree<T>& t) : m_root(retain(t.m_root)), m_size(t.m_size) {}
+    PersistentTree<T>& operator= (const PersistentTree<T>& t)
+    {
+        Node* r = retain(t.m_root);
+        release(this->m_root);
+        this->m_root = r;
+        this->m_size = t.m_size;
+        return *this;
+    }
+    ~PersistentTree() {release(this->m_root);}
+
+    int     size() const {return this->m_size;}
+    bool    is_empty() const {return !this->m_root;}
+    /** 返回根节点（只读） */
+    const Node* root() const {return this->m_root;}
+
+    /*!
+     * @brief 查找
+     *
+     * @param e: 查找目标
+     * @return 返回指向元素的指针，不存在时返回nullptr
+     * @retval None
+     */
+    const T* search(const T& e) const
+    {
+        const Node* n = this->m_root;
+        while (n)
+        {
+            if (dsa::less_than(e, n->data))
+                n = n->left;
+            else if (dsa::less_than(n->data, e))
+                n = n->right;
+            else
+                return &n->data;
+        }
+        return nullptr;
+    }
+
+    /** 中序遍历 */
+    template <typename VST>
+    void    traverse(VST& visit) const {traverse_at(this->m_root, visit);}
+};
+
+/*!
+ * @brief 持久化AVL树
+ *
+ * 与AvlTree相同的平衡条件，使用递归实现（没有parent指针），返回调整后的子树根节点。
+ */
+template <typename T>
+class PersistentAvl : public PersistentTree<T>
+{
+protected:
+    using Node = PNode<T>;
+
+    static int  stature(const Node* n) {return n ? n->height : -1;}
+    static void update_height(Node* n)
+    {
+        int a = stature(n->left), b = stature(n->right);
+        n->height = 1 + (a > b ? a : b);
+    }
+    /** 右旋，n已独占 */
+    static Node* rotate_right(Node* n)
+    {
+        Node* l = n->left = PersistentTree<T>::own(n->left);
+        n->left = l->right;
+        l->right = n;
+        update_height(n);
+        update_height(l);
+        return l;
+    }
+    /** 左旋，n已独占 */
+    static Node* rotate_left(Node* n)
+    {
+        Node* r = n->right = PersistentTree<T>::own(n->right);
+        n->right = r->left;
+        r->left = n;
+        update_height(n);
+        update_height(r);
+        return r;
+    }
+    /** 恢复n处的平衡，n已独占 */
+    static Node* balance(Node* n)
+    {
+        update_height(n);
+        int bf = stature(n->left) - stature(n->right);
+        if (bf > 1)
+        {
+            if (stature(n->left->left) < stature(n->left->right))
+                n->left = rotate_left(PersistentTree<T>::own(n->left));
+            return rotate_right(n);
+        }
+        if (bf < -1)
+        {
+            if (stature(n->right->right) < stature(n->right->left))
+                n->right = rotate_right(PersistentTree<T>::own(n->right));
+            return rotate_left(n);
+        }
+        return n;
+    }
+
+    static Node* insert_at(Node* n, const T& e)
+    {
+        if (!n)
+            return new Node(e);
+        n = PersistentTree<T>::own(n);
+        if (dsa::less_than(e, n->data))
+            n->left = insert_at(n->left, e);
+        else
+            n->right = insert_at(n->right, e);
+        return balance(n);
+    }
+    /** 删除e（e一定存在） */
+    static Node* remove_at(Node* n, const T& e)
+    {
+        n = PersistentTree<T>::own(n);
+        if (dsa::less_than(e, n->data))
+            n->left = remove_at(n->left, e);
+        else if (dsa::less_than(n->data, e))
+            n->right = remove_at(n->right, e);
+        else
+        {
+            if (!n->left || !n->right)
+            {
+                Node* c = PersistentTree<T>::retain(n->left ? n->left : n->right);
+                PersistentTree<T>::release(n);
+                return c;
+            }
+            // 用直接后继替换，再在右子树中删除直接后继
+            const Node* s = n->right;
+            while (s->left) s = s->left;
+            n->data = s->data;
+            n->right = remove_at(n->right, n->data);
+        }
+        return balance(n);
+    }
+
+public:
+    /*!
+     * @brief 插入，只复制查找路径上被共享的节点
+     *
+     * @param e: 插入目标
+     * @return 已存在时返回false
+     * @retval None
+     */
+    bool    insert(const T& e)
+    {
+        if (this->search(e))
+            return false;
+        this->m_root = insert_at(this->m_root, e);
+        this->m_size ++;
+        return true;
+    }
+    /*!
+     * @brief 删除，只复制查找路径上被共享的节点
+     *
+     * @param e: 删除目标
+     * @return 不存在时返回false
+     * @retval None
+     */
+    bool    remove(const T& e)
+    {
+        if (!this->search(e))
+            return false;
+        this->m_root = remove_at(this->m_root, e);
+        this->m_size --;
+        return true;
+    }
+};
+
+/*!
+ * @brief 持久化红黑树（左倾红黑树，LLRB）
+ *
+ * <pre>
+ * 左倾红黑树与2-3树一一对应，红节点只能作为左子节点，插入与删除均可用自顶向下的递归实现，
+ * 修改只发生在递归路径（及其兄弟节点的颜色）上，适合路径复制：
+ * 插入：递归到底插入红节点，回溯时依次修正：右红则左旋，连续左红则右旋，左右均红则颜色翻转；
+ * 删除：下行时通过move_red_left/move_red_right保证当前节点或其子节点为红（不会删除2-节点），
+ *       回溯时用与插入相同的修正恢复左倾。
+ * </pre>
+ */
+template <typename T>
+class PersistentRBTree : public PersistentTree<T>
+{
+protected:
+    using Node = PNode<T>;
+
+    static bool is_red(const Node* n) {return n && n->color == RBColor::Red;}
+    static void toggle(Node* n) {n->color = (n->color == RBColor::Red) ? RBColor::Black : RBColor::Red;}
+
+    /** 左旋，h已独占 */
+    static Node* rotate_left(Node* h)
+    {
+        Node* x = PersistentTree<T>::own(h->right);
+        h->right = x->left;
+        x->left = h;
+        x->color = h->color;
+        h->color = RBColor::Red;
+        return x;
+    }
+    /** 右旋，h已独占 */
+    static Node* rotate_right(Node* h)
+    {
+        Node* x = PersistentTree<T>::own(h->left);
+        h->left = x->right;
+        x->right = h;
+        x->color = h->color;
+        h->color = RBColor::Red;
+        return x;
+    }
+    /** 颜色翻转，h已独占，子节点也需要独占 */
+    static void flip(Node* h)
+    {
+        toggle(h);
+        h->left = PersistentTree<T>::own(h->left);
+        toggle(h->left);
+        h->right = PersistentTree<T>::own(h->right);
+        toggle(h->right);
+    }
+    /** 回溯时恢复左倾 */
+    static Node* fix_up(Node* h)
+    {
+        if (is_red(h->right) && !is_red(h->left))
+            h = rotate_left(h);
+        if (is_red(h->left) && is_red(h->left->left))
+            h = rotate_right(h);
+        if (is_red(h->left) && is_red(h->right))
+            flip(h);
+        return h;
+    }
+    /** h为红，h->left与h->left->left为黑时，使h->left或其左子节点变红 */
+    static Node* move_red_left(Node* h)
+    {
+        flip(h);
+        if (is_red(h->right->left))
+        {
+            h->right = rotate_right(h->right);
+            h = rotate_left(h);
+            flip(h);
+        }
+        return h;
+    }
+    /** h为红，h->right与h->right->left为黑时，使h->right或其子节点变红 */
+    static Node* move_red_right(Node* h)
+    {
+        flip(h);
+        if (is_red(h->left->left))
+        {
+            h = rotate_right(h);
+            flip(h);
+        }
+        return h;
+    }
+
+    static Node* insert_at(Node* h, const T& e)
+    {
+        if (!h)
+            return new Node(e, nullptr, nullptr, 0, RBColor::Red);
+        h = PersistentTree<T>::own(h);
+        if (dsa::less_than(e, h->data))
+            h->left = insert_at(h->left, e);
+        else
+            h->right = insert_at(h->right, e);
+        return fix_up(h);
+    }
+    static Node* remove_min(Node* h)
+    {
+        h = PersistentTree<T>::own(h);
+        if (!h->left)
+        {
+            PersistentTree<T>::release(h);  // 左倾：没有左子节点，则也没有右子节点
+            return nullptr;
+        }
+        if (!is_red(h->left) && !is_red(h->left->left))
+            h = move_red_left(h);
+        h->left = remove_min(h->left);
+        return fix_up(h);
+    }
+    /** 删除e（e一定存在） */
+    static Node* remove_at(Node* h, const T& e)
+    {
+        h = PersistentTree<T>::own(h);
+        if (dsa::less_than(e, h->data))
+        {
+            if (!is_red(h->left) && !is_red(h->left->left))
+                h = move_red_left(h);
+            h->left = remove_at(h->left, e);
+        }
+        else
+        {
+            if (is_red(h->left))
+                h = rotate_right(h);
+            if (!dsa::less_than(h->data, e) && !h->right)
+            {
+                PersistentTree<T>::release(h);
+                return nullptr;
+            }
+            if (!is_red(h->right) && !is_red(h->right->left))
+                h = move_red_right(h);
+            if (!dsa::less_than(h->data, e))
+            {
+                // 用直接后继替换，再在右子树中删除最小节点
+                const Node* s = h->right;
+                while (s->left) s = s->left;
+                h->data = s->data;
+                h->right = remove_min(h->right);
+            }
+            else
+                h->right = remove_at(h->right, e);
+        }
+        return fix_up(h);
+    }
+
+public:
+    /*!
+     * @brief 插入，只复制查找路径上被共享的节点
+     *
+     * @param e: 插入目标
+     * @return 已存在时返回false
+     * @retval None
+     */
+    bool    insert(const T& e)
+    {
+        if (this->search(e))
+            return false;
+        this->m_root = insert_at(this->m_root, e);
+        this->m_root->color = RBColor::Black;
+        this->m_size ++;
+        return true;
+    }
+    /*!
+     * @brief 删除，只复制查找路径上被共享的节点
+     *
+     * @param e: 删除目标
+     * @return 不存在时返回false
+     * @retval None
+     */
+    bool    remove(const T& e)
+    {
+        if (!this->search(e))
+            return false;
+        this->m_root = PersistentTree<T>::own(this->m_root);
+        if (!is_red(this->m_root->left) && !is_red(this->m_root->right))
+            this->m_root->color = RBColor::Red;
+        this->m_root = remove_at(this->m_root, e);
+        if (this->m_root)
+            this->m_root->color = RBColor::Black;
+        this->m_size --;
+        return true;
+    }
+};
+
+/*! @} */
+
+} /* dsa */
+
+#endif /* ifndef DSAS_PERSISTENT_TREE_H */
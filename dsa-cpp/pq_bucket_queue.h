@@ -0,0 +1,197 @@
+
+//==============================================================================
+/*!
+ * @file pq_bucket_queue.h
+ * @brief 桶队列模版类（Dial算法，小范围整数优先级）
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_PQ_BUCKET_QUEUE_H
+#define DSAS_PQ_BUCKET_QUEUE_H
+
+#include "vector.h"
+#include "priority_queue.h"
+#include "share/entry.h"
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup LPQ
+ *
+ * @{
+ */
+
+#define PQ_BUCKET_RANGE     64      /**< 桶队列的默认key跨度 */
+
+/*!
+ * @brief 桶队列模板类
+ *
+ * <pre>
+ * 元素为词条(key, value)，key为非负整数，key越小优先级越高（get_max/del_max取最小的key）。
+ * 队列中的key须落在[cur, cur + C)内，cur为游标（不超过最小的key）。
+ * Dijkstra中，队列中的距离都不超过 当前距离 + 最大边权，故C取最大边权+1即可。
+ *
+ * 以C个桶组成的环（C为2的幂），key放在桶 key & (C-1) 中，同一个桶中的key都相同：
+ *
+ *   游标 = 13, C = 8
+ *   桶:   0    1    2    3    4    5    6    7
+ *        [16] [17] [  ] [  ] [  ] [13] [14] [  ]
+ *                                   ^ 游标
+ *
+ * del_max从游标处向前找第一个非空的桶；key单调时（如Dijkstra）游标只前进不后退，
+ * 总代价为O(元素数量 + 最大key)，适用于边权为小整数的图（如路网按秒计的通行时间）。
+ * 插入小于游标的key时游标后退；key的跨度超过C时，环扩大并重新分配。
+ * </pre>
+ *
+ */
+template <typename V = int>
+class PqBucketQueue : public dsa::PQ<dsa::Entry<int,V>>
+{
+public:
+    using E = dsa::Entry<int,V>;
+
+protected:
+    dsa::Vector<E>* m_bucket;
+    int             m_num;      /**< 桶的数量，为2的幂 */
+    int             m_cur;      /**< 游标：不超过最小的key */
+    int             m_top;      /**< 不小于最大的key */
+    int             m_size;
+
+    void    grow(int span);
+    void    seek();
+
+public:
+    PqBucketQueue(int range = PQ_BUCKET_RANGE);
+    ~PqBucketQueue() {delete[] this->m_bucket;}
+    PqBucketQueue(const PqBucketQueue&) = delete;
+    PqBucketQueue& operator= (const PqBucketQueue&) = delete;
+
+    int     size() const {return this->m_size;}
+    bool    is_empty() const {return this->m_size == 0;}
+    void    clear();
+
+    void    push(int key, const V& value);
+    /** 插入词条（PQ接口） */
+    void    insert(const E& e) {this->push(e.key, e.value);}
+    /** key最小的词条 */
+    E       get_max()
+    {
+        this->seek();
+        dsa::Vector<E>& b = this->m_bucket[this->m_cur & (this->m_num - 1)];
+        return b[b.size() - 1];
+    }
+    E       del_max();
+};
+
+/*! @} */
+
+
+/*!
+ * @brief 创建桶队列
+ *
+ * @param range: key的跨度（最大key - 最小key + 1），向上取为2的幂，不足时自动扩大
+ * @return
+ * @retval None
+ */
+template <typename V>
+PqBucketQueue<V>::PqBucketQueue(int range) : m_cur(0), m_top(0), m_size(0)
+{
+    this->m_num = 2;
+    while (this->m_num < range)
+        this->m_num <<= 1;
+    this->m_bucket = new dsa::Vector<E>[this->m_num];
+}
+
+/*!
+ * @brief 扩大环，使其至少容纳span个不同的key
+ *
+ * @param span: 需要的跨度
+ * @return
+ * @retval None
+ */
+template <typename V>
+void PqBucketQueue<V>::grow(int span)
+{
+    int n = this->m_num;
+    while (n < span)
+        n <<= 1;
+    dsa::Vector<E>* nb = new dsa::Vector<E>[n];
+    for (int k = 0; k < this->m_num; k ++)
+    {
+        dsa::Vector<E>& b = this->m_bucket[k];
+        for (int j = 0; j < b.size(); j ++)
+            nb[b[j].key & (n - 1)].push_back(b[j]);
+    }
+    delete[] this->m_bucket;
+    this->m_bucket = nb;
+    this->m_num = n;
+}
+
+/** 游标前进到第一个非空的桶，队列须非空 */
+template <typename V>
+void PqBucketQueue<V>::seek()
+{
+    while (this->m_bucket[this->m_cur & (this->m_num - 1)].is_empty())
+        this->m_cur ++;
+}
+
+/** 清空 */
+template <typename V>
+void PqBucketQueue<V>::clear()
+{
+    for (int k = 0; k < this->m_num; k ++)
+        this->m_bucket[k].clear();
+    this->m_size = 0;
+}
+
+/*!
+ * @brief 插入词条
+ *
+ * @param key: 关键码，非负
+ * @param value: 值
+ * @return
+ * @retval None
+ */
+template <typename V>
+void PqBucketQueue<V>::push(int key, const V& value)
+{
+    if (this->m_size == 0)
+        this->m_cur = this->m_top = key;    // 空队列时游标直接跳到key，避免逐桶前进
+    else
+    {
+        if (key < this->m_cur)
+            this->m_cur = key;
+        if (key > this->m_top)
+            this->m_top = key;
+        if (this->m_top - this->m_cur >= this->m_num)
+            this->grow(this->m_top - this->m_cur + 1);
+    }
+    this->m_bucket[key & (this->m_num - 1)].push_back(E(key, value));
+    this->m_size ++;
+}
+
+/*!
+ * @brief 删除key最小的词条
+ *
+ * @param None
+ * @return 返回删除的词条，队列须非空
+ * @retval None
+ */
+template <typename V>
+typename PqBucketQueue<V>::E PqBucketQueue<V>::del_max()
+{
+    this->seek();
+    dsa::Vector<E>& b = this->m_bucket[this->m_cur & (this->m_num - 1)];
+    this->m_size --;
+    return b.remove(b.size() - 1);
+}
+
+} /* dsa */
+
+#endif /* ifndef DSAS_PQ_BUCKET_QUEUE_H */
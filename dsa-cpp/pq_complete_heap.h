@@ -14,9 +14,11 @@
 #ifndef DSAS_PQ_COMPLETE_HEAP_H
 #define DSAS_PQ_COMPLETE_HEAP_H
 
+#include <cstddef>
 #include "vector.h"
 #include "priority_queue.h"
 #include "share/swap.h"
+#include "share/macro.h"
 
 namespace dsa
 {
@@ -41,6 +43,8 @@ namespace dsa
 #define PQ_RightChildValid(n, i)    PQ_InHeap(n, PQ_RightChild(i)) /**< 判断i是否有两个孩子，对于完全二叉堆，有右孩子，必有左孩子*/
 /*! @} */
 
+#define PQ_HEAPIFY_BLOCK    (256 * 1024)    /**< 分块建堆时子树的字节数上限（约为L2缓存的大小） */
+
 
 /*!
  * @brief 完全二叉堆模板类
@@ -91,45 +95,15 @@ public:
     /** 第一个元素，即是优先级最高的元素，时间复杂度O(1) */
     T       get_max() {return this->m_array[0];};
     T       del_max();
-
-private:
-    int proper_parent(int n, int i);
 };
 
+template <typename T> int  heap_sift_down(T* A, int n, int i);
+template <typename T> void heap_build(T* A, int n);
 template <typename T> void heap_sort(dsa::Vector<T>& vec, int lo, int hi);
 
 /*! @} */
 
 
-/*!
- * @brief 获取父子三者的最大者
- *
- * 获取父节点与其子节点间的最大者
- *
- * @param n: 二叉堆元素数量
- * @param i: 父节点下标
- * @return 返回最大者的下标
- * @retval None
- */
-template <typename T>
-int PqComplHeap<T>::proper_parent(int n, int i)
-{
-#define PQ_Bigger(i, j)     (((this->m_array[i]) >= (this->m_array[j])) ? (i) : (j))
-    if (PQ_RightChildValid(n, i))
-    {
-        // i的左右孩子均存在
-        return PQ_Bigger(i, PQ_Bigger(PQ_LeftChild(i), PQ_RightChild(i)) );
-    }
-    else if(PQ_LeftChildValid(n, i))
-    {
-        // 只有i的左孩子存在
-        return PQ_Bigger(i, PQ_LeftChild(i));
-    }
-    else
-        return i;
-#undef PQ_Bigger
-}
-
 /*!
  * @brief 上滤
  *
@@ -158,24 +132,17 @@ int PqComplHeap<T>::percolate_up(int i)
 /*!
  * @brief 下滤
  *
- * 对前n个元素的第i个元素进行下滤
+ * 对前n个元素的第i个元素进行下滤，见heap_sift_down
  *
  * @param n: 元素数量
  * @param i: 进行下滤的元素下标
- * @return
+ * @return 返回元素的最终下标
  * @retval None
  */
 template <typename T>
 int PqComplHeap<T>::percolate_down(int n, int i)
 {
-    int j;
-    while(i!= (j = this->proper_parent(n, i)))
-    {
-        // i的子节点元比i大，则下滤
-        dsa::swap(this->m_array[i], this->m_array[j]);
-        i = j;
-    }
-    return i;
+    return dsa::heap_sift_down(this->m_array, n, i);
 }
 
 /*!
@@ -252,16 +219,119 @@ void PqComplHeap<T>::heapify(int n)
     // 效率较高： 对所有节点的高度求和
     // 越往堆底，高度越小（下滤的距离越小），节点数越多
     // Sum[height(i)] = O(n)
-    for(int k = PQ_Parent(n-1); k >= 0; k--)
+    // 按子树分块处理，见heap_build
+    dsa::heap_build(this->m_array, n);
+#endif
+
+}
+
+/*!
+ * @brief 自底向上的下滤（Floyd）
+ *
+ * <pre>
+ * 经典下滤每层比较两次（两个孩子之间、较大孩子与下滤元素之间），
+ * 而下滤的元素（如del_max中从末尾移到堆顶的元素）通常很小，最终会落到接近堆底的位置。
+ * Floyd的做法：
+ * (1) 不与下滤元素比较，沿较大的孩子一直下降到叶节点，沿途将孩子上移，每层只比较一次；
+ * (2) 再将下滤元素从该叶节点位置上滤，通常只需一两次比较。
+ * 总比较次数约为log(n)+O(1)，经典下滤约为2log(n)。
+ * 较大孩子的选择 c += (A[c] < A[c+1]) 不含分支，避免随机数据下的分支预测失败。
+ * 但无分支时下一层的地址依赖本层比较的结果，堆超出缓存后每层都要等待一次访存；
+ * 故预取j往下第4层的后代：它们在数组中连续（16个），下降路径必经其中之一。
+ * </pre>
+ *
+ * @param A: 堆数组（最大堆）
+ * @param n: 元素数量
+ * @param i: 进行下滤的元素下标
+ * @return 返回元素的最终下标
+ * @retval None
+ */
+template <typename T>
+int heap_sift_down(T* A, int n, int i)
+{
+    T e = A[i];
+    int j = i;
+    int c = PQ_LeftChild(j);
+    while (c + 1 < n)
     {
-        this->percolate_down(n, k);
+        std::size_t d = ((std::size_t)j + 1) * 16 - 1;
+        if (d < (std::size_t)n)
+            DSAS_PREFETCH(&A[d]);
+        c += (A[c] < A[c+1]);               // 选较大的孩子（左右相等时取左孩子）
+        A[j] = A[c];
+        j = c;
+        c = PQ_LeftChild(j);
     }
-#endif
+    if (c < n)                              // 最后一个内部节点只有左孩子
+    {
+        A[j] = A[c];
+        j = c;
+    }
+    while (j > i)
+    {
+        int p = PQ_Parent(j);
+        if (!(A[p] < e))
+            break;
+        A[j] = A[p];
+        j = p;
+    }
+    A[j] = e;
+    return j;
+}
 
+/*!
+ * @brief 分块自底向上建堆
+ *
+ * <pre>
+ * 逐层自底向上建堆时，每一层都要扫过整个数组，n较大时各层都不在缓存中。
+ * 分块：子树的每一层在数组中是连续的一段，以深度d0的节点为根的子树不超过PQ_HEAPIFY_BLOCK字节，
+ * 逐个子树在其内部自底向上建堆（子树的所有层都留在缓存中），最后处理深度小于d0的少量节点：
+ *
+ *            [          上层：2^d0-1个节点          ]
+ *           /      |      |      |      |      |     \
+ *        [子树]  [子树] [子树] [子树] [子树] [子树]  [子树]   各自在缓存内建堆
+ *
+ * 深度为l的一层中，子树r的节点为[(r+1)*2^l-1, (r+2)*2^l-1)。
+ * </pre>
+ *
+ * @param A: 数组
+ * @param n: 元素数量
+ * @return
+ * @retval None
+ */
+template <typename T>
+void heap_build(T* A, int n)
+{
+    if (n < 2)
+        return;
+    const int last = PQ_Parent(n-1);        // 最后一个内部节点
+    long long block = PQ_HEAPIFY_BLOCK / (long long)sizeof(T);
+    int d0 = 0;
+    while (((long long)n >> d0) > block)
+        d0 ++;
+    int first = (1 << d0) - 1;              // 深度为d0的第一个节点
+
+    for (int r = ((2 * first + 1 < n) ? 2 * first + 1 : n) - 1; r >= first; r --)
+    {
+        // 子树r：自最深的一层向上，逐层连续处理
+        int depth = 0;
+        while ((long long)(r + 1) * (2LL << depth) - 1 <= last)
+            depth ++;
+        for (int l = depth; l >= 0; l --)
+        {
+            long long lo = (long long)(r + 1) * (1LL << l) - 1;
+            long long hi = lo + (1LL << l);
+            if (hi > last + 1) hi = last + 1;
+            for (long long k = hi - 1; k >= lo; k --)
+                dsa::heap_sift_down(A, n, (int)k);
+        }
+    }
+    for (int k = (first - 1 < last) ? first - 1 : last; k >= 0; k --)
+        dsa::heap_sift_down(A, n, k);
 }
 
 /*!
- * @brief 利用完全二叉堆对向量区间进行排序
+ * @brief 利用完全二叉堆对向量区间进行排序（原地）
  *
  * <pre>
  *
@@ -271,6 +341,7 @@ void PqComplHeap<T>::heapify(int n)
  * [ # --- heap --- # --- sorted ---]
  *  lo             hi
  *
+ * 换到堆顶的末尾元素通常很小，适合Floyd自底向上的下滤。
  * </pre>
  *
  * @param vec: 待排序向量
@@ -281,11 +352,16 @@ void PqComplHeap<T>::heapify(int n)
 template <typename T>
 void heap_sort(dsa::Vector<T>& vec, int lo, int hi)
 {
-    dsa::PqComplHeap<T> h(vec, lo, hi);
-    while(!h.is_empty())
+    int n = hi - lo;
+    if (n < 2)
+        return;
+    T* A = &vec[lo];
+    dsa::heap_build(A, n);
+    while (n > 1)
     {
         // 将堆顶元素放入已经排序部分
-        vec[--hi] = h.del_max();
+        dsa::swap(A[0], A[--n]);
+        dsa::heap_sift_down(A, n, 0);
     }
 }
 
@@ -0,0 +1,257 @@
+
+//==============================================================================
+/*!
+ * @file pq_dary_heap.h
+ * @brief D叉完全堆模版类（孩子按缓存行对齐）
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_PQ_DARY_HEAP_H
+#define DSAS_PQ_DARY_HEAP_H
+
+#include <new>
+#include <cstdint>
+#include "priority_queue.h"
+#include "share/compare.h"
+#include "share/macro.h"
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup LPQ
+ *
+ * @{
+ */
+
+#define PQ_DARY_CAPACITY    64      /**< D叉堆的默认初始容量 */
+
+/*!
+ * @brief D叉完全堆模板类
+ *
+ * <pre>
+ * 节点i的孩子为D*i+1 ~ D*i+D，父节点为(i-1)/D，树高为log_D(n)，以4叉堆为例：
+ *
+ *                 0
+ *       /     /       \      \
+ *      1     2         3      4
+ *    / | \ \
+ *   5  6 7  8   ...
+ *
+ * 数组的起始地址按缓存行对齐，并使下标1位于第D个槽位上，
+ * 则每组兄弟D*i+1 ~ D*i+D的字节偏移均为D*sizeof(T)的整数倍：
+ *
+ * 槽位:  [ - - - 0 | 1 2 3 4 | 5 6 7 8 | 9 ... ]     (D=4, 4字节关键码，每个缓存行容纳4组兄弟)
+ *
+ * 当D*sizeof(T)整除缓存行大小时，一组兄弟恰在同一缓存行内，下滤每层只访问一个缓存行；
+ * 二叉堆的下滤每层也访问一个缓存行，但层数是4叉堆的2倍（8叉堆的3倍）。
+ * 上滤每层只比较一次，层数更少，插入也更快；代价是下滤每层多D-2次比较。
+ *
+ * 优先级由CMP决定：CMP(a, b)为true表示a的优先级低于b，使用dsa::Greater<T>即为最小堆。
+ * </pre>
+ *
+ */
+template <typename T, int D = 4, typename CMP = dsa::Less<T>>
+class PqDaryHeap : public dsa::PQ<T>
+{
+    static_assert(D >= 2, "PqDaryHeap: D must be at least 2");
+
+protected:
+    char*   m_raw;      /**< 申请的原始内存 */
+    T*      m_array;    /**< 堆数组，m_array[1]按D*sizeof(T)对齐 */
+    int     m_size;
+    int     m_cap;
+    CMP     cmp;
+
+    void    reserve(int cap);
+    int     percolate_up(int i);
+    int     percolate_down(int i);
+    void    heapify();
+
+public:
+    PqDaryHeap(int cap = PQ_DARY_CAPACITY) : m_raw(nullptr), m_array(nullptr), m_size(0), m_cap(0)
+    {
+        this->reserve(cap > 0 ? cap : 1);
+    }
+    /** 从数组[0,n)建立D叉堆 */
+    PqDaryHeap(const T* A, int n) : m_raw(nullptr), m_array(nullptr), m_size(0), m_cap(0)
+    {
+        this->reserve(n > 0 ? n : 1);
+        for (int k = 0; k < n; k ++)
+            this->m_array[k] = A[k];
+        this->m_size = n;
+        this->heapify();
+    }
+    ~PqDaryHeap()
+    {
+        for (int k = 0; k < this->m_cap; k ++)
+            this->m_array[k].~T();
+        ::operator delete(this->m_raw);
+    }
+    PqDaryHeap(const PqDaryHeap&) = delete;
+    PqDaryHeap& operator= (const PqDaryHeap&) = delete;
+
+    int     size() const {return this->m_size;}
+    bool    is_empty() const {return this->m_size == 0;}
+    void    clear() {this->m_size = 0;}
+    /** 按下标访问（堆序） */
+    const T& operator[](int i) const {return this->m_array[i];}
+
+    void    insert(const T& e);
+    /** 堆顶，即优先级最高的元素，时间复杂度O(1) */
+    T       get_max() {return this->m_array[0];}
+    T       del_max();
+};
+
+/*! @} */
+
+
+/*!
+ * @brief 扩展容量，保持m_array[1]的对齐
+ *
+ * @param cap: 新容量
+ * @return
+ * @retval None
+ */
+template <typename T, int D, typename CMP>
+void PqDaryHeap<T,D,CMP>::reserve(int cap)
+{
+    if (cap <= this->m_cap)
+        return;
+    // 前D-1个槽位作为填充，m_array[0]位于第D-1个槽位
+    char* raw = static_cast<char*>(::operator new((std::size_t)(cap + D - 1) * sizeof(T) + DSAS_CACHELINE));
+    std::uintptr_t a = reinterpret_cast<std::uintptr_t>(raw);
+    T* base = reinterpret_cast<T*>((a + DSAS_CACHELINE - 1) / DSAS_CACHELINE * DSAS_CACHELINE);
+    T* arr = base + (D - 1);
+    for (int k = 0; k < cap; k ++)
+        new (&arr[k]) T();
+    for (int k = 0; k < this->m_size; k ++)
+        arr[k] = this->m_array[k];
+    for (int k = 0; k < this->m_cap; k ++)
+        this->m_array[k].~T();
+    ::operator delete(this->m_raw);
+    this->m_raw = raw;
+    this->m_array = arr;
+    this->m_cap = cap;
+}
+
+/*!
+ * @brief 上滤
+ *
+ * @param i: 新插入元素的下标
+ * @return 返回最终下标
+ * @retval None
+ */
+template <typename T, int D, typename CMP>
+int PqDaryHeap<T,D,CMP>::percolate_up(int i)
+{
+    T e = this->m_array[i];
+    while (i > 0)
+    {
+        int p = (i - 1) / D;
+        if (!this->cmp(this->m_array[p], e))
+            break;
+        this->m_array[i] = this->m_array[p];
+        i = p;
+    }
+    this->m_array[i] = e;
+    return i;
+}
+
+/*!
+ * @brief 下滤：在同一缓存行内的D个孩子中选出优先级最高者
+ *
+ * @param i: 进行下滤的元素下标
+ * @return 返回最终下标
+ * @retval None
+ */
+template <typename T, int D, typename CMP>
+int PqDaryHeap<T,D,CMP>::percolate_down(int i)
+{
+    const int n = this->m_size;
+    T e = this->m_array[i];
+    for (;;)
+    {
+        int c = D * i + 1;
+        if (c >= n)
+            break;
+        // 最优孩子的值保存在局部变量中，避免按刚选出的下标重新读取（形成依赖链）
+        int best = c;
+        T bv = this->m_array[c];
+        if (c + D <= n)
+        {
+            // 孩子满D个（除最后一组外均是如此），循环次数为常量，可完全展开
+            for (int j = 1; j < D; j ++)
+            {
+                bool b = this->cmp(bv, this->m_array[c + j]);   // 随机数据下分支难以预测，写成条件传送的形式
+                best = b ? c + j : best;
+                bv = b ? this->m_array[c + j] : bv;
+            }
+        }
+        else
+        {
+            for (int j = c + 1; j < n; j ++)
+            {
+                bool b = this->cmp(bv, this->m_array[j]);
+                best = b ? j : best;
+                bv = b ? this->m_array[j] : bv;
+            }
+        }
+        if (!this->cmp(e, bv))
+            break;
+        this->m_array[i] = bv;
+        i = best;
+    }
+    this->m_array[i] = e;
+    return i;
+}
+
+/** 自下而上下滤，O(n)建堆 */
+template <typename T, int D, typename CMP>
+void PqDaryHeap<T,D,CMP>::heapify()
+{
+    for (int k = (this->m_size - 2) / D; k >= 0 && this->m_size > 1; k --)
+        this->percolate_down(k);
+}
+
+/*!
+ * @brief 插入元素
+ *
+ * @param e: 待插入的元素
+ * @return
+ * @retval None
+ */
+template <typename T, int D, typename CMP>
+void PqDaryHeap<T,D,CMP>::insert(const T& e)
+{
+    if (this->m_size >= this->m_cap)
+        this->reserve(2 * this->m_cap);
+    this->m_array[this->m_size ++] = e;
+    this->percolate_up(this->m_size - 1);
+}
+
+/*!
+ * @brief 删除堆顶元素
+ *
+ * @param None
+ * @return 返回堆顶元素
+ * @retval None
+ */
+template <typename T, int D, typename CMP>
+T PqDaryHeap<T,D,CMP>::del_max()
+{
+    T max_elem = this->m_array[0];
+    this->m_array[0] = this->m_array[-- this->m_size];
+    if (this->m_size > 0)
+        this->percolate_down(0);
+    return max_elem;
+}
+
+} /* dsa */
+
+#endif /* ifndef DSAS_PQ_DARY_HEAP_H */
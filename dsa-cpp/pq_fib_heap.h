@@ -0,0 +1,390 @@
+
+//==============================================================================
+/*!
+ * @file pq_fib_heap.h
+ * @brief 斐波那契堆模版类
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_PQ_FIB_HEAP_H
+#define DSAS_PQ_FIB_HEAP_H
+
+#include "priority_queue.h"
+#include "share/compare.h"
+#include "share/swap.h"
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup LPQ
+ *
+ * @{
+ */
+
+#define PQ_FIB_MAX_DEGREE   64      /**< 节点度数的上限：度数为d的子树至少有F(d+2)个节点，int规模下d<46 */
+
+template <typename T> struct FibNode;
+template <typename T>
+using FibNodePtr = struct FibNode<T>*;
+
+/*!
+ * @brief 斐波那契堆节点
+ *
+ * 兄弟之间以循环双向链表连接，父节点只指向其中一个孩子。
+ */
+template <typename T>
+struct FibNode
+{
+    T               data;
+    FibNodePtr<T>   parent;
+    FibNodePtr<T>   child;      /**< 任一孩子 */
+    FibNodePtr<T>   left;       /**< 左兄弟（循环） */
+    FibNodePtr<T>   right;      /**< 右兄弟（循环） */
+    int             degree;     /**< 孩子数量 */
+    bool            mark;       /**< 成为孩子后是否失去过孩子 */
+
+    FibNode(const T& e) : data(e), parent(nullptr), child(nullptr), left(this), right(this), degree(0), mark(false) {}
+};
+
+/*!
+ * @brief 斐波那契堆模板类
+ *
+ * <pre>
+ * 堆是若干棵堆序树组成的根链表（循环双向链表），m_max指向优先级最高的根：
+ *
+ *   m_max
+ *     |
+ *     9 <-> 4 <-> 7 <-> 2        根链表
+ *    / \          |
+ *   8   5         6
+ *   |
+ *   1
+ *
+ * insert/merge：加入/拼接根链表，O(1)，不做任何整理；
+ * del_max：堆顶的孩子并入根链表，再合并（consolidate）度数相同的根，直到各根的度数互不相同，均摊O(log n)；
+ * increase_key：若破坏了堆序，将节点剪到根链表（cut）；父节点第二次失去孩子时也被剪下（级联剪切），均摊O(1)。
+ * 级联剪切保证度数为d的子树至少有F(d+2)个节点，故度数为O(log n)。
+ *
+ * 优先级由CMP决定：CMP(a, b)为true表示a的优先级低于b，使用dsa::Greater<T>即为最小堆；
+ * increase_key指提升优先级，对最小堆即是经典的decrease-key。
+ * push返回的句柄（节点指针）在该元素出堆前一直有效，merge后仍然有效。
+ * </pre>
+ *
+ */
+template <typename T, typename CMP = dsa::Less<T>>
+class PqFibHeap : public dsa::PQ<T>
+{
+protected:
+    FibNodePtr<T>   m_max;
+    int             m_size;
+    CMP             cmp;
+
+    /** 将x从所在的兄弟链表中摘出 */
+    static void unlink(FibNodePtr<T> x) {x->left->right = x->right; x->right->left = x->left; x->left = x->right = x;}
+    /** 将单个节点x插入到a的右侧 */
+    static void splice(FibNodePtr<T> a, FibNodePtr<T> x) {x->right = a->right; x->left = a; a->right->left = x; a->right = x;}
+    void    add_root(FibNodePtr<T> x);
+    void    consolidate();
+    void    cut(FibNodePtr<T> x, FibNodePtr<T> p);
+    void    cascading_cut(FibNodePtr<T> p);
+
+public:
+    PqFibHeap() : m_max(nullptr), m_size(0) {}
+    ~PqFibHeap() {this->clear();}
+    PqFibHeap(const PqFibHeap&) = delete;
+    PqFibHeap& operator= (const PqFibHeap&) = delete;
+
+    int     size() const {return this->m_size;}
+    bool    is_empty() const {return !this->m_max;}
+    void    clear();
+
+    FibNodePtr<T> push(const T& e);
+    /** 插入元素（PQ接口） */
+    void    insert(const T& e) {this->push(e);}
+    /** 堆顶，即优先级最高的元素，时间复杂度O(1) */
+    T       get_max() {return this->m_max->data;}
+    /** 堆顶的句柄 */
+    FibNodePtr<T> top() const {return this->m_max;}
+    T       del_max();
+    bool    increase_key(FibNodePtr<T> x, const T& e);
+    void    remove(FibNodePtr<T> x);
+    void    merge(PqFibHeap<T,CMP>& h);
+};
+
+/*! @} */
+
+
+/** 将单个节点x加入根链表，并更新m_max */
+template <typename T, typename CMP>
+void PqFibHeap<T,CMP>::add_root(FibNodePtr<T> x)
+{
+    x->parent = nullptr;
+    x->mark = false;
+    if (!this->m_max)
+    {
+        x->left = x->right = x;
+        this->m_max = x;
+        return;
+    }
+    splice(this->m_max, x);
+    if (this->cmp(this->m_max->data, x->data))
+        this->m_max = x;
+}
+
+/*!
+ * @brief 合并度数相同的根，直到各根的度数互不相同
+ *
+ * <pre>
+ * 逐个扫描根链表，A[d]记录已扫描过的度数为d的根；
+ * 遇到同度数的根，优先级低者成为高者的孩子，度数加1后继续查A[d+1]。
+ * 扫描前先数出根的数量，因为扫描过程中根链表会变化。
+ * </pre>
+ *
+ * @param None
+ * @return
+ * @retval None
+ */
+template <typename T, typename CMP>
+void PqFibHeap<T,CMP>::consolidate()
+{
+    FibNodePtr<T> A[PQ_FIB_MAX_DEGREE] = {nullptr};
+    int r = 0;
+    FibNodePtr<T> w = this->m_max;
+    do { r ++; w = w->right; } while (w != this->m_max);
+
+    while (r --)
+    {
+        FibNodePtr<T> x = w;
+        w = w->right;           // w尚未扫描，不会被合并掉
+        int d = x->degree;
+        while (A[d])
+        {
+            FibNodePtr<T> y = A[d];
+            if (this->cmp(x->data, y->data))
+                dsa::swap(x, y);
+            // y成为x的孩子
+            unlink(y);
+            y->parent = x;
+            y->mark = false;
+            if (x->child)
+                splice(x->child, y);
+            else
+                x->child = y;
+            x->degree ++;
+            A[d ++] = nullptr;
+        }
+        A[d] = x;
+    }
+
+    this->m_max = nullptr;
+    for (int d = 0; d < PQ_FIB_MAX_DEGREE; d ++)
+        if (A[d] && (!this->m_max || this->cmp(this->m_max->data, A[d]->data)))
+            this->m_max = A[d];
+}
+
+/** 将x从父节点p的孩子链表中剪下，加入根链表 */
+template <typename T, typename CMP>
+void PqFibHeap<T,CMP>::cut(FibNodePtr<T> x, FibNodePtr<T> p)
+{
+    if (p->child == x)
+        p->child = (x->right == x) ? nullptr : x->right;
+    unlink(x);
+    p->degree --;
+    this->add_root(x);
+}
+
+/*!
+ * @brief 级联剪切
+ *
+ * p刚失去一个孩子：未标记则标记，已标记则将p也剪下，并继续检查p的父节点。
+ *
+ * @param p: 失去孩子的节点
+ * @return
+ * @retval None
+ */
+template <typename T, typename CMP>
+void PqFibHeap<T,CMP>::cascading_cut(FibNodePtr<T> p)
+{
+    for (FibNodePtr<T> g = p->parent; g; p = g, g = p->parent)
+    {
+        if (!p->mark)
+        {
+            p->mark = true;
+            break;
+        }
+        this->cut(p, g);
+    }
+}
+
+/*!
+ * @brief 释放所有节点
+ *
+ * 断开根链表，将节点的孩子（循环链表）拼接到其后，再释放节点，不使用递归。
+ *
+ * @param None
+ * @return
+ * @retval None
+ */
+template <typename T, typename CMP>
+void PqFibHeap<T,CMP>::clear()
+{
+    if (!this->m_max)
+        return;
+    FibNodePtr<T> x = this->m_max;
+    x->left->right = nullptr;
+    while (x)
+    {
+        if (x->child)
+        {
+            FibNodePtr<T> last = x->child->left;
+            last->right = x->right;
+            x->right = x->child;
+        }
+        FibNodePtr<T> n = x->right;
+        delete x;
+        x = n;
+    }
+    this->m_max = nullptr;
+    this->m_size = 0;
+}
+
+/*!
+ * @brief 插入元素
+ *
+ * @param e: 待插入的元素
+ * @return 返回元素的句柄
+ * @retval None
+ */
+template <typename T, typename CMP>
+FibNodePtr<T> PqFibHeap<T,CMP>::push(const T& e)
+{
+    FibNodePtr<T> x = new FibNode<T>(e);
+    this->add_root(x);
+    this->m_size ++;
+    return x;
+}
+
+/*!
+ * @brief 删除堆顶
+ *
+ * @param None
+ * @return 返回堆顶元素
+ * @retval None
+ */
+template <typename T, typename CMP>
+T PqFibHeap<T,CMP>::del_max()
+{
+    FibNodePtr<T> z = this->m_max;
+    T e = z->data;
+    // 孩子并入根链表
+    while (z->child)
+    {
+        FibNodePtr<T> c = z->child;
+        z->child = (c->right == c) ? nullptr : c->right;
+        unlink(c);
+        c->parent = nullptr;
+        c->mark = false;
+        splice(z, c);
+    }
+    FibNodePtr<T> next = z->right;
+    unlink(z);
+    delete z;
+    this->m_size --;
+    if (next == z)
+        this->m_max = nullptr;
+    else
+    {
+        this->m_max = next;
+        this->consolidate();
+    }
+    return e;
+}
+
+/*!
+ * @brief 提升优先级
+ *
+ * @param x: 元素的句柄
+ * @param e: 新的值，优先级不能低于原值
+ * @return 新值的优先级更低时返回false
+ * @retval None
+ */
+template <typename T, typename CMP>
+bool PqFibHeap<T,CMP>::increase_key(FibNodePtr<T> x, const T& e)
+{
+    if (this->cmp(e, x->data))
+        return false;
+    x->data = e;
+    FibNodePtr<T> p = x->parent;
+    if (p && this->cmp(p->data, x->data))
+    {
+        this->cut(x, p);
+        this->cascading_cut(p);
+    }
+    else if (!p && this->cmp(this->m_max->data, x->data))
+        this->m_max = x;
+    return true;
+}
+
+/*!
+ * @brief 删除句柄对应的元素
+ *
+ * 将x剪到根链表并视为堆顶，再按del_max删除。
+ *
+ * @param x: 元素的句柄，删除后失效
+ * @return
+ * @retval None
+ */
+template <typename T, typename CMP>
+void PqFibHeap<T,CMP>::remove(FibNodePtr<T> x)
+{
+    FibNodePtr<T> p = x->parent;
+    if (p)
+    {
+        this->cut(x, p);
+        this->cascading_cut(p);
+    }
+    this->m_max = x;
+    this->del_max();
+}
+
+/*!
+ * @brief 合并堆，拼接两个根链表，O(1)
+ *
+ * @param h: 待合并的堆，合并后为空，其句柄转为本堆的句柄
+ * @return
+ * @retval None
+ */
+template <typename T, typename CMP>
+void PqFibHeap<T,CMP>::merge(PqFibHeap<T,CMP>& h)
+{
+    if (&h == this || !h.m_max)
+        return;
+    if (this->m_max)
+    {
+        FibNodePtr<T> a = this->m_max;
+        FibNodePtr<T> b = h.m_max;
+        FibNodePtr<T> ar = a->right;
+        FibNodePtr<T> bl = b->left;
+        a->right = b;
+        b->left = a;
+        bl->right = ar;
+        ar->left = bl;
+        if (this->cmp(a->data, b->data))
+            this->m_max = b;
+    }
+    else
+        this->m_max = h.m_max;
+    this->m_size += h.m_size;
+    h.m_max = nullptr;
+    h.m_size = 0;
+}
+
+} /* dsa */
+
+#endif /* ifndef DSAS_PQ_FIB_HEAP_H */
@@ -0,0 +1,344 @@
+
+//==============================================================================
+/*!
+ * @file pq_index_heap.h
+ * @brief 索引堆模版类（支持按句柄修改关键码）
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_PQ_INDEX_HEAP_H
+#define DSAS_PQ_INDEX_HEAP_H
+
+#include "vector.h"
+#include "priority_queue.h"
+#include "share/compare.h"
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup LPQ
+ *
+ * @{
+ */
+
+/*!
+ * @brief 索引堆（D叉完全堆）模板类
+ *
+ * <pre>
+ * 堆中存放的是句柄（非负整数），关键码按句柄存放，另有句柄到堆中位置的映射：
+ *
+ * 句柄:      0    1    2    3
+ * m_key:   [30] [50] [10] [40]           关键码
+ * m_pos:   [ 2] [ 0] [-1] [ 1]           句柄在m_heap中的位置，-1表示不在堆中
+ * m_heap:  [ 1] [ 3] [ 0]                按关键码形成堆序：50, 40, 30
+ *
+ * 上滤/下滤移动句柄时同步更新m_pos，故可在O(log n)内按句柄修改关键码或删除，
+ * 不必像PqComplHeap那样插入重复元素（如Dijkstra以顶点编号为句柄，松弛时直接更新距离）。
+ *
+ * 优先级由CMP决定：CMP(a, b)为true表示a的优先级低于b，堆顶为优先级最高者；
+ * 使用dsa::Greater<T>即为最小堆。increase_key/decrease_key指优先级的升降（按CMP）。
+ *
+ * 句柄的来源有两种，不要混用：
+ * (1) insert(h, e)：由调用者指定句柄（如顶点编号），句柄空间按需扩展；
+ * (2) push(e)：由堆分配句柄，出堆（del_max/pop/remove）的句柄会被之后的push复用。
+ * </pre>
+ *
+ */
+template <typename T, typename CMP = dsa::Less<T>, int D = 2>
+class PqIndexHeap : public dsa::PQ<T>
+{
+    static_assert(D >= 2, "PqIndexHeap: D must be at least 2");
+
+protected:
+    dsa::Vector<int>    m_heap;     /**< 按堆序存放的句柄 */
+    dsa::Vector<T>      m_key;      /**< 句柄 -> 关键码 */
+    dsa::Vector<int>    m_pos;      /**< 句柄 -> 在m_heap中的位置，-1表示不在堆中 */
+    dsa::Vector<int>    m_spare;    /**< push分配的、已出堆的句柄 */
+    bool                m_auto;     /**< 是否由push分配句柄 */
+    CMP                 cmp;
+
+    /** 句柄h的优先级是否低于句柄g */
+    bool    lower(int h, int g) const {return this->cmp(this->m_key[h], this->m_key[g]);}
+    /** 将句柄h放到位置i */
+    void    place(int i, int h) {this->m_heap[i] = h; this->m_pos[h] = i;}
+    int     percolate_up(int i);
+    int     percolate_down(int i);
+    void    remove_at(int i);
+
+public:
+    PqIndexHeap() : m_auto(false) {}
+    /** 预留句柄空间[0, n) */
+    PqIndexHeap(int n) : m_heap(n > 0 ? n : 1), m_key(n > 0 ? n : 1), m_pos(n > 0 ? n : 1), m_auto(false)
+    {
+        this->reserve(n);
+    }
+
+    /** 元素数量 */
+    int     size() const {return this->m_heap.size();}
+    bool    is_empty() const {return this->m_heap.is_empty();}
+    /** 清空堆，已分配的句柄空间保留 */
+    void    clear()
+    {
+        for (int k = 0; k < this->m_heap.size(); k ++)
+            this->m_pos[this->m_heap[k]] = -1;
+        this->m_heap.clear();
+        this->m_spare.clear();
+        for (int h = 0; this->m_auto && h < this->m_pos.size(); h ++)
+            this->m_spare.push_back(h);
+    }
+    /** 扩展句柄空间至[0, n) */
+    void    reserve(int n)
+    {
+        while (this->m_pos.size() < n)
+        {
+            this->m_pos.push_back(-1);
+            this->m_key.push_back(T());
+        }
+    }
+    /** 句柄h是否在堆中 */
+    bool    contains(int h) const {return 0 <= h && h < this->m_pos.size() && this->m_pos[h] >= 0;}
+    /** 句柄h的关键码（h须在堆中） */
+    const T& key(int h) const {return this->m_key[h];}
+
+    bool    insert(int h, const T& e);
+    int     push(const T& e);
+    /** 插入元素，由堆分配句柄（PQ接口） */
+    void    insert(const T& e) {this->push(e);}
+    /** 堆顶（优先级最高）的关键码 */
+    T       get_max() {return this->m_key[this->m_heap[0]];}
+    /** 堆顶的句柄 */
+    int     top() const {return this->m_heap[0];}
+    T       del_max();
+    int     pop();
+    bool    remove(int h);
+    bool    update(int h, const T& e);
+    bool    increase_key(int h, const T& e);
+    bool    decrease_key(int h, const T& e);
+};
+
+/*! @} */
+
+
+/*!
+ * @brief 上滤：空出位置i，较低优先级的父节点逐层下移，最后放入原句柄
+ *
+ * @param i: 起始位置
+ * @return 返回最终位置
+ * @retval None
+ */
+template <typename T, typename CMP, int D>
+int PqIndexHeap<T,CMP,D>::percolate_up(int i)
+{
+    int h = this->m_heap[i];
+    while (i > 0)
+    {
+        int p = (i - 1) / D;
+        if (!this->lower(this->m_heap[p], h))
+            break;
+        this->place(i, this->m_heap[p]);
+        i = p;
+    }
+    this->place(i, h);
+    return i;
+}
+
+/*!
+ * @brief 下滤：在D个孩子中选出优先级最高者，高于当前句柄时上移，直至堆底
+ *
+ * @param i: 起始位置
+ * @return 返回最终位置
+ * @retval None
+ */
+template <typename T, typename CMP, int D>
+int PqIndexHeap<T,CMP,D>::percolate_down(int i)
+{
+    const int n = this->m_heap.size();
+    int h = this->m_heap[i];
+    for (;;)
+    {
+        int c = D * i + 1;
+        if (c >= n)
+            break;
+        int end = (c + D < n) ? c + D : n;
+        int best = c;
+        for (int j = c + 1; j < end; j ++)
+            if (this->lower(this->m_heap[best], this->m_heap[j]))
+                best = j;
+        if (!this->lower(h, this->m_heap[best]))
+            break;
+        this->place(i, this->m_heap[best]);
+        i = best;
+    }
+    this->place(i, h);
+    return i;
+}
+
+/** 删除位置i的句柄：以末尾句柄填补，再上滤或下滤 */
+template <typename T, typename CMP, int D>
+void PqIndexHeap<T,CMP,D>::remove_at(int i)
+{
+    int h = this->m_heap[i];
+    int last = this->m_heap.remove(this->m_heap.size() - 1);
+    this->m_pos[h] = -1;
+    if (this->m_auto)
+        this->m_spare.push_back(h);
+    if (i < this->m_heap.size())
+    {
+        this->place(i, last);
+        if (this->percolate_up(i) == i)
+            this->percolate_down(i);
+    }
+}
+
+/*!
+ * @brief 以指定句柄插入
+ *
+ * @param h: 句柄（非负整数），超出句柄空间时自动扩展
+ * @param e: 关键码
+ * @return 句柄为负或已在堆中时返回false
+ * @retval None
+ */
+template <typename T, typename CMP, int D>
+bool PqIndexHeap<T,CMP,D>::insert(int h, const T& e)
+{
+    if (h < 0)
+        return false;
+    this->reserve(h + 1);
+    if (this->m_pos[h] >= 0)
+        return false;
+    this->m_key[h] = e;
+    this->m_heap.push_back(h);
+    this->m_pos[h] = this->m_heap.size() - 1;
+    this->percolate_up(this->m_heap.size() - 1);
+    return true;
+}
+
+/*!
+ * @brief 插入元素，由堆分配句柄（优先复用已出堆的句柄）
+ *
+ * @param e: 关键码
+ * @return 返回句柄
+ * @retval None
+ */
+template <typename T, typename CMP, int D>
+int PqIndexHeap<T,CMP,D>::push(const T& e)
+{
+    this->m_auto = true;
+    int h = this->m_spare.is_empty() ? this->m_pos.size() : this->m_spare.remove(this->m_spare.size() - 1);
+    this->insert(h, e);
+    return h;
+}
+
+/*!
+ * @brief 删除堆顶
+ *
+ * @param None
+ * @return 返回堆顶的关键码
+ * @retval None
+ */
+template <typename T, typename CMP, int D>
+T PqIndexHeap<T,CMP,D>::del_max()
+{
+    T e = this->m_key[this->m_heap[0]];
+    this->remove_at(0);
+    return e;
+}
+
+/*!
+ * @brief 删除堆顶
+ *
+ * @param None
+ * @return 返回堆顶的句柄，其关键码仍可通过key(h)读取，直到句柄被再次插入
+ * @retval None
+ */
+template <typename T, typename CMP, int D>
+int PqIndexHeap<T,CMP,D>::pop()
+{
+    int h = this->m_heap[0];
+    this->remove_at(0);
+    return h;
+}
+
+/*!
+ * @brief 按句柄删除
+ *
+ * @param h: 句柄
+ * @return 句柄不在堆中时返回false
+ * @retval None
+ */
+template <typename T, typename CMP, int D>
+bool PqIndexHeap<T,CMP,D>::remove(int h)
+{
+    if (!this->contains(h))
+        return false;
+    this->remove_at(this->m_pos[h]);
+    return true;
+}
+
+/*!
+ * @brief 修改关键码，按优先级的升降上滤或下滤
+ *
+ * @param h: 句柄
+ * @param e: 新关键码
+ * @return 句柄不在堆中时返回false
+ * @retval None
+ */
+template <typename T, typename CMP, int D>
+bool PqIndexHeap<T,CMP,D>::update(int h, const T& e)
+{
+    if (!this->contains(h))
+        return false;
+    bool up = this->cmp(this->m_key[h], e);
+    this->m_key[h] = e;
+    if (up)
+        this->percolate_up(this->m_pos[h]);
+    else
+        this->percolate_down(this->m_pos[h]);
+    return true;
+}
+
+/*!
+ * @brief 提升优先级（只上滤）
+ *
+ * @param h: 句柄
+ * @param e: 新关键码，优先级不能低于原关键码
+ * @return 句柄不在堆中或新关键码优先级更低时返回false
+ * @retval None
+ */
+template <typename T, typename CMP, int D>
+bool PqIndexHeap<T,CMP,D>::increase_key(int h, const T& e)
+{
+    if (!this->contains(h) || this->cmp(e, this->m_key[h]))
+        return false;
+    this->m_key[h] = e;
+    this->percolate_up(this->m_pos[h]);
+    return true;
+}
+
+/*!
+ * @brief 降低优先级（只下滤）
+ *
+ * @param h: 句柄
+ * @param e: 新关键码，优先级不能高于原关键码
+ * @return 句柄不在堆中或新关键码优先级更高时返回false
+ * @retval None
+ */
+template <typename T, typename CMP, int D>
+bool PqIndexHeap<T,CMP,D>::decrease_key(int h, const T& e)
+{
+    if (!this->contains(h) || this->cmp(this->m_key[h], e))
+        return false;
+    this->m_key[h] = e;
+    this->percolate_down(this->m_pos[h]);
+    return true;
+}
+
+} /* dsa */
+
+#endif /* ifndef DSAS_PQ_INDEX_HEAP_H */
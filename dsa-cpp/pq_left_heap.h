@@ -54,9 +54,13 @@ template <typename T>
 class PqLeftHeap : public PQ<T>, public BinTree<T>
 {
 public:
+    ~PqLeftHeap() {this->clear();}
+
     void    insert(const T&);
     T       get_max(){return this->m_root->data;}
     T       del_max();
+    void    merge(PqLeftHeap<T>& h);
+    void    clear();
 
 protected:
     BinNodePtr<T>   merge(BinNodePtr<T>, BinNodePtr<T>);
@@ -86,10 +90,17 @@ protected:
  *    -----------
  * 比较al与AR的npl值，通过互换，使 npl(a->left) >= npl(a->right)
  *
+ * 递归形式中，merge沿两个右侧链交替下降，回溯时自下而上交换左右子堆、更新npl。
+ * 这里改为迭代：
+ * (1) 自上而下：沿右侧链下降，每层保留较大者，较小者留待与其右子堆继续合并，
+ *     直到某个右子堆为空，将剩下的堆整个接上；
+ * (2) 自下而上：沿parent回到根，逐个节点恢复左倾性并更新npl。
+ * 右侧链长度为O(log(n))，但经多次合并、删除后，左式堆也可能很深（如有序插入时左侧链长为n），
+ * 迭代实现不受递归深度的限制。
  * </pre>
  *
  * @param a,b: 待合并的两个左式堆
- * @return
+ * @return 返回合并后的根节点
  * @retval None
  */
 template <typename T>
@@ -101,18 +112,86 @@ BinNodePtr<T> PqLeftHeap<T>::merge(BinNodePtr<T> a, BinNodePtr<T> b)
     // 确保a >= b，因为合并后，a做为根节点，必须为最大值
     if (a->data < b->data)
         dsa::swap(a, b);
-    // 合并a的右子堆与b
-    a->right = this->merge(a->right, b);      // 因为右侧链长度 d <= O(log(n))，故merge最多递归d次，即时间复杂度为O(log(n))
-    a->right->parent = a;
-    // 使a继续满足左倾性
-    if (!a->left || a->left->npl < a->right->npl)
-        dsa::swap(a->left, a->right);
-    // 更新npl，若a->right=nullptr，则a距a->right的距离为1
-    a->npl = a->right ? (a->right->npl + 1) : 1;
+    BinNodePtr<T> root = a;
+    // 自上而下：a为合并路径上的节点，b为待合并到a的右子堆中的堆
+    while (a->right)
+    {
+        if (a->right->data < b->data)
+            dsa::swap(a->right, b);
+        a->right->parent = a;
+        a = a->right;
+    }
+    a->right = b;
+    b->parent = a;
+    // 自下而上：使合并路径上的节点继续满足左倾性，并更新npl
+    for (;;)
+    {
+        if (!a->left || a->left->npl < a->right->npl)
+            dsa::swap(a->left, a->right);
+        // 更新npl，若a->right=nullptr，则a距a->right的距离为1
+        a->npl = a->right ? (a->right->npl + 1) : 1;
+        if (a == root)
+            break;
+        a = a->parent;
+    }
 
     return a;
 }
 
+/*!
+ * @brief 合并另一个左式堆，O(log(n))
+ *
+ * @param h: 待合并的堆，合并后为空
+ * @return
+ * @retval None
+ */
+template <typename T>
+void PqLeftHeap<T>::merge(PqLeftHeap<T>& h)
+{
+    if (&h == this)
+        return;
+    this->m_root = this->merge(this->m_root, h.m_root);
+    if (this->m_root)
+        this->m_root->parent = nullptr;
+    this->m_size += h.m_size;
+    h.m_root = nullptr;
+    h.m_size = 0;
+}
+
+/*!
+ * @brief 释放所有节点
+ *
+ * 左式堆的左侧链可能很长，不使用BinTree的递归删除：
+ * 有左孩子时右旋，使左子树逐步转移到右侧，否则释放当前节点并沿右孩子继续，O(n)。
+ *
+ * @param None
+ * @return
+ * @retval None
+ */
+template <typename T>
+void PqLeftHeap<T>::clear()
+{
+    BinNodePtr<T> x = this->m_root;
+    while (x)
+    {
+        BinNodePtr<T> l = x->left;
+        if (l)
+        {
+            x->left = l->right;
+            l->right = x;
+            x = l;
+        }
+        else
+        {
+            BinNodePtr<T> r = x->right;
+            delete x;
+            x = r;
+        }
+    }
+    this->m_root = nullptr;
+    this->m_size = 0;
+}
+
 /*!
  * @brief 插入节点
  *
@@ -0,0 +1,235 @@
+
+//==============================================================================
+/*!
+ * @file pq_multiqueue.h
+ * @brief 并发优先级队列（MultiQueue）
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_PQ_MULTIQUEUE_H
+#define DSAS_PQ_MULTIQUEUE_H
+
+#include <atomic>
+#include <thread>
+#include <functional>
+#include "priority_queue.h"
+#include "pq_complete_heap.h"
+#include "share/lock.h"
+#include "share/macro.h"
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup LPQ
+ *
+ * @{
+ */
+
+/*!
+ * @brief MultiQueue：由多个带锁的完全二叉堆组成的松弛（relaxed）并发优先级队列
+ *
+ * <pre>
+ * 单个加锁的堆，所有线程都在同一把锁、同一个堆顶缓存行上串行。
+ * MultiQueue使用m = c * P个相互独立的PqComplHeap（P为线程数，c通常取2~4）：
+ *
+ *   slot[0]: [lock][size][top] -> PqComplHeap
+ *   slot[1]: [lock][size][top] -> PqComplHeap
+ *   ......
+ *
+ * insert：随机选一个堆，try_lock失败则换一个，插入；
+ * del_max：随机选两个堆，比较两者缓存的堆顶（不加锁），锁住较大者并删除其堆顶（two-choice），
+ *          锁被占用或堆已空则重选；两个都为空时扫描所有堆，全空才返回失败。
+ *
+ * 删除的不一定是全局最大值，但期望的排名误差为O(m)，与元素总数无关，适用于任务调度等场景。
+ * 各堆的size与堆顶在持锁时更新为原子变量，供其他线程无锁读取，故T须可平凡复制（如整数、指针）。
+ * 每个slot后有一个缓存行的填充，避免相邻slot之间的伪共享。
+ * </pre>
+ *
+ */
+template <typename T>
+class PqMultiQueue : public dsa::PQ<T>
+{
+protected:
+    struct Slot
+    {
+        dsa::SpinLock       lock;
+        std::atomic<int>    size;       /**< 堆中元素数量，持锁时更新 */
+        std::atomic<T>      top;        /**< 堆顶的缓存，size为0时无意义 */
+        dsa::PqComplHeap<T> heap;
+        char                pad[DSAS_CACHELINE];
+
+        Slot() : size(0), top(T()) {}
+        /** 持锁时调用，更新size与堆顶的缓存 */
+        void publish()
+        {
+            if (!this->heap.is_empty())
+                this->top.store(this->heap.get_max(), std::memory_order_relaxed);
+            this->size.store(this->heap.size(), std::memory_order_release);
+        }
+    };
+
+    Slot*   m_slots;
+    int     m_num;
+
+    /** 线程私有的随机数（xorshift），返回[0, m_num) */
+    int     rand_slot() const
+    {
+        static thread_local unsigned int s = 0;
+        if (!s)
+            s = (unsigned int)std::hash<std::thread::id>()(std::this_thread::get_id()) | 1u;
+        s ^= s << 13; s ^= s >> 17; s ^= s << 5;
+        return (int)(s % (unsigned int)this->m_num);
+    }
+
+public:
+    PqMultiQueue(int threads, int c = 2);
+    ~PqMultiQueue() {delete[] this->m_slots;}
+    PqMultiQueue(const PqMultiQueue&) = delete;
+    PqMultiQueue& operator= (const PqMultiQueue&) = delete;
+
+    /** 堆的数量 */
+    int     queues() const {return this->m_num;}
+    int     size() const;
+    bool    is_empty() const {return this->size() == 0;}
+
+    void    insert(const T& e);
+    T       get_max();
+    bool    try_del_max(T& e);
+    /** 删除一个（近似的）最大值，队列须非空 */
+    T       del_max() {T e; while (!this->try_del_max(e)) dsa::cpu_relax(); return e;}
+};
+
+/*! @} */
+
+
+/*!
+ * @brief 创建MultiQueue
+ *
+ * @param threads: 并发访问的线程数
+ * @param c: 每个线程对应的堆数量，越大竞争越少、删除的元素越偏离最大值
+ * @return
+ * @retval None
+ */
+template <typename T>
+PqMultiQueue<T>::PqMultiQueue(int threads, int c)
+{
+    this->m_num = (threads > 0 ? threads : 1) * (c > 0 ? c : 1);
+    if (this->m_num < 2)
+        this->m_num = 2;
+    this->m_slots = new Slot[this->m_num];
+}
+
+/** 元素数量，并发修改时为近似值 */
+template <typename T>
+int PqMultiQueue<T>::size() const
+{
+    int n = 0;
+    for (int k = 0; k < this->m_num; k ++)
+        n += this->m_slots[k].size.load(std::memory_order_relaxed);
+    return n;
+}
+
+/*!
+ * @brief 插入元素
+ *
+ * @param e: 待插入的元素
+ * @return
+ * @retval None
+ */
+template <typename T>
+void PqMultiQueue<T>::insert(const T& e)
+{
+    for (;;)
+    {
+        Slot& s = this->m_slots[this->rand_slot()];
+        if (!s.lock.try_lock())
+            continue;
+        s.heap.insert(e);
+        s.publish();
+        s.lock.unlock();
+        return;
+    }
+}
+
+/*!
+ * @brief 所有堆顶中的最大值（不加锁，并发修改时为近似值），队列须非空
+ *
+ * @param None
+ * @return 返回最大的堆顶
+ * @retval None
+ */
+template <typename T>
+T PqMultiQueue<T>::get_max()
+{
+    T m = T();
+    bool found = false;
+    for (int k = 0; k < this->m_num; k ++)
+    {
+        Slot& s = this->m_slots[k];
+        if (s.size.load(std::memory_order_acquire) == 0)
+            continue;
+        T t = s.top.load(std::memory_order_relaxed);
+        if (!found || m < t)
+            m = t;
+        found = true;
+    }
+    return m;
+}
+
+/*!
+ * @brief 删除一个近似的最大值（two-choice）
+ *
+ * @param e: 返回删除的元素
+ * @return 所有堆均为空时返回false
+ * @retval None
+ */
+template <typename T>
+bool PqMultiQueue<T>::try_del_max(T& e)
+{
+    for (;;)
+    {
+        int i = this->rand_slot();
+        int j = this->rand_slot();
+        int ni = this->m_slots[i].size.load(std::memory_order_acquire);
+        int nj = this->m_slots[j].size.load(std::memory_order_acquire);
+        int k;
+        if (ni && nj)
+            k = (this->m_slots[i].top.load(std::memory_order_relaxed)
+                    < this->m_slots[j].top.load(std::memory_order_relaxed)) ? j : i;
+        else if (ni || nj)
+            k = ni ? i : j;
+        else
+        {
+            // 两个都为空：找一个非空的堆，全空则失败
+            k = -1;
+            for (int r = 0; r < this->m_num && k < 0; r ++)
+                if (this->m_slots[r].size.load(std::memory_order_acquire))
+                    k = r;
+            if (k < 0)
+                return false;
+        }
+
+        Slot& s = this->m_slots[k];
+        if (!s.lock.try_lock())
+            continue;
+        if (s.heap.is_empty())
+        {
+            s.lock.unlock();
+            continue;
+        }
+        e = s.heap.del_max();
+        s.publish();
+        s.lock.unlock();
+        return true;
+    }
+}
+
+} /* dsa */
+
+#endif /* ifndef DSAS_PQ_MULTIQUEUE_H */
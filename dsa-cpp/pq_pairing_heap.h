@@ -0,0 +1,331 @@
+
+//==============================================================================
+/*!
+ * @file pq_pairing_heap.h
+ * @brief 配对堆模版类
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_PQ_PAIRING_HEAP_H
+#define DSAS_PQ_PAIRING_HEAP_H
+
+#include "priority_queue.h"
+#include "share/compare.h"
+#include "share/swap.h"
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup LPQ
+ *
+ * @{
+ */
+
+template <typename T> struct PairNode;
+template <typename T>
+using PairNodePtr = struct PairNode<T>*;
+
+/*!
+ * @brief 配对堆节点
+ *
+ * <pre>
+ * 孩子以单链表组织（child指向最左孩子，next指向右兄弟）；
+ * prev指向左兄弟，最左孩子的prev指向父节点，据此可在O(1)内将节点从树中摘出。
+ * </pre>
+ */
+template <typename T>
+struct PairNode
+{
+    T               data;
+    PairNodePtr<T>  child;  /**< 最左孩子 */
+    PairNodePtr<T>  next;   /**< 右兄弟 */
+    PairNodePtr<T>  prev;   /**< 左兄弟，最左孩子则为父节点 */
+
+    PairNode(const T& e) : data(e), child(nullptr), next(nullptr), prev(nullptr) {}
+};
+
+/*!
+ * @brief 配对堆模板类
+ *
+ * <pre>
+ * 堆是一棵多叉树，根的优先级最高；唯一的基本操作是link：两个根中优先级低者成为高者的最左孩子。
+ *
+ * insert/merge：与根link，O(1)；
+ * increase_key：将节点连同子树摘出，再与根link，O(1)（均摊o(log n)）；
+ * del_max：删除根，孩子两遍配对（自左向右两两link，再自右向左逐个link），均摊O(log n)。
+ *
+ *       9                  第一遍：link(3,8) = 8, link(5,7) = 7
+ *    / / \ \     del_max     第二遍：link(7,8) = 8        8
+ *   3 8   5 7    ======>                                 / \
+ *                                                       7   3
+ *                                                       |
+ *                                                       5
+ *
+ * 所有操作都不递归，退化成长链（如有序插入）时也不会栈溢出。
+ *
+ * 优先级由CMP决定：CMP(a, b)为true表示a的优先级低于b，使用dsa::Greater<T>即为最小堆；
+ * increase_key指提升优先级，对最小堆即是经典的decrease-key（如Dijkstra的松弛）。
+ * push返回的句柄（节点指针）在该元素出堆前一直有效，merge后仍然有效。
+ * </pre>
+ *
+ */
+template <typename T, typename CMP = dsa::Less<T>>
+class PqPairingHeap : public dsa::PQ<T>
+{
+protected:
+    PairNodePtr<T>  m_root;
+    int             m_size;
+    CMP             cmp;
+
+    PairNodePtr<T>  link(PairNodePtr<T> a, PairNodePtr<T> b);
+    PairNodePtr<T>  combine(PairNodePtr<T> first);
+    void            cut(PairNodePtr<T> x);
+
+public:
+    PqPairingHeap() : m_root(nullptr), m_size(0) {}
+    ~PqPairingHeap() {this->clear();}
+    PqPairingHeap(const PqPairingHeap&) = delete;
+    PqPairingHeap& operator= (const PqPairingHeap&) = delete;
+
+    int     size() const {return this->m_size;}
+    bool    is_empty() const {return !this->m_root;}
+    void    clear();
+
+    PairNodePtr<T> push(const T& e);
+    /** 插入元素（PQ接口） */
+    void    insert(const T& e) {this->push(e);}
+    /** 堆顶，即优先级最高的元素，时间复杂度O(1) */
+    T       get_max() {return this->m_root->data;}
+    /** 堆顶的句柄 */
+    PairNodePtr<T> top() const {return this->m_root;}
+    T       del_max();
+    bool    increase_key(PairNodePtr<T> x, const T& e);
+    void    remove(PairNodePtr<T> x);
+    void    merge(PqPairingHeap<T,CMP>& h);
+};
+
+/*! @} */
+
+
+/*!
+ * @brief 合并两个根（next与prev均已断开）
+ *
+ * @param a,b: 两个根节点，不能为nullptr
+ * @return 返回新的根
+ * @retval None
+ */
+template <typename T, typename CMP>
+PairNodePtr<T> PqPairingHeap<T,CMP>::link(PairNodePtr<T> a, PairNodePtr<T> b)
+{
+    if (this->cmp(a->data, b->data))
+        dsa::swap(a, b);
+    // b成为a的最左孩子
+    b->next = a->child;
+    if (a->child)
+        a->child->prev = b;
+    b->prev = a;
+    a->child = b;
+    return a;
+}
+
+/*!
+ * @brief 两遍配对，将兄弟链表合并成一棵树
+ *
+ * <pre>
+ * 第一遍自左向右两两link，结果借用next逆序串起来（相当于一个栈），
+ * 第二遍从栈顶（即最右）开始逐个link，两遍都是迭代完成。
+ * </pre>
+ *
+ * @param first: 兄弟链表的第一个节点
+ * @return 返回合并后的根，first为nullptr时返回nullptr
+ * @retval None
+ */
+template <typename T, typename CMP>
+PairNodePtr<T> PqPairingHeap<T,CMP>::combine(PairNodePtr<T> first)
+{
+    PairNodePtr<T> stack = nullptr;
+    while (first)
+    {
+        PairNodePtr<T> a = first;
+        PairNodePtr<T> b = a->next;
+        a->prev = nullptr;
+        if (!b)
+        {
+            a->next = stack;
+            stack = a;
+            break;
+        }
+        first = b->next;
+        a->next = b->next = b->prev = nullptr;
+        PairNodePtr<T> p = this->link(a, b);
+        p->next = stack;
+        stack = p;
+    }
+    if (!stack)
+        return nullptr;
+
+    PairNodePtr<T> r = stack;
+    stack = stack->next;
+    r->next = nullptr;
+    while (stack)
+    {
+        PairNodePtr<T> n = stack->next;
+        stack->next = nullptr;
+        r = this->link(r, stack);
+        stack = n;
+    }
+    r->prev = nullptr;
+    return r;
+}
+
+/** 将非根节点x连同其子树从树中摘出 */
+template <typename T, typename CMP>
+void PqPairingHeap<T,CMP>::cut(PairNodePtr<T> x)
+{
+    if (x->prev->child == x)
+        x->prev->child = x->next;       // x是最左孩子，prev为父节点
+    else
+        x->prev->next = x->next;
+    if (x->next)
+        x->next->prev = x->prev;
+    x->next = x->prev = nullptr;
+}
+
+/*!
+ * @brief 释放所有节点
+ *
+ * 将节点的孩子链表接到当前链表的后面，再释放节点，不使用递归。
+ *
+ * @param None
+ * @return
+ * @retval None
+ */
+template <typename T, typename CMP>
+void PqPairingHeap<T,CMP>::clear()
+{
+    PairNodePtr<T> x = this->m_root;
+    PairNodePtr<T> tail = x;
+    while (x)
+    {
+        if (x->child)
+        {
+            tail->next = x->child;
+            while (tail->next)
+                tail = tail->next;
+        }
+        PairNodePtr<T> n = x->next;
+        delete x;
+        x = n;
+    }
+    this->m_root = nullptr;
+    this->m_size = 0;
+}
+
+/*!
+ * @brief 插入元素
+ *
+ * @param e: 待插入的元素
+ * @return 返回元素的句柄
+ * @retval None
+ */
+template <typename T, typename CMP>
+PairNodePtr<T> PqPairingHeap<T,CMP>::push(const T& e)
+{
+    PairNodePtr<T> x = new PairNode<T>(e);
+    this->m_root = this->m_root ? this->link(this->m_root, x) : x;
+    this->m_size ++;
+    return x;
+}
+
+/*!
+ * @brief 删除堆顶
+ *
+ * @param None
+ * @return 返回堆顶元素
+ * @retval None
+ */
+template <typename T, typename CMP>
+T PqPairingHeap<T,CMP>::del_max()
+{
+    PairNodePtr<T> r = this->m_root;
+    T e = r->data;
+    this->m_root = this->combine(r->child);
+    delete r;
+    this->m_size --;
+    return e;
+}
+
+/*!
+ * @brief 提升优先级
+ *
+ * @param x: 元素的句柄
+ * @param e: 新的值，优先级不能低于原值
+ * @return 新值的优先级更低时返回false
+ * @retval None
+ */
+template <typename T, typename CMP>
+bool PqPairingHeap<T,CMP>::increase_key(PairNodePtr<T> x, const T& e)
+{
+    if (this->cmp(e, x->data))
+        return false;
+    x->data = e;
+    if (x != this->m_root)
+    {
+        this->cut(x);
+        this->m_root = this->link(this->m_root, x);
+    }
+    return true;
+}
+
+/*!
+ * @brief 删除句柄对应的元素
+ *
+ * 摘出x的子树，删除x后将其孩子两遍配对，再与根link。
+ *
+ * @param x: 元素的句柄，删除后失效
+ * @return
+ * @retval None
+ */
+template <typename T, typename CMP>
+void PqPairingHeap<T,CMP>::remove(PairNodePtr<T> x)
+{
+    if (x == this->m_root)
+    {
+        this->del_max();
+        return;
+    }
+    this->cut(x);
+    PairNodePtr<T> c = this->combine(x->child);
+    if (c)
+        this->m_root = this->link(this->m_root, c);
+    delete x;
+    this->m_size --;
+}
+
+/*!
+ * @brief 合并堆，O(1)
+ *
+ * @param h: 待合并的堆，合并后为空，其句柄转为本堆的句柄
+ * @return
+ * @retval None
+ */
+template <typename T, typename CMP>
+void PqPairingHeap<T,CMP>::merge(PqPairingHeap<T,CMP>& h)
+{
+    if (&h == this || !h.m_root)
+        return;
+    this->m_root = this->m_root ? this->link(this->m_root, h.m_root) : h.m_root;
+    this->m_size += h.m_size;
+    h.m_root = nullptr;
+    h.m_size = 0;
+}
+
+} /* dsa */
+
+#endif /* ifndef DSAS_PQ_PAIRING_HEAP_H */
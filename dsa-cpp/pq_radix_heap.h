@@ -0,0 +1,167 @@
+
+//==============================================================================
+/*!
+ * @file pq_radix_heap.h
+ * @brief 基数堆模版类（单调整数优先级）
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_PQ_RADIX_HEAP_H
+#define DSAS_PQ_RADIX_HEAP_H
+
+#include <type_traits>
+#include "vector.h"
+#include "priority_queue.h"
+#include "share/entry.h"
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup LPQ
+ *
+ * @{
+ */
+
+/*!
+ * @brief 基数堆模板类
+ *
+ * <pre>
+ * 元素为词条(key, value)，key为无符号整数，key越小优先级越高（get_max/del_max取最小的key）。
+ * 要求单调：插入的key不小于最近一次删除的key（last），Dijkstra与事件模拟均满足。
+ *
+ * 按key与last的最高不同位分桶：桶0存放key == last的元素，桶i（i >= 1）存放 2^(i-1) <= key^last < 2^i 的元素：
+ *
+ *   last = 8 (0b1000)
+ *   桶0: 8     桶1: 9     桶2: 10,11     桶3: 12..15     桶4: 空     桶5: 16..31     ...
+ *
+ * del_max：桶0非空则直接取出；否则找到第一个非空的桶i，以其中最小的key作为新的last，
+ * 将桶i的元素重新分配——它们与新last的最高不同位都低于i，只会移到更低的桶。
+ * 每个元素最多下移W次（W为key的位数），故均摊O(W)，与元素数量无关，且不需要比较元素。
+ * </pre>
+ *
+ */
+template <typename K = unsigned int, typename V = int>
+class PqRadixHeap : public dsa::PQ<dsa::Entry<K,V>>
+{
+    static_assert(std::is_integral<K>::value && std::is_unsigned<K>::value, "PqRadixHeap: key must be unsigned integral");
+
+public:
+    using E = dsa::Entry<K,V>;
+    enum {BITS = sizeof(K) * 8};
+
+protected:
+    dsa::Vector<E>  m_bucket[BITS + 1];
+    K               m_last;     /**< 最近一次删除的key */
+    int             m_size;
+
+    /** key与last的最高不同位 + 1，相同则为0 */
+    static int      bucket_of(K x)
+    {
+#if defined(__GNUC__)
+        return x ? (int)(sizeof(unsigned long long) * 8) - __builtin_clzll((unsigned long long)x) : 0;
+#else
+        int b = 0;
+        for (; x; x >>= 1) b ++;
+        return b;
+#endif
+    }
+    void            pull();
+
+public:
+    PqRadixHeap() : m_last(0), m_size(0) {}
+
+    int     size() const {return this->m_size;}
+    bool    is_empty() const {return this->m_size == 0;}
+    /** 最近一次删除的key，之后插入的key不能小于它 */
+    K       last() const {return this->m_last;}
+    void    clear();
+
+    bool    push(K key, const V& value);
+    /** 插入词条（PQ接口），key须不小于last() */
+    void    insert(const E& e) {this->push(e.key, e.value);}
+    /** key最小的词条 */
+    E       get_max() {this->pull(); return this->m_bucket[0][this->m_bucket[0].size() - 1];}
+    E       del_max();
+};
+
+/*! @} */
+
+
+/*!
+ * @brief 保证桶0非空：从第一个非空的桶中取最小key作为last，并重新分配该桶
+ *
+ * @param None
+ * @return
+ * @retval None
+ */
+template <typename K, typename V>
+void PqRadixHeap<K,V>::pull()
+{
+    if (!this->m_bucket[0].is_empty())
+        return;
+    int i = 1;
+    while (this->m_bucket[i].is_empty())
+        i ++;
+    dsa::Vector<E>& b = this->m_bucket[i];
+    K m = b[0].key;
+    for (int k = 1; k < b.size(); k ++)
+        if (b[k].key < m)
+            m = b[k].key;
+    this->m_last = m;
+    for (int k = 0; k < b.size(); k ++)
+        this->m_bucket[bucket_of(b[k].key ^ m)].push_back(b[k]);
+    b.clear();
+}
+
+/** 清空，last归0 */
+template <typename K, typename V>
+void PqRadixHeap<K,V>::clear()
+{
+    for (int k = 0; k <= BITS; k ++)
+        this->m_bucket[k].clear();
+    this->m_last = 0;
+    this->m_size = 0;
+}
+
+/*!
+ * @brief 插入词条
+ *
+ * @param key: 关键码，不能小于last()
+ * @param value: 值
+ * @return key小于last()时返回false
+ * @retval None
+ */
+template <typename K, typename V>
+bool PqRadixHeap<K,V>::push(K key, const V& value)
+{
+    if (key < this->m_last)
+        return false;
+    this->m_bucket[bucket_of(key ^ this->m_last)].push_back(E(key, value));
+    this->m_size ++;
+    return true;
+}
+
+/*!
+ * @brief 删除key最小的词条
+ *
+ * @param None
+ * @return 返回删除的词条，堆须非空
+ * @retval None
+ */
+template <typename K, typename V>
+typename PqRadixHeap<K,V>::E PqRadixHeap<K,V>::del_max()
+{
+    this->pull();
+    this->m_size --;
+    return this->m_bucket[0].remove(this->m_bucket[0].size() - 1);
+}
+
+} /* dsa */
+
+#endif /* ifndef DSAS_PQ_RADIX_HEAP_H */
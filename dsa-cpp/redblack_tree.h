@@ -13,6 +13,7 @@
 #ifndef DSAS_REDBLACK_TREE_H
 #define DSAS_REDBLACK_TREE_H
 
+#include <type_traits>
 #include "binary_node.h"
 #include "binary_search_tree.h"
 
@@ -40,17 +41,24 @@ namespace dsa
  *</pre>
  *
  */
-template <typename T>
-class RedBlackTree : public BinSearchTree<T>
+template <typename T, typename N = BinNode<T> >
+class RedBlackTree : public BinSearchTree<T,N>
 {
+    static_assert(!std::is_same<N, BinNodeAvl<T> >::value, "RedBlackTree: BinNodeAvl does not store colors");
+
 public:
-    BinNodePtr<T>   insert(const T&);
+    N*              insert(const T&);
     bool            remove(const T&);
+    /** 并入other（要求本树元素均小于other中的元素），O(log(n)) */
+    bool            join(RedBlackTree<T,N>& other) {return this->join_tree(other);}
+    /** 本树保留 < e 的元素，其余移入other，O(log(n)) */
+    void            split(const T& e, RedBlackTree<T,N>& other) {this->split_tree(e, other);}
 
 protected:
-    void            solve_double_red(BinNodePtr<T>);
-    void            solve_double_black(BinNodePtr<T>);
-    int             update_height(BinNodePtr<T>);
+    void            solve_double_red(N*);
+    void            solve_double_black(N*);
+    int             update_height(N*);
+    N*              join_at(N*, N*, N*);
 };
 
 /*! @} */
@@ -61,19 +69,20 @@ protected:
  *
  * 红黑树的高度，只对黑节点计数。
  * 此函数是对基类BinTree中的update_height的重写，
- * 故BinSearchTree<T>::connect34中将会调用这里的update_height进行高度更新。
+ * 故BinSearchTree<T,N>::connect34中将会调用这里的update_height进行高度更新。
  *
  * @param x: 待更新高度的节点
  * @return
  * @retval None
  */
-template <typename T>
-int RedBlackTree<T>::update_height(BinNodePtr<T> x)
+template <typename T, typename N>
+int RedBlackTree<T,N>::update_height(N* x)
 {
     x->height = (BN_Stature(x->left) > BN_Stature(x->right)) ?
                 BN_Stature(x->left) : BN_Stature(x->right);
     if (BN_IsBlack(x))
         x->height++;
+    BN_UpdateCount(*x);
     return x->height;
 }
 
@@ -128,47 +137,47 @@ int RedBlackTree<T>::update_height(BinNodePtr<T> x)
  * @return
  * @retval None
  */
-template <typename T>
-void RedBlackTree<T>::solve_double_red(BinNodePtr<T> x)
+template <typename T, typename N>
+void RedBlackTree<T,N>::solve_double_red(N* x)
 {
     if (BN_IsRoot(*x))
     {
-        x->color = RBColor::Black;
+        x->set_color(RBColor::Black);
         this->m_root->height++;         // 变成黑节点，高度加1
         return;
     }
-    BinNodePtr<T> p = x->parent;
+    N* p = x->parent;
     if (BN_IsBlack(p))                  // p为黑节点，则没有双红问题
         return;
-    BinNodePtr<T> g = p->parent;          // p为红节点，必有黑父节点
-    BinNodePtr<T> u = BN_IsLeftChild(*p) ? g->right : g->left;
+    N* g = p->parent;                     // p为红节点，必有黑父节点
+    N* u = BN_IsLeftChild(*p) ? g->right : g->left;
 
     if (BN_IsBlack(u))
     {
         // RR-1
-        g->color = RBColor::Red;
+        g->set_color(RBColor::Red);
        // x,p同侧，即同为左孩子或同为右孩子
         if (BN_IsLeftChild(*x) == BN_IsLeftChild(*p))
-            p->color = RBColor::Black;
+            p->set_color(RBColor::Black);
         else
-            x->color = RBColor::Black;
+            x->set_color(RBColor::Black);
 
-        BinNodePtr<T>& n = RefFromParent(*g); // 获取g在父节点的孩子节点指针
+        typename N::Link& n = RefFromParent(*g); // 获取g在父节点的孩子节点指针
         n = this->rotate_at(x);             // 34重构中会更新高度，故重染色需要在rotate_at之前进行
-        //n->color = RBColor::Black;
-        //n->left->color = RBColor::Red;
-        //n->right->color = RBColor::Red;
+        //n->set_color(RBColor::Black);
+        //n->left->set_color(RBColor::Red);
+        //n->right->set_color(RBColor::Red);
     }
     else
     {
         // RR-2 重新染色
         // u原来为红节点，故一定不为nullptr
-        p->color = RBColor::Black;
+        p->set_color(RBColor::Black);
         p->height ++;                   // 由红转黑，高度加1
-        u->color = RBColor::Black;
+        u->set_color(RBColor::Black);
         u->height ++;                   // 由红转黑，高度加1
         if (!BN_IsRoot(*g))
-            g->color = RBColor::Red;    // 若g不是根节点，需要转红，继续检测双红问题
+            g->set_color(RBColor::Red); // 若g不是根节点，需要转红，继续检测双红问题
         solve_double_red(g);            // 若g是根节点，在递归调用中，高度会得到更新
     }
 }
@@ -258,51 +267,51 @@ void RedBlackTree<T>::solve_double_red(BinNodePtr<T> x)
  * @return
  * @retval None
  */
-template <typename T>
-void RedBlackTree<T>::solve_double_black(BinNodePtr<T> r)
+template <typename T, typename N>
+void RedBlackTree<T,N>::solve_double_black(N* r)
 {
     // 如果r为nullptr，则r的父节点为m_hot
-    BinNodePtr<T> p = r ? r->parent : this->m_hot;
+    N* p = r ? r->parent : this->m_hot;
     // r为根节点
     if (!p)
         return;
     // r的兄弟节点
-    BinNodePtr<T> s = (r == p->left) ? p->right : p->left;
+    N* s = (r == p->left) ? p->right : p->left;
 
     if (BN_IsBlack(s))  // s为黑
     {
-        BinNodePtr<T> t = nullptr;
+        N* t = nullptr;
         if (BN_IsRed(s->left)) t = s->left;
         else if (BN_IsRed(s->right)) t = s->right;
         if (t)          // s至少有一个红子节点
         {
             // BB-1
-            RBColor clr = p->color;
-            BinNodePtr<T>& n = RefFromParent(*p);
+            RBColor clr = p->get_color();
+            typename N::Link& n = RefFromParent(*p);
             // 因为34重构前，未进行颜色设置，故rotate_at中的高度更新无效
             n = this->rotate_at(t);
             // 重染色后，需要重新计算黑高度
             if (BN_HasLeftChild(*n))
             {
-                n->left->color = RBColor::Black;
+                n->left->set_color(RBColor::Black);
                 this->update_height(n->left);
             }
             if (BN_HasRightChild(*n))
             {
-                n->right->color = RBColor::Black;
+                n->right->set_color(RBColor::Black);
                 this->update_height(n->right);
             }
-            n->color = clr;
+            n->set_color(clr);
             this->update_height(n);
         }
         else            // s两个子节点均为黑
         {
-            s->color = RBColor::Red;        // s转红，高度减1
+            s->set_color(RBColor::Red);     // s转红，高度减1
             s->height--;
             if (BN_IsRed(p))                // p为红
             {
                 // BB-2R
-                p->color = RBColor::Black;  //p转黑，但黑高度不变
+                p->set_color(RBColor::Black); //p转黑，但黑高度不变
             }
             else                            // p为黑
             {
@@ -315,12 +324,12 @@ void RedBlackTree<T>::solve_double_black(BinNodePtr<T> r)
     else                // s为红，两个子节点则一定为黑
     {
         // BB-3
-        p->color = RBColor::Red;
-        s->color = RBColor::Black;
-        BinNodePtr<T> t = (BN_IsLeftChild(*s)) ? s->left : s->right;
+        p->set_color(RBColor::Red);
+        s->set_color(RBColor::Black);
+        N* t = (BN_IsLeftChild(*s)) ? s->left : s->right;
                         // 取t与s取同侧
         this->m_hot = p;
-        BinNodePtr<T>& n = RefFromParent(*p);
+        typename N::Link& n = RefFromParent(*p);
         n = this->rotate_at(t);
         // 递归修正r处的双黑问题
         solve_double_black(r);
@@ -334,14 +343,15 @@ void RedBlackTree<T>::solve_double_black(BinNodePtr<T> r)
  * @return
  * @retval None
  */
-template <typename T>
-BinNodePtr<T> RedBlackTree<T>::insert(const T& e)
+template <typename T, typename N>
+N* RedBlackTree<T,N>::insert(const T& e)
 {
-    BinNodePtr<T>& x = this->search(e);       // 使用BinSearchTree::search()
+    typename N::Link& x = this->search(e);    // 使用BinSearchTree::search()
     if (x)
         return x;
-    x = new BinNode<T>(e, this->m_hot, nullptr, nullptr, -1);   // 以m_hot为父节点，高度为-1，默认为红节点
+    x = new N(e, this->m_hot, nullptr, nullptr, -1);            // 以m_hot为父节点，高度为-1，默认为红节点
     this->m_size ++;
+    this->update_size_above(this->m_hot);   // 旋转不改变子树规模，故先更新祖先的cnt
     solve_double_red(x);
 
     // 无论原树中是否有e，返回时总有x->data == e
@@ -373,17 +383,18 @@ BinNodePtr<T> RedBlackTree<T>::insert(const T& e)
  * @return
  * @retval None
  */
-template <typename T>
-bool RedBlackTree<T>::remove(const T& e)
+template <typename T, typename N>
+bool RedBlackTree<T,N>::remove(const T& e)
 {
-    BinNodePtr<T>& x = this->search(e);
+    typename N::Link& x = this->search(e);
     if (!x)
         return false;
 
-    // 因为是先删除x，再进行调整，故先保存好x的颜色
-    dsa::RBColor xclr = x->color;
+    // 因为是先删除x，再进行调整，故先保存好实际被删除节点的颜色
+    // （x有两个子节点时，remove_at实际删除的是x的直接后继）
+    dsa::RBColor xclr = (x->left && x->right) ? x->successor()->get_color() : x->get_color();
     // r为接替x所在位置的节点，r可以为nullptr，m_hot为r的父节点
-    BinNodePtr<T> r = this->remove_at(x, this->m_hot);
+    N* r = this->remove_at(x, this->m_hot);
 
     // 没有节点了，则直接返回
     if(!(--this->m_size))
@@ -391,7 +402,7 @@ bool RedBlackTree<T>::remove(const T& e)
     // 删除的是根节点，则所有路径少了一个黑节点，则r即为新root节点
     if(!this->m_hot)
     {
-        this->m_root->color = RBColor::Black;
+        this->m_root->set_color(RBColor::Black);
         this->update_height(this->m_root);
         return true;
     }
@@ -400,7 +411,7 @@ bool RedBlackTree<T>::remove(const T& e)
     // x为黑，r为红，r的颜色和高度需要调整
     if (xclr == dsa::RBColor::Black && BN_IsRed(r))
     {
-        r->color = RBColor::Black;
+        r->set_color(RBColor::Black);
         r->height ++;
     }
     // x为红，r为黑，则r颜色和高度无需要变化（因为x的黑高度和r的黑高度相等）
@@ -419,7 +430,7 @@ bool RedBlackTree<T>::remove(const T& e)
     // r为红，则需要染黑
     if (BN_IsRed(r))
     {
-        r->color = RBColor::Black;
+        r->set_color(RBColor::Black);
         r->height ++;
         return true;
     }
@@ -429,6 +440,64 @@ bool RedBlackTree<T>::remove(const T& e)
 #endif
 }
 
+/*!
+ * @brief 以k为根节点，连接红黑子树l与r（l中元素 < k < r中元素）
+ *
+ * <pre>
+ * 先将l与r的根节点染黑（红黑树的子树，根节点染黑后仍为红黑树）；
+ * 黑高度相同：k染黑，作为l与r的根节点；
+ * l的黑高度较大（r较大时对称）：沿l的右侧链下行，找到与r黑高度相同的黑节点c（可以为外部节点），
+ * k染红，以k替换c的位置，c与r分别作为k的左右子树，k的黑高度与c相同，
+ * 故各路径黑节点数不变，最后使用solve_double_red修正可能出现的双红问题。
+ * </pre>
+ *
+ * @param l: 左子树根节点（parent为nullptr）
+ * @param k: 独立的节点
+ * @param r: 右子树根节点（parent为nullptr）
+ * @return 返回连接后的根节点
+ * @retval None
+ */
+template <typename T, typename N>
+N* RedBlackTree<T,N>::join_at(N* l, N* k, N* r)
+{
+    if (BN_IsRed(l)) {l->set_color(RBColor::Black); l->height ++;}
+    if (BN_IsRed(r)) {r->set_color(RBColor::Black); r->height ++;}
+    int hl = BN_Stature(l);
+    int hr = BN_Stature(r);
+    if (hl == hr)
+    {
+        k->set_color(RBColor::Black);
+        return BinSearchTree<T,N>::join_at(l, k, r);
+    }
+
+    N* p = nullptr;
+    N* c;
+    if (hl > hr)
+    {
+        this->m_root = c = l;
+        while (BN_IsRed(c) || BN_Stature(c) > hr) {p = c; c = c->right;}
+        p->right = k;
+        k->left = c;
+        k->right = r;
+    }
+    else
+    {
+        this->m_root = c = r;
+        while (BN_IsRed(c) || BN_Stature(c) > hl) {p = c; c = c->left;}
+        p->left = k;
+        k->left = l;
+        k->right = c;
+    }
+    k->set_color(RBColor::Red);
+    k->parent = p;
+    if (k->left) k->left->parent = k;
+    if (k->right) k->right->parent = k;
+    this->update_height(k);
+    this->update_size_above(k);
+    this->solve_double_red(k);
+    return this->m_root;
+}
+
 } /* dsa */
 
 #endif /* ifndef DSAS_REDBLACK_TREE_H */
@@ -31,6 +31,17 @@ template <typename T> struct Less
     bool operator() (const T& lhs, const T& rhs) const {return lhs < rhs;}
 };
 
+/*!
+ * @brief Greater仿函数
+ *
+ * 作为优先级队列的比较器时，将最大堆反转为最小堆（如Dijkstra中距离最小者优先）。
+ *
+ */
+template <typename T> struct Greater
+{
+    bool operator() (const T& lhs, const T& rhs) const {return rhs < lhs;}
+};
+
 /*!
  * @name 比较函数模板
  *
@@ -92,6 +92,7 @@ struct Entry
 template <typename K, typename V>
 struct Dict
 {
+    virtual ~Dict() {}
     virtual int     size() const = 0;
     virtual bool    put(K, V) = 0;
     virtual V*      get(K) = 0;
@@ -0,0 +1,272 @@
+
+//==============================================================================
+/*!
+ * @file epoch.h
+ * @brief 基于epoch的内存回收
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_EPOCH_H
+#define DSAS_EPOCH_H
+
+#include <atomic>
+#include <thread>
+#include "macro.h"
+#include "lock.h"
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup Share
+ *
+ * @{
+ */
+
+#define EPOCH_MAX_THREADS   128     /**< 同时参与epoch回收的线程数上限 */
+#define EPOCH_RECLAIM_BATCH 64      /**< 待回收对象达到此数量时，尝试回收一次 */
+
+/*!
+ * @brief 基于epoch的内存回收（全局唯一）
+ *
+ * <pre>
+ * 无锁读者在访问共享节点期间，写者不能立即释放被摘除的节点，而是将其退休(retire)，待安全时再释放：
+ *
+ * (1) 全局epoch G单调递增，每个线程占用一个槽位（独占一个缓存行）；
+ * (2) 读者进入临界区时，将当前G写入自己的槽位，离开时清0；
+ * (3) 写者先将节点从结构中摘除，再retire：以 r = G++ 标记该节点；
+ * (4) 回收时，取所有活跃槽位中的最小epoch m，所有 r < m 的节点均可释放。
+ *
+ * 槽位epoch为e的读者，在进入临界区时G已为e，即该读者进入时，所有 r < e 的节点早已被摘除，
+ * 读者不可能再访问到它们；而 r >= e 的节点可能正被该读者访问，需要继续等待。
+ * 读者写槽位与写者读槽位之间均有seq_cst屏障，保证写者读到旧槽位时，读者一定能看到节点已被摘除。
+ *
+ * 读者只写自己的槽位，不同读者之间没有共享写，读操作的开销不随线程数增加。
+ * 线程首次进入时自动注册槽位，线程退出时自动归还。
+ * </pre>
+ *
+ */
+class EpochDomain
+{
+private:
+    /** 线程槽位，独占一个缓存行 */
+    struct alignas(DSAS_CACHELINE) Slot
+    {
+        std::atomic<unsigned long long> epoch;  /**< 0表示不在临界区 */
+        std::atomic<bool>               used;
+    };
+
+    /** 退休的对象 */
+    struct Retired
+    {
+        void*               ptr;
+        void                (*deleter)(void*);
+        unsigned long long  epoch;
+        Retired*            next;
+    };
+
+    /** 线程本地状态，线程退出时析构，归还槽位 */
+    struct ThreadState
+    {
+        int     slot;
+        int     depth;      /**< 临界区嵌套深度 */
+        ThreadState() : slot(-1), depth(0) {}
+        ~ThreadState() {if (this->slot >= 0) EpochDomain::instance().release_slot(this->slot);}
+    };
+
+    Slot                            m_slots[EPOCH_MAX_THREADS];
+    std::atomic<unsigned long long> m_epoch;
+    Retired*                        m_retired;      /**< 退休对象链表 */
+    std::atomic<int>                m_count;        /**< 退休对象数量 */
+    dsa::SpinLock                   m_lock;         /**< 保护退休链表 */
+
+    EpochDomain() : m_epoch(1), m_retired(nullptr), m_count(0)
+    {
+        for (int k = 0; k < EPOCH_MAX_THREADS; k ++)
+        {
+            this->m_slots[k].epoch.store(0, std::memory_order_relaxed);
+            this->m_slots[k].used.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    /** 获取线程本地状态 */
+    static ThreadState& local()
+    {
+        static thread_local ThreadState ts;
+        return ts;
+    }
+
+    /** 注册槽位，槽位用完时等待其它线程退出 */
+    int     acquire_slot()
+    {
+        for (;;)
+        {
+            for (int k = 0; k < EPOCH_MAX_THREADS; k ++)
+            {
+                bool f = false;
+                if (!this->m_slots[k].used.load(std::memory_order_relaxed)
+                    && this->m_slots[k].used.compare_exchange_strong(f, true, std::memory_order_acq_rel))
+                    return k;
+            }
+            std::this_thread::yield();
+        }
+    }
+    /** 归还槽位 */
+    void    release_slot(int k)
+    {
+        this->m_slots[k].epoch.store(0, std::memory_order_release);
+        this->m_slots[k].used.store(false, std::memory_order_release);
+    }
+
+    /** 所有活跃读者中的最小epoch */
+    unsigned long long min_active()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        unsigned long long m = this->m_epoch.load(std::memory_order_seq_cst);
+        for (int k = 0; k < EPOCH_MAX_THREADS; k ++)
+        {
+            unsigned long long e = this->m_slots[k].epoch.load(std::memory_order_acquire);
+            if (e && e < m)
+                m = e;
+        }
+        return m;
+    }
+
+public:
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator= (const EpochDomain&) = delete;
+    /** 进程退出时，释放所有退休对象 */
+    ~EpochDomain()
+    {
+        while (this->m_retired)
+        {
+            Retired* r = this->m_retired;
+            this->m_retired = r->next;
+            r->deleter(r->ptr);
+            delete r;
+        }
+    }
+
+    /** 全局实例 */
+    static EpochDomain& instance()
+    {
+        static EpochDomain d;
+        return d;
+    }
+
+    /** 进入临界区（可嵌套） */
+    void    enter()
+    {
+        ThreadState& ts = local();
+        if (ts.depth++ > 0)
+            return;
+        if (ts.slot < 0)
+            ts.slot = this->acquire_slot();
+        this->m_slots[ts.slot].epoch.store(this->m_epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+    /** 离开临界区 */
+    void    exit()
+    {
+        ThreadState& ts = local();
+        if (--ts.depth > 0)
+            return;
+        this->m_slots[ts.slot].epoch.store(0, std::memory_order_release);
+    }
+
+    /*!
+     * @brief 退休对象，待没有读者可能访问时，调用deleter释放
+     *
+     * 调用前，对象必须已从数据结构中摘除。
+     *
+     * @param ptr: 对象指针
+     * @param deleter: 释放函数
+     * @return
+     * @retval None
+     */
+    void    retire(void* ptr, void (*deleter)(void*))
+    {
+        Retired* r = new Retired;
+        r->ptr = ptr;
+        r->deleter = deleter;
+        r->epoch = this->m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        bool full;
+        {
+            dsa::LockGuard<dsa::SpinLock> g(this->m_lock);
+            r->next = this->m_retired;
+            this->m_retired = r;
+            // 每积累一批尝试一次（有长时间停留在临界区的读者时，避免每次retire都扫描整个链表）
+            full = ((this->m_count.fetch_add(1, std::memory_order_relaxed) + 1) % EPOCH_RECLAIM_BATCH == 0);
+        }
+        if (full)
+            this->reclaim();
+    }
+
+    /*!
+     * @brief 释放所有已安全的退休对象
+     *
+     * @param None
+     * @return 返回释放的对象数量
+     * @retval None
+     */
+    int     reclaim()
+    {
+        Retired* done = nullptr;
+        {
+            dsa::LockGuard<dsa::SpinLock> g(this->m_lock);
+            unsigned long long m = this->min_active();
+            Retired** pp = &this->m_retired;
+            while (*pp)
+            {
+                Retired* r = *pp;
+                if (r->epoch < m)
+                {
+                    *pp = r->next;
+                    r->next = done;
+                    done = r;
+                    this->m_count.fetch_sub(1, std::memory_order_relaxed);
+                }
+                else
+                    pp = &r->next;
+            }
+        }
+        // 在锁外调用deleter
+        int n = 0;
+        while (done)
+        {
+            Retired* r = done;
+            done = r->next;
+            r->deleter(r->ptr);
+            delete r;
+            n ++;
+        }
+        return n;
+    }
+
+    /** 待回收的对象数量 */
+    int     pending() const {return this->m_count.load(std::memory_order_relaxed);}
+};
+
+/*!
+ * @brief 作用域epoch临界区，构造时进入，析构时离开
+ *
+ */
+class EpochGuard
+{
+public:
+    EpochGuard() {dsa::EpochDomain::instance().enter();}
+    ~EpochGuard() {dsa::EpochDomain::instance().exit();}
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator= (const EpochGuard&) = delete;
+};
+
+/*! @} */
+
+} /* dsa */
+
+#endif /* ifndef DSAS_EPOCH_H */
@@ -0,0 +1,200 @@
+
+//==============================================================================
+/*!
+ * @file lock.h
+ * @brief 自旋锁
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_LOCK_H
+#define DSAS_LOCK_H
+
+#include <atomic>
+#include <thread>
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup Share
+ *
+ * @{
+ */
+
+/*!
+ * @brief 自旋等待时让出流水线
+ *
+ * @param None
+ * @return
+ * @retval None
+ */
+inline void cpu_relax()
+{
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_ia32_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+/*!
+ * @brief 自旋等待的退避
+ *
+ * 先自旋若干次，之后让出CPU，避免持锁线程被换出时，等待者空转整个时间片。
+ *
+ */
+struct Backoff
+{
+    int n;
+    Backoff() : n(0) {}
+    void pause()
+    {
+        if (this->n < 64)
+        {
+            this->n ++;
+            cpu_relax();
+        }
+        else
+            std::this_thread::yield();
+    }
+};
+
+/*!
+ * @brief 自旋锁
+ *
+ * 先读后写（test-and-test-and-set），等待时只读本地缓存行，不反复争抢总线。
+ * 适用于临界区很短的场景。
+ *
+ */
+class SpinLock
+{
+private:
+    std::atomic<bool> m_lock;
+
+public:
+    SpinLock() : m_lock(false) {}
+    SpinLock(const SpinLock&) = delete;
+    SpinLock& operator= (const SpinLock&) = delete;
+
+    /** 尝试加锁，不等待 */
+    bool try_lock()
+    {
+        return !this->m_lock.load(std::memory_order_relaxed)
+            && !this->m_lock.exchange(true, std::memory_order_acquire);
+    }
+    /** 加锁 */
+    void lock()
+    {
+        Backoff b;
+        while (!this->try_lock())
+            while (this->m_lock.load(std::memory_order_relaxed))
+                b.pause();
+    }
+    /** 解锁 */
+    void unlock() {this->m_lock.store(false, std::memory_order_release);}
+};
+
+/*!
+ * @brief 读写自旋锁
+ *
+ * <pre>
+ * m_state: [ readers ... | W | P ]
+ *   bit0 (W): 写者持有锁
+ *   bit1 (P): 有写者在等待，此时新的读者不再进入，避免写者饥饿
+ *   其余位:   读者数量（以4为单位）
+ * </pre>
+ *
+ */
+class RWSpinLock
+{
+private:
+    enum {WRITER = 0x01, PENDING = 0x02, READER = 0x04};
+    std::atomic<int> m_state;
+
+public:
+    RWSpinLock() : m_state(0) {}
+    RWSpinLock(const RWSpinLock&) = delete;
+    RWSpinLock& operator= (const RWSpinLock&) = delete;
+
+    /** 加读锁 */
+    void lock_shared()
+    {
+        Backoff b;
+        for (;;)
+        {
+            int s = this->m_state.load(std::memory_order_relaxed);
+            if (!(s & (WRITER | PENDING))
+                && this->m_state.compare_exchange_weak(s, s + READER, std::memory_order_acquire))
+                return;
+            b.pause();
+        }
+    }
+    /** 解读锁 */
+    void unlock_shared() {this->m_state.fetch_sub(READER, std::memory_order_release);}
+
+    /** 加写锁 */
+    void lock()
+    {
+        Backoff b;
+        for (;;)
+        {
+            int s = this->m_state.load(std::memory_order_relaxed);
+            if (!(s & ~PENDING))
+            {
+                // 没有读者与写者，取得锁（同时清除等待标记）
+                if (this->m_state.compare_exchange_weak(s, WRITER, std::memory_order_acquire))
+                    return;
+            }
+            else if (!(s & PENDING))
+                this->m_state.fetch_or(PENDING, std::memory_order_relaxed);
+            b.pause();
+        }
+    }
+    /** 解写锁 */
+    void unlock() {this->m_state.fetch_and(~WRITER, std::memory_order_release);}
+};
+
+/*!
+ * @brief 作用域锁，构造时加锁，析构时解锁
+ *
+ */
+template <typename L>
+class LockGuard
+{
+private:
+    L& m_lock;
+
+public:
+    explicit LockGuard(L& l) : m_lock(l) {this->m_lock.lock();}
+    ~LockGuard() {this->m_lock.unlock();}
+    LockGuard(const LockGuard&) = delete;
+    LockGuard& operator= (const LockGuard&) = delete;
+};
+
+/*!
+ * @brief 作用域读锁
+ *
+ */
+template <typename L>
+class SharedLockGuard
+{
+private:
+    L& m_lock;
+
+public:
+    explicit SharedLockGuard(L& l) : m_lock(l) {this->m_lock.lock_shared();}
+    ~SharedLockGuard() {this->m_lock.unlock_shared();}
+    SharedLockGuard(const SharedLockGuard&) = delete;
+    SharedLockGuard& operator= (const SharedLockGuard&) = delete;
+};
+
+/*! @} */
+
+} /* dsa */
+
+#endif /* ifndef DSAS_LOCK_H */
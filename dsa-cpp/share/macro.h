@@ -21,4 +21,14 @@
 #warning "Using time lib of std"
 #endif
 
+/** 缓存行大小（字节），用于数据对齐，避免伪共享 */
+#define DSAS_CACHELINE      64
+
+/** 预取addr所在的缓存行（只读），不支持时为空操作 */
+#if defined(__GNUC__)
+#define DSAS_PREFETCH(addr) __builtin_prefetch((addr), 0, 3)
+#else
+#define DSAS_PREFETCH(addr) ((void)0)
+#endif
+
 #endif /* ifndef DSAS_MARCO_H */
@@ -0,0 +1,298 @@
+
+//==============================================================================
+/*!
+ * @file pool.h
+ * @brief 定长节点内存池
+ *
+ * @date
+ * @version
+ * @author
+ * @copyright
+ */
+//==============================================================================
+
+#ifndef DSAS_POOL_H
+#define DSAS_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include "lock.h"
+
+namespace dsa
+{
+
+/*!
+ * @addtogroup Share
+ *
+ * @{
+ */
+
+#define POOL_CHUNK_BYTES    (64 * 1024)     /**< 每次向系统申请的内存块大小 */
+
+/*!
+ * @brief 定长节点内存池
+ *
+ * <pre>
+ * 每次向系统申请一整块（chunk）内存，切分为定长的节点：
+ *   chunk: [next chunk][node][node][node]......[node]
+ * 释放的节点串成空闲链表（链接指针直接存放在空闲节点内部），分配时优先复用。
+ * 与逐个new相比：
+ * (1) 没有每个节点的malloc头部（通常16字节）；
+ * (2) 相邻分配的节点在内存中连续，遍历时缓存与TLB命中率更高；
+ * (3) 分配与释放只是链表头的弹出与压入。
+ * 内存块只在内存池析构时归还系统。分配与释放由自旋锁保护，可被多个线程共享。
+ * </pre>
+ *
+ */
+class NodePool
+{
+private:
+    struct FreeNode {FreeNode* next;};
+
+    std::size_t m_size;     /**< 节点大小（已按对齐要求取整） */
+    std::size_t m_offset;   /**< chunk中第一个节点的偏移 */
+    std::size_t m_align;    /**< 节点的对齐要求 */
+    std::size_t m_extra;    /**< 超过operator new对齐能力时，每个chunk多申请的字节数 */
+    int         m_per;      /**< 每个chunk的节点数 */
+    void*       m_chunks;   /**< chunk链表 */
+    FreeNode*   m_free;     /**< 空闲节点链表 */
+    long        m_used;     /**< 正在使用的节点数 */
+    long        m_nchunk;   /**< chunk数量 */
+    dsa::SpinLock m_lock;
+
+protected:
+    /** 申请新的chunk，并将其中的节点加入空闲链表 */
+    void grow()
+    {
+        char* c = static_cast<char*>(::operator new(this->m_offset + this->m_size * this->m_per + this->m_extra));
+        *reinterpret_cast<void**>(c) = this->m_chunks;
+        this->m_chunks = c;
+        this->m_nchunk ++;
+        // operator new只保证alignof(std::max_align_t)，更大的对齐（如缓存行）需要手动调整起始位置
+        std::uintptr_t a = reinterpret_cast<std::uintptr_t>(c + this->m_offset);
+        char* base = reinterpret_cast<char*>((a + this->m_align - 1) / this->m_align * this->m_align);
+        // 逆序压入，使得分配顺序与地址顺序一致
+        for (int k = this->m_per - 1; k >= 0; k --)
+        {
+            FreeNode* n = reinterpret_cast<FreeNode*>(base + this->m_size * k);
+            n->next = this->m_free;
+            this->m_free = n;
+        }
+    }
+
+public:
+    /*!
+     * @param size: 节点大小
+     * @param align: 节点的对齐要求
+     */
+    NodePool(std::size_t size, std::size_t align = alignof(std::max_align_t))
+        : m_chunks(nullptr), m_free(nullptr), m_used(0), m_nchunk(0)
+    {
+        if (align < alignof(FreeNode))
+            align = alignof(FreeNode);
+        if (size < sizeof(FreeNode))
+            size = sizeof(FreeNode);
+        this->m_size = (size + align - 1) / align * align;
+        this->m_offset = (sizeof(void*) + align - 1) / align * align;
+        this->m_align = align;
+        this->m_extra = (align > alignof(std::max_align_t)) ? align : 0;
+        this->m_per = static_cast<int>((POOL_CHUNK_BYTES - this->m_offset) / this->m_size);
+        if (this->m_per < 1)
+            this->m_per = 1;
+    }
+    ~NodePool()
+    {
+        while (this->m_chunks)
+        {
+            void* next = *static_cast<void**>(this->m_chunks);
+            ::operator delete(this->m_chunks);
+            this->m_chunks = next;
+        }
+    }
+    NodePool(const NodePool&) = delete;
+    NodePool& operator= (const NodePool&) = delete;
+
+    /** 分配一个节点 */
+    void* alloc()
+    {
+        dsa::LockGuard<dsa::SpinLock> g(this->m_lock);
+        if (!this->m_free)
+            this->grow();
+        FreeNode* n = this->m_free;
+        this->m_free = n->next;
+        this->m_used ++;
+        return n;
+    }
+    /** 释放一个节点 */
+    void free(void* p)
+    {
+        if (!p)
+            return;
+        dsa::LockGuard<dsa::SpinLock> g(this->m_lock);
+        FreeNode* n = static_cast<FreeNode*>(p);
+        n->next = this->m_free;
+        this->m_free = n;
+        this->m_used --;
+    }
+
+    /** 获取节点大小 */
+    std::size_t node_size() const {return this->m_size;}
+    /** 获取正在使用的节点数 */
+    long    used() const {return this->m_used;}
+    /** 获取向系统申请的字节数 */
+    long    reserved() const {return this->m_nchunk * (long)(this->m_offset + this->m_size * this->m_per + this->m_extra);}
+};
+
+
+#define POOL_INDEX_BITS     16      /**< IndexPool每个chunk的节点数为 2^POOL_INDEX_BITS */
+#define POOL_INDEX_CHUNKS   4096    /**< IndexPool的chunk数上限，节点数不超过 POOL_INDEX_CHUNKS << POOL_INDEX_BITS */
+
+/*!
+ * @brief 以32位下标寻址的定长节点内存池
+ *
+ * <pre>
+ * 与NodePool一样按chunk切分定长节点，但每个节点还有一个32位下标：
+ *   id = chunk序号 << POOL_INDEX_BITS | 节点在chunk中的序号
+ * 下标0保留为空（第0个chunk的第0个节点不分配）。
+ * 节点之间用下标代替指针链接时，每个链接只占4字节。
+ * (1) 下标 -> 地址：查一次chunk表，chunk表大小固定、只增不改，无需加锁；
+ * (2) 地址 -> 下标：在按地址排序的chunk表中二分查找，较慢，节点应在构造时记下自己的下标；
+ * (3) 空闲链表同样用下标串起来，存放在空闲节点内部。
+ * 分配与释放由自旋锁保护，可被多个线程共享；下标空间用尽时alloc返回nullptr。
+ * </pre>
+ *
+ */
+class IndexPool
+{
+private:
+    std::size_t m_size;     /**< 节点大小（已按对齐要求取整） */
+    std::size_t m_align;    /**< 节点的对齐要求 */
+    std::size_t m_extra;    /**< 超过operator new对齐能力时，每个chunk多申请的字节数 */
+    uint32_t    m_free;     /**< 空闲节点链表（下标，0为空） */
+    long        m_used;     /**< 正在使用的节点数 */
+    int         m_nchunk;   /**< chunk数量 */
+    char*       m_raw[POOL_INDEX_CHUNKS];     /**< 各chunk向系统申请的内存 */
+    char*       m_base[POOL_INDEX_CHUNKS];    /**< 各chunk中第0个节点的地址 */
+    int         m_order[POOL_INDEX_CHUNKS];   /**< 按m_base从小到大排列的chunk序号 */
+    dsa::SpinLock m_lock;
+
+protected:
+    /** 申请新的chunk，并将其中的节点加入空闲链表 */
+    bool grow()
+    {
+        if (this->m_nchunk >= POOL_INDEX_CHUNKS)
+            return false;
+        const uint32_t per = 1u << POOL_INDEX_BITS;
+        int c = this->m_nchunk;
+        char* raw = static_cast<char*>(::operator new(this->m_size * per + this->m_extra));
+        std::uintptr_t a = reinterpret_cast<std::uintptr_t>(raw);
+        this->m_raw[c] = raw;
+        this->m_base[c] = reinterpret_cast<char*>((a + this->m_align - 1) / this->m_align * this->m_align);
+        // 插入排序，保持m_order按地址有序
+        int k = c;
+        for (; k > 0 && this->m_base[this->m_order[k-1]] > this->m_base[c]; k --)
+            this->m_order[k] = this->m_order[k-1];
+        this->m_order[k] = c;
+        this->m_nchunk ++;
+        // 逆序压入，使得分配顺序与地址顺序一致
+        uint32_t first = (c == 0) ? 1 : 0;
+        for (uint32_t i = per; i > first; i --)
+        {
+            uint32_t id = (static_cast<uint32_t>(c) << POOL_INDEX_BITS) | (i - 1);
+            *static_cast<uint32_t*>(this->at(id)) = this->m_free;
+            this->m_free = id;
+        }
+        return true;
+    }
+
+    /** 由地址获取下标（需持有锁） */
+    uint32_t lookup(const void* p) const
+    {
+        const char* q = static_cast<const char*>(p);
+        int lo = 0, hi = this->m_nchunk - 1;
+        while (lo < hi)
+        {
+            int mi = (lo + hi + 1) / 2;
+            if (this->m_base[this->m_order[mi]] <= q)
+                lo = mi;
+            else
+                hi = mi - 1;
+        }
+        int c = this->m_order[lo];
+        return (static_cast<uint32_t>(c) << POOL_INDEX_BITS)
+            | static_cast<uint32_t>((q - this->m_base[c]) / this->m_size);
+    }
+
+public:
+    /*!
+     * @param size: 节点大小
+     * @param align: 节点的对齐要求
+     */
+    IndexPool(std::size_t size, std::size_t align = alignof(std::max_align_t))
+        : m_free(0), m_used(0), m_nchunk(0)
+    {
+        if (align < alignof(uint32_t))
+            align = alignof(uint32_t);
+        if (size < sizeof(uint32_t))
+            size = sizeof(uint32_t);
+        this->m_size = (size + align - 1) / align * align;
+        this->m_align = align;
+        this->m_extra = (align > alignof(std::max_align_t)) ? align : 0;
+    }
+    ~IndexPool()
+    {
+        for (int k = 0; k < this->m_nchunk; k ++)
+            ::operator delete(this->m_raw[k]);
+    }
+    IndexPool(const IndexPool&) = delete;
+    IndexPool& operator= (const IndexPool&) = delete;
+
+    /** 分配一个节点，下标空间用尽时返回nullptr */
+    void* alloc()
+    {
+        dsa::LockGuard<dsa::SpinLock> g(this->m_lock);
+        if (!this->m_free && !this->grow())
+            return nullptr;
+        uint32_t id = this->m_free;
+        void* n = this->at(id);
+        this->m_free = *static_cast<uint32_t*>(n);
+        this->m_used ++;
+        return n;
+    }
+    /** 释放一个节点 */
+    void free(void* p)
+    {
+        if (!p)
+            return;
+        dsa::LockGuard<dsa::SpinLock> g(this->m_lock);
+        *static_cast<uint32_t*>(p) = this->m_free;
+        this->m_free = this->lookup(p);
+        this->m_used --;
+    }
+
+    /** 由下标获取节点地址（id不能为0） */
+    void* at(uint32_t id) const
+    {
+        return this->m_base[id >> POOL_INDEX_BITS] + (id & ((1u << POOL_INDEX_BITS) - 1)) * this->m_size;
+    }
+    /** 由节点地址获取下标（p必须由alloc分配） */
+    uint32_t id_of(const void* p)
+    {
+        dsa::LockGuard<dsa::SpinLock> g(this->m_lock);
+        return this->lookup(p);
+    }
+
+    /** 获取节点大小 */
+    std::size_t node_size() const {return this->m_size;}
+    /** 获取正在使用的节点数 */
+    long    used() const {return this->m_used;}
+    /** 获取向系统申请的字节数 */
+    long    reserved() const {return this->m_nchunk * (long)((this->m_size << POOL_INDEX_BITS) + this->m_extra);}
+};
+
+/*! @} */
+
+} /* dsa */
+
+#endif /* ifndef DSAS_POOL_H */
@@ -25,22 +25,85 @@ namespace dsa
  * @{
  */
 
+#ifndef SPLAY_RAND_PERIOD
+#define SPLAY_RAND_PERIOD   8       /**< 概率伸展模式下，平均每SPLAY_RAND_PERIOD次访问伸展一次 */
+#endif
+
+/** 伸展方式 */
+typedef enum : unsigned char
+{
+    SplayBottomUp,  /**< 自底向上：先查找，再沿parent指针回溯伸展（默认） */
+    SplayTopDown,   /**< 自顶向下：查找的同时伸展，只需一趟，高度沿记录的L、R链更新，不沿parent指针回溯 */
+    SplaySemi,      /**< 半伸展：zig-zig时只旋转一次，目标节点的深度约减半，不一定成为树根 */
+    SplayRandom     /**< 概率伸展：每次访问以1/period的概率完整伸展，否则不调整 */
+}SplayMode;
+
 /*!
  * @brief 伸展树类
  *
  * 局部性：刚被访问的过的数据，极有可能很快现次被访问；
  *
+ * <pre>
+ * search按伸展方式调整树的结构；insert/remove需要目标位于树根，
+ * 故总是完整伸展（SplayTopDown模式下自顶向下，其它模式下自底向上）。
+ * 半伸展与概率伸展减少了每次访问的调整量，适合访问不够集中、调整开销不划算的场景，
+ * 可通过stat()比较各模式下的平均访问深度与旋转次数。
+ * find不调整结构，也不统计，多个线程可并发调用（期间不能有写操作）。
+ * </pre>
+ *
  */
-template <typename T>
-class SplayTree : public BinSearchTree<T>
+template <typename T, typename N = BinNode<T> >
+class SplayTree : public BinSearchTree<T,N>
 {
 public:
-    BinNodePtr<T>&  search(const T& e);
-    BinNodePtr<T>   insert(const T& e);
+    /** 访问统计 */
+    struct SplayStat
+    {
+        long long accesses; /**< 访问次数（search/insert/remove） */
+        long long depth;    /**< 访问节点的深度之和（调整之前） */
+        long long rotations;/**< 旋转次数（自顶向下伸展只统计zig-zig中的旋转，link不计） */
+        long long splays;   /**< 调整了结构的访问次数 */
+    };
+
+    SplayTree(SplayMode mode = SplayMode::SplayBottomUp, int period = SPLAY_RAND_PERIOD)
+        : m_mode(mode), m_period(period), m_seed(2463534242u) {this->reset_stat();}
+
+    typename N::Link& search(const T& e);
+    N*              insert(const T& e);
     bool            remove(const T& e);
+    N*              find(const T& e) const;
+
+    /** 设置伸展方式，period只用于SplayRandom */
+    void    set_mode(SplayMode mode, int period = SPLAY_RAND_PERIOD) {this->m_mode = mode; this->m_period = period;}
+    /** 获取伸展方式 */
+    SplayMode mode() const {return this->m_mode;}
+    /** 获取访问统计 */
+    const SplayStat& stat() const {return this->m_stat;}
+    /** 清零访问统计 */
+    void    reset_stat() {this->m_stat.accesses = 0; this->m_stat.depth = 0; this->m_stat.rotations = 0; this->m_stat.splays = 0;}
 
 protected:
-    BinNodePtr<T>   splay(BinNodePtr<T>);
+    N*              splay(N*);
+    N*              semi_splay(N*);
+    N*              splay_top_down(const T&);
+    typename N::Link& access(const T&, bool);
+
+    /** 指向节点v的引用（父节点的left/right或树根） */
+    typename N::Link& slot_of(N* v)
+    {
+        if (!v->parent) return this->m_root;
+        return (v == v->parent->left) ? v->parent->left : v->parent->right;
+    }
+    static void     attach_left(N*, N*);
+    static void     attach_right(N*, N*);
+
+private:
+    SplayMode       m_mode;
+    int             m_period;
+    unsigned int    m_seed;     /**< 概率伸展的随机种子 */
+    SplayStat       m_stat;
+    dsa::Stack<N*>  m_lspine;              /**< 自顶向下伸展时L的右链（栈顶为最右端） */
+    dsa::Stack<N*>  m_rspine;              /**< 自顶向下伸展时R的左链（栈顶为最左端） */
 };
 
 /*! @} */
@@ -54,8 +117,8 @@ protected:
  * @return
  * @retval None
  */
-template <typename T>
-inline void attach_left(BinNodePtr<T> p, BinNodePtr<T> c)
+template <typename T, typename N>
+inline void SplayTree<T,N>::attach_left(N* p, N* c)
 {
     p->left = c;
     if (c) c->parent = p;
@@ -69,8 +132,8 @@ inline void attach_left(BinNodePtr<T> p, BinNodePtr<T> c)
  * @return
  * @retval None
  */
-template <typename T>
-inline void attach_right(BinNodePtr<T> p, BinNodePtr<T> c)
+template <typename T, typename N>
+inline void SplayTree<T,N>::attach_right(N* p, N* c)
 {
     p->right = c;
     if (c) c->parent = p;
@@ -80,18 +143,81 @@ inline void attach_right(BinNodePtr<T> p, BinNodePtr<T> c)
  * @brief 查找节点。
  *
  * @param e: 查找目标。
- * @return 返回经过伸展后的树根节点。返回nullptr的唯一情况：树没有任何节点，即空树。
+ * @return 返回指向目标节点（没有找到时为最后访问的节点）的引用：
+ *         完整伸展时，即为经过伸展后的树根节点；半伸展或概率伸展时，节点不一定位于树根。
+ *         返回nullptr的唯一情况：树没有任何节点，即空树。
+ * @retval None
+ */
+template <typename T, typename N>
+typename N::Link& SplayTree<T,N>::search(const T& e)
+{
+    return this->access(e, false);
+}
+
+/*!
+ * @brief 查找节点，不调整结构
+ *
+ * @param e: 查找目标。
+ * @return 没有找到时返回nullptr
+ * @retval None
+ */
+template <typename T, typename N>
+N* SplayTree<T,N>::find(const T& e) const
+{
+    N* x = this->m_root;
+    while (x && dsa::not_equal(e, x->data))
+        x = dsa::less_than(e, x->data) ? x->left : x->right;
+    return x;
+}
+
+/*!
+ * @brief 访问节点，并按伸展方式调整
+ *
+ * @param e: 查找目标。
+ * @param full: 为true时总是完整伸展，目标（或最后访问的节点）成为树根
+ * @return 返回指向目标节点（没有找到时为最后访问的节点）的引用
  * @retval None
  */
-template <typename T>
-BinNodePtr<T>& SplayTree<T>::search(const T& e)
+template <typename T, typename N>
+typename N::Link& SplayTree<T,N>::access(const T& e, bool full)
 {
-    BinNodePtr<T> p = this->search_in(this->m_root, e, this->m_hot = nullptr);
+    this->m_stat.accesses++;
+    if (!this->m_root) return this->m_root;
+
+    SplayMode mode = this->m_mode;
+    if (full && mode != SplayMode::SplayTopDown)
+        mode = SplayMode::SplayBottomUp;
+    if (mode == SplayMode::SplayTopDown)
+    {
+        this->m_root = this->splay_top_down(e);
+        return this->m_root;
+    }
+
+    N* p = this->search_in(this->m_root, e, this->m_hot = nullptr);
     // 无论是否找到节点，均会进行伸展操作，即没有找到目标节点，也将靠近目标的节点移到树根
-    this->m_root = this->splay(p ? p : this->m_hot);
-    // 若m_root为nullptr（即没有查找到目标e，且m_hot也为nullptr）
-    // 则一定是空树的情况（非空树，即使没有查找到目录，m_hot也不会为nullptr）
-    return this->m_root;
+    // 非空树，即使没有查找到目录，m_hot也不会为nullptr
+    N* v = p ? p : this->m_hot;
+    for (N* x = v->parent; x; x = x->parent)
+        this->m_stat.depth++;
+
+    switch (mode)
+    {
+    case SplayMode::SplaySemi:
+        this->m_root = this->semi_splay(v);
+        return this->slot_of(v);
+    case SplayMode::SplayRandom:
+        // xorshift32
+        this->m_seed ^= this->m_seed << 13;
+        this->m_seed ^= this->m_seed >> 17;
+        this->m_seed ^= this->m_seed << 5;
+        if (this->m_period > 1 && this->m_seed % this->m_period)
+            return this->slot_of(v);
+        this->m_root = this->splay(v);
+        return this->m_root;
+    default:
+        this->m_root = this->splay(v);
+        return this->m_root;
+    }
 }
 
 /*!
@@ -101,23 +227,23 @@ BinNodePtr<T>& SplayTree<T>::search(const T& e)
  * @return
  * @retval None
  */
-template <typename T>
-BinNodePtr<T> SplayTree<T>::insert(const T& e)
+template <typename T, typename N>
+N* SplayTree<T,N>::insert(const T& e)
 {
     // 如果是空树，直接插入节点即可
     if (!this->m_root)
     {
         this->m_size++;
-        this->m_root = new BinNode<T>(e, nullptr);
+        this->m_root = new N(e, nullptr);
         return this->m_root;
     }
 
     // 因为不是空树,返回的x不可以为nullptr
-    // search 返回经过伸展后的树根节点
-    if (dsa::is_equal(this->search(e)->data, e)) return this->m_root;
+    // 完整伸展后，返回树根节点
+    if (dsa::is_equal(this->access(e, true)->data, e)) return this->m_root;
 
-    BinNodePtr<T> r = this->m_root;
-    this->m_root = new BinNode<T>(e, nullptr);
+    N* r = this->m_root;
+    this->m_root = new N(e, nullptr);
     this->m_size++;
 
     // 确定新插入节点的位置
@@ -148,16 +274,16 @@ BinNodePtr<T> SplayTree<T>::insert(const T& e)
  * @return
  * @retval None
  */
-template <typename T>
-bool SplayTree<T>::remove(const T& e)
+template <typename T, typename N>
+bool SplayTree<T,N>::remove(const T& e)
 {
     // 空树直接返回
     if (!this->m_root) return false;
     // 没有找到目标
-    if (dsa::not_equal(this->search(e)->data, e)) return false;
+    if (dsa::not_equal(this->access(e, true)->data, e)) return false;
 
     // 删除目标节点（经过伸展，已经移到了根节点）
-    BinNodePtr<T> s = this->m_root;
+    N* s = this->m_root;
     if (!BN_HasLeftChild(*this->m_root))
     {
         this->m_root = this->m_root->right;
@@ -166,11 +292,11 @@ bool SplayTree<T>::remove(const T& e)
     else if (!BN_HasRightChild(*this->m_root))
     {
         this->m_root = this->m_root->left;
-        if (this->m_root) this->m_root = nullptr;
+        if (this->m_root) this->m_root->parent = nullptr;
     }
     else
     {
-        BinNodePtr<T> lt = this->m_root->left;
+        N* lt = this->m_root->left;
         // 暂时分离左子树
         this->m_root->left = nullptr;
         lt->parent = nullptr;
@@ -179,7 +305,7 @@ bool SplayTree<T>::remove(const T& e)
         this->m_root->parent = nullptr;
         // 以原树根为目标，在原右子树做一次（必定失败的）查找，
         // 原右子树中的最大值经过伸展后，会移到原右子树的根节点
-        this->search(s->data);
+        this->access(s->data, true);
         // 再将原左子树连接到根节点
         this->m_root->left = lt;
         lt->parent = this->m_root;
@@ -269,17 +395,18 @@ bool SplayTree<T>::remove(const T& e)
  * @return
  * @retval None
  */
-template <typename T>
-BinNodePtr<T> SplayTree<T>::splay(BinNodePtr<T> v)
+template <typename T, typename N>
+N* SplayTree<T,N>::splay(N* v)
 {
     if (!v) return nullptr;
-    BinNodePtr<T> p;
-    BinNodePtr<T> g;
+    N* p;
+    N* g;
+    if (v->parent) this->m_stat.splays++;
 
     // 双层伸展，伸展完成后，v将成为子树的根节点
     while((p = v->parent) && (g = p->parent))
     {
-        BinNodePtr<T> gg = g->parent;
+        N* gg = g->parent;
         if (BN_IsLeftChild(*v))
         {
             if (BN_IsLeftChild(*p))
@@ -310,7 +437,7 @@ BinNodePtr<T> SplayTree<T>::splay(BinNodePtr<T> v)
             else
             {
                 // zag-zig
-                this->connect34(g, v, g,
+                this->connect34(p, v, g,
                         p->left, v->left, v->right, g->right);
             }
 
@@ -326,11 +453,13 @@ BinNodePtr<T> SplayTree<T>::splay(BinNodePtr<T> v)
         this->update_height(g);
         this->update_height(p);
         this->update_height(v);
+        this->m_stat.rotations += 2;
     }
 
     // 单层伸展，最多一次旋转
     if ((p = v->parent))
     {
+        this->m_stat.rotations++;
         if (BN_IsLeftChild(*v))
         {
             attach_left(p, v->right);
@@ -341,6 +470,8 @@ BinNodePtr<T> SplayTree<T>::splay(BinNodePtr<T> v)
             attach_right(p, v->left);
             attach_left(v, p);
         }
+        this->update_height(p);
+        this->update_height(v);
     }
 
     // v成为树的根节点
@@ -348,6 +479,197 @@ BinNodePtr<T> SplayTree<T>::splay(BinNodePtr<T> v)
     return v;
 }
 
+/*!
+ * @brief 对节点进行半伸展
+ *
+ * <pre>
+ * 与splay的区别只在zig-zig（zag-zag）：只旋转一次(g, p)，然后从p继续向上伸展，v只上升一层：
+ *         g                  p
+ *       /   \              /   \
+ *      p    T3    =>      v     g
+ *     / \               / \   / \
+ *    v  T2             T0 T1 T2 T3
+ *   / \
+ *  T0 T1
+ * zig-zag（zag-zig）与splay相同，v上升两层后继续。
+ * 访问路径的长度仍约减半（摊还复杂度与splay相同），但v不一定成为树根，每次的旋转次数更少。
+ * </pre>
+ *
+ * @param v: 待伸展的节点
+ * @return 返回新的树根节点
+ * @retval None
+ */
+template <typename T, typename N>
+N* SplayTree<T,N>::semi_splay(N* v)
+{
+    if (!v) return nullptr;
+    N* p;
+    N* g;
+    if (v->parent) this->m_stat.splays++;
+
+    while((p = v->parent) && (g = p->parent))
+    {
+        N* gg = g->parent;
+        N* top;                     // 调整后子树的根节点
+        if (BN_IsLeftChild(*v) && BN_IsLeftChild(*p))
+        {
+            // zig-zig：只旋转(g, p)
+            attach_left(g, p->right);
+            attach_right(p, g);
+            this->update_height(g);
+            this->update_height(p);
+            this->m_stat.rotations++;
+            top = p;
+        }
+        else if (BN_IsRightChild(*v) && BN_IsRightChild(*p))
+        {
+            // zag-zag：只旋转(g, p)
+            attach_right(g, p->left);
+            attach_left(p, g);
+            this->update_height(g);
+            this->update_height(p);
+            this->m_stat.rotations++;
+            top = p;
+        }
+        else
+        {
+            if (BN_IsLeftChild(*v))
+                this->connect34(g, v, p, g->left, v->left, v->right, p->right);     // zig-zag
+            else
+                this->connect34(p, v, g, p->left, v->left, v->right, g->right);     // zag-zig
+            this->m_stat.rotations += 2;
+            top = v;
+        }
+
+        if (!gg)
+            top->parent = nullptr;
+        else
+            (g == gg->left) ? attach_left(gg, top) : attach_right(gg, top);
+        v = top;
+    }
+
+    if ((p = v->parent))
+    {
+        if (BN_IsLeftChild(*v))
+        {
+            attach_left(p, v->right);
+            attach_right(v, p);
+        }
+        else
+        {
+            attach_right(p, v->left);
+            attach_left(v, p);
+        }
+        this->update_height(p);
+        this->update_height(v);
+        this->m_stat.rotations++;
+    }
+
+    v->parent = nullptr;
+    return v;
+}
+
+/*!
+ * @brief 自顶向下伸展
+ *
+ * <pre>
+ * 从树根向下查找e，沿途将节点拆分到左树L（均小于e）与右树R（均大于e）中，
+ * 查找结束时，当前节点t的左右子树分别接到L的最右端与R的最左端，再以L、R作为t的左右子树：
+ *
+ * e < t：若e < t->left，先右旋t（zig-zig）；再将t挂到R的最左端（link right），t下移到左子节点；
+ * e > t：若e > t->right，先左旋t（zag-zag）；再将t挂到L的最右端（link left），t下移到右子节点；
+ * zig-zag（zag-zig）按两次link处理。
+ *
+ * 只需一趟向下的遍历，不需要递归栈；结束后只有L的右链与R的左链上节点的子树发生了变化，
+ * 下降时将这两条链上的节点依次压栈，结束后出栈即为自底向上的顺序，据此更新高度，不沿parent指针回溯
+ * （attach仍维护parent指针，供其它操作使用）。
+ * </pre>
+ *
+ * @param e: 查找目标
+ * @return 返回新的树根节点（e或最后访问的节点）
+ * @retval None
+ */
+template <typename T, typename N>
+N* SplayTree<T,N>::splay_top_down(const T& e)
+{
+    N* t = this->m_root;
+    if (!t) return nullptr;
+    N *lroot = nullptr, *ltail = nullptr;              // 左树，沿右链挂接
+    N *rroot = nullptr, *rtail = nullptr;              // 右树，沿左链挂接
+
+    for (;;)
+    {
+        if (dsa::less_than(e, t->data))
+        {
+            if (!t->left) break;
+            if (dsa::less_than(e, t->left->data))
+            {
+                // zig-zig：先右旋
+                N* y = t->left;
+                attach_left(t, y->right);
+                attach_right(y, t);
+                this->update_height(t);
+                this->m_stat.rotations++;
+                this->m_stat.depth++;
+                t = y;
+                if (!t->left) break;
+            }
+            // link right
+            if (rtail) attach_left(rtail, t); else rroot = t;
+            rtail = t;
+            this->m_rspine.push(t);
+            t = t->left;
+            this->m_stat.depth++;
+        }
+        else if (dsa::less_than(t->data, e))
+        {
+            if (!t->right) break;
+            if (dsa::less_than(t->right->data, e))
+            {
+                // zag-zag：先左旋
+                N* y = t->right;
+                attach_right(t, y->left);
+                attach_left(y, t);
+                this->update_height(t);
+                this->m_stat.rotations++;
+                this->m_stat.depth++;
+                t = y;
+                if (!t->right) break;
+            }
+            // link left
+            if (ltail) attach_right(ltail, t); else lroot = t;
+            ltail = t;
+            this->m_lspine.push(t);
+            t = t->right;
+            this->m_stat.depth++;
+        }
+        else
+            break;
+    }
+
+    // 组装：t的左右子树接到L、R上，L、R再成为t的左右子树
+    if (ltail)
+    {
+        attach_right(ltail, t->left);
+        attach_left(t, lroot);
+    }
+    if (rtail)
+    {
+        attach_left(rtail, t->right);
+        attach_right(t, rroot);
+    }
+    t->parent = nullptr;
+    if (t != this->m_root) this->m_stat.splays++;
+
+    // 沿L的右链与R的左链自底向上，最后是t
+    while (!this->m_lspine.is_empty())
+        this->update_height(this->m_lspine.pop());
+    while (!this->m_rspine.is_empty())
+        this->update_height(this->m_rspine.pop());
+    this->update_height(t);
+    return t;
+}
+
 } /* dsa */
 
 #endif /* ifndef DSAS_SPLAY_TREE_H */
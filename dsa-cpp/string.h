@@ -64,21 +64,39 @@ protected:
             this->expand();
         this->m_array[this->m_size] = '\0';
     };
+    /** 以str[0,n)替换内容：先申请能容纳n个字符和'\0'的数组，再复制 */
+    void    assign(const char* str, int n)
+    {
+        int cap = 2 * n + 1;
+        char* a = new char[cap];
+        for (int k = 0; k < n; k ++)
+            a[k] = str[k];
+        a[n] = '\0';
+        delete[] this->m_array;     // str可能指向原数组，复制完成后再释放
+        this->m_array = a;
+        this->m_cap = cap;
+        this->m_size = n;
+    }
 
 public:
-    String() : dsa::Vector<char>() {}
-    String(const char* str) : dsa::Vector<char>(str, str_len(str)) {this->addZero();}
-    String(const char* str, int n) : dsa::Vector<char>(str, n) {this->addZero();}
-    String(const char* str, int lo, int hi) : dsa::Vector<char>(str, lo, hi) {this->addZero();}
-    String(const String& str) : dsa::Vector<char>(str.m_array, str.m_size) {this->addZero();}
-    String(const String& str, int lo, int hi) : dsa::Vector<char>(str.m_array, lo, hi) {this->addZero();}
+    String() : dsa::Vector<char>() {this->addZero();}
+    String(const char* str) : dsa::Vector<char>(0) {this->assign(str, str_len(str));}
+    String(const char* str, int n) : dsa::Vector<char>(0) {this->assign(str, n);}
+    String(const char* str, int lo, int hi) : dsa::Vector<char>(0) {this->assign(str + lo, hi - lo);}
+    String(const String& str) : dsa::Vector<char>(0) {this->assign(str.m_array, str.m_size);}
+    String(const String& str, int lo, int hi) : dsa::Vector<char>(0) {this->assign(str.m_array + lo, hi - lo);}
 
+    /** 重写赋值(=)运算符 */
+    String& operator=(const String& str)
+    {
+        if (this != &str)
+            this->assign(str.m_array, str.m_size);
+        return *this;
+    }
     /** 重写赋值(=)运算符 */
     String& operator=(const char* str)
     {
-        if(this->m_array) delete[] this->m_array;
-        this->copy_from(str, 0, str_len(str));
-        this->addZero();
+        this->assign(str, str_len(str));
         return *this;
     }
     /** 重写赋值(+=)运算符 */
@@ -55,6 +55,7 @@ public:
 
     /** 清空数据 */
     void    clear() {this->m_size = 0;}
+    void    resize(int n, const T& ele = T());
     /** 判断是否为空 */
     bool    is_empty() const {return !bool(this->m_size);}
     /** 返回元素数量 */
@@ -62,6 +63,7 @@ public:
     int     push_front(const T& ele);
     int     push_back(const T& ele);
     int     insert(int index, const T& ele);
+    int     insert(int index, const Vector<T,CMP>& V, int lo, int hi);
     /** 按序插入元素，可插入重复元素 */
     int     insert_multi_byorder(const T& ele) {return this->insert(this->search(ele)+1, ele);}
     /** 按序插入元素，不可插入重复元素，返回元素下标 */
@@ -275,6 +277,34 @@ int Vector<T,CMP>::insert(int index, const T& ele)
     return index;
 }
 
+/*!
+ * @brief 插入V中[lo,hi)的元素到指定下标位置
+ *
+ * 原有元素只整体后移一次，时间复杂度为O(m_size+hi-lo)，
+ * 而逐个调用insert(index, ele)为O(m_size*(hi-lo))。
+ * V不能是当前Vector本身。
+ *
+ * @param index: 指定的插入下标位置
+ * @param V: 源Vector
+ * @param lo,hi: 源Vector的下标范围[lo,hi)
+ * @return 返回插入的元素数量
+ * @retval None
+ */
+template <typename T, typename CMP>
+int Vector<T,CMP>::insert(int index, const Vector<T,CMP>& V, int lo, int hi)
+{
+    int n = hi - lo;
+    if (n <= 0) return 0;
+    while(this->m_size + n > this->m_cap)
+        this->expand();
+    for(int k = this->m_size - 1; k >= index; k--)
+        this->m_array[k+n] = this->m_array[k];
+    for(int k = 0; k < n; k++)
+        this->m_array[index+k] = V.m_array[lo+k];
+    this->m_size += n;
+    return n;
+}
+
 /*!
  * @brief 删除指定下标的元素
  *
@@ -326,7 +356,7 @@ template <typename T, typename CMP>
 void Vector<T,CMP>::expand()
 {
     T* old_ar = this->m_array;
-    this->m_cap *= 2;
+    this->m_cap = this->m_cap > 0 ? 2*this->m_cap : 1;   // 容量可能为0（如拷贝空Vector）
     this->m_array = new T[this->m_cap];
     for(int k = 0; k < m_size; k++)
     {
@@ -335,6 +365,33 @@ void Vector<T,CMP>::expand()
     delete[] old_ar;
 }
 
+/*!
+ * @brief 调整元素数量为n
+ *
+ * 容量不足时一次扩展到n（不按倍增），新增的元素初始化为ele；n较小时只截断。
+ *
+ * @param n: 新的元素数量
+ * @param ele: 新增元素的初值
+ * @return
+ * @retval None
+ */
+template <typename T, typename CMP>
+void Vector<T,CMP>::resize(int n, const T& ele)
+{
+    if (n > this->m_cap)
+    {
+        T* old_ar = this->m_array;
+        this->m_cap = n;
+        this->m_array = new T[this->m_cap];
+        for (int k = 0; k < this->m_size; k++)
+            this->m_array[k] = old_ar[k];
+        delete[] old_ar;
+    }
+    for (int k = this->m_size; k < n; k++)
+        this->m_array[k] = ele;
+    this->m_size = n;
+}
+
 /*!
  * @brief 在[lo, hi)查找特定元素
  *